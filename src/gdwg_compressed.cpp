@@ -0,0 +1,29 @@
+#include "gdwg_compressed.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  VARINT FUNCTIONS                                                                  //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+auto gdwg::varint::write(std::string& out, std::uint64_t value) -> void {
+	while (value >= 0x80U) {
+		out += static_cast<char>(static_cast<std::uint8_t>(value | 0x80U));
+		value >>= 7U;
+	}
+	out += static_cast<char>(static_cast<std::uint8_t>(value));
+}
+
+auto gdwg::varint::read(std::string_view& in) -> std::uint64_t {
+	auto value = std::uint64_t{0};
+	for (auto shift = 0U; shift < 64U; shift += 7U) {
+		if (in.empty())
+			throw std::runtime_error("Cannot call gdwg::varint::read on a truncated input");
+		auto const byte = static_cast<std::uint8_t>(in.front());
+		in.remove_prefix(1);
+		// The tenth byte may only hold the top bit of the number
+		if (shift == 63U and byte > 1U)
+			break;
+		value |= std::uint64_t{byte & 0x7fU} << shift;
+		if ((byte & 0x80U) == 0)
+			return value;
+	}
+	throw std::runtime_error("Cannot call gdwg::varint::read on a number wider than 64 bits");
+}
@@ -0,0 +1,474 @@
+#ifndef GDWG_COMPRESSED_H
+#	define GDWG_COMPRESSED_H
+
+#	include "gdwg_graph.h"
+#	include "gdwg_io.h"
+#	include "gdwg_wal.h"
+
+#	include <algorithm>
+#	include <cstddef>
+#	include <cstdint>
+#	include <filesystem>
+#	include <optional>
+#	include <stdexcept>
+#	include <string>
+#	include <string_view>
+#	include <system_error>
+#	include <utility>
+#	include <vector>
+
+namespace gdwg {
+	/**
+	 * LEB128 variable-length integers: seven bits per byte, least significant first, with the high bit set on every
+	 * byte but the last. Small numbers, such as the gaps between sorted ids, take a single byte.
+	 */
+	struct varint {
+		/**
+		 * @brief Appends a number.
+		 *
+		 * @param out The buffer to append to.
+		 * @param value The number.
+		 */
+		static auto write(std::string& out, std::uint64_t value) -> void;
+
+		/**
+		 * @brief Reads a number from the front of the input and removes it.
+		 * @note Marked as [[nodiscard]] because the number is lost if ignored.
+		 *
+		 * @param in The input.
+		 * @return The number.
+		 * @throws std::runtime_error If the input is truncated or the number does not fit in 64 bits.
+		 */
+		[[nodiscard]] static auto read(std::string_view& in) -> std::uint64_t;
+	};
+
+	/**
+	 * An immutable, compressed copy of a graph for archival and cold replicas. Nodes get dense ids in sorted order.
+	 * The edges of each node are stored as one byte string of varints: the distance of the first destination from
+	 * the source, then the gaps between consecutive destinations, each with a bit for whether the edge is weighted.
+	 * The weights are kept in a separate column. Queries decode only the edges of the node they ask about.
+	 */
+	template<typename N, typename E>
+	class compressed_graph {
+	 public:
+		/**
+		 * @brief Constructs an empty compressed graph.
+		 * @note Not marked as noexcept because the offset columns start with one entry.
+		 */
+		compressed_graph() = default;
+
+		/**
+		 * @brief Compresses a graph.
+		 * @note Not marked as noexcept because allocating the columns may throw.
+		 *
+		 * Time complexity: O(n + e log n).
+		 *
+		 * @param g The graph to compress.
+		 */
+		explicit compressed_graph(graph<N, E> const& g);
+
+		/**
+		 * @brief Checks if a node is in the graph.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 *
+		 * Time complexity: O(log n).
+		 *
+		 * @param value The node to check.
+		 * @return True if the node is in the graph, otherwise false.
+		 */
+		[[nodiscard]] auto is_node(N const& value) const -> bool;
+
+		/**
+		 * @brief Checks if there is an edge from src to dst, decoding the edges of src only up to dst.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Not marked as noexcept because it throws an exception if src or dst does not exist.
+		 *
+		 * Time complexity: O(log n + d) where d is the out-degree of src.
+		 *
+		 * @param src The source node.
+		 * @param dst The destination node.
+		 * @return True if the nodes are connected, otherwise false.
+		 */
+		[[nodiscard]] auto is_connected(N const& src, N const& dst) const -> bool;
+
+		/**
+		 * @brief Returns all nodes in ascending order.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Marked as noexcept because the nodes are stored as they are.
+		 *
+		 * @return The nodes.
+		 */
+		[[nodiscard]] auto nodes() const noexcept -> std::vector<N> const&;
+
+		/**
+		 * @brief Returns the nodes connected from src, decoding the edges of src only.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Not marked as noexcept because it throws an exception if src does not exist.
+		 *
+		 * Time complexity: O(log n + d) where d is the out-degree of src.
+		 *
+		 * @param src The source node.
+		 * @return The destinations of the edges from src in ascending order, without duplicates.
+		 */
+		[[nodiscard]] auto connections(N const& src) const -> std::vector<N>;
+
+		/**
+		 * @brief Returns the number of edges.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Marked as noexcept because the count is stored.
+		 *
+		 * @return The number of edges.
+		 */
+		[[nodiscard]] auto edge_count() const noexcept -> std::size_t;
+
+		/**
+		 * @brief Checks if there are no nodes.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Marked as noexcept because it only checks a size.
+		 *
+		 * @return True if there are no nodes, otherwise false.
+		 */
+		[[nodiscard]] auto empty() const noexcept -> bool;
+
+		/**
+		 * @brief Returns the number of bytes used by the edge stream, the weight column and the per-node offsets, not
+		 * counting the nodes themselves.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Marked as noexcept because it only sums sizes.
+		 *
+		 * @return The size of the compressed edges.
+		 */
+		[[nodiscard]] auto compressed_bytes() const noexcept -> std::size_t;
+
+		/**
+		 * @brief Decompresses into a graph equal to the one that was compressed.
+		 * @note Marked as [[nodiscard]] because the graph is lost if ignored.
+		 *
+		 * Time complexity: O(n + e).
+		 *
+		 * @return The graph.
+		 */
+		[[nodiscard]] auto decompress() const -> graph<N, E>;
+
+		/**
+		 * @brief Writes the compressed graph to a file, replacing it atomically with asynchronous writes.
+		 *
+		 * @param path The file to write.
+		 * @throws std::system_error If the file could not be written.
+		 */
+		auto save(std::filesystem::path const& path) const -> void
+		requires serializable<N> and serializable<E>;
+
+		/**
+		 * @brief Reads a compressed graph written by save.
+		 * @note Marked as [[nodiscard]] because the graph is lost if ignored.
+		 *
+		 * @param path The file to read.
+		 * @return The compressed graph.
+		 * @throws std::system_error If the file could not be read.
+		 * @throws std::runtime_error If the file is corrupt.
+		 */
+		[[nodiscard]] static auto load(std::filesystem::path const& path) -> compressed_graph
+		requires serializable<N> and serializable<E>;
+
+		/**
+		 * @brief Compares two compressed graphs for equality.
+		 *
+		 * @return True if they hold the same nodes and edges, otherwise false.
+		 */
+		[[nodiscard]] auto operator==(compressed_graph const&) const -> bool = default;
+
+	 private:
+		static constexpr std::string_view file_magic = "GDWGCMPR";
+
+		std::vector<N> nodes_;
+		// Node i owns edges_[edge_offsets_[i], edge_offsets_[i + 1]) and the weights from weight_offsets_[i]
+		std::vector<std::uint64_t> edge_offsets_ = std::vector<std::uint64_t>(1);
+		std::vector<std::uint64_t> weight_offsets_ = std::vector<std::uint64_t>(1);
+		std::string edges_;
+		std::vector<E> weights_;
+		std::size_t edge_count_ = 0;
+
+		/**
+		 * @brief Returns the dense id of a node.
+		 *
+		 * @param value The node.
+		 * @return The id, or std::nullopt if the node is not in the graph.
+		 */
+		[[nodiscard]] auto id_of(N const& value) const -> std::optional<std::size_t>;
+
+		/**
+		 * @brief Decodes the edges of a node in order until visit returns false.
+		 *
+		 * @param src The id of the source node.
+		 * @param visit Called with the id of the destination and a pointer to the weight, or nullptr if the edge is
+		 * unweighted.
+		 */
+		template<typename F>
+		auto decode(std::size_t src, F visit) const -> void;
+
+		/**
+		 * @brief Checks that the columns are consistent, as they are when read from an intact file.
+		 *
+		 * @throws std::runtime_error If any offset or id is out of range.
+		 */
+		auto validate() const -> void;
+	};
+} // namespace gdwg
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  COMPRESSED GRAPH FUNCTIONS                                                        //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename N, typename E>
+gdwg::compressed_graph<N, E>::compressed_graph(graph<N, E> const& g)
+: nodes_{g.nodes()} {
+	edge_offsets_.reserve(nodes_.size() + 1);
+	weight_offsets_.reserve(nodes_.size() + 1);
+	// Each source closes the lists of the sources before it, which have no edges left
+	auto closed = std::size_t{0};
+	auto const& close_until = [this, &closed](std::size_t src) {
+		for (; closed < src; ++closed) {
+			edge_offsets_.push_back(edges_.size());
+			weight_offsets_.push_back(weights_.size());
+		}
+	};
+	auto last_src = std::optional<std::size_t>{};
+	auto previous = std::uint64_t{0};
+	g.for_each_edge([&](N const& src, N const& dst, std::optional<E> const& weight) {
+		auto const src_id = *id_of(src);
+		auto const dst_id = static_cast<std::uint64_t>(*id_of(dst));
+		close_until(src_id);
+		// The first destination is stored relative to the source, zigzag-encoded since it may be smaller
+		auto const gap = last_src != src_id
+		                     ? (dst_id >= src_id ? (dst_id - src_id) << 1U : ((src_id - dst_id) << 1U) - 1U)
+		                     : dst_id - previous;
+		varint::write(edges_, (gap << 1U) | (weight ? 1U : 0U));
+		if (weight)
+			weights_.push_back(*weight);
+		last_src = src_id;
+		previous = dst_id;
+		++edge_count_;
+	});
+	close_until(nodes_.size());
+	edges_.shrink_to_fit();
+	weights_.shrink_to_fit();
+}
+
+template<typename N, typename E>
+auto gdwg::compressed_graph<N, E>::is_node(N const& value) const -> bool {
+	return id_of(value).has_value();
+}
+
+template<typename N, typename E>
+auto gdwg::compressed_graph<N, E>::is_connected(N const& src, N const& dst) const -> bool {
+	auto const src_id = id_of(src);
+	auto const dst_id = id_of(dst);
+	if (not src_id or not dst_id) {
+		throw std::runtime_error("Cannot call gdwg::compressed_graph<N, E>::is_connected if src or dst node don't exist "
+		                         "in the graph");
+	}
+	auto found = false;
+	decode(*src_id, [&found, target = *dst_id](std::size_t id, E const*) {
+		found = id == target;
+		return id < target;
+	});
+	return found;
+}
+
+template<typename N, typename E>
+auto gdwg::compressed_graph<N, E>::nodes() const noexcept -> std::vector<N> const& {
+	return nodes_;
+}
+
+template<typename N, typename E>
+auto gdwg::compressed_graph<N, E>::connections(N const& src) const -> std::vector<N> {
+	auto const src_id = id_of(src);
+	if (not src_id)
+		throw std::runtime_error("Cannot call gdwg::compressed_graph<N, E>::connections if src doesn't exist in the graph");
+	auto result = std::vector<N>{};
+	decode(*src_id, [this, &result](std::size_t id, E const*) {
+		// Parallel edges have a gap of zero, so duplicates are adjacent
+		if (result.empty() or not(result.back() == nodes_[id]))
+			result.push_back(nodes_[id]);
+		return true;
+	});
+	return result;
+}
+
+template<typename N, typename E>
+auto gdwg::compressed_graph<N, E>::edge_count() const noexcept -> std::size_t {
+	return edge_count_;
+}
+
+template<typename N, typename E>
+auto gdwg::compressed_graph<N, E>::empty() const noexcept -> bool {
+	return nodes_.empty();
+}
+
+template<typename N, typename E>
+auto gdwg::compressed_graph<N, E>::compressed_bytes() const noexcept -> std::size_t {
+	return edges_.size() + weights_.size() * sizeof(E)
+	       + (edge_offsets_.size() + weight_offsets_.size()) * sizeof(std::uint64_t);
+}
+
+template<typename N, typename E>
+auto gdwg::compressed_graph<N, E>::decompress() const -> graph<N, E> {
+	auto edges = std::vector<typename graph_builder<N, E>::indexed_edge>{};
+	edges.reserve(edge_count_);
+	for (auto src = std::size_t{0}; src < nodes_.size(); ++src) {
+		decode(src, [src, &edges](std::size_t dst, E const* weight) {
+			edges.push_back({src, dst, weight != nullptr ? std::optional<E>{*weight} : std::nullopt});
+			return true;
+		});
+	}
+	return graph_builder<N, E>::from_sorted(nodes_, edges);
+}
+
+template<typename N, typename E>
+auto gdwg::compressed_graph<N, E>::save(std::filesystem::path const& path) const -> void
+requires serializable<N> and serializable<E>
+{
+	// The CRC is carried across the blocks handed to the writer
+	auto out = async_writer{path};
+	auto block = std::string{file_magic};
+	auto crc = std::uint32_t{0};
+	auto const& hand_over = [&out, &block, &crc](std::size_t at_least) {
+		if (block.size() < at_least)
+			return;
+		crc = crc32(block, crc);
+		out.write(std::exchange(block, std::string{}));
+	};
+	serializer<std::uint64_t>::write(block, nodes_.size());
+	for (auto const& n : nodes_) {
+		serializer<N>::write(block, n);
+		hand_over(out.block_bytes());
+	}
+	// Offsets are stored as per-node lengths, which are small
+	for (auto i = std::size_t{0}; i < nodes_.size(); ++i) {
+		varint::write(block, edge_offsets_[i + 1] - edge_offsets_[i]);
+		varint::write(block, weight_offsets_[i + 1] - weight_offsets_[i]);
+		hand_over(out.block_bytes());
+	}
+	serializer<std::uint64_t>::write(block, edge_count_);
+	serializer<std::uint64_t>::write(block, edges_.size());
+	// The edges are already encoded, so they are checksummed and written in place
+	hand_over(0);
+	crc = crc32(edges_, crc);
+	for (auto offset = std::size_t{0}; offset < edges_.size(); offset += out.block_bytes()) {
+		out.write(std::string_view{edges_}.substr(offset, out.block_bytes()));
+	}
+	for (auto const& w : weights_) {
+		serializer<E>::write(block, w);
+		hand_over(out.block_bytes());
+	}
+	hand_over(0);
+	serializer<std::uint32_t>::write(block, crc);
+	out.write(std::move(block));
+	out.commit(true);
+}
+
+template<typename N, typename E>
+auto gdwg::compressed_graph<N, E>::load(std::filesystem::path const& path) -> compressed_graph
+requires serializable<N> and serializable<E>
+{
+	auto const data = durable_file::read(path);
+	if (not data) {
+		throw std::system_error(std::make_error_code(std::errc::no_such_file_or_directory),
+		                        "Cannot call gdwg::compressed_graph<N, E>::load on " + path.string());
+	}
+	auto const corrupt = [] {
+		return std::runtime_error("Cannot call gdwg::compressed_graph<N, E>::load on a corrupt file");
+	};
+	auto const view = std::string_view{*data};
+	if (view.size() < file_magic.size() + sizeof(std::uint32_t) or not view.starts_with(file_magic))
+		throw corrupt();
+	auto const body = view.substr(0, view.size() - sizeof(std::uint32_t));
+	auto trailer = view.substr(body.size());
+	if (serializer<std::uint32_t>::read(trailer) != crc32(body))
+		throw corrupt();
+
+	auto in = body.substr(file_magic.size());
+	auto result = compressed_graph{};
+	auto const node_count = serializer<std::uint64_t>::read(in);
+	// Each node takes at least two bytes of lengths, which bounds the count before anything is allocated
+	if (node_count > in.size())
+		throw corrupt();
+	result.nodes_.reserve(node_count);
+	for (auto i = std::uint64_t{0}; i < node_count; ++i) {
+		result.nodes_.push_back(serializer<N>::read(in));
+	}
+	result.edge_offsets_.assign(1, 0);
+	result.weight_offsets_.assign(1, 0);
+	for (auto i = std::uint64_t{0}; i < node_count; ++i) {
+		result.edge_offsets_.push_back(result.edge_offsets_.back() + varint::read(in));
+		result.weight_offsets_.push_back(result.weight_offsets_.back() + varint::read(in));
+	}
+	result.edge_count_ = serializer<std::uint64_t>::read(in);
+	auto const edge_bytes = serializer<std::uint64_t>::read(in);
+	if (edge_bytes > in.size())
+		throw corrupt();
+	result.edges_ = std::string{in.substr(0, edge_bytes)};
+	in.remove_prefix(edge_bytes);
+	while (not in.empty()) {
+		result.weights_.push_back(serializer<E>::read(in));
+	}
+	result.validate();
+	return result;
+}
+
+template<typename N, typename E>
+auto gdwg::compressed_graph<N, E>::id_of(N const& value) const -> std::optional<std::size_t> {
+	auto const it = std::lower_bound(nodes_.begin(), nodes_.end(), value);
+	if (it == nodes_.end() or value < *it)
+		return std::nullopt;
+	return static_cast<std::size_t>(it - nodes_.begin());
+}
+
+template<typename N, typename E>
+template<typename F>
+auto gdwg::compressed_graph<N, E>::decode(std::size_t src, F visit) const -> void {
+	auto in = std::string_view{edges_}.substr(edge_offsets_[src], edge_offsets_[src + 1] - edge_offsets_[src]);
+	auto weight = weights_.data() + weight_offsets_[src];
+	auto dst = std::uint64_t{0};
+	for (auto first = true; not in.empty(); first = false) {
+		auto const code = varint::read(in);
+		auto const gap = code >> 1U;
+		if (first)
+			dst = (gap & 1U) == 0 ? src + (gap >> 1U) : src - ((gap + 1U) >> 1U);
+		else
+			dst += gap;
+		auto const* const value = (code & 1U) != 0 ? weight++ : nullptr;
+		if (not visit(static_cast<std::size_t>(dst), value))
+			return;
+	}
+}
+
+template<typename N, typename E>
+auto gdwg::compressed_graph<N, E>::validate() const -> void {
+	auto const corrupt = [] {
+		return std::runtime_error("Cannot call gdwg::compressed_graph<N, E>::load on a corrupt file");
+	};
+	if (not std::is_sorted(nodes_.begin(), nodes_.end()) or not std::is_sorted(edge_offsets_.begin(), edge_offsets_.end())
+	    or not std::is_sorted(weight_offsets_.begin(), weight_offsets_.end()) or edge_offsets_.back() != edges_.size()
+	    or weight_offsets_.back() != weights_.size())
+	{
+		throw corrupt();
+	}
+	auto edges = std::size_t{0};
+	for (auto src = std::size_t{0}; src < nodes_.size(); ++src) {
+		auto weighted = std::uint64_t{0};
+		decode(src, [&](std::size_t dst, E const* weight) {
+			if (dst >= nodes_.size())
+				throw corrupt();
+			weighted += weight != nullptr ? 1U : 0U;
+			++edges;
+			return true;
+		});
+		if (weighted != weight_offsets_[src + 1] - weight_offsets_[src])
+			throw corrupt();
+	}
+	if (edges != edge_count_)
+		throw corrupt();
+}
+
+#endif // GDWG_COMPRESSED_H
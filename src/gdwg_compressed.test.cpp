@@ -0,0 +1,105 @@
+#include "gdwg_compressed.h"
+#include "gdwg_testing.h"
+
+#include <catch2/catch.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace {
+	using gdwg::testing::sample;
+	using gdwg::testing::scratch_path;
+
+	using graph_type = gdwg::graph<std::string, int>;
+	using compressed_type = gdwg::compressed_graph<std::string, int>;
+} // namespace
+
+TEST_CASE("Varint operation", "[compressed]") {
+	auto out = std::string{};
+	for (auto const value : {std::uint64_t{0}, std::uint64_t{127}, std::uint64_t{128}, ~std::uint64_t{0}}) {
+		gdwg::varint::write(out, value);
+	}
+	REQUIRE(out.size() == 1 + 1 + 2 + 10);
+	auto in = std::string_view{out};
+	REQUIRE(gdwg::varint::read(in) == 0);
+	REQUIRE(gdwg::varint::read(in) == 127);
+	REQUIRE(gdwg::varint::read(in) == 128);
+	REQUIRE(gdwg::varint::read(in) == ~std::uint64_t{0});
+	REQUIRE(in.empty());
+
+	auto truncated = std::string_view{"\x80"};
+	REQUIRE_THROWS_AS(gdwg::varint::read(truncated), std::runtime_error);
+	auto const wide = std::string(10, '\xff') + '\x01';
+	auto too_wide = std::string_view{wide};
+	REQUIRE_THROWS_AS(gdwg::varint::read(too_wide), std::runtime_error);
+}
+
+TEST_CASE("Compressed graph operation", "[compressed]") {
+	auto const g = sample();
+	auto const c = compressed_type{g};
+
+	SECTION("Queries match the graph") {
+		REQUIRE(c.nodes() == g.nodes());
+		REQUIRE(c.edge_count() == 8);
+		REQUIRE(c.is_node("C"));
+		REQUIRE_FALSE(c.is_node("F"));
+		for (auto const& src : g.nodes()) {
+			REQUIRE(c.connections(src) == g.connections(src));
+			for (auto const& dst : g.nodes()) {
+				REQUIRE(c.is_connected(src, dst) == g.is_connected(src, dst));
+			}
+		}
+	}
+
+	SECTION("Missing nodes throw") {
+		REQUIRE_THROWS_WITH(c.is_connected("A", "F"),
+		                    "Cannot call gdwg::compressed_graph<N, E>::is_connected if src or dst node don't exist in "
+		                    "the graph");
+		REQUIRE_THROWS_WITH(c.connections("F"),
+		                    "Cannot call gdwg::compressed_graph<N, E>::connections if src doesn't exist in the graph");
+	}
+
+	SECTION("Decompressing restores the graph") {
+		REQUIRE(c.decompress() == g);
+		REQUIRE(compressed_type{}.decompress().empty());
+		REQUIRE(compressed_type{graph_type{}} == compressed_type{});
+	}
+
+	SECTION("Gaps between nearby ids take one byte each") {
+		auto chain = gdwg::graph<int, int>{};
+		for (auto i = 0; i < 1000; ++i) {
+			chain.insert_node(i);
+		}
+		for (auto i = 0; i < 1000; ++i) {
+			for (auto j = i + 1; j < std::min(i + 9, 1000); ++j) {
+				chain.insert_edge(i, j);
+			}
+		}
+		auto const compressed = gdwg::compressed_graph<int, int>{chain};
+		REQUIRE(compressed.edge_count() == static_cast<std::size_t>(std::distance(chain.begin(), chain.end())));
+		REQUIRE(compressed.compressed_bytes() == compressed.edge_count() + 2 * 1001 * sizeof(std::uint64_t));
+		REQUIRE(compressed.decompress() == chain);
+	}
+
+	SECTION("The file round-trips") {
+		auto const file = scratch_path{};
+		c.save(file.path);
+		REQUIRE(compressed_type::load(file.path) == c);
+		REQUIRE(compressed_type::load(file.path).decompress() == g);
+	}
+
+	SECTION("Missing and corrupt files are reported") {
+		auto const file = scratch_path{};
+		REQUIRE_THROWS_AS(compressed_type::load(file.path), std::system_error);
+		c.save(file.path);
+		auto data = std::string{};
+		{
+			auto in = std::ifstream{file.path, std::ios::binary};
+			data.assign(std::istreambuf_iterator<char>{in}, {});
+		}
+		data[data.size() / 2] = static_cast<char>(data[data.size() / 2] ^ 0x55);
+		std::ofstream{file.path, std::ios::binary | std::ios::trunc} << data;
+		REQUIRE_THROWS_AS(compressed_type::load(file.path), std::runtime_error);
+	}
+}
@@ -0,0 +1,190 @@
+#include "gdwg_external.h"
+
+#include <cerrno>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+	[[noreturn]] auto throw_errno(char const* what) -> void {
+		throw std::system_error(errno, std::generic_category(), what);
+	}
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  BLOCK FILE FUNCTIONS                                                              //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+gdwg::block_file::block_file(std::filesystem::path const& path)
+: fd_{::open(path.c_str(), O_RDONLY | O_CLOEXEC)}
+, size_{0} {
+	if (fd_ < 0)
+		throw_errno("Cannot construct gdwg::block_file");
+	struct ::stat status {};
+	if (::fstat(fd_, &status) != 0) {
+		auto const error = errno;
+		::close(fd_);
+		throw std::system_error(error, std::generic_category(), "Cannot construct gdwg::block_file");
+	}
+	size_ = static_cast<std::uint64_t>(status.st_size);
+}
+
+gdwg::block_file::block_file(block_file&& other) noexcept
+: fd_{std::exchange(other.fd_, -1)}
+, size_{std::exchange(other.size_, 0)} {}
+
+auto gdwg::block_file::operator=(block_file&& other) noexcept -> block_file& {
+	if (this != &other) {
+		if (fd_ >= 0)
+			::close(fd_);
+		fd_ = std::exchange(other.fd_, -1);
+		size_ = std::exchange(other.size_, 0);
+	}
+	return *this;
+}
+
+gdwg::block_file::~block_file() {
+	if (fd_ >= 0)
+		::close(fd_);
+}
+
+auto gdwg::block_file::read(std::uint64_t offset, std::size_t size) const -> std::string {
+	auto data = std::string(size, '\0');
+	auto done = std::size_t{0};
+	while (done < size) {
+		auto const count = ::pread(fd_, data.data() + done, size - done, static_cast<::off_t>(offset + done));
+		if (count < 0) {
+			if (errno == EINTR)
+				continue;
+			throw_errno("Cannot call gdwg::block_file::read");
+		}
+		if (count == 0)
+			throw std::runtime_error("Cannot call gdwg::block_file::read past the end of the file");
+		done += static_cast<std::size_t>(count);
+	}
+	return data;
+}
+
+auto gdwg::block_file::read_block(std::uint64_t offset) const -> std::string {
+	if (offset > size_ or size_ - offset < wal_frame::header_size)
+		throw std::runtime_error("Cannot call gdwg::block_file::read_block on a truncated block");
+	auto frame = read(offset, wal_frame::header_size);
+	auto header = std::string_view{frame};
+	auto const size = serializer<std::uint32_t>::read(header);
+	if (size > size_ - offset - wal_frame::header_size)
+		throw std::runtime_error("Cannot call gdwg::block_file::read_block on a truncated block");
+	frame += read(offset + wal_frame::header_size, size);
+	auto in = std::string_view{frame};
+	if (not wal_frame::next(in))
+		throw std::runtime_error("Cannot call gdwg::block_file::read_block on a corrupt block");
+	return frame.substr(wal_frame::header_size);
+}
+
+auto gdwg::block_file::size() const noexcept -> std::uint64_t {
+	return size_;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  BLOCK WRITER FUNCTIONS                                                            //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+gdwg::block_writer::block_writer(std::filesystem::path const& path, std::size_t block_bytes)
+: file_{path, true}
+, block_bytes_{block_bytes}
+, offset_{0} {}
+
+auto gdwg::block_writer::starts_block() const noexcept -> bool {
+	return not frame_.has_value();
+}
+
+auto gdwg::block_writer::offset() const noexcept -> std::uint64_t {
+	return offset_;
+}
+
+auto gdwg::block_writer::payload() -> std::string& {
+	if (not frame_)
+		frame_ = wal_frame::open(buffer_);
+	return buffer_;
+}
+
+auto gdwg::block_writer::end_record() -> void {
+	if (buffer_.size() - wal_frame::header_size < block_bytes_)
+		return;
+	wal_frame::seal(buffer_, *frame_);
+	file_.append(buffer_);
+	offset_ += buffer_.size();
+	buffer_.clear();
+	frame_.reset();
+}
+
+auto gdwg::block_writer::finish(bool sync) -> void {
+	if (frame_) {
+		wal_frame::seal(buffer_, *frame_);
+		file_.append(buffer_);
+		offset_ += buffer_.size();
+		buffer_.clear();
+		frame_.reset();
+	}
+	if (sync)
+		file_.sync();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  BUFFER POOL FUNCTIONS                                                             //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+gdwg::buffer_pool::buffer_pool(std::size_t capacity)
+: capacity_{std::max(capacity, std::size_t{1})} {
+	frames_.reserve(capacity_);
+}
+
+auto gdwg::buffer_pool::fetch(std::size_t file, std::uint64_t offset, block_file const& source)
+    -> std::shared_ptr<std::string const> {
+	auto const key = block_key{file, offset};
+	{
+		auto const lock = std::lock_guard{mutex_};
+		if (auto const it = index_.find(key); it != index_.end()) {
+			auto& cached = frames_[it->second];
+			cached.referenced = true;
+			++stats_.hits;
+			return cached.block;
+		}
+		++stats_.misses;
+	}
+	auto block = std::make_shared<std::string const>(source.read_block(offset));
+	auto const lock = std::lock_guard{mutex_};
+	// Another thread may have read the same block in the meantime
+	if (auto const it = index_.find(key); it != index_.end())
+		return frames_[it->second].block;
+	if (frames_.size() < capacity_) {
+		index_.emplace(key, frames_.size());
+		frames_.push_back(frame{key, block, true});
+		return block;
+	}
+	// Two sweeps clear every reference bit, so a frame which is not pinned is found if there is one
+	for (auto step = std::size_t{0}; step < 2 * frames_.size(); ++step) {
+		auto const victim = hand_;
+		hand_ = (hand_ + 1) % frames_.size();
+		auto& candidate = frames_[victim];
+		if (candidate.block.use_count() > 1)
+			continue;
+		if (candidate.referenced) {
+			candidate.referenced = false;
+			continue;
+		}
+		index_.erase(candidate.key);
+		index_.emplace(key, victim);
+		candidate = frame{key, block, true};
+		++stats_.evictions;
+		return block;
+	}
+	return block;
+}
+
+auto gdwg::buffer_pool::statistics() const -> stats {
+	auto const lock = std::lock_guard{mutex_};
+	return stats_;
+}
+
+auto gdwg::buffer_pool::capacity() const noexcept -> std::size_t {
+	return capacity_;
+}
@@ -0,0 +1,974 @@
+#ifndef GDWG_EXTERNAL_H
+#	define GDWG_EXTERNAL_H
+
+#	include "gdwg_graph.h"
+#	include "gdwg_wal.h"
+
+#	include <algorithm>
+#	include <cstddef>
+#	include <cstdint>
+#	include <filesystem>
+#	include <functional>
+#	include <map>
+#	include <memory>
+#	include <mutex>
+#	include <optional>
+#	include <queue>
+#	include <span>
+#	include <stdexcept>
+#	include <string>
+#	include <string_view>
+#	include <tuple>
+#	include <type_traits>
+#	include <utility>
+#	include <vector>
+
+namespace gdwg {
+	/**
+	 * How much memory an external graph may use, and how its files are cut into blocks.
+	 */
+	struct external_options {
+		// Bytes for the sort buffer while bulk loading, and for the buffer pool while querying. The sparse index,
+		// one key per block, comes on top.
+		std::size_t memory_budget = std::size_t{64} << 20U;
+		// The size a block is filled to before the next one starts: the unit of reading, caching and indexing.
+		std::size_t block_bytes = std::size_t{64} << 10U;
+	};
+
+	/**
+	 * A file read with positional reads, so that several threads can read different parts of it at once. Its
+	 * contents are the blocks of an external graph: frames, as in a write-ahead log, of whole records. Every failure
+	 * is reported as a std::system_error.
+	 */
+	class block_file {
+	 public:
+		/**
+		 * Opens a file for reading.
+		 *
+		 * @param path The file to open.
+		 */
+		explicit block_file(std::filesystem::path const& path);
+
+		block_file(block_file const&) = delete;
+		auto operator=(block_file const&) -> block_file& = delete;
+
+		/**
+		 * Move constructor. The moved-from file no longer owns a descriptor.
+		 */
+		block_file(block_file&& other) noexcept;
+
+		/**
+		 * Move assignment. Closes the current descriptor and takes over the one of other.
+		 */
+		auto operator=(block_file&& other) noexcept -> block_file&;
+
+		/**
+		 * Closes the file.
+		 */
+		~block_file();
+
+		/**
+		 * @brief Reads bytes at a position, retrying short reads.
+		 * @note Marked as [[nodiscard]] because the bytes are lost if ignored.
+		 *
+		 * @param offset The position of the first byte.
+		 * @param size The number of bytes.
+		 * @return The bytes.
+		 * @throws std::runtime_error If the file ends first.
+		 */
+		[[nodiscard]] auto read(std::uint64_t offset, std::size_t size) const -> std::string;
+
+		/**
+		 * @brief Reads the block at a position.
+		 * @note Marked as [[nodiscard]] because the block is lost if ignored.
+		 *
+		 * @param offset The position of the frame of the block.
+		 * @return The payload of the block. The next block starts wal_frame::header_size bytes after its end.
+		 * @throws std::runtime_error If the frame is truncated or fails its CRC.
+		 */
+		[[nodiscard]] auto read_block(std::uint64_t offset) const -> std::string;
+
+		/**
+		 * @brief Returns the size of the file when it was opened.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Marked as noexcept because the size is stored.
+		 *
+		 * @return The size in bytes.
+		 */
+		[[nodiscard]] auto size() const noexcept -> std::uint64_t;
+
+	 private:
+		int fd_;
+		std::uint64_t size_;
+	};
+
+	/**
+	 * Writes records into the blocks of a file. A block is closed once it holds block_bytes of records, so a record
+	 * never spans two blocks.
+	 */
+	class block_writer {
+	 public:
+		/**
+		 * Creates or truncates a file to write blocks to.
+		 *
+		 * @param path The file to write.
+		 * @param block_bytes The size a block is filled to.
+		 */
+		block_writer(std::filesystem::path const& path, std::size_t block_bytes);
+
+		/**
+		 * @brief Checks if the next record starts a new block, so that a caller can index its key.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Marked as noexcept because it only checks the buffer.
+		 *
+		 * @return True if the next record is the first of its block, otherwise false.
+		 */
+		[[nodiscard]] auto starts_block() const noexcept -> bool;
+
+		/**
+		 * @brief Returns the position in the file of the block the next record goes to.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Marked as noexcept because the position is stored.
+		 *
+		 * @return The position.
+		 */
+		[[nodiscard]] auto offset() const noexcept -> std::uint64_t;
+
+		/**
+		 * @brief Returns the buffer of the current block, to append one record to. The record is complete once
+		 * end_record is called.
+		 * @note Marked as [[nodiscard]] because the buffer must be appended to.
+		 *
+		 * @return The buffer.
+		 */
+		[[nodiscard]] auto payload() -> std::string&;
+
+		/**
+		 * @brief Completes a record, writing out the block if it is full.
+		 */
+		auto end_record() -> void;
+
+		/**
+		 * @brief Writes out the last block.
+		 *
+		 * @param sync True to wait until the file is on stable storage.
+		 */
+		auto finish(bool sync) -> void;
+
+	 private:
+		durable_file file_;
+		std::size_t block_bytes_;
+		std::uint64_t offset_;
+		std::string buffer_;
+		std::optional<std::size_t> frame_;
+	};
+
+	/**
+	 * A fixed number of cached blocks, shared by every thread querying an external graph, replaced in CLOCK order:
+	 * a hand sweeps the frames, giving each recently used one a second chance before evicting it. A block stays
+	 * pinned while a caller holds it, and is not evicted until released.
+	 */
+	class buffer_pool {
+	 public:
+		/**
+		 * How often blocks were found in the pool.
+		 */
+		struct stats {
+			std::uint64_t hits = 0;
+			std::uint64_t misses = 0;
+			std::uint64_t evictions = 0;
+		};
+
+		/**
+		 * Creates an empty pool.
+		 *
+		 * @param capacity The number of blocks cached at most, at least one.
+		 */
+		explicit buffer_pool(std::size_t capacity);
+
+		/**
+		 * @brief Returns a block, reading it on a miss. The read is done without holding the pool, so that misses on
+		 * different blocks proceed in parallel. If every frame is pinned the block is returned without being cached.
+		 * @note Marked as [[nodiscard]] because the block is lost if ignored.
+		 *
+		 * @param file The number of the file, distinguishing the files sharing the pool.
+		 * @param offset The position of the block in the file.
+		 * @param source The file to read a missing block from.
+		 * @return The payload of the block, pinned while held.
+		 */
+		[[nodiscard]] auto fetch(std::size_t file, std::uint64_t offset, block_file const& source)
+		    -> std::shared_ptr<std::string const>;
+
+		/**
+		 * @brief Returns the number of hits, misses and evictions so far.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 *
+		 * @return The statistics.
+		 */
+		[[nodiscard]] auto statistics() const -> stats;
+
+		/**
+		 * @brief Returns the number of blocks cached at most.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Marked as noexcept because the capacity is stored.
+		 *
+		 * @return The capacity.
+		 */
+		[[nodiscard]] auto capacity() const noexcept -> std::size_t;
+
+	 private:
+		using block_key = std::pair<std::size_t, std::uint64_t>;
+
+		struct frame {
+			block_key key;
+			std::shared_ptr<std::string const> block;
+			bool referenced;
+		};
+
+		std::size_t capacity_;
+		mutable std::mutex mutex_;
+		std::vector<frame> frames_;
+		std::map<block_key, std::size_t> index_;
+		std::size_t hand_ = 0;
+		stats stats_;
+	};
+
+	template<serializable N, serializable E>
+	class external_builder;
+
+	/**
+	 * A read-only graph kept on disk for graphs larger than memory. Its nodes and edges are stored in graph order
+	 * in the blocks of two files, with the first key of every block in a sparse index in memory. Queries find the
+	 * block to start from in the index and page blocks in through a bounded buffer pool; full scans read blocks in
+	 * order without going through the pool, so they do not flush it. External graphs are created by an
+	 * external_builder and reopened from their directory.
+	 */
+	template<serializable N, serializable E>
+	class external_graph {
+	 public:
+		/**
+		 * @brief Opens the external graph in a directory, reading only its index.
+		 * @note Not marked as noexcept because reading the index may fail.
+		 *
+		 * Time complexity: O(b) where b is the number of blocks.
+		 *
+		 * @param dir The directory the graph was built in.
+		 * @param options The memory budget for the buffer pool. The block size is the one the graph was built with.
+		 * @throws std::system_error If the files could not be opened.
+		 * @throws std::runtime_error If the index is missing or corrupt.
+		 */
+		explicit external_graph(std::filesystem::path dir, external_options const& options = {});
+
+		/**
+		 * @brief Writes a graph to a directory as an external graph.
+		 * @note Marked as [[nodiscard]] because the external graph is lost if ignored.
+		 *
+		 * @param g The graph to write.
+		 * @param dir The directory to write to, which must exist.
+		 * @param options The memory budget and block size.
+		 * @return The external graph.
+		 */
+		[[nodiscard]] static auto
+		build(graph<N, E> const& g, std::filesystem::path const& dir, external_options const& options = {})
+		    -> external_graph;
+
+		/**
+		 * @brief Checks if a node is in the graph, paging in at most one block.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 *
+		 * Time complexity: O(log b + B) where B is the number of records in a block.
+		 *
+		 * @param value The node to check.
+		 * @return True if the node is in the graph, otherwise false.
+		 */
+		[[nodiscard]] auto is_node(N const& value) const -> bool;
+
+		/**
+		 * @brief Checks if there is an edge from src to dst.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Not marked as noexcept because it throws an exception if src or dst does not exist.
+		 *
+		 * Time complexity: O(log b + B), paging in the block holding the edges from src to dst and rarely the next.
+		 *
+		 * @param src The source node.
+		 * @param dst The destination node.
+		 * @return True if the nodes are connected, otherwise false.
+		 */
+		[[nodiscard]] auto is_connected(N const& src, N const& dst) const -> bool;
+
+		/**
+		 * @brief Returns the nodes connected from src.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Not marked as noexcept because it throws an exception if src does not exist.
+		 *
+		 * Time complexity: O(log b + B + d) where d is the out-degree of src.
+		 *
+		 * @param src The source node.
+		 * @return The destinations of the edges from src in ascending order, without duplicates.
+		 */
+		[[nodiscard]] auto connections(N const& src) const -> std::vector<N>;
+
+		/**
+		 * @brief Calls fn with every node in ascending order, reading one block at a time.
+		 *
+		 * @param fn Called with each node.
+		 */
+		template<std::invocable<N const&> F>
+		auto for_each_node(F fn) const -> void;
+
+		/**
+		 * @brief Calls fn with the source, destination and weight of every edge in graph order, reading one block at
+		 * a time.
+		 *
+		 * @param fn Called with each edge.
+		 */
+		template<std::invocable<N const&, N const&, std::optional<E> const&> F>
+		auto for_each_edge(F fn) const -> void;
+
+		/**
+		 * @brief Returns the number of nodes.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Marked as noexcept because the count is stored in the index.
+		 *
+		 * @return The number of nodes.
+		 */
+		[[nodiscard]] auto node_count() const noexcept -> std::size_t;
+
+		/**
+		 * @brief Returns the number of edges.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Marked as noexcept because the count is stored in the index.
+		 *
+		 * @return The number of edges.
+		 */
+		[[nodiscard]] auto edge_count() const noexcept -> std::size_t;
+
+		/**
+		 * @brief Returns how well the buffer pool is serving queries.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 *
+		 * @return The statistics of the buffer pool.
+		 */
+		[[nodiscard]] auto pool_stats() const -> buffer_pool::stats;
+
+	 private:
+		friend class external_builder<N, E>;
+
+		struct edge_record {
+			N src;
+			N dst;
+			std::optional<E> weight;
+
+			/**
+			 * @brief Orders edges by source, then destination, then weight, as the graph stores them.
+			 *
+			 * @param other The edge to compare with.
+			 * @return True if this edge sorts before other, otherwise false.
+			 */
+			[[nodiscard]] auto operator<(edge_record const& other) const -> bool;
+
+			/**
+			 * @brief Compares two edges for equality.
+			 *
+			 * @return True if the nodes and weights are equal, otherwise false.
+			 */
+			[[nodiscard]] auto operator==(edge_record const&) const -> bool = default;
+		};
+
+		static constexpr std::string_view index_magic = "GDWGEXTI";
+		static constexpr std::size_t nodes_file = 0;
+		static constexpr std::size_t edges_file = 1;
+
+		block_file nodes_;
+		block_file edges_;
+		std::uint64_t node_count_ = 0;
+		std::uint64_t edge_count_ = 0;
+		// The first key and the position of every block
+		std::vector<N> node_keys_;
+		std::vector<std::uint64_t> node_blocks_;
+		std::vector<std::pair<N, N>> edge_keys_;
+		std::vector<std::uint64_t> edge_blocks_;
+		std::unique_ptr<buffer_pool> pool_;
+
+		/**
+		 * @brief Returns the paths of the files of an external graph.
+		 *
+		 * @param dir The directory of the graph.
+		 * @param name "nodes", "edges" or "index".
+		 * @return The path.
+		 */
+		[[nodiscard]] static auto path_of(std::filesystem::path const& dir, std::string_view name)
+		    -> std::filesystem::path;
+
+		/**
+		 * @brief Appends a record to a block.
+		 *
+		 * @param out The block.
+		 * @param value The record.
+		 */
+		static auto write_record(std::string& out, N const& value) -> void;
+		static auto write_record(std::string& out, edge_record const& value) -> void;
+
+		/**
+		 * @brief Decodes every record of a block.
+		 *
+		 * @param block The payload of the block.
+		 * @return The records.
+		 * @throws std::runtime_error If the block is malformed.
+		 */
+		template<typename T>
+		[[nodiscard]] static auto read_records(std::string_view block) -> std::vector<T>;
+
+		/**
+		 * @brief Visits the edges through the buffer pool, starting with a block, until visit returns false.
+		 *
+		 * @param block The position of the first block in the index.
+		 * @param visit Called with each edge.
+		 */
+		template<typename F>
+		auto scan_edges(std::size_t block, F visit) const -> void;
+
+		/**
+		 * @brief Visits every record of a file in order, reading blocks directly.
+		 *
+		 * @param file The file.
+		 * @param visit Called with each record.
+		 */
+		template<typename T, typename F>
+		static auto scan_file(block_file const& file, F visit) -> void;
+
+		/**
+		 * @brief Constructs an external graph over files whose index is given.
+		 */
+		external_graph(std::filesystem::path const& dir, external_options const& options, std::string_view index);
+	};
+
+	/**
+	 * Bulk loads an external graph with an external merge sort. Nodes and edges are collected in memory up to the
+	 * memory budget, then sorted, deduplicated and spilled to a run file. finish merges the runs, several at a time
+	 * if there are more than fit in the budget at once, into the blocks of the graph and writes its index.
+	 */
+	template<serializable N, serializable E>
+	class external_builder {
+	 public:
+		/**
+		 * Creates a builder writing to a directory.
+		 *
+		 * @param dir The directory to build the graph in, which must exist.
+		 * @param options The memory budget and block size.
+		 */
+		explicit external_builder(std::filesystem::path dir, external_options const& options = {});
+
+		external_builder(external_builder const&) = delete;
+		auto operator=(external_builder const&) -> external_builder& = delete;
+
+		/**
+		 * Removes the runs left over if the builder was never finished.
+		 */
+		~external_builder();
+
+		/**
+		 * @brief Adds a node. Adding a node twice has no effect.
+		 *
+		 * @param value The node.
+		 */
+		auto add_node(N const& value) -> void;
+
+		/**
+		 * @brief Adds an edge and both of its nodes. Adding an edge twice has no effect.
+		 *
+		 * @param src The source node.
+		 * @param dst The destination node.
+		 * @param weight The weight, or std::nullopt for an unweighted edge.
+		 */
+		auto add_edge(N const& src, N const& dst, std::optional<E> const& weight = std::nullopt) -> void;
+
+		/**
+		 * @brief Merges everything added into the external graph and leaves the builder empty.
+		 * @note Marked as [[nodiscard]] because the external graph is lost if ignored.
+		 *
+		 * Time complexity: O(m log m) for m additions, in O(log_k r) passes over r runs with fan-in k.
+		 *
+		 * @return The external graph.
+		 * @throws std::system_error If a file could not be written.
+		 */
+		[[nodiscard]] auto finish() -> external_graph<N, E>;
+
+		/**
+		 * @brief Returns the number of runs spilled to disk so far.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Marked as noexcept because the runs are counted.
+		 *
+		 * @return The number of runs.
+		 */
+		[[nodiscard]] auto runs() const noexcept -> std::size_t;
+
+	 private:
+		using edge_record = typename external_graph<N, E>::edge_record;
+
+		std::filesystem::path dir_;
+		external_options options_;
+		std::vector<N> nodes_;
+		std::vector<edge_record> edges_;
+		std::size_t buffered_bytes_ = 0;
+		std::vector<std::filesystem::path> node_runs_;
+		std::vector<std::filesystem::path> edge_runs_;
+		std::size_t runs_created_ = 0;
+		std::string scratch_;
+
+		/**
+		 * @brief Counts a record against the memory budget, spilling everything buffered once it is exceeded.
+		 *
+		 * @param value The record just buffered.
+		 */
+		template<typename T>
+		auto account(T const& value) -> void;
+
+		/**
+		 * @brief Sorts, deduplicates and writes out the buffered records as new runs.
+		 */
+		auto spill() -> void;
+
+		/**
+		 * @brief Sorts and deduplicates records and writes them to a new run.
+		 *
+		 * @param records The records.
+		 * @param runs The runs to add the new run to.
+		 */
+		template<typename T>
+		auto write_run(std::vector<T>& records, std::vector<std::filesystem::path>& runs) -> void;
+
+		/**
+		 * @brief Merges runs until at most the fan-in are left, then streams their merged, deduplicated records.
+		 *
+		 * @param runs The runs, which are removed.
+		 * @param visit Called with every distinct record in order.
+		 */
+		template<typename T, typename F>
+		auto merge(std::vector<std::filesystem::path>& runs, F visit) -> void;
+
+		/**
+		 * @brief Returns the number of runs merged at once, so that one block of each fits in the budget.
+		 *
+		 * @return The fan-in, at least two.
+		 */
+		[[nodiscard]] auto fan_in() const noexcept -> std::size_t;
+	};
+} // namespace gdwg
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  EXTERNAL GRAPH FUNCTIONS                                                          //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<gdwg::serializable N, gdwg::serializable E>
+gdwg::external_graph<N, E>::external_graph(std::filesystem::path dir, external_options const& options)
+: external_graph{dir, options, [&dir] {
+	                 auto index = durable_file::read(path_of(dir, "index"));
+	                 if (not index)
+		                 throw std::runtime_error("Cannot call gdwg::external_graph<N, E>::external_graph without an index");
+	                 return std::move(*index);
+                 }()} {}
+
+template<gdwg::serializable N, gdwg::serializable E>
+gdwg::external_graph<N, E>::external_graph(std::filesystem::path const& dir,
+                                           external_options const& options,
+                                           std::string_view index)
+: nodes_{path_of(dir, "nodes")}
+, edges_{path_of(dir, "edges")}
+, pool_{std::make_unique<buffer_pool>(std::max(options.memory_budget / std::max(options.block_bytes, std::size_t{1}),
+                                               std::size_t{2}))} {
+	auto const corrupt = [] {
+		return std::runtime_error("Cannot call gdwg::external_graph<N, E>::external_graph on a corrupt index");
+	};
+	if (index.size() < index_magic.size() + sizeof(std::uint32_t) or not index.starts_with(index_magic))
+		throw corrupt();
+	auto const body = index.substr(0, index.size() - sizeof(std::uint32_t));
+	auto trailer = index.substr(body.size());
+	if (serializer<std::uint32_t>::read(trailer) != crc32(body))
+		throw corrupt();
+	auto in = body.substr(index_magic.size());
+	node_count_ = serializer<std::uint64_t>::read(in);
+	edge_count_ = serializer<std::uint64_t>::read(in);
+	auto const node_blocks = serializer<std::uint64_t>::read(in);
+	if (node_blocks > in.size())
+		throw corrupt();
+	for (auto i = std::uint64_t{0}; i < node_blocks; ++i) {
+		node_keys_.push_back(serializer<N>::read(in));
+		node_blocks_.push_back(serializer<std::uint64_t>::read(in));
+	}
+	auto const edge_blocks = serializer<std::uint64_t>::read(in);
+	if (edge_blocks > in.size())
+		throw corrupt();
+	for (auto i = std::uint64_t{0}; i < edge_blocks; ++i) {
+		auto src = serializer<N>::read(in);
+		auto dst = serializer<N>::read(in);
+		edge_keys_.emplace_back(std::move(src), std::move(dst));
+		edge_blocks_.push_back(serializer<std::uint64_t>::read(in));
+	}
+}
+
+template<gdwg::serializable N, gdwg::serializable E>
+auto gdwg::external_graph<N, E>::build(graph<N, E> const& g,
+                                       std::filesystem::path const& dir,
+                                       external_options const& options) -> external_graph {
+	auto builder = external_builder<N, E>{dir, options};
+	g.for_each_node([&builder](N const& value) { builder.add_node(value); });
+	g.for_each_edge([&builder](N const& src, N const& dst, std::optional<E> const& weight) {
+		builder.add_edge(src, dst, weight);
+	});
+	return builder.finish();
+}
+
+template<gdwg::serializable N, gdwg::serializable E>
+auto gdwg::external_graph<N, E>::is_node(N const& value) const -> bool {
+	// The last block starting at or before the node is the only one which may hold it
+	auto const next = std::upper_bound(node_keys_.begin(), node_keys_.end(), value);
+	if (next == node_keys_.begin())
+		return false;
+	auto const block = pool_->fetch(nodes_file, node_blocks_[static_cast<std::size_t>(next - node_keys_.begin() - 1)], nodes_);
+	auto const records = read_records<N>(*block);
+	return std::binary_search(records.begin(), records.end(), value);
+}
+
+template<gdwg::serializable N, gdwg::serializable E>
+auto gdwg::external_graph<N, E>::is_connected(N const& src, N const& dst) const -> bool {
+	if (not is_node(src) or not is_node(dst)) {
+		throw std::runtime_error("Cannot call gdwg::external_graph<N, E>::is_connected if src or dst node don't exist "
+		                         "in the graph");
+	}
+	// Edges from src to dst may begin in the last block starting before them
+	auto const key = std::pair<N const&, N const&>{src, dst};
+	auto const first = std::lower_bound(edge_keys_.begin(), edge_keys_.end(), key, [](auto const& lhs, auto const& rhs) {
+		return std::tie(lhs.first, lhs.second) < std::tie(rhs.first, rhs.second);
+	});
+	auto found = false;
+	scan_edges(static_cast<std::size_t>(std::max(first - edge_keys_.begin() - 1, std::ptrdiff_t{0})),
+	           [&](edge_record const& edge) {
+		           if (std::tie(edge.src, edge.dst) < std::tie(src, dst))
+			           return true;
+		           found = not(src < edge.src) and not(dst < edge.dst);
+		           return false;
+	           });
+	return found;
+}
+
+template<gdwg::serializable N, gdwg::serializable E>
+auto gdwg::external_graph<N, E>::connections(N const& src) const -> std::vector<N> {
+	if (not is_node(src))
+		throw std::runtime_error("Cannot call gdwg::external_graph<N, E>::connections if src doesn't exist in the graph");
+	auto const first = std::lower_bound(edge_keys_.begin(), edge_keys_.end(), src, [](auto const& key, N const& value) {
+		return key.first < value;
+	});
+	auto result = std::vector<N>{};
+	scan_edges(static_cast<std::size_t>(std::max(first - edge_keys_.begin() - 1, std::ptrdiff_t{0})),
+	           [&](edge_record const& edge) {
+		           if (edge.src < src)
+			           return true;
+		           if (src < edge.src)
+			           return false;
+		           if (result.empty() or result.back() < edge.dst)
+			           result.push_back(edge.dst);
+		           return true;
+	           });
+	return result;
+}
+
+template<gdwg::serializable N, gdwg::serializable E>
+template<std::invocable<N const&> F>
+auto gdwg::external_graph<N, E>::for_each_node(F fn) const -> void {
+	scan_file<N>(nodes_, [&fn](N const& value) { std::invoke(fn, value); });
+}
+
+template<gdwg::serializable N, gdwg::serializable E>
+template<std::invocable<N const&, N const&, std::optional<E> const&> F>
+auto gdwg::external_graph<N, E>::for_each_edge(F fn) const -> void {
+	scan_file<edge_record>(edges_, [&fn](edge_record const& edge) { std::invoke(fn, edge.src, edge.dst, edge.weight); });
+}
+
+template<gdwg::serializable N, gdwg::serializable E>
+auto gdwg::external_graph<N, E>::node_count() const noexcept -> std::size_t {
+	return static_cast<std::size_t>(node_count_);
+}
+
+template<gdwg::serializable N, gdwg::serializable E>
+auto gdwg::external_graph<N, E>::edge_count() const noexcept -> std::size_t {
+	return static_cast<std::size_t>(edge_count_);
+}
+
+template<gdwg::serializable N, gdwg::serializable E>
+auto gdwg::external_graph<N, E>::pool_stats() const -> buffer_pool::stats {
+	return pool_->statistics();
+}
+
+template<gdwg::serializable N, gdwg::serializable E>
+auto gdwg::external_graph<N, E>::edge_record::operator<(edge_record const& other) const -> bool {
+	return std::tie(src, dst, weight) < std::tie(other.src, other.dst, other.weight);
+}
+
+template<gdwg::serializable N, gdwg::serializable E>
+auto gdwg::external_graph<N, E>::path_of(std::filesystem::path const& dir, std::string_view name)
+    -> std::filesystem::path {
+	return dir / name;
+}
+
+template<gdwg::serializable N, gdwg::serializable E>
+auto gdwg::external_graph<N, E>::write_record(std::string& out, N const& value) -> void {
+	serializer<N>::write(out, value);
+}
+
+template<gdwg::serializable N, gdwg::serializable E>
+auto gdwg::external_graph<N, E>::write_record(std::string& out, edge_record const& value) -> void {
+	serializer<N>::write(out, value.src);
+	serializer<N>::write(out, value.dst);
+	serializer<bool>::write(out, value.weight.has_value());
+	if (value.weight)
+		serializer<E>::write(out, *value.weight);
+}
+
+template<gdwg::serializable N, gdwg::serializable E>
+template<typename T>
+auto gdwg::external_graph<N, E>::read_records(std::string_view block) -> std::vector<T> {
+	auto records = std::vector<T>{};
+	while (not block.empty()) {
+		if constexpr (std::is_same_v<T, edge_record>) {
+			auto src = serializer<N>::read(block);
+			auto dst = serializer<N>::read(block);
+			auto weight = std::optional<E>{};
+			if (serializer<bool>::read(block))
+				weight = serializer<E>::read(block);
+			records.push_back(edge_record{std::move(src), std::move(dst), std::move(weight)});
+		}
+		else {
+			records.push_back(serializer<N>::read(block));
+		}
+	}
+	return records;
+}
+
+template<gdwg::serializable N, gdwg::serializable E>
+template<typename F>
+auto gdwg::external_graph<N, E>::scan_edges(std::size_t block, F visit) const -> void {
+	for (; block < edge_blocks_.size(); ++block) {
+		auto const data = pool_->fetch(edges_file, edge_blocks_[block], edges_);
+		for (auto const& edge : read_records<edge_record>(*data)) {
+			if (not visit(edge))
+				return;
+		}
+	}
+}
+
+template<gdwg::serializable N, gdwg::serializable E>
+template<typename T, typename F>
+auto gdwg::external_graph<N, E>::scan_file(block_file const& file, F visit) -> void {
+	for (auto offset = std::uint64_t{0}; offset < file.size();) {
+		auto const block = file.read_block(offset);
+		offset += wal_frame::header_size + block.size();
+		for (auto const& record : read_records<T>(block)) {
+			visit(record);
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  EXTERNAL BUILDER FUNCTIONS                                                        //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<gdwg::serializable N, gdwg::serializable E>
+gdwg::external_builder<N, E>::external_builder(std::filesystem::path dir, external_options const& options)
+: dir_{std::move(dir)}
+, options_{options} {}
+
+template<gdwg::serializable N, gdwg::serializable E>
+gdwg::external_builder<N, E>::~external_builder() {
+	auto ec = std::error_code{};
+	for (auto const& run : node_runs_) {
+		std::filesystem::remove(run, ec);
+	}
+	for (auto const& run : edge_runs_) {
+		std::filesystem::remove(run, ec);
+	}
+}
+
+template<gdwg::serializable N, gdwg::serializable E>
+auto gdwg::external_builder<N, E>::add_node(N const& value) -> void {
+	nodes_.push_back(value);
+	account(nodes_.back());
+}
+
+template<gdwg::serializable N, gdwg::serializable E>
+auto gdwg::external_builder<N, E>::add_edge(N const& src, N const& dst, std::optional<E> const& weight) -> void {
+	add_node(src);
+	add_node(dst);
+	edges_.push_back(edge_record{src, dst, weight});
+	account(edges_.back());
+}
+
+template<gdwg::serializable N, gdwg::serializable E>
+auto gdwg::external_builder<N, E>::finish() -> external_graph<N, E> {
+	spill();
+	auto nodes = block_writer{external_graph<N, E>::path_of(dir_, "nodes"), options_.block_bytes};
+	auto edges = block_writer{external_graph<N, E>::path_of(dir_, "edges"), options_.block_bytes};
+	auto index = std::string{external_graph<N, E>::index_magic};
+	auto node_count = std::uint64_t{0};
+	auto edge_count = std::uint64_t{0};
+	// The block index is collected separately, as its length goes in front of it
+	auto node_index = std::string{};
+	auto node_blocks = std::uint64_t{0};
+	merge<N>(node_runs_, [&](N const& value) {
+		if (nodes.starts_block()) {
+			serializer<N>::write(node_index, value);
+			serializer<std::uint64_t>::write(node_index, nodes.offset());
+			++node_blocks;
+		}
+		external_graph<N, E>::write_record(nodes.payload(), value);
+		nodes.end_record();
+		++node_count;
+	});
+	auto edge_index = std::string{};
+	auto edge_blocks = std::uint64_t{0};
+	merge<edge_record>(edge_runs_, [&](edge_record const& edge) {
+		if (edges.starts_block()) {
+			serializer<N>::write(edge_index, edge.src);
+			serializer<N>::write(edge_index, edge.dst);
+			serializer<std::uint64_t>::write(edge_index, edges.offset());
+			++edge_blocks;
+		}
+		external_graph<N, E>::write_record(edges.payload(), edge);
+		edges.end_record();
+		++edge_count;
+	});
+	nodes.finish(true);
+	edges.finish(true);
+	serializer<std::uint64_t>::write(index, node_count);
+	serializer<std::uint64_t>::write(index, edge_count);
+	serializer<std::uint64_t>::write(index, node_blocks);
+	index += node_index;
+	serializer<std::uint64_t>::write(index, edge_blocks);
+	index += edge_index;
+	serializer<std::uint32_t>::write(index, crc32(index));
+	durable_file::replace(external_graph<N, E>::path_of(dir_, "index"), index, true);
+	return external_graph<N, E>{dir_, options_, index};
+}
+
+template<gdwg::serializable N, gdwg::serializable E>
+auto gdwg::external_builder<N, E>::runs() const noexcept -> std::size_t {
+	return runs_created_;
+}
+
+template<gdwg::serializable N, gdwg::serializable E>
+template<typename T>
+auto gdwg::external_builder<N, E>::account(T const& value) -> void {
+	scratch_.clear();
+	external_graph<N, E>::write_record(scratch_, value);
+	buffered_bytes_ += sizeof(T) + scratch_.size();
+	if (buffered_bytes_ >= options_.memory_budget)
+		spill();
+}
+
+template<gdwg::serializable N, gdwg::serializable E>
+auto gdwg::external_builder<N, E>::spill() -> void {
+	write_run(nodes_, node_runs_);
+	write_run(edges_, edge_runs_);
+	buffered_bytes_ = 0;
+}
+
+template<gdwg::serializable N, gdwg::serializable E>
+template<typename T>
+auto gdwg::external_builder<N, E>::write_run(std::vector<T>& records, std::vector<std::filesystem::path>& runs) -> void {
+	if (records.empty())
+		return;
+	std::sort(records.begin(), records.end());
+	records.erase(std::unique(records.begin(), records.end()), records.end());
+	auto const path = dir_ / ("run-" + std::to_string(runs_created_++));
+	auto writer = block_writer{path, options_.block_bytes};
+	runs.push_back(path);
+	for (auto const& record : records) {
+		external_graph<N, E>::write_record(writer.payload(), record);
+		writer.end_record();
+	}
+	writer.finish(false);
+	records.clear();
+	records.shrink_to_fit();
+}
+
+template<gdwg::serializable N, gdwg::serializable E>
+template<typename T, typename F>
+auto gdwg::external_builder<N, E>::merge(std::vector<std::filesystem::path>& runs, F visit) -> void {
+	// A run being merged, holding one block in memory
+	struct cursor {
+		block_file file;
+		std::uint64_t offset = 0;
+		std::vector<T> records;
+		std::size_t position = 0;
+
+		auto advance() -> bool {
+			if (++position < records.size())
+				return true;
+			if (offset >= file.size())
+				return false;
+			auto const block = file.read_block(offset);
+			offset += wal_frame::header_size + block.size();
+			records = external_graph<N, E>::template read_records<T>(block);
+			position = 0;
+			return not records.empty();
+		}
+	};
+	auto const& merge_group = [](std::span<std::filesystem::path const> group, auto&& emit) {
+		auto cursors = std::vector<cursor>{};
+		cursors.reserve(group.size());
+		for (auto const& path : group) {
+			cursors.push_back(cursor{block_file{path}, 0, {}, 0});
+		}
+		// The heap holds the cursors which are not exhausted, smallest record on top
+		auto const greater = [&cursors](std::size_t lhs, std::size_t rhs) {
+			return cursors[rhs].records[cursors[rhs].position] < cursors[lhs].records[cursors[lhs].position];
+		};
+		auto heap = std::priority_queue<std::size_t, std::vector<std::size_t>, decltype(greater)>{greater};
+		for (auto i = std::size_t{0}; i < cursors.size(); ++i) {
+			if (cursors[i].advance())
+				heap.push(i);
+		}
+		auto last = std::optional<T>{};
+		while (not heap.empty()) {
+			auto const top = heap.top();
+			heap.pop();
+			auto& current = cursors[top];
+			// Runs are deduplicated, but the same record may be in several of them
+			if (not last or *last < current.records[current.position]) {
+				last = current.records[current.position];
+				emit(*last);
+			}
+			if (current.advance())
+				heap.push(top);
+		}
+	};
+	auto const remove = [](std::span<std::filesystem::path const> group) {
+		for (auto const& path : group) {
+			std::filesystem::remove(path);
+		}
+	};
+	while (runs.size() > fan_in()) {
+		auto merged = std::vector<std::filesystem::path>{};
+		for (auto first = std::size_t{0}; first < runs.size(); first += fan_in()) {
+			auto const group = std::span{runs}.subspan(first, std::min(fan_in(), runs.size() - first));
+			auto const path = dir_ / ("run-" + std::to_string(runs_created_++));
+			auto writer = block_writer{path, options_.block_bytes};
+			merge_group(group, [&writer](T const& record) {
+				external_graph<N, E>::write_record(writer.payload(), record);
+				writer.end_record();
+			});
+			writer.finish(false);
+			remove(group);
+			merged.push_back(path);
+		}
+		runs = std::move(merged);
+	}
+	merge_group(runs, visit);
+	remove(runs);
+	runs.clear();
+}
+
+template<gdwg::serializable N, gdwg::serializable E>
+auto gdwg::external_builder<N, E>::fan_in() const noexcept -> std::size_t {
+	return std::max(options_.memory_budget / std::max(options_.block_bytes, std::size_t{1}), std::size_t{2});
+}
+
+#endif // GDWG_EXTERNAL_H
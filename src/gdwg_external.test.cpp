@@ -0,0 +1,158 @@
+#include "gdwg_external.h"
+#include "gdwg_testing.h"
+
+#include <catch2/catch.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+
+namespace {
+	using gdwg::testing::sample;
+	using gdwg::testing::scratch_dir;
+
+	// Small blocks and a small budget, so that even test graphs span many blocks and runs
+	constexpr auto tiny = gdwg::external_options{.memory_budget = 4096, .block_bytes = 256};
+} // namespace
+
+TEST_CASE("Buffer pool operation", "[external]") {
+	auto const dir = scratch_dir{};
+	auto writer = gdwg::block_writer{dir.path / "blocks", 4};
+	auto offsets = std::vector<std::uint64_t>{};
+	for (auto const* record : {"first", "second", "third"}) {
+		REQUIRE(writer.starts_block());
+		offsets.push_back(writer.offset());
+		writer.payload() += record;
+		writer.end_record();
+	}
+	writer.finish(false);
+	auto const file = gdwg::block_file{dir.path / "blocks"};
+
+	SECTION("Blocks are framed and read back") {
+		REQUIRE(file.read_block(offsets[1]) == "second");
+		REQUIRE(file.size() == 3 * gdwg::wal_frame::header_size + 5 + 6 + 5);
+		REQUIRE_THROWS_AS(file.read_block(file.size() - 2), std::runtime_error);
+	}
+
+	SECTION("Blocks are cached until evicted in CLOCK order") {
+		auto pool = gdwg::buffer_pool{2};
+		REQUIRE(*pool.fetch(0, offsets[0], file) == "first");
+		REQUIRE(*pool.fetch(0, offsets[0], file) == "first");
+		REQUIRE(*pool.fetch(0, offsets[1], file) == "second");
+		REQUIRE(*pool.fetch(0, offsets[2], file) == "third");
+		auto const stats = pool.statistics();
+		REQUIRE(stats.hits == 1);
+		REQUIRE(stats.misses == 3);
+		REQUIRE(stats.evictions == 1);
+	}
+
+	SECTION("Pinned blocks are not evicted") {
+		auto pool = gdwg::buffer_pool{1};
+		auto const pinned = pool.fetch(0, offsets[0], file);
+		REQUIRE(*pool.fetch(0, offsets[1], file) == "second");
+		REQUIRE(pool.statistics().evictions == 0);
+		REQUIRE(*pool.fetch(0, offsets[0], file) == "first");
+		REQUIRE(pool.statistics().hits == 1);
+	}
+}
+
+TEST_CASE("External graph operation", "[external]") {
+	auto const dir = scratch_dir{};
+
+	SECTION("Queries match the graph") {
+		auto const g = sample();
+		auto const external = gdwg::external_graph<std::string, int>::build(g, dir.path);
+		REQUIRE(external.node_count() == 5);
+		REQUIRE(external.edge_count() == 8);
+		for (auto const& src : g.nodes()) {
+			REQUIRE(external.is_node(src));
+			REQUIRE(external.connections(src) == g.connections(src));
+			for (auto const& dst : g.nodes()) {
+				REQUIRE(external.is_connected(src, dst) == g.is_connected(src, dst));
+			}
+		}
+		REQUIRE_FALSE(external.is_node("F"));
+		REQUIRE_FALSE(external.is_node(""));
+		REQUIRE_THROWS_WITH(external.is_connected("A", "F"),
+		                    "Cannot call gdwg::external_graph<N, E>::is_connected if src or dst node don't exist in the "
+		                    "graph");
+		REQUIRE_THROWS_WITH(external.connections("F"),
+		                    "Cannot call gdwg::external_graph<N, E>::connections if src doesn't exist in the graph");
+	}
+
+	SECTION("Scans visit everything in graph order") {
+		auto const g = sample();
+		auto const external = gdwg::external_graph<std::string, int>::build(g, dir.path);
+		auto copy = gdwg::graph<std::string, int>{};
+		external.for_each_node([&copy](std::string const& value) { copy.insert_node(value); });
+		auto edges = std::vector<std::tuple<std::string, std::string, std::optional<int>>>{};
+		external.for_each_edge([&](std::string const& src, std::string const& dst, std::optional<int> const& weight) {
+			edges.emplace_back(src, dst, weight);
+			copy.insert_edge(src, dst, weight);
+		});
+		REQUIRE(copy == g);
+		REQUIRE(std::ranges::is_sorted(edges));
+	}
+
+	SECTION("Bulk loading sorts through many runs within the budget") {
+		auto expected = gdwg::graph<int, int>{};
+		auto builder = gdwg::external_builder<int, int>{dir.path, tiny};
+		auto random = std::mt19937{42};
+		auto node = std::uniform_int_distribution{0, 299};
+		for (auto i = 0; i < 3000; ++i) {
+			auto const src = node(random);
+			auto const dst = node(random);
+			auto const weight = i % 4 == 0 ? std::nullopt : std::optional<int>{i % 7};
+			expected.insert_node(src);
+			expected.insert_node(dst);
+			expected.insert_edge(src, dst, weight);
+			builder.add_edge(src, dst, weight);
+		}
+		builder.add_node(1000);
+		expected.insert_node(1000);
+		auto const external = builder.finish();
+		REQUIRE(builder.runs() > 16);
+		REQUIRE(std::distance(std::filesystem::directory_iterator{dir.path}, {}) == 3);
+
+		auto copy = gdwg::graph<int, int>{};
+		external.for_each_node([&copy](int value) { copy.insert_node(value); });
+		external.for_each_edge([&copy](int src, int dst, std::optional<int> weight) { copy.insert_edge(src, dst, weight); });
+		REQUIRE(copy == expected);
+		for (auto src = 0; src < 300; src += 7) {
+			REQUIRE(external.connections(src) == expected.connections(src));
+			REQUIRE(external.is_connected(src, (src * 13) % 300) == expected.is_connected(src, (src * 13) % 300));
+		}
+		REQUIRE(external.is_node(1000));
+		REQUIRE(external.connections(1000).empty());
+	}
+
+	SECTION("Reopening reads only the index and pages blocks in on demand") {
+		auto g = gdwg::graph<int, int>{};
+		for (auto i = 0; i < 2000; ++i) {
+			g.insert_node(i);
+			g.insert_edge(i, i, i);
+		}
+		{ auto const built = gdwg::external_graph<int, int>::build(g, dir.path, tiny); }
+		auto const external = gdwg::external_graph<int, int>{dir.path, tiny};
+		REQUIRE(external.edge_count() == 2000);
+		REQUIRE(external.pool_stats().misses == 0);
+		REQUIRE(external.is_connected(1234, 1234));
+		REQUIRE_FALSE(external.is_connected(1234, 1235));
+		auto const after_first = external.pool_stats();
+		REQUIRE(after_first.misses > 0);
+		REQUIRE(external.is_connected(1234, 1234));
+		REQUIRE(external.pool_stats().misses == after_first.misses);
+		for (auto i = 0; i < 2000; i += 50) {
+			REQUIRE(external.connections(i) == std::vector{i});
+		}
+		REQUIRE(external.pool_stats().evictions > 0);
+	}
+
+	SECTION("A missing or corrupt index is reported") {
+		REQUIRE_THROWS(gdwg::external_graph<std::string, int>{dir.path});
+		{ auto const built = gdwg::external_graph<std::string, int>::build(sample(), dir.path); }
+		std::ofstream{dir.path / "index", std::ios::binary | std::ios::app} << 'x';
+		REQUIRE_THROWS_AS((gdwg::external_graph<std::string, int>{dir.path}), std::runtime_error);
+	}
+}
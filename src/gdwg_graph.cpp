@@ -1 +1,201 @@
 #include "gdwg_graph.h"
+
+#include <bit>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  NODE POOL FUNCTIONS                                                               //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+auto gdwg::node_pool::allocate(std::size_t bytes) -> void* {
+	auto const size = block_size(bytes);
+	auto const lock = std::lock_guard{mutex_};
+	// Recycle a freed block of the same size first
+	for (auto& list : free_lists_) {
+		if (list.size == size and list.head != nullptr) {
+			auto* const block = list.head;
+			list.head = *static_cast<void**>(block);
+			used_ += size;
+			return block;
+		}
+	}
+	if (static_cast<std::size_t>(limit_ - cursor_) < size) {
+		// Grow geometrically so that an unreserved pool only allocates O(log n) chunks
+		grow(std::max({size, capacity_, min_chunk_bytes}));
+	}
+	auto* const block = cursor_;
+	cursor_ += size;
+	used_ += size;
+	return block;
+}
+
+auto gdwg::node_pool::deallocate(void* ptr, std::size_t bytes) noexcept -> void {
+	auto const size = block_size(bytes);
+	auto const lock = std::lock_guard{mutex_};
+	used_ -= size;
+	auto list = std::ranges::find(free_lists_, size, &free_list::size);
+	if (list == free_lists_.end()) {
+		// A pool only ever sees a handful of distinct sizes, so this allocates at most a few times
+		try {
+			list = free_lists_.insert(free_lists_.end(), free_list{size, nullptr});
+		} catch (...) {
+			// Without a free list the block simply stays unused until the pool is destroyed
+			return;
+		}
+	}
+	::new (ptr) void*(list->head);
+	list->head = ptr;
+}
+
+auto gdwg::node_pool::reserve(std::size_t bytes) -> void {
+	auto const lock = std::lock_guard{mutex_};
+	if (static_cast<std::size_t>(limit_ - cursor_) < bytes) {
+		grow(bytes);
+	}
+}
+
+auto gdwg::node_pool::capacity() const noexcept -> std::size_t {
+	auto const lock = std::lock_guard{mutex_};
+	return capacity_;
+}
+
+auto gdwg::node_pool::used() const noexcept -> std::size_t {
+	auto const lock = std::lock_guard{mutex_};
+	return used_;
+}
+
+auto gdwg::node_pool::block_size(std::size_t bytes) noexcept -> std::size_t {
+	return (std::max(bytes, sizeof(void*)) + alignment - 1) / alignment * alignment;
+}
+
+auto gdwg::node_pool::grow(std::size_t bytes) -> void {
+	auto const size = block_size(bytes);
+	chunks_.push_back(std::make_unique_for_overwrite<std::byte[]>(size));
+	cursor_ = chunks_.back().get();
+	limit_ = cursor_ + size;
+	capacity_ += size;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                               GRAPH FINGERPRINT FUNCTIONS                                                          //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+auto gdwg::graph_fingerprint::operator+=(graph_fingerprint const& other) noexcept -> graph_fingerprint& {
+	high += other.high;
+	low += other.low;
+	return *this;
+}
+
+auto gdwg::graph_fingerprint::operator-=(graph_fingerprint const& other) noexcept -> graph_fingerprint& {
+	high -= other.high;
+	low -= other.low;
+	return *this;
+}
+
+auto gdwg::graph_fingerprint::from_hash(std::uint64_t hash) noexcept -> graph_fingerprint {
+	// Distinct odd constants make the two halves independent functions of the hash
+	return graph_fingerprint{mix(hash ^ 0x9e3779b97f4a7c15U), mix(hash * 0xd6e8feb86659fd93U + 0x632be59bd9b4e019U)};
+}
+
+auto gdwg::graph_fingerprint::mix(std::uint64_t x) noexcept -> std::uint64_t {
+	x ^= x >> 30U;
+	x *= 0xbf58476d1ce4e5b9U;
+	x ^= x >> 27U;
+	x *= 0x94d049bb133111ebU;
+	x ^= x >> 31U;
+	return x;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                               GRAPH MEMORY USAGE FUNCTIONS                                                         //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+auto gdwg::graph_memory_usage::total() const noexcept -> std::size_t {
+	return node_storage + edge_storage + allocator_overhead + heap_payload;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                               GRAPH STATS FUNCTIONS                                                                //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+auto gdwg::graph_stats::operator[](graph_operation op) const noexcept -> operation_stats const& {
+	return operations[static_cast<std::size_t>(op)];
+}
+
+thread_local std::uint64_t gdwg::stats_recorder::thread_comparisons_ = 0;
+thread_local std::uint64_t gdwg::stats_recorder::thread_visits_ = 0;
+
+auto gdwg::stats_recorder::record(graph_operation op,
+                                  std::uint64_t comparisons,
+                                  std::uint64_t visits,
+                                  std::chrono::nanoseconds latency) noexcept -> void {
+	auto& counter = counters_[static_cast<std::size_t>(op)];
+	// The counters are independent, so relaxed ordering is enough; a snapshot may be mid-way through a call.
+	counter.calls.fetch_add(1, std::memory_order_relaxed);
+	counter.comparisons.fetch_add(comparisons, std::memory_order_relaxed);
+	counter.visits.fetch_add(visits, std::memory_order_relaxed);
+	auto const nanos = static_cast<std::uint64_t>(std::max(latency.count(), std::chrono::nanoseconds::rep{0}));
+	auto const bucket = std::min(static_cast<std::size_t>(std::bit_width(nanos)), operation_stats::latency_buckets - 1);
+	counter.latency_ns[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+auto gdwg::stats_recorder::snapshot() const noexcept -> graph_stats {
+	auto stats = graph_stats{};
+	for (auto i = std::size_t{0}; i < graph_operation_count; ++i) {
+		auto const& counter = counters_[i];
+		auto& op = stats.operations[i];
+		op.calls = counter.calls.load(std::memory_order_relaxed);
+		op.comparisons = counter.comparisons.load(std::memory_order_relaxed);
+		op.visits = counter.visits.load(std::memory_order_relaxed);
+		for (auto b = std::size_t{0}; b < operation_stats::latency_buckets; ++b) {
+			op.latency_ns[b] = counter.latency_ns[b].load(std::memory_order_relaxed);
+		}
+	}
+	return stats;
+}
+
+auto gdwg::stats_recorder::reset() noexcept -> void {
+	for (auto& counter : counters_) {
+		counter.calls.store(0, std::memory_order_relaxed);
+		counter.comparisons.store(0, std::memory_order_relaxed);
+		counter.visits.store(0, std::memory_order_relaxed);
+		for (auto& bucket : counter.latency_ns) {
+			bucket.store(0, std::memory_order_relaxed);
+		}
+	}
+}
+
+auto gdwg::stats_recorder::count_comparison() noexcept -> void {
+	++thread_comparisons_;
+}
+
+auto gdwg::stats_recorder::count_visit() noexcept -> void {
+	++thread_visits_;
+}
+
+auto gdwg::stats_recorder::comparisons() noexcept -> std::uint64_t {
+	return thread_comparisons_;
+}
+
+auto gdwg::stats_recorder::visits() noexcept -> std::uint64_t {
+	return thread_visits_;
+}
+
+namespace {
+	// The recorder of the innermost probe on this thread, which the probes nested in it leave the recording to
+	thread_local gdwg::stats_recorder const* active_recorder = nullptr;
+} // namespace
+
+gdwg::operation_probe::operation_probe(stats_recorder& recorder, graph_operation op) noexcept
+: recorder_{recorder}
+, enclosing_{std::exchange(active_recorder, &recorder)}
+, op_{op}
+, comparisons_{stats_recorder::comparisons()}
+, visits_{stats_recorder::visits()}
+, start_{std::chrono::steady_clock::now()} {}
+
+gdwg::operation_probe::~operation_probe() {
+	active_recorder = enclosing_;
+	if (enclosing_ == &recorder_)
+		return;
+	auto const latency = std::chrono::steady_clock::now() - start_;
+	recorder_.record(op_,
+	                 stats_recorder::comparisons() - comparisons_,
+	                 stats_recorder::visits() - visits_,
+	                 std::chrono::duration_cast<std::chrono::nanoseconds>(latency));
+}
@@ -2,1195 +2,4424 @@
 #	define GDWG_GRAPH_H
 
 #	include <algorithm>
+#	include <array>
+#	include <atomic>
+#	include <bit>
+#	include <chrono>
+#	include <concepts>
+#	include <cstddef>
+#	include <cstdint>
+#	include <functional>
+#	include <future>
 #	include <memory>
+#	include <mutex>
+#	include <new>
+#	include <numeric>
 #	include <optional>
+#	include <ranges>
 #	include <set>
 #	include <map>
+#	include <unordered_map>
+#	include <unordered_set>
 #	include <sstream>
+#	include <string>
+#	include <tuple>
+#	include <type_traits>
 #	include <utility>
 #	include <vector>
 
+// Define to a non-zero value, consistently in every translation unit, to make graph operations record statistics.
+#	ifndef GDWG_GRAPH_INSTRUMENTATION
+#		define GDWG_GRAPH_INSTRUMENTATION 0
+#	endif
+
 namespace gdwg {
 	// Declaration of graph for class edge uses.
 	template<typename N, typename E>
 	class graph;
 
+	// Declaration of graph_view for graph::filtered.
+	template<typename N, typename E, typename P>
+	class graph_view;
+
+	// Declaration of reverse_view for graph::reversed.
 	template<typename N, typename E>
-	class edge {
+	class reverse_view;
+
+	// Declaration of graph_builder, which assembles the storage of a graph directly.
+	template<typename N, typename E>
+	class graph_builder;
+
+	// Declaration of traversal, which walks the storage of a graph for the generators in gdwg_traversal.h.
+	template<typename N, typename E>
+	class traversal;
+
+	// Declaration of parallel_algorithms, which walks the storage of a graph for the functions in gdwg_parallel.h.
+	template<typename N, typename E>
+	class parallel_algorithms;
+
+	/**
+	 * A thread-safe pool of fixed-size blocks backing the node and edge storage of a graph.
+	 * Blocks are carved out of large chunks and recycled through per-size free lists, so once capacity has been
+	 * reserved, inserting nodes and edges does not call the global allocator.
+	 */
+	class node_pool {
 	 public:
 		/**
-		 * @brief Prints the edge information as a string.
-		 * @note Marked as [[nodiscard]] because the string representation of the edge is important and should not be
-		 * ignored.
+		 * Default constructor. Constructs an empty pool with no chunks allocated.
+		 */
+		node_pool() = default;
+
+		/**
+		 * The pool hands out raw pointers into its chunks, so it can be neither copied nor moved.
+		 */
+		node_pool(node_pool const&) = delete;
+		auto operator=(node_pool const&) -> node_pool& = delete;
+
+		/**
+		 * @brief Destructor.
+		 * @note Defaulted, releases all chunks.
+		 */
+		~node_pool() = default;
+
+		/**
+		 * @brief Allocates a block of at least the given size, aligned to the default new alignment.
+		 * @note Marked as [[nodiscard]] because discarding the block would leak it until the pool is destroyed.
+		 * Not marked as noexcept because growing the pool may throw std::bad_alloc.
 		 *
-		 * @return A string representing the edge.
+		 * Time complexity: O(1) amortised.
+		 *
+		 * @param bytes The size of the block.
+		 * @return A pointer to the block.
 		 */
-		[[nodiscard]] virtual auto print_edge() const -> std::string = 0;
+		[[nodiscard]] auto allocate(std::size_t bytes) -> void*;
 
 		/**
-		 * @brief Checks if the edge is weighted.
-		 * @note Marked as [[nodiscard]] because this information is critical for distinguishing between weighted and
-		 * unweighted edges. Marked as noexcept because it only returns a boolean value without throwing exceptions.
+		 * @brief Returns a block to the pool for reuse by later allocations of the same size.
+		 * @note Marked as noexcept because it only links the block into a free list.
 		 *
-		 * @return True if the edge is weighted, otherwise false.
+		 * @param ptr The block previously returned by allocate.
+		 * @param bytes The size the block was allocated with.
 		 */
-		[[nodiscard]] virtual auto is_weighted() const noexcept -> bool;
+		auto deallocate(void* ptr, std::size_t bytes) noexcept -> void;
 
 		/**
-		 * @brief Gets the weight of the edge.
-		 * @note Marked as [[nodiscard]] because the weight is important and should not be ignored.
-		 * Marked as noexcept because it only accesses a member variable without throwing exceptions.
+		 * @brief Ensures that at least the given number of bytes can be allocated without growing the pool.
+		 * @note Not marked as noexcept because allocating the chunk may throw std::bad_alloc.
 		 *
-		 * @return An optional containing the weight if the edge is weighted, otherwise std::nullopt.
+		 * @param bytes The number of bytes to make available.
 		 */
-		[[nodiscard]] virtual auto get_weight() const noexcept -> std::optional<E>;
+		auto reserve(std::size_t bytes) -> void;
 
 		/**
-		 * @brief Gets the nodes of the edge.
-		 * @note Marked as [[nodiscard]] because the nodes are critical for edge identification.
-		 * Marked as noexcept because std::make_pair not throw exceptions.
+		 * @brief Returns the total number of bytes held in chunks by the pool.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
 		 *
-		 * @return A pair of nodes representing the edge's source and destination.
+		 * @return The capacity of the pool in bytes.
 		 */
-		[[nodiscard]] virtual auto get_nodes() const noexcept -> std::pair<N, N>;
+		[[nodiscard]] auto capacity() const noexcept -> std::size_t;
 
 		/**
-		 * @brief Checks if two edges are equal.
-		 * @note Marked as noexcept because it only compares member variables without throwing exceptions.
+		 * @brief Returns the number of bytes in blocks which are currently allocated from the pool.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
 		 *
-		 * @param other The edge to compare with.
-		 * @return True if the edges are equal, otherwise false.
+		 * @return The bytes in use, counted in whole blocks.
 		 */
-		[[nodiscard]] virtual auto operator==(edge const& other) const noexcept -> bool;
+		[[nodiscard]] auto used() const noexcept -> std::size_t;
 
 		/**
-		 * @brief Destructor.
-		 * @note Defaulted.
+		 * @brief Rounds a requested size up to the size of the block that will hold it.
+		 * @note Marked as noexcept because it only performs arithmetic.
+		 *
+		 * @param bytes The requested size.
+		 * @return The block size.
 		 */
-		virtual ~edge() = default;
+		[[nodiscard]] static auto block_size(std::size_t bytes) noexcept -> std::size_t;
 
-	 protected:
-		N src_;
-		N dst_;
-		std::optional<E> weight_;
+		// Every block is aligned to (and sized in multiples of) the alignment guaranteed by operator new.
+		static constexpr auto alignment = std::size_t{__STDCPP_DEFAULT_NEW_ALIGNMENT__};
 
-		friend class graph<N, E>;
+	 private:
+		struct free_list {
+			std::size_t size;
+			void* head;
+		};
 
-		/**
-		 * Default constructor.
-		 */
-		edge() = default;
+		// Chunks are never smaller than this, so that an unreserved pool still grows geometrically.
+		static constexpr auto min_chunk_bytes = std::size_t{64 * 1024};
+
+		mutable std::mutex mutex_;
+		std::vector<std::unique_ptr<std::byte[]>> chunks_;
+		std::vector<free_list> free_lists_;
+		std::byte* cursor_ = nullptr;
+		std::byte* limit_ = nullptr;
+		std::size_t capacity_ = 0;
+		std::size_t used_ = 0;
 
 		/**
-		 * Copy and move constructor in default.
+		 * @brief Allocates a new chunk and makes it the current bump region. Must be called with mutex_ held.
+		 *
+		 * @param bytes The size of the chunk.
 		 */
-		edge(edge const&) = default;
-		edge(edge&&) noexcept = default;
+		auto grow(std::size_t bytes) -> void;
+	};
+
+	/**
+	 * A standard allocator drawing from a shared node_pool. A default constructed allocator has no pool and falls
+	 * back to the global operator new, so graphs that never reserve keep their usual allocation behaviour.
+	 * The pool is held by shared_ptr so that shared_ptr control blocks keep it alive for as long as they need it.
+	 */
+	template<typename T>
+	class pool_allocator {
+	 public:
+		using value_type = T;
+		using propagate_on_container_copy_assignment = std::true_type;
+		using propagate_on_container_move_assignment = std::true_type;
+		using propagate_on_container_swap = std::true_type;
 
 		/**
-		 * Copy and move assignment in default.
-		 * @return The instance after copy or move.
+		 * @brief Default constructor. Constructs an allocator using the global operator new.
 		 */
-		auto operator=(edge const&) -> edge& = default;
-		auto operator=(edge&&) noexcept -> edge& = default;
+		pool_allocator() noexcept = default;
 
 		/**
-		 * @brief Constructs an edge with the given source, destination, and weight.
-		 * @note Marked as noexcept because it only performs basic pointer assignments and does not perform any
-		 * operations that could throw exceptions.
+		 * @brief Constructs an allocator drawing from the given pool.
+		 * @note Marked as noexcept because it only moves a shared_ptr.
 		 *
-		 * @param src The source node.
-		 * @param dst The destination node.
-		 * @param weight The weight of the edge, optional.
+		 * @param pool The pool to allocate from, or nullptr for the global operator new.
 		 */
-		edge(N const& src, N const& dst, std::optional<E> const& weight = std::nullopt) noexcept;
+		explicit pool_allocator(std::shared_ptr<node_pool> pool) noexcept;
 
 		/**
-		 * @brief Clones the edge, returning a unique pointer to the new edge.
-		 * @note Marked as [[nodiscard]] because the cloned pointer is important and should not be ignored.
+		 * @brief Rebinding constructor, sharing the pool of an allocator for another type.
+		 * @note Marked as noexcept because it only copies a shared_ptr.
 		 *
-		 * @return A unique pointer to the cloned edge.
+		 * @param other The allocator to share the pool of.
 		 */
-		[[nodiscard]] virtual auto clone_ptr() const -> std::unique_ptr<edge> = 0;
+		template<typename U>
+		pool_allocator(pool_allocator<U> const& other) noexcept;
 
 		/**
-		 * @brief Sets the source and destination nodes of the edge.
-		 * @note Marked as noexcept because it only performs basic pointer assignments and does not perform any
-		 * operations that could throw exceptions.
+		 * @brief Allocates storage for n objects of type T.
+		 * @note Marked as [[nodiscard]] because discarding the storage would leak it.
 		 *
-		 * @param src The source node.
-		 * @param dst The destination node.
+		 * @param n The number of objects.
+		 * @return A pointer to the storage.
 		 */
-		virtual auto set_nodes(N const& src, N const& dst) noexcept -> void;
+		[[nodiscard]] auto allocate(std::size_t n) -> T*;
 
 		/**
-		 * @brief Compares two edges using the three-way comparison operator.
-		 * @note Marked as noexcept because it only performs comparisons and does not perform any operations that could
-		 * throw exceptions.
+		 * @brief Deallocates storage previously obtained from an equal allocator.
+		 * @note Marked as noexcept because deallocation never throws.
 		 *
-		 * @param other The other edge to compare.
-		 * @return A std::strong_ordering result of the comparison.
+		 * @param ptr The storage to release.
+		 * @param n The number of objects the storage was allocated for.
 		 */
-		virtual auto edge_comp(edge const& other) const noexcept -> std::strong_ordering;
-	};
+		auto deallocate(T* ptr, std::size_t n) noexcept -> void;
 
-	template<typename N, typename E>
-	class weighted_edge final : public edge<N, E> {
-	 public:
 		/**
-		 * @brief Prints the weighted edge information as a string.
-		 * @note Marked as [[nodiscard]] because the string representation of the edge is important and should not be
-		 * ignored. Not marked as noexcept because constructing a std::string may throw exceptions.
+		 * @brief Returns the pool this allocator draws from.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
 		 *
-		 * @return A string representing the weighted edge.
+		 * @return The pool, or nullptr for the global operator new.
 		 */
-		[[nodiscard]] auto print_edge() const -> std::string override;
+		[[nodiscard]] auto pool() const noexcept -> std::shared_ptr<node_pool> const&;
 
 		/**
-		 * @brief Constructs a weighted edge with the given source, destination, and weight.
-		 * @note Marked as noexcept because it only performs basic pointer assignments and does not perform any
-		 * operations that could throw exceptions.
+		 * @brief Checks if storage allocated by one allocator can be deallocated by the other.
 		 *
-		 * @param src The source node.
-		 * @param dst The destination node.
-		 * @param weight The weight of the edge, optional.
+		 * @param other The allocator to compare with.
+		 * @return True if both allocators draw from the same pool, otherwise false.
 		 */
-		weighted_edge(N const& src, N const& dst, E const& weight) noexcept;
+		template<typename U>
+		[[nodiscard]] auto operator==(pool_allocator<U> const& other) const noexcept -> bool;
 
 	 private:
+		std::shared_ptr<node_pool> pool_;
+
 		/**
-		 * @brief Clones the weighted edge, returning a unique pointer to the new edge.
-		 * @note Marked as [[nodiscard]] because the cloned pointer is important and should not be ignored.
-		 * Not marked as noexcept because std::make_unique may throw exceptions.
+		 * @brief Checks if allocations of T are served from the pool.
 		 *
-		 * @return A unique pointer to the cloned weighted edge.
+		 * @return True if there is a pool and T needs no more than its alignment, otherwise false.
 		 */
-		[[nodiscard]] auto clone_ptr() const -> std::unique_ptr<edge<N, E>> override;
-		friend class graph<N, E>;
+		[[nodiscard]] auto uses_pool() const noexcept -> bool;
 	};
 
-	template<typename N, typename E>
-	class unweighted_edge final : public edge<N, E> {
-	 public:
+	/**
+	 * An order-independent 128-bit fingerprint of the contents of a graph: the wrapping sum of a hash of every node
+	 * and every edge. Equal graphs always have equal fingerprints, so differing fingerprints prove that two graphs
+	 * differ without comparing their contents. Node and edge types without a std::hash specialisation contribute
+	 * nothing, in which case only equal fingerprints are meaningful.
+	 */
+	struct graph_fingerprint {
+		std::uint64_t high = 0;
+		std::uint64_t low = 0;
+
 		/**
-		 * @brief Prints the unweighted edge information as a string.
-		 * @note Marked as [[nodiscard]] because the string representation of the edge is important and should not be
-		 * ignored. Not marked as noexcept because constructing a std::string may throw exceptions.
+		 * @brief Adds the fingerprint of an element to this fingerprint.
+		 * @note Marked as noexcept because it only performs wrapping arithmetic.
 		 *
-		 * @return A string representing the unweighted edge.
+		 * @param other The fingerprint to add.
+		 * @return A reference to this fingerprint.
 		 */
-		[[nodiscard]] auto print_edge() const -> std::string override;
+		auto operator+=(graph_fingerprint const& other) noexcept -> graph_fingerprint&;
 
 		/**
-		 * @brief Constructs an unweighted edge with the given source and destination.
-		 * @note Marked as noexcept because it not throw exceptions.
+		 * @brief Removes the fingerprint of an element from this fingerprint.
+		 * @note Marked as noexcept because it only performs wrapping arithmetic.
 		 *
-		 * @param src The source node.
-		 * @param dst The destination node.
+		 * @param other The fingerprint to subtract.
+		 * @return A reference to this fingerprint.
 		 */
-		unweighted_edge(N const& src, N const& dst) noexcept;
+		auto operator-=(graph_fingerprint const& other) noexcept -> graph_fingerprint&;
 
-	 private:
 		/**
-		 * @brief Clones the unweighted edge, returning a unique pointer to the new edge.
-		 * @note Marked as [[nodiscard]] because the cloned pointer is important and should not be ignored.
-		 * Not marked as noexcept because std::make_unique may throw exceptions.
+		 * @brief Compares two fingerprints for equality.
 		 *
-		 * @return A unique pointer to the cloned unweighted edge.
+		 * @return True if both halves are equal, otherwise false.
 		 */
-		[[nodiscard]] auto clone_ptr() const -> std::unique_ptr<edge<N, E>> override;
-		friend class graph<N, E>;
+		[[nodiscard]] auto operator==(graph_fingerprint const&) const noexcept -> bool = default;
+
+		/**
+		 * @brief Spreads a 64-bit hash over both halves of a fingerprint.
+		 * @note Marked as noexcept because it only performs arithmetic.
+		 *
+		 * @param hash The hash to spread, usually a combination of std::hash values.
+		 * @return A fingerprint whose halves are independently mixed from the hash.
+		 */
+		[[nodiscard]] static auto from_hash(std::uint64_t hash) noexcept -> graph_fingerprint;
+
+		/**
+		 * @brief Mixes a 64-bit value so that every input bit affects every output bit (splitmix64 finaliser).
+		 * @note Marked as noexcept because it only performs arithmetic.
+		 *
+		 * @param x The value to mix.
+		 * @return The mixed value.
+		 */
+		[[nodiscard]] static auto mix(std::uint64_t x) noexcept -> std::uint64_t;
 	};
 
-	template<typename N, typename E>
-	class graph {
+	/**
+	 * Customisation point reporting the heap memory owned by a value, excluding the value itself. Like std::hash it
+	 * is specialised for the types which own heap memory; a type without a specialisation owns none.
+	 */
+	template<typename T>
+	struct heap_usage {};
+
+	/**
+	 * A type with a heap_usage specialisation.
+	 */
+	template<typename T>
+	concept heap_owning = requires(heap_usage<T> const usage, T const& value) {
+		{ usage(value) } -> std::convertible_to<std::size_t>;
+	};
+
+	/**
+	 * @brief Returns the heap memory owned by a value according to its heap_usage specialisation.
+	 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+	 * Marked as noexcept because heap_usage specialisations only inspect the value.
+	 *
+	 * @param value The value to inspect.
+	 * @return The number of heap bytes owned by the value, or 0 if it has no heap_usage specialisation.
+	 */
+	template<typename T>
+	[[nodiscard]] auto heap_bytes(T const& value) noexcept -> std::size_t;
+
+	template<typename CharT, typename Traits, typename Alloc>
+	struct heap_usage<std::basic_string<CharT, Traits, Alloc>> {
 		/**
-		 * The private part using for the member which are store in the graph class.
-		 * Using to short name of the long type name, and comparator for the set use to sort and find.
-		 * And the private iterator used only for the class graph.
+		 * @brief Returns the size of the buffer of a string which does not fit in the small string buffer.
+		 * @note Marked as noexcept because it only queries the capacity.
+		 *
+		 * @param value The string to inspect.
+		 * @return The heap bytes owned by the string.
 		 */
-		struct compare_shared_ptr {
-			using is_transparent = std::true_type;
+		auto operator()(std::basic_string<CharT, Traits, Alloc> const& value) const noexcept -> std::size_t;
+	};
 
-			/**
-			 * @brief Compares two shared_ptr<N> instances lexicographically.
-			 * @note This function is marked as noexcept because it doesn't perform any operations that could throw
-			 * exceptions. Dereferencing a shared_ptr is a safe operation that doesn't throw exceptions.
-			 *
-			 * @param lhs The left-hand side shared_ptr<N> for comparison.
-			 * @param rhs The right-hand side shared_ptr<N> for comparison.
-			 * @return A boolean result of the comparison.
-			 */
-			auto operator()(std::shared_ptr<N> const& lhs, std::shared_ptr<N> const& rhs) const noexcept -> bool;
+	template<typename T, typename Alloc>
+	struct heap_usage<std::vector<T, Alloc>> {
+		/**
+		 * @brief Returns the size of the buffer of a vector and the heap memory owned by its elements.
+		 * @note Marked as noexcept because it only queries the capacity and the elements.
+		 *
+		 * @param value The vector to inspect.
+		 * @return The heap bytes owned by the vector.
+		 */
+		auto operator()(std::vector<T, Alloc> const& value) const noexcept -> std::size_t;
+	};
 
-			/**
-			 * @brief Compares a shared_ptr<N> instance with an N instance lexicographically.
-			 * @note This function is marked as noexcept because it doesn't perform any operations that could throw
-			 * exceptions. Dereferencing a shared_ptr is a safe operation that doesn't throw exceptions.
-			 *
-			 * @param lhs The left-hand side shared_ptr<N> for comparison.
-			 * @param rhs The right-hand side N for comparison.
-			 * @return A boolean result of the comparison.
-			 */
-			auto operator()(std::shared_ptr<N> const& lhs, N const& rhs) const noexcept -> bool;
+	/**
+	 * A breakdown of the memory used by a graph, in bytes. Node and edge storage are the sizes of the objects which
+	 * make up the nodes and edges: their set entries, shared_ptr control blocks and the values themselves. Allocator
+	 * overhead is what the allocator spends on top of that: alignment padding, allocation headers, and the reserved
+	 * but unused part of a pool. Heap payload is the memory owned by the node and weight values, as reported by
+	 * heap_usage, including the copies of the nodes held by every edge.
+	 */
+	struct graph_memory_usage {
+		std::size_t node_storage = 0;
+		std::size_t edge_storage = 0;
+		std::size_t allocator_overhead = 0;
+		std::size_t heap_payload = 0;
 
-			/**
-			 * @brief Compares an N instance with a shared_ptr<N> instance lexicographically.
-			 * @note This function is marked as noexcept because it doesn't perform any operations that could throw
-			 * exceptions. Dereferencing a shared_ptr is a safe operation that doesn't throw exceptions.
-			 *
-			 * @param lhs The left-hand side N for comparison.
-			 * @param rhs The right-hand side shared_ptr<N> for comparison.
-			 * @return A boolean result of the comparison.
-			 */
-			auto operator()(N const& lhs, std::shared_ptr<N> const& rhs) const noexcept -> bool;
-		};
+		/**
+		 * @brief Returns the total memory used by the graph.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Marked as noexcept because it only adds the components.
+		 *
+		 * @return The sum of all components.
+		 */
+		[[nodiscard]] auto total() const noexcept -> std::size_t;
 
-		// Using type for storing edge with src, dst as the tuple in graph class.
-		using edge_tuple = std::tuple<std::shared_ptr<N>, std::shared_ptr<N>, std::shared_ptr<edge<N, E>>>;
+		/**
+		 * @brief Compares two breakdowns for equality.
+		 *
+		 * @return True if every component is equal, otherwise false.
+		 */
+		[[nodiscard]] auto operator==(graph_memory_usage const&) const noexcept -> bool = default;
+	};
 
-		struct compare_edges_set {
-			using is_transparent = std::true_type;
+	/**
+	 * True if graph operations record statistics, see GDWG_GRAPH_INSTRUMENTATION. When false the instrumentation is
+	 * compiled out entirely and graph::stats() always reports zero.
+	 */
+	inline constexpr bool instrumentation_enabled = GDWG_GRAPH_INSTRUMENTATION != 0;
+
+	/**
+	 * The graph operations which record statistics.
+	 */
+	enum class graph_operation : std::uint8_t {
+		insert_node,
+		insert_edge,
+		replace_node,
+		merge_replace_node,
+		erase_node,
+		erase_edge,
+		is_node,
+		is_connected,
+		edges,
+		find,
+		connections,
+	};
 
-			/**
-			 * @brief Compares two edge_tuple<N, E> instances lexicographically based on their nodes and edges.
-			 * @note This function is marked as noexcept because it doesn't perform any operations that could throw
-			 * exceptions. Dereferencing a shared_ptr is a safe operation that doesn't throw exceptions.
-			 *
-			 * @param lhs The left-hand side edge_tuple<N, E> for comparison.
-			 * @param rhs The right-hand side edge_tuple<N, E> for comparison.
-			 * @return A boolean result of the comparison.
-			 */
-			auto operator()(edge_tuple const& lhs, edge_tuple const& rhs) const noexcept -> bool;
+	inline constexpr std::size_t graph_operation_count = 11;
 
-		 private:
-			compare_shared_ptr comp_shared_node_;
-		};
+	/**
+	 * The statistics of a single graph operation. Comparisons count every invocation of the node and edge set
+	 * comparators, including the node comparisons made by an edge comparison. Visits count the edges examined by
+	 * the paths which walk the edge set.
+	 */
+	struct operation_stats {
+		// Bucket i counts the calls whose latency in nanoseconds has a bit width of i, i.e. lies in [2^(i-1), 2^i).
+		// The last bucket also counts every slower call.
+		static constexpr std::size_t latency_buckets = 40;
 
-		// Member type of graph, define in private for using at some functions.
-		using type_nodes_set = std::set<std::shared_ptr<N>, compare_shared_ptr>;
-		using edges_set = std::set<edge_tuple, compare_edges_set>;
+		std::uint64_t calls = 0;
+		std::uint64_t comparisons = 0;
+		std::uint64_t visits = 0;
+		std::array<std::uint64_t, latency_buckets> latency_ns{};
 
-		class iter {
-		 public:
-			using value_type = struct {
-				N from;
-				N to;
-				std::optional<E> weight;
-			};
-			using reference = value_type;
-			using pointer = void;
-			using difference_type = std::ptrdiff_t;
-			using iterator_category = std::bidirectional_iterator_tag;
+		/**
+		 * @brief Compares two statistics for equality.
+		 *
+		 * @return True if every counter is equal, otherwise false.
+		 */
+		[[nodiscard]] auto operator==(operation_stats const&) const noexcept -> bool = default;
+	};
 
-			/**
-			 * Iterator default constructor
-			 */
-			iter() = default;
+	/**
+	 * A snapshot of the statistics of every graph operation.
+	 */
+	struct graph_stats {
+		std::array<operation_stats, graph_operation_count> operations{};
 
-			/**
-			 * @brief Dereferences the iterator to access the current edge.
-			 * @note Marked as [[nodiscard]] because the dereferenced value is important and should not be ignored.
-			 * Marked as noexcept because it only involves dereferencing smart pointers and copying values, which do not
-			 * throw exceptions.
-			 *
-			 * @return A reference to the current edge value.
-			 */
-			[[nodiscard]] auto operator*() const noexcept -> reference;
+		/**
+		 * @brief Returns the statistics of an operation.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Marked as noexcept because every operation has an entry.
+		 *
+		 * @param op The operation.
+		 * @return The statistics of the operation.
+		 */
+		[[nodiscard]] auto operator[](graph_operation op) const noexcept -> operation_stats const&;
 
-			/**
-			 * @brief Advances the iterator to the next position (pre-increment).
-			 * @note Marked as noexcept because it only increments the internal iterator, which does not throw
-			 * exceptions.
-			 *
-			 * @return A reference to the incremented iterator.
-			 */
-			auto operator++() noexcept -> iter&;
-
-			/**
-			 * @brief Advances the iterator to the next position (post-increment).
-			 * @note Marked as noexcept because it only increments the internal iterator, which does not throw
-			 * exceptions.
-			 *
-			 * @return A copy of the iterator before incrementing.
-			 */
-			auto operator++(int) noexcept -> iter;
+		/**
+		 * @brief Compares two snapshots for equality.
+		 *
+		 * @return True if the statistics of every operation are equal, otherwise false.
+		 */
+		[[nodiscard]] auto operator==(graph_stats const&) const noexcept -> bool = default;
+	};
 
-			/**
-			 * @brief Moves the iterator to the previous position (pre-decrement).
-			 * @note Marked as noexcept because it only decrements the internal iterator, which does not throw
-			 * exceptions.
-			 *
-			 * @return A reference to the decremented iterator.
-			 */
-			auto operator--() noexcept -> iter&;
+	/**
+	 * Thread-safe counters backing graph::stats(). Comparisons and visits are counted per thread, and attributed to
+	 * the operation running on that thread by an operation_probe.
+	 */
+	class stats_recorder {
+	 public:
+		/**
+		 * Default constructor. Constructs a recorder with every counter at zero.
+		 */
+		stats_recorder() noexcept = default;
 
-			/**
-			 * @brief Moves the iterator to the previous position (post-decrement).
-			 * @note Marked as noexcept because it only decrements the internal iterator, which does not throw
-			 * exceptions.
-			 *
-			 * @return A copy of the iterator before decrementing.
-			 */
-			auto operator--(int) noexcept -> iter;
+		/**
+		 * Recorders count the operations on a single graph, so they are neither copied nor moved with it.
+		 */
+		stats_recorder(stats_recorder const&) = delete;
+		auto operator=(stats_recorder const&) -> stats_recorder& = delete;
 
-			/**
-			 * @brief Compares two iterators for equality.
-			 * @note Marked as noexcept because it only compares internal iterators, which do not throw exceptions.
-			 *
-			 * @param other The iterator to compare with.
-			 * @return True if the iterators are equal, otherwise false.
-			 */
-			auto operator==(iter const& other) const noexcept -> bool;
+		/**
+		 * Default destructor.
+		 */
+		~stats_recorder() = default;
 
-		 private:
-			using set_iter = typename edges_set::iterator;
+		/**
+		 * @brief Records a completed call of an operation.
+		 * @note Marked as noexcept because it only increments atomic counters.
+		 *
+		 * @param op The operation.
+		 * @param comparisons The comparisons made by the call.
+		 * @param visits The edges visited by the call.
+		 * @param latency The duration of the call.
+		 */
+		auto record(graph_operation op,
+		            std::uint64_t comparisons,
+		            std::uint64_t visits,
+		            std::chrono::nanoseconds latency) noexcept -> void;
 
-			set_iter set_it_;
-			/**
-			 * @brief Constructs an iterator from a set iterator.
-			 * @note Marked as noexcept because it only initializes the internal iterator, which does not throw
-			 * exceptions.
-			 *
-			 * @param set_it The set iterator to initialize with.
-			 */
-			explicit iter(set_iter const& set_it) noexcept;
+		/**
+		 * @brief Returns a snapshot of the counters.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Marked as noexcept because it only loads atomic counters.
+		 *
+		 * @return The statistics recorded so far.
+		 */
+		[[nodiscard]] auto snapshot() const noexcept -> graph_stats;
 
-			/**
-			 * @brief Returns the base iterator.
-			 * @note Marked as [[nodiscard]] because the base iterator is important and should not be ignored.
-			 * Marked as noexcept because it only returns the internal iterator, which does not throw exceptions.
-			 *
-			 * @return The base set iterator.
-			 */
-			[[nodiscard]] auto base() const noexcept -> set_iter;
+		/**
+		 * @brief Sets every counter back to zero.
+		 * @note Marked as noexcept because it only stores atomic counters.
+		 */
+		auto reset() noexcept -> void;
 
-			friend class graph;
-		};
+		/**
+		 * @brief Counts a comparator invocation on the calling thread.
+		 * @note Marked as noexcept because it only increments a thread local counter.
+		 */
+		static auto count_comparison() noexcept -> void;
 
-	 public:
-		using iterator = iter;
 		/**
-		 * @brief Default constructor. Constructs an empty graph.
-		 * @note Marked as noexcept because it only initializes member variables and does not throw exceptions.
+		 * @brief Counts a visited edge on the calling thread.
+		 * @note Marked as noexcept because it only increments a thread local counter.
 		 */
-		graph() noexcept;
+		static auto count_visit() noexcept -> void;
 
 		/**
-		 * @brief Constructs a graph from an initializer list of nodes.
-		 * @note Not marked as noexcept because it may perform operations that could throw exceptions.
+		 * @brief Returns the comparisons counted on the calling thread so far.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
 		 *
-		 * @param il The initializer list of nodes to construct the graph with.
+		 * @return The running count of comparisons.
 		 */
-		graph(std::initializer_list<N> const& il);
+		[[nodiscard]] static auto comparisons() noexcept -> std::uint64_t;
 
 		/**
-		 * @brief Constructs a graph from a range of nodes.
-		 * @note Not marked as noexcept because it may perform operations that could throw exceptions by
-		 * std::make_shared.
+		 * @brief Returns the visits counted on the calling thread so far.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
 		 *
-		 * @tparam InputIt The type of the input iterator.
-		 * @param first The beginning of the range of nodes.
-		 * @param last The end of the range of nodes.
+		 * @return The running count of visits.
 		 */
-		template<typename InputIt>
-		graph(InputIt const& first, InputIt const& last);
+		[[nodiscard]] static auto visits() noexcept -> std::uint64_t;
+
+	 private:
+		struct counters {
+			std::atomic<std::uint64_t> calls;
+			std::atomic<std::uint64_t> comparisons;
+			std::atomic<std::uint64_t> visits;
+			std::array<std::atomic<std::uint64_t>, operation_stats::latency_buckets> latency_ns;
+		};
 
+		std::array<counters, graph_operation_count> counters_{};
+
+		static thread_local std::uint64_t thread_comparisons_;
+		static thread_local std::uint64_t thread_visits_;
+	};
+
+	/**
+	 * Records a single call of a graph operation into a stats_recorder when it goes out of scope. A probe nested in
+	 * another probe of the same recorder on the same thread, e.g. for the is_node call made by replace_node, records
+	 * nothing, so that only the public entry point is counted and its comparisons and visits include the nested call.
+	 */
+	class operation_probe {
+	 public:
 		/**
-		 * @brief Copy constructor. Constructs a graph as a copy of another graph.
+		 * Starts timing an operation.
 		 *
-		 * @param other The graph to copy from.
+		 * @param recorder The recorder to record the call into, which must outlive the probe.
+		 * @param op The operation.
 		 */
-		graph(graph const& other);
+		operation_probe(stats_recorder& recorder, graph_operation op) noexcept;
+
+		operation_probe(operation_probe const&) = delete;
+		auto operator=(operation_probe const&) -> operation_probe& = delete;
 
 		/**
-		 * @brief Move constructor. Constructs a graph by moving another graph.
-		 * @note Marked as noexcept because it only exchanges member variables and does not throw exceptions.
-		 *
-		 * @param other The graph to move from.
+		 * Records the call, whether the operation returned or threw, unless the probe is nested.
 		 */
-		graph(graph&& other) noexcept;
+		~operation_probe();
+
+	 private:
+		stats_recorder& recorder_;
+		// The recorder of the probe this one is nested in on the same thread, if any
+		stats_recorder const* enclosing_;
+		graph_operation op_;
+		std::uint64_t comparisons_;
+		std::uint64_t visits_;
+		std::chrono::steady_clock::time_point start_;
+	};
 
+	/**
+	 * Stands in for stats_recorder and operation_probe when instrumentation is compiled out. Every member is an
+	 * empty constexpr function, so nothing of the instrumentation remains in the compiled graph.
+	 */
+	class stats_disabled {
+	 public:
 		/**
-		 * @brief Destructor.
-		 * @note Defaulted.
+		 * Default constructor, standing in for a stats_recorder.
 		 */
-		~graph() = default;
+		constexpr stats_disabled() noexcept = default;
 
 		/**
-		 * @brief Copy assignment operator. Assigns the graph from another graph.
-		 *
-		 * @param other The graph to assign from.
-		 * @return A reference to the assigned graph.
+		 * Constructor standing in for an operation_probe.
 		 */
-		auto operator=(graph const& other) -> graph&;
+		constexpr stats_disabled(stats_disabled&, graph_operation) noexcept;
 
 		/**
-		 * @brief Move assignment operator. Moves the graph from another graph.
-		 * @note Marked as noexcept because it only exchanges member variables and does not throw exceptions.
+		 * @brief Returns a snapshot with every counter at zero.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
 		 *
-		 * @param other The graph to move from.
-		 * @return A reference to the assigned graph.
+		 * @return Empty statistics.
 		 */
-		auto operator=(graph&& other) noexcept -> graph&;
+		[[nodiscard]] constexpr auto snapshot() const noexcept -> graph_stats;
 
-		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-		//                             GRAPH MODIFIER FUNCTIONS                                                       //
-		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 		/**
-		 * @brief Inserts a node into the graph.
-		 * @note Not marked as noexcept because std::make_shared may throw.
-		 *
-		 * @param value The value of the node to insert.
-		 * @return True if the node was inserted, otherwise false.
+		 * @brief Does nothing.
 		 */
-		auto insert_node(N const& value) -> bool;
+		constexpr auto reset() noexcept -> void;
+	};
+
+	/**
+	 * The difference between two graphs, as computed by gdwg::diff. Removed edges whose source or destination is a
+	 * removed node are left out, as removing the node removes them. Every list is sorted in the order of the graph.
+	 */
+	template<typename N, typename E>
+	struct graph_delta {
+		struct edge_value {
+			N from;
+			N to;
+			std::optional<E> weight;
+
+			/**
+			 * @brief Compares two edges for equality.
+			 *
+			 * @return True if the nodes and weights are equal, otherwise false.
+			 */
+			[[nodiscard]] auto operator==(edge_value const&) const -> bool = default;
+		};
+
+		std::vector<N> added_nodes;
+		std::vector<N> removed_nodes;
+		std::vector<edge_value> added_edges;
+		std::vector<edge_value> removed_edges;
 
 		/**
-		 * @brief Inserts an edge into the graph.
-		 * @note Not marked as noexcept because it may throw exceptions if src or dst do not exist.
+		 * @brief Returns the number of changes in the delta.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Marked as noexcept because it only adds the sizes of the lists.
 		 *
-		 * @param src The source node of the edge.
-		 * @param dst The destination node of the edge.
-		 * @param weight The weight of the edge, optional.
-		 * @return True if the edge was inserted, otherwise false.
+		 * @return The number of added and removed nodes and edges.
 		 */
-		auto insert_edge(N const& src, N const& dst, std::optional<E> const& weight = std::nullopt) -> bool;
+		[[nodiscard]] auto size() const noexcept -> std::size_t;
 
 		/**
-		 * @brief Replaces an existing node with a new node.
-		 * @note Not marked as noexcept because it may throw exceptions if old_data does not exist.
+		 * @brief Checks if the delta changes nothing, i.e. if the graphs it was computed from are equal.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
 		 *
-		 * @param old_data The existing node to replace.
-		 * @param new_data The new node to replace the old one.
-		 * @return True if the node was replaced, otherwise false.
+		 * @return True if there are no changes, otherwise false.
 		 */
-		auto replace_node(N const& old_data, N const& new_data) -> bool;
+		[[nodiscard]] auto empty() const noexcept -> bool;
 
 		/**
-		 * @brief Merges an existing node into another node, replacing the old node.
-		 * @note Not marked as noexcept because it may throw exceptions if old_data or new_data do not exist.
+		 * @brief Compares two deltas for equality.
 		 *
-		 * @param old_data The existing node to merge.
-		 * @param new_data The node to merge the old one into.
+		 * @return True if every list is equal, otherwise false.
 		 */
-		auto merge_replace_node(N const& old_data, N const& new_data) -> void;
+		[[nodiscard]] auto operator==(graph_delta const&) const -> bool = default;
+	};
+
+	/**
+	 * The kinds of change reported to a mutation_sink.
+	 */
+	enum class mutation_kind : std::uint8_t {
+		insert_node,
+		insert_edge,
+		erase_node,
+		erase_edge,
+		replace_node,
+		merge_replace_node,
+		clear,
+	};
+
+	/**
+	 * A single change made to a graph. Replaying the events which are not cascaded, in order, through the matching
+	 * graph operations reproduces the graph.
+	 */
+	template<typename N, typename E>
+	struct mutation {
+		mutation_kind kind;
+		// The node, the source of an edge, or the old value of a replaced or merged node. Empty for clear.
+		std::optional<N> src;
+		// The destination of an edge, or the new value of a replaced or merged node.
+		std::optional<N> dst;
+		// The weight of an edge.
+		std::optional<E> weight;
+		// True for an edge removed because one of its nodes was erased. These follow the erase_node event, and with
+		// lazy erasure arrive when the graph is compacted.
+		bool cascaded = false;
 
 		/**
-		 * @brief Erases a node from the graph.
-		 * @note Not marked as noexcept because it may throw exceptions if value does not exist.
+		 * @brief Compares two events for equality.
 		 *
-		 * @param value The value of the node to erase.
-		 * @return True if the node was erased, otherwise false.
+		 * @return True if every field is equal, otherwise false.
 		 */
-		auto erase_node(N const& value) -> bool;
+		[[nodiscard]] auto operator==(mutation const&) const -> bool = default;
+	};
 
+	/**
+	 * Receives the changes made to a graph, on the thread making them. Sinks are called while the graph is being
+	 * modified, so they must not access the graph and should return quickly.
+	 */
+	template<typename N, typename E>
+	class mutation_sink {
+	 public:
 		/**
-		 * @brief Erases an edge from the graph.
-		 * @note Not marked as noexcept because it throws an exception if src or dst do not exist.
-		 *
-		 * Time complexity: O(log n) for error checking, O(e) for searching to erase. Totally O(log(n) + e).
-		 *
-		 * @param src The source node of the edge.
-		 * @param dst The destination node of the edge.
-		 * @param weight The weight of the edge, optional.
-		 * @return True if the edge was erased, otherwise false.
+		 * Virtual destructor, as sinks are owned through pointers to this interface.
 		 */
-		auto erase_edge(N const& src, N const& dst, std::optional<E> const& weight = std::nullopt) -> bool;
+		virtual ~mutation_sink() = default;
 
 		/**
-		 * @brief Erases an edge from the graph using an iterator.
-		 * @note Marked as noexcept because the erase operation only throws if the compare function throws, which is
-		 * noexcept.
-		 *
-		 * Time complexity: O(log(e)) for removing an element in a set.
+		 * @brief Receives a change made to the graph.
+		 * @note Marked as noexcept because the change has already been made and cannot be undone.
 		 *
-		 * @param i The iterator pointing to the edge to erase.
-		 * @return An iterator to the element following the erased one.
+		 * @param event The change.
 		 */
-		auto erase_edge(iterator const& i) noexcept -> iterator;
+		virtual auto on_mutation(mutation<N, E> const& event) noexcept -> void = 0;
 
 		/**
-		 * @brief Erases a range of edges from the graph.
-		 * @note Marked as noexcept because the erase operation only throws if the compare function throws, which is
-		 * noexcept.
-		 *
-		 * Time complexity: O(log(e) + d) for removing a range of elements in a set.
-		 *
-		 * @param i The iterator pointing to the first edge to erase.
-		 * @param s The iterator pointing to the element past the last edge to erase.
-		 * @return An iterator to the element following the last erased one.
+		 * @brief Called instead of on_mutation when an event could not be built, e.g. because copying a node threw.
+		 * @note Marked as noexcept because the change has already been made and cannot be undone.
 		 */
-		auto erase_edge(iterator const& i, iterator const& s) noexcept -> iterator;
+		virtual auto on_lost() noexcept -> void = 0;
+	};
 
+	/**
+	 * A bounded lock-free queue for exactly one producer thread and one consumer thread. The capacity is rounded up
+	 * to a power of two, and pushing into a full ring fails instead of waiting for the consumer.
+	 */
+	template<typename T>
+	class spsc_ring {
+	 public:
 		/**
-		 * @brief Clears all nodes and edges from the graph.
-		 * @note Marked as noexcept because it only clears the containers, which do not throw exceptions.
+		 * Constructs an empty ring.
 		 *
-		 * @return void.
+		 * @param capacity The minimum number of elements the ring can hold, at least 1.
 		 */
-		auto clear() noexcept -> void;
+		explicit spsc_ring(std::size_t capacity);
 
-		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-		//                            GRAPH ACCESSORS FUNCTIONS                                                       //
-		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 		/**
-		 * @brief Checks if a node exists in the graph.
-		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
-		 * Marked as noexcept because it only checks for the existence of a node in a set, which does not throw
-		 * exceptions.
+		 * @brief Appends a copy of an element. Must only be called by the producer.
 		 *
-		 * Time complexity: O(log n) for finding element in a set.
+		 * Time complexity: O(1).
 		 *
-		 * @param value The value of the node to check.
-		 * @return True if the node exists, otherwise false.
+		 * @param value The element to append.
+		 * @return True if the element was appended, false if the ring is full.
 		 */
-		[[nodiscard]] auto is_node(N const& value) const noexcept -> bool;
+		auto try_push(T const& value) -> bool;
 
 		/**
-		 * @brief Checks if the graph is empty.
-		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
-		 * Marked as noexcept because it only checks if the set of nodes is empty, which does not throw exceptions.
+		 * @brief Removes the oldest element. Must only be called by the consumer.
+		 * @note Marked as [[nodiscard]] because the element is lost if ignored.
 		 *
-		 * @return True if the graph is empty, otherwise false.
+		 * Time complexity: O(1).
+		 *
+		 * @return The oldest element, or std::nullopt if the ring is empty.
 		 */
-		[[nodiscard]] auto empty() const noexcept -> bool;
+		[[nodiscard]] auto try_pop() -> std::optional<T>;
 
 		/**
-		 * @brief Checks if two nodes are connected by an edge.
+		 * @brief Returns the number of elements in the ring, which may already be stale when called concurrently.
 		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
-		 * Not marked as noexcept because it throws an exception if src or dst do not exist.
 		 *
-		 * @param src The source node.
-		 * @param dst The destination node.
-		 * @return True if the nodes are connected, otherwise false.
+		 * @return The number of elements.
 		 */
-		[[nodiscard]] auto is_connected(N const& src, N const& dst) const -> bool;
+		[[nodiscard]] auto size() const noexcept -> std::size_t;
 
 		/**
-		 * @brief Returns a vector of all nodes in the graph.
+		 * @brief Returns the number of elements the ring can hold.
 		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
 		 *
-		 * Time complexity: O(n) for all nodes insertion.
-		 *
-		 * @return A vector of all nodes in the graph.
+		 * @return The capacity of the ring.
 		 */
-		[[nodiscard]] auto nodes() const -> std::vector<N>;
+		[[nodiscard]] auto capacity() const noexcept -> std::size_t;
 
+	 private:
+		// Keeps the indices written by the producer and the consumer on separate cache lines
+		static constexpr std::size_t cache_line = 64;
+
+		std::vector<std::optional<T>> slots_;
+		std::size_t mask_;
+		// Written by the consumer only
+		alignas(cache_line) std::atomic<std::size_t> head_;
+		// Written by the producer only
+		alignas(cache_line) std::atomic<std::size_t> tail_;
+	};
+
+	/**
+	 * A mutation_sink buffering the changes made to a graph in a spsc_ring, so that a consumer thread can follow the
+	 * graph incrementally without slowing down the writer. When the consumer falls behind and the ring is full, new
+	 * events are dropped and counted; a consumer seeing dropped events must rebuild its state from the graph.
+	 */
+	template<typename N, typename E>
+	class change_feed final : public mutation_sink<N, E> {
+	 public:
 		/**
-		 * @brief Returns a vector of all edges between two nodes.
-		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
-		 * Not marked as noexcept because it throws an exception if src or dst do not exist.
+		 * Constructs an empty feed.
 		 *
-		 * Time complexity: O(log n) for error checking, O(e) for insertion of edges. Totally O(log n + e).
+		 * @param capacity The minimum number of events buffered before events are dropped.
+		 */
+		explicit change_feed(std::size_t capacity);
+
+		/**
+		 * @brief Buffers a change. Called by the graph on the writer thread.
+		 * @note Marked as noexcept because a change which cannot be buffered is counted as dropped.
 		 *
-		 * @param src The source node.
-		 * @param dst The destination node.
-		 * @return A vector of unique pointers to all edges between the two nodes.
+		 * @param event The change.
 		 */
-		[[nodiscard]] auto edges(N const& src, N const& dst) const -> std::vector<std::unique_ptr<edge<N, E>>>;
+		auto on_mutation(mutation<N, E> const& event) noexcept -> void override;
 
 		/**
-		 * @brief Finds an edge in the graph.
+		 * @brief Counts a change which could not be built as dropped.
+		 */
+		auto on_lost() noexcept -> void override;
+
+		/**
+		 * @brief Removes the oldest buffered change. Must only be called by the consumer thread.
+		 * @note Marked as [[nodiscard]] because the event is lost if ignored.
+		 *
+		 * @return The oldest change, or std::nullopt if none is buffered.
+		 */
+		[[nodiscard]] auto poll() -> std::optional<mutation<N, E>>;
+
+		/**
+		 * @brief Passes every buffered change to a function, oldest first. Must only be called by the consumer thread.
+		 *
+		 * @param f The function to call with each change.
+		 * @return The number of changes passed to f.
+		 */
+		template<typename F>
+		requires std::invocable<F&, mutation<N, E>&&>
+		auto drain(F f) -> std::size_t;
+
+		/**
+		 * @brief Returns the number of changes dropped since the feed was created.
 		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
-		 * Marked as noexcept because it only performs search operations that do not throw exceptions.
 		 *
-		 * Time complexity: O(e), finding iterator by search over the iterator inside graph class.
+		 * @return The number of dropped changes.
+		 */
+		[[nodiscard]] auto dropped() const noexcept -> std::uint64_t;
+
+	 private:
+		spsc_ring<mutation<N, E>> ring_;
+		std::atomic<std::uint64_t> dropped_;
+	};
+
+	/**
+	 * A key type which can be used to look up nodes of type N without first constructing an N, e.g. std::string_view
+	 * or char const* for std::string nodes. Arithmetic keys of another type are excluded so that they keep converting
+	 * to N as before instead of being compared with mixed types.
+	 */
+	template<typename K, typename N>
+	concept node_key = std::same_as<std::remove_cvref_t<K>, N>
+	                   or (not std::is_arithmetic_v<std::remove_cvref_t<K>>
+	                       and requires(K const& key, N const& node) {
+		                       { node < key } -> std::convertible_to<bool>;
+		                       { key < node } -> std::convertible_to<bool>;
+	                       });
+
+	template<typename N, typename E>
+	class edge {
+	 public:
+		/**
+		 * @brief Prints the edge information as a string.
+		 * @note Marked as [[nodiscard]] because the string representation of the edge is important and should not be
+		 * ignored.
+		 *
+		 * @return A string representing the edge.
+		 */
+		[[nodiscard]] virtual auto print_edge() const -> std::string = 0;
+
+		/**
+		 * @brief Checks if the edge is weighted.
+		 * @note Marked as [[nodiscard]] because this information is critical for distinguishing between weighted and
+		 * unweighted edges. Marked as noexcept because it only returns a boolean value without throwing exceptions.
+		 *
+		 * @return True if the edge is weighted, otherwise false.
+		 */
+		[[nodiscard]] virtual auto is_weighted() const noexcept -> bool;
+
+		/**
+		 * @brief Gets the weight of the edge.
+		 * @note Marked as [[nodiscard]] because the weight is important and should not be ignored.
+		 * Marked as noexcept because it only accesses a member variable without throwing exceptions.
+		 *
+		 * @return An optional containing the weight if the edge is weighted, otherwise std::nullopt.
+		 */
+		[[nodiscard]] virtual auto get_weight() const noexcept -> std::optional<E>;
+
+		/**
+		 * @brief Gets the nodes of the edge.
+		 * @note Marked as [[nodiscard]] because the nodes are critical for edge identification.
+		 * Marked as noexcept because std::make_pair not throw exceptions.
+		 *
+		 * @return A pair of nodes representing the edge's source and destination.
+		 */
+		[[nodiscard]] virtual auto get_nodes() const noexcept -> std::pair<N, N>;
+
+		/**
+		 * @brief Checks if two edges are equal.
+		 * @note Marked as noexcept because it only compares member variables without throwing exceptions.
+		 *
+		 * @param other The edge to compare with.
+		 * @return True if the edges are equal, otherwise false.
+		 */
+		[[nodiscard]] virtual auto operator==(edge const& other) const noexcept -> bool;
+
+		/**
+		 * @brief Destructor.
+		 * @note Defaulted.
+		 */
+		virtual ~edge() = default;
+
+	 protected:
+		N src_;
+		N dst_;
+		std::optional<E> weight_;
+
+		friend class graph<N, E>;
+
+		/**
+		 * Default constructor.
+		 */
+		edge() = default;
+
+		/**
+		 * Copy and move constructor in default.
+		 */
+		edge(edge const&) = default;
+		edge(edge&&) noexcept = default;
+
+		/**
+		 * Copy and move assignment in default.
+		 * @return The instance after copy or move.
+		 */
+		auto operator=(edge const&) -> edge& = default;
+		auto operator=(edge&&) noexcept -> edge& = default;
+
+		/**
+		 * @brief Constructs an edge with the given source, destination, and weight.
+		 * @note Marked as noexcept because it only performs basic pointer assignments and does not perform any
+		 * operations that could throw exceptions.
 		 *
 		 * @param src The source node.
 		 * @param dst The destination node.
 		 * @param weight The weight of the edge, optional.
-		 * @return An iterator to the edge if found, otherwise end iterator.
 		 */
-		[[nodiscard]] auto
-		find(N const& src, N const& dst, std::optional<E> const& weight = std::nullopt) const noexcept -> iterator;
+		edge(N const& src, N const& dst, std::optional<E> const& weight = std::nullopt) noexcept;
 
 		/**
-		 * @brief Returns a vector of nodes connected to the given source node.
-		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
-		 * Not marked as noexcept because it throws an exception if src does not exist.
+		 * @brief Clones the edge, returning a unique pointer to the new edge.
+		 * @note Marked as [[nodiscard]] because the cloned pointer is important and should not be ignored.
 		 *
-		 * Time complexity: O(log(n)) for error check. O(e) for iterating over the graph class to get the dst nodes and
-		 * push to vector and O(e) to remove duplicate element. Totally O(log(n)+e).
+		 * @return A unique pointer to the cloned edge.
+		 */
+		[[nodiscard]] virtual auto clone_ptr() const -> std::unique_ptr<edge> = 0;
+
+		/**
+		 * @brief Sets the source and destination nodes of the edge.
+		 * @note Marked as noexcept because it only performs basic pointer assignments and does not perform any
+		 * operations that could throw exceptions.
 		 *
 		 * @param src The source node.
-		 * @return A vector of nodes connected to the source node.
+		 * @param dst The destination node.
 		 */
-		[[nodiscard]] auto connections(N const& src) const -> std::vector<N>;
+		virtual auto set_nodes(N const& src, N const& dst) noexcept -> void;
 
-		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-		//                               GRAPH ITERATOR ACCESS FUNCTIONS                                              //
-		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 		/**
-		 * @brief Returns an iterator to the beginning of the edges set.
-		 * @note Marked as [[nodiscard]] because the iterator is important and should not be ignored.
-		 * Marked as noexcept because it only returns an iterator to the beginning of the set, which does not throw
-		 * exceptions.
+		 * @brief Compares two edges using the three-way comparison operator.
+		 * @note Marked as noexcept because it only performs comparisons and does not perform any operations that could
+		 * throw exceptions.
 		 *
-		 * @return An iterator to the beginning of the edges set.
+		 * @param other The other edge to compare.
+		 * @return A std::strong_ordering result of the comparison.
 		 */
-		[[nodiscard]] auto begin() const noexcept -> iterator;
+		virtual auto edge_comp(edge const& other) const noexcept -> std::strong_ordering;
 
 		/**
-		 * @brief Returns an iterator to the end of the edges set.
-		 * @note Marked as [[nodiscard]] because the iterator is important and should not be ignored.
-		 * Marked as noexcept because it only returns an iterator to the end of the set, which does not throw
-		 * exceptions.
+		 * @brief Compares two optional weights in the order used for edges, unweighted edges first.
+		 * @note Marked as noexcept because it only performs comparisons and does not perform any operations that could
+		 * throw exceptions.
 		 *
-		 * @return An iterator to the end of the edges set.
+		 * @param lhs The weight of the left-hand side edge.
+		 * @param rhs The weight of the right-hand side edge.
+		 * @return A std::strong_ordering result of the comparison.
 		 */
-		[[nodiscard]] auto end() const noexcept -> iterator;
+		static auto weight_comp(std::optional<E> const& lhs, std::optional<E> const& rhs) noexcept
+		    -> std::strong_ordering;
+	};
 
-		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-		//                                  GRAPH OTHER FUNCTIONS                                                     //
-		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	template<typename N, typename E>
+	class weighted_edge final : public edge<N, E> {
+	 public:
 		/**
-		 * @brief Compares two graphs for equality.
-		 * @note Marked as [[nodiscard]] because the result of the comparison is important and should not be ignored.
-		 * Marked as noexcept because it does not perform any operations that can throw exceptions.
-		 *
-		 * Time complexity: O(n + e) where it will compare all nodes and edges.
+		 * @brief Prints the weighted edge information as a string.
+		 * @note Marked as [[nodiscard]] because the string representation of the edge is important and should not be
+		 * ignored. Not marked as noexcept because constructing a std::string may throw exceptions.
 		 *
-		 * @param other The graph to compare with.
-		 * @return True if the graphs are equal, otherwise false.
+		 * @return A string representing the weighted edge.
 		 */
-		[[nodiscard]] auto operator==(graph const& other) const noexcept -> bool;
+		[[nodiscard]] auto print_edge() const -> std::string override;
 
 		/**
-		 * @brief Outputs the graph to the given output stream.
-		 * @note Not marked as noexcept because streaming to std::ostream can throw.
+		 * @brief Constructs a weighted edge with the given source, destination, and weight.
+		 * @note Marked as noexcept because it only performs basic pointer assignments and does not perform any
+		 * operations that could throw exceptions.
 		 *
-		 * @tparam T The type of the nodes in the graph.
-		 * @tparam U The type of the edges in the graph.
-		 * @param os The output stream to write to.
-		 * @param g The graph to output.
-		 * @return The output stream.
+		 * @param src The source node.
+		 * @param dst The destination node.
+		 * @param weight The weight of the edge, optional.
 		 */
-		template<typename T, typename U>
-		friend auto operator<<(std::ostream& os, graph<T, U> const& g) -> std::ostream&;
+		weighted_edge(N const& src, N const& dst, E const& weight) noexcept;
 
 	 private:
-		type_nodes_set nodes_;
-		edges_set edges_;
-
 		/**
-		 * @brief Finds a node in the graph and returns a shared pointer to it.
-		 * @note Marked as [[nodiscard]] because the returned pointer is important and should not be ignored.
-		 * Marked as noexcept because it only performs a lookup and pointer operations which do not throw exceptions.
+		 * @brief Clones the weighted edge, returning a unique pointer to the new edge.
+		 * @note Marked as [[nodiscard]] because the cloned pointer is important and should not be ignored.
+		 * Not marked as noexcept because std::make_unique may throw exceptions.
 		 *
-		 * @param value The value of the node to find.
-		 * @return A shared pointer to the node if found, otherwise nullptr.
+		 * @return A unique pointer to the cloned weighted edge.
 		 */
-		[[nodiscard]] auto find_node_ptr(N const& value) const noexcept -> std::shared_ptr<N>;
+		[[nodiscard]] auto clone_ptr() const -> std::unique_ptr<edge<N, E>> override;
+		friend class graph<N, E>;
+	};
 
+	template<typename N, typename E>
+	class unweighted_edge final : public edge<N, E> {
+	 public:
 		/**
-		 * @brief Updates the source or destination of an edge to a new node.
-		 * @note Marked as noexcept because it does not perform any operations that can throw exceptions.
+		 * @brief Prints the unweighted edge information as a string.
+		 * @note Marked as [[nodiscard]] because the string representation of the edge is important and should not be
+		 * ignored. Not marked as noexcept because constructing a std::string may throw exceptions.
 		 *
-		 * @param src_ptr The shared pointer to the old node.
-		 * @param dst_ptr The shared pointer to the new node.
-		 * @return void
+		 * @return A string representing the unweighted edge.
 		 */
-		auto update_node(std::shared_ptr<N> const& src_ptr, std::shared_ptr<N> const& dst_ptr) noexcept -> void;
+		[[nodiscard]] auto print_edge() const -> std::string override;
 
 		/**
-		 * @brief Performs a deep copy of the given graph into the current graph instance.
+		 * @brief Constructs an unweighted edge with the given source and destination.
+		 * @note Marked as noexcept because it not throw exceptions.
 		 *
-		 * This method will copy all nodes and edges from the provided graph into the
-		 * current graph instance, ensuring that the current graph becomes an exact
-		 * duplicate of the other graph. Any existing nodes and edges in the current
-		 * graph will be replaced.
+		 * @param src The source node.
+		 * @param dst The destination node.
+		 */
+		unweighted_edge(N const& src, N const& dst) noexcept;
+
+	 private:
+		/**
+		 * @brief Clones the unweighted edge, returning a unique pointer to the new edge.
+		 * @note Marked as [[nodiscard]] because the cloned pointer is important and should not be ignored.
+		 * Not marked as noexcept because std::make_unique may throw exceptions.
 		 *
-		 * @param other The graph to copy from.
-		 * @return void
+		 * @return A unique pointer to the cloned unweighted edge.
 		 */
-		auto deep_copy(graph const& other) -> void;
+		[[nodiscard]] auto clone_ptr() const -> std::unique_ptr<edge<N, E>> override;
+		friend class graph<N, E>;
 	};
-	// Redeclaration of graph friend function operator<<
-	template<typename T, typename U>
-	auto operator<<(std::ostream& os, graph<T, U> const& g) -> std::ostream&;
-} // namespace gdwg
-
-#endif // GDWG_GRAPH_H
 
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-//                             COMPARE SHARED PTR FUNCTIONS                                                           //
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-template<typename N, typename E>
-auto gdwg::graph<N, E>::compare_shared_ptr::operator()(std::shared_ptr<N> const& lhs,
-                                                       std::shared_ptr<N> const& rhs) const noexcept -> bool {
-	return *lhs < *rhs;
+	template<typename N, typename E>
+	class graph {
+		/**
+		 * The private part using for the member which are store in the graph class.
+		 * Using to short name of the long type name, and comparator for the set use to sort and find.
+		 * And the private iterator used only for the class graph.
+		 */
+		struct compare_shared_ptr {
+			using is_transparent = std::true_type;
+
+			/**
+			 * @brief Compares two shared_ptr<N> instances lexicographically.
+			 * @note This function is marked as noexcept because it doesn't perform any operations that could throw
+			 * exceptions. Dereferencing a shared_ptr is a safe operation that doesn't throw exceptions.
+			 *
+			 * @param lhs The left-hand side shared_ptr<N> for comparison.
+			 * @param rhs The right-hand side shared_ptr<N> for comparison.
+			 * @return A boolean result of the comparison.
+			 */
+			auto operator()(std::shared_ptr<N> const& lhs, std::shared_ptr<N> const& rhs) const noexcept -> bool;
+
+			/**
+			 * @brief Compares a shared_ptr<N> instance with an N instance lexicographically.
+			 * @note This function is marked as noexcept because it doesn't perform any operations that could throw
+			 * exceptions. Dereferencing a shared_ptr is a safe operation that doesn't throw exceptions.
+			 *
+			 * @param lhs The left-hand side shared_ptr<N> for comparison.
+			 * @param rhs The right-hand side N for comparison.
+			 * @return A boolean result of the comparison.
+			 */
+			auto operator()(std::shared_ptr<N> const& lhs, N const& rhs) const noexcept -> bool;
+
+			/**
+			 * @brief Compares an N instance with a shared_ptr<N> instance lexicographically.
+			 * @note This function is marked as noexcept because it doesn't perform any operations that could throw
+			 * exceptions. Dereferencing a shared_ptr is a safe operation that doesn't throw exceptions.
+			 *
+			 * @param lhs The left-hand side N for comparison.
+			 * @param rhs The right-hand side shared_ptr<N> for comparison.
+			 * @return A boolean result of the comparison.
+			 */
+			auto operator()(N const& lhs, std::shared_ptr<N> const& rhs) const noexcept -> bool;
+
+			/**
+			 * @brief Compares a shared_ptr<N> instance with a heterogeneous key lexicographically.
+			 * @note Allows lookups by e.g. std::string_view without constructing a temporary N.
+			 *
+			 * @param lhs The left-hand side shared_ptr<N> for comparison.
+			 * @param rhs The right-hand side key for comparison.
+			 * @return A boolean result of the comparison.
+			 */
+			template<node_key<N> K>
+			auto operator()(std::shared_ptr<N> const& lhs, K const& rhs) const noexcept -> bool;
+
+			/**
+			 * @brief Compares a heterogeneous key with a shared_ptr<N> instance lexicographically.
+			 * @note Allows lookups by e.g. std::string_view without constructing a temporary N.
+			 *
+			 * @param lhs The left-hand side key for comparison.
+			 * @param rhs The right-hand side shared_ptr<N> for comparison.
+			 * @return A boolean result of the comparison.
+			 */
+			template<node_key<N> K>
+			auto operator()(K const& lhs, std::shared_ptr<N> const& rhs) const noexcept -> bool;
+		};
+
+		// Using type for storing edge with src, dst as the tuple in graph class.
+		using edge_tuple = std::tuple<std::shared_ptr<N>, std::shared_ptr<N>, std::shared_ptr<edge<N, E>>>;
+
+		// Lookup key for an edge between two stored nodes, ordered like the edge_tuple it matches.
+		struct edge_key {
+			N const* src;
+			N const* dst;
+			std::optional<E> const* weight;
+		};
+
+		struct compare_edges_set {
+			using is_transparent = std::true_type;
+
+			/**
+			 * @brief Compares two edge_tuple<N, E> instances lexicographically based on their nodes and edges.
+			 * @note This function is marked as noexcept because it doesn't perform any operations that could throw
+			 * exceptions. Dereferencing a shared_ptr is a safe operation that doesn't throw exceptions.
+			 *
+			 * @param lhs The left-hand side edge_tuple<N, E> for comparison.
+			 * @param rhs The right-hand side edge_tuple<N, E> for comparison.
+			 * @return A boolean result of the comparison.
+			 */
+			auto operator()(edge_tuple const& lhs, edge_tuple const& rhs) const noexcept -> bool;
+
+			/**
+			 * @brief Compares an edge_tuple<N, E> with an edge_key, allowing edges to be looked up without allocating.
+			 * @note This function is marked as noexcept because it only performs comparisons.
+			 *
+			 * @param lhs The left-hand side edge_tuple<N, E> for comparison.
+			 * @param rhs The right-hand side edge_key for comparison.
+			 * @return A boolean result of the comparison.
+			 */
+			auto operator()(edge_tuple const& lhs, edge_key const& rhs) const noexcept -> bool;
+
+			/**
+			 * @brief Compares an edge_key with an edge_tuple<N, E>, allowing edges to be looked up without allocating.
+			 * @note This function is marked as noexcept because it only performs comparisons.
+			 *
+			 * @param lhs The left-hand side edge_key for comparison.
+			 * @param rhs The right-hand side edge_tuple<N, E> for comparison.
+			 * @return A boolean result of the comparison.
+			 */
+			auto operator()(edge_key const& lhs, edge_tuple const& rhs) const noexcept -> bool;
+
+		 private:
+			compare_shared_ptr comp_shared_node_;
+
+			/**
+			 * @brief Three-way compares the edge stored in a tuple with an edge_key.
+			 *
+			 * @param lhs The edge_tuple<N, E> to compare.
+			 * @param rhs The edge_key to compare.
+			 * @return A std::strong_ordering result of the comparison.
+			 */
+			static auto key_comp(edge_tuple const& lhs, edge_key const& rhs) noexcept -> std::strong_ordering;
+		};
+
+		// Member type of graph, define in private for using at some functions.
+		using type_nodes_set = std::set<std::shared_ptr<N>, compare_shared_ptr, pool_allocator<std::shared_ptr<N>>>;
+		using edges_set = std::set<edge_tuple, compare_edges_set, pool_allocator<edge_tuple>>;
+
+		class iter {
+		 public:
+			using value_type = struct {
+				N from;
+				N to;
+				std::optional<E> weight;
+			};
+			using reference = value_type;
+			using pointer = void;
+			using difference_type = std::ptrdiff_t;
+			using iterator_category = std::bidirectional_iterator_tag;
+
+			/**
+			 * Iterator default constructor
+			 */
+			iter() = default;
+
+			/**
+			 * @brief Dereferences the iterator to access the current edge.
+			 * @note Marked as [[nodiscard]] because the dereferenced value is important and should not be ignored.
+			 * Marked as noexcept because it only involves dereferencing smart pointers and copying values, which do not
+			 * throw exceptions.
+			 *
+			 * @return A reference to the current edge value.
+			 */
+			[[nodiscard]] auto operator*() const noexcept -> reference;
+
+			/**
+			 * @brief Advances the iterator to the next position (pre-increment).
+			 * @note Marked as noexcept because it only increments the internal iterator, which does not throw
+			 * exceptions.
+			 *
+			 * @return A reference to the incremented iterator.
+			 */
+			auto operator++() noexcept -> iter&;
+
+			/**
+			 * @brief Advances the iterator to the next position (post-increment).
+			 * @note Marked as noexcept because it only increments the internal iterator, which does not throw
+			 * exceptions.
+			 *
+			 * @return A copy of the iterator before incrementing.
+			 */
+			auto operator++(int) noexcept -> iter;
+
+			/**
+			 * @brief Moves the iterator to the previous position (pre-decrement).
+			 * @note Marked as noexcept because it only decrements the internal iterator, which does not throw
+			 * exceptions.
+			 *
+			 * @return A reference to the decremented iterator.
+			 */
+			auto operator--() noexcept -> iter&;
+
+			/**
+			 * @brief Moves the iterator to the previous position (post-decrement).
+			 * @note Marked as noexcept because it only decrements the internal iterator, which does not throw
+			 * exceptions.
+			 *
+			 * @return A copy of the iterator before decrementing.
+			 */
+			auto operator--(int) noexcept -> iter;
+
+			/**
+			 * @brief Compares two iterators for equality.
+			 * @note Marked as noexcept because it only compares internal iterators, which do not throw exceptions.
+			 *
+			 * @param other The iterator to compare with.
+			 * @return True if the iterators are equal, otherwise false.
+			 */
+			auto operator==(iter const& other) const noexcept -> bool;
+
+		 private:
+			using set_iter = typename edges_set::iterator;
+
+			set_iter set_it_;
+			// The graph the iterator belongs to, used to skip edges of lazily erased nodes.
+			graph const* graph_ = nullptr;
+
+			/**
+			 * @brief Constructs an iterator from a set iterator.
+			 * @note Marked as noexcept because it only initializes the internal iterator, which does not throw
+			 * exceptions.
+			 *
+			 * @param set_it The set iterator to initialize with.
+			 * @param g The graph the set iterator belongs to.
+			 */
+			iter(set_iter const& set_it, graph const* g) noexcept;
+
+			/**
+			 * @brief Returns the base iterator.
+			 * @note Marked as [[nodiscard]] because the base iterator is important and should not be ignored.
+			 * Marked as noexcept because it only returns the internal iterator, which does not throw exceptions.
+			 *
+			 * @return The base set iterator.
+			 */
+			[[nodiscard]] auto base() const noexcept -> set_iter;
+
+			friend class graph;
+		};
+
+	 public:
+		using iterator = iter;
+		/**
+		 * @brief Default constructor. Constructs an empty graph.
+		 * @note Marked as noexcept because it only initializes member variables and does not throw exceptions.
+		 */
+		graph() noexcept;
+
+		/**
+		 * @brief Constructs a graph from an initializer list of nodes.
+		 * @note Not marked as noexcept because it may perform operations that could throw exceptions.
+		 *
+		 * @param il The initializer list of nodes to construct the graph with.
+		 */
+		graph(std::initializer_list<N> const& il);
+
+		/**
+		 * @brief Constructs a graph from a range of nodes.
+		 * @note Not marked as noexcept because it may perform operations that could throw exceptions by
+		 * std::make_shared.
+		 *
+		 * @tparam InputIt The type of the input iterator.
+		 * @param first The beginning of the range of nodes.
+		 * @param last The end of the range of nodes.
+		 */
+		template<typename InputIt>
+		graph(InputIt const& first, InputIt const& last);
+
+		/**
+		 * @brief Copy constructor. Constructs a graph as a copy of another graph.
+		 *
+		 * @param other The graph to copy from.
+		 */
+		graph(graph const& other);
+
+		/**
+		 * @brief Move constructor. Constructs a graph by moving another graph.
+		 * @note Marked as noexcept because it only exchanges member variables and does not throw exceptions.
+		 *
+		 * @param other The graph to move from.
+		 */
+		graph(graph&& other) noexcept;
+
+		/**
+		 * @brief Destructor.
+		 * @note Defaulted.
+		 */
+		~graph() = default;
+
+		/**
+		 * @brief Copy assignment operator. Assigns the graph from another graph.
+		 *
+		 * @param other The graph to assign from.
+		 * @return A reference to the assigned graph.
+		 */
+		auto operator=(graph const& other) -> graph&;
+
+		/**
+		 * @brief Move assignment operator. Moves the graph from another graph.
+		 * @note Marked as noexcept because it only exchanges member variables and does not throw exceptions.
+		 *
+		 * @param other The graph to move from.
+		 * @return A reference to the assigned graph.
+		 */
+		auto operator=(graph&& other) noexcept -> graph&;
+
+		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		//                             GRAPH MODIFIER FUNCTIONS                                                       //
+		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/**
+		 * @brief Inserts a node into the graph.
+		 * @note Not marked as noexcept because std::make_shared may throw.
+		 *
+		 * @param value The value of the node to insert.
+		 * @return True if the node was inserted, otherwise false.
+		 */
+		auto insert_node(N const& value) -> bool;
+
+		/**
+		 * @brief Inserts a node into the graph by moving the value into the node storage.
+		 * @note Not marked as noexcept because std::make_shared may throw.
+		 *
+		 * @param value The value of the node to insert.
+		 * @return True if the node was inserted, otherwise false.
+		 */
+		auto insert_node(N&& value) -> bool;
+
+		/**
+		 * @brief Inserts an edge into the graph.
+		 * @note Not marked as noexcept because it may throw exceptions if src or dst do not exist.
+		 *
+		 * @param src The source node of the edge.
+		 * @param dst The destination node of the edge.
+		 * @param weight The weight of the edge, optional.
+		 * @return True if the edge was inserted, otherwise false.
+		 */
+		auto insert_edge(N const& src, N const& dst, std::optional<E> const& weight = std::nullopt) -> bool;
+
+		/**
+		 * @brief Inserts an edge into the graph, looking up src and dst by heterogeneous keys.
+		 * @note Not marked as noexcept because it may throw exceptions if src or dst do not exist.
+		 *
+		 * @param src The key of the source node of the edge.
+		 * @param dst The key of the destination node of the edge.
+		 * @param weight The weight of the edge, optional.
+		 * @return True if the edge was inserted, otherwise false.
+		 */
+		template<node_key<N> Src, node_key<N> Dst>
+		auto insert_edge(Src const& src, Dst const& dst, std::optional<E> const& weight = std::nullopt) -> bool;
+
+		/**
+		 * @brief Replaces an existing node with a new node.
+		 * @note Not marked as noexcept because it may throw exceptions if old_data does not exist.
+		 *
+		 * @param old_data The existing node to replace.
+		 * @param new_data The new node to replace the old one.
+		 * @return True if the node was replaced, otherwise false.
+		 */
+		auto replace_node(N const& old_data, N const& new_data) -> bool;
+
+		/**
+		 * @brief Replaces an existing node with a new node, moving the new value into the node storage.
+		 * @note Not marked as noexcept because it may throw exceptions if old_data does not exist.
+		 *
+		 * @param old_data The existing node to replace.
+		 * @param new_data The new node to replace the old one.
+		 * @return True if the node was replaced, otherwise false.
+		 */
+		auto replace_node(N const& old_data, N&& new_data) -> bool;
+
+		/**
+		 * @brief Merges an existing node into another node, replacing the old node.
+		 * @note Not marked as noexcept because it may throw exceptions if old_data or new_data do not exist.
+		 *
+		 * @param old_data The existing node to merge.
+		 * @param new_data The node to merge the old one into.
+		 */
+		auto merge_replace_node(N const& old_data, N const& new_data) -> void;
+
+		/**
+		 * @brief Erases a node from the graph.
+		 * @note Not marked as noexcept because it may throw exceptions if value does not exist.
+		 *
+		 * Time complexity: O(log n + e) for erasing the node and sweeping its edges. With lazy erase enabled, the
+		 * node is tombstoned in O(log n) and its edges are skipped until compact() removes them.
+		 *
+		 * @param value The value of the node to erase.
+		 * @return True if the node was erased, otherwise false.
+		 */
+		auto erase_node(N const& value) -> bool;
+
+		/**
+		 * @brief Erases a node from the graph, looking it up by a heterogeneous key.
+		 *
+		 * @param value The key of the node to erase.
+		 * @return True if the node was erased, otherwise false.
+		 */
+		template<node_key<N> K>
+		auto erase_node(K const& value) -> bool;
+
+		/**
+		 * @brief Erases an edge from the graph.
+		 * @note Not marked as noexcept because it throws an exception if src or dst do not exist.
+		 *
+		 * Time complexity: O(log n) for error checking, O(log e) for searching to erase. Totally O(log n + log e).
+		 *
+		 * @param src The source node of the edge.
+		 * @param dst The destination node of the edge.
+		 * @param weight The weight of the edge, optional.
+		 * @return True if the edge was erased, otherwise false.
+		 */
+		auto erase_edge(N const& src, N const& dst, std::optional<E> const& weight = std::nullopt) -> bool;
+
+		/**
+		 * @brief Erases an edge from the graph, looking up src and dst by heterogeneous keys.
+		 * @note Not marked as noexcept because it throws an exception if src or dst do not exist.
+		 *
+		 * @param src The key of the source node of the edge.
+		 * @param dst The key of the destination node of the edge.
+		 * @param weight The weight of the edge, optional.
+		 * @return True if the edge was erased, otherwise false.
+		 */
+		template<node_key<N> Src, node_key<N> Dst>
+		auto erase_edge(Src const& src, Dst const& dst, std::optional<E> const& weight = std::nullopt) -> bool;
+
+		/**
+		 * @brief Erases an edge from the graph using an iterator.
+		 * @note Marked as noexcept because the erase operation only throws if the compare function throws, which is
+		 * noexcept.
+		 *
+		 * Time complexity: O(log(e)) for removing an element in a set.
+		 *
+		 * @param i The iterator pointing to the edge to erase.
+		 * @return An iterator to the element following the erased one.
+		 */
+		auto erase_edge(iterator const& i) noexcept -> iterator;
+
+		/**
+		 * @brief Erases a range of edges from the graph.
+		 * @note Marked as noexcept because the erase operation only throws if the compare function throws, which is
+		 * noexcept.
+		 *
+		 * Time complexity: O(log(e) + d) for removing a range of elements in a set.
+		 *
+		 * @param i The iterator pointing to the first edge to erase.
+		 * @param s The iterator pointing to the element past the last edge to erase.
+		 * @return An iterator to the element following the last erased one.
+		 */
+		auto erase_edge(iterator const& i, iterator const& s) noexcept -> iterator;
+
+		/**
+		 * @brief Erases a batch of nodes and all of their edges from the graph.
+		 * @note Not marked as noexcept because collecting the doomed nodes may throw std::bad_alloc.
+		 *
+		 * Values which are not nodes of the graph are ignored, as they are by erase_node.
+		 *
+		 * Time complexity: O(k log n) for erasing the nodes, O(e) for one sweep over the edges. Totally
+		 * O(k log n + e), instead of O(k * e) for k calls to erase_node.
+		 *
+		 * @param values The range of node values (or node keys) to erase.
+		 * @return The number of nodes erased.
+		 */
+		template<std::ranges::input_range R>
+		requires node_key<std::ranges::range_value_t<R>, N>
+		auto erase_nodes(R&& values) -> std::size_t;
+
+		/**
+		 * @brief Erases every edge for which the predicate returns true.
+		 * @note Not marked as noexcept because the predicate may throw.
+		 *
+		 * Time complexity: O(e), one pass over the edges.
+		 *
+		 * @param pred A predicate invoked with the source node, destination node and weight of each edge.
+		 * @return The number of edges erased.
+		 */
+		template<typename Pred>
+		requires std::predicate<Pred&, N const&, N const&, std::optional<E> const&>
+		auto erase_edges_if(Pred pred) -> std::size_t;
+
+		/**
+		 * @brief Clears all nodes and edges from the graph.
+		 * @note Marked as noexcept because it only clears the containers, which do not throw exceptions.
+		 *
+		 * @return void.
+		 */
+		auto clear() noexcept -> void;
+
+		/**
+		 * @brief Pre-allocates storage for the given total number of nodes and edges.
+		 * @note Not marked as noexcept because allocating the storage may throw std::bad_alloc.
+		 *
+		 * The first call moves the graph onto a node_pool, so that nodes, edges and their tree nodes are carved out of
+		 * one large chunk instead of being allocated individually. Later calls only grow the pool.
+		 *
+		 * Time complexity: O(n log n + e) for the first call on a non-empty graph, O(1) otherwise.
+		 *
+		 * @param node_count The number of nodes the graph is expected to hold.
+		 * @param edge_count The number of edges the graph is expected to hold.
+		 */
+		auto reserve(std::size_t node_count, std::size_t edge_count) -> void;
+
+		/**
+		 * @brief Releases storage which is no longer used by any node or edge.
+		 * @note Not marked as noexcept because rebuilding the storage may throw std::bad_alloc.
+		 *
+		 * Rebuilds a pooled graph into a pool sized exactly for its current contents. A graph which never reserved
+		 * storage allocates its nodes and edges individually, so it has nothing to release.
+		 *
+		 * Time complexity: O(n log n + e) for rebuilding a pooled graph, O(1) otherwise.
+		 */
+		auto shrink_to_fit() -> void;
+
+		/**
+		 * @brief Returns the number of bytes reserved for nodes and edges, whether they are in use or not.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Marked as noexcept because the capacity of the pool is stored.
+		 *
+		 * Time complexity: O(1).
+		 *
+		 * @return The capacity of the pool the graph allocates from, or 0 if it never reserved storage.
+		 */
+		[[nodiscard]] auto reserved_bytes() const noexcept -> std::size_t;
+
+		/**
+		 * @brief Enables or disables lazy erasing of nodes.
+		 * @note Marked as noexcept because it only sets a flag, and compacts the graph when disabling.
+		 *
+		 * With lazy erase enabled, erase_node only moves the node into a tombstone set instead of sweeping all
+		 * edges. Edges of tombstoned nodes are skipped by iteration, find and the accessors, so every observable
+		 * result is the same as with eager erasing, until compact() physically removes them.
+		 * Iterators obtained from a graph before it is moved from do not skip the tombstones moved with it.
+		 *
+		 * @param enabled True to defer the edge sweep of erase_node, false to compact and erase eagerly again.
+		 */
+		auto set_lazy_erase(bool enabled) noexcept -> void;
+
+		/**
+		 * @brief Checks if lazy erasing of nodes is enabled.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 *
+		 * @return True if erase_node tombstones nodes, otherwise false.
+		 */
+		[[nodiscard]] auto lazy_erase() const noexcept -> bool;
+
+		/**
+		 * @brief Returns the number of erased nodes whose edges have not been compacted yet.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 *
+		 * @return The number of tombstoned nodes.
+		 */
+		[[nodiscard]] auto tombstones() const noexcept -> std::size_t;
+
+		/**
+		 * @brief Physically removes the edges of all tombstoned nodes.
+		 * @note Marked as noexcept because erasing from a set and destroying nodes do not throw.
+		 *
+		 * Time complexity: O(e log t) for one sweep over the edges, where t is the number of tombstones.
+		 */
+		auto compact() noexcept -> void;
+
+		/**
+		 * The compacted edges of a graph, built on a background thread by compact_async and swapped in by
+		 * compact(pending_compaction).
+		 */
+		class pending_compaction {
+		 public:
+			/**
+			 * @brief Returns whether the background thread has finished building the compacted edges.
+			 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+			 *
+			 * @return True if compact(pending_compaction) will not wait, otherwise false.
+			 */
+			[[nodiscard]] auto ready() const -> bool;
+
+		 private:
+			friend class graph;
+
+			struct result_type {
+				edges_set edges;
+				// The edges left out, reported to the sinks once the result is swapped in.
+				std::vector<edge_tuple> erased;
+				graph_fingerprint erased_fingerprint;
+			};
+
+			std::future<result_type> result_;
+			// The version of the graph the snapshot was taken from.
+			std::uint64_t version_ = 0;
+		};
+
+		/**
+		 * @brief Builds the compacted edge set on a background thread, from a snapshot of the edges and tombstones.
+		 * The graph stays usable in the meantime, and is left unchanged until the result is passed to
+		 * compact(pending_compaction).
+		 * @note Marked as [[nodiscard]] because discarding the result wastes the compaction.
+		 * Not marked as noexcept because taking the snapshot may throw std::bad_alloc and starting the thread may
+		 * throw std::system_error.
+		 *
+		 * Time complexity: O(e) on the calling thread to copy the edges, and O(e) on the background thread.
+		 *
+		 * @return The pending compaction.
+		 */
+		[[nodiscard]] auto compact_async() const -> pending_compaction;
+
+		/**
+		 * @brief Waits for a compaction started by compact_async and swaps its edges in. If this graph has been
+		 * modified since the snapshot, or the compaction failed, the graph is compacted with compact() instead.
+		 * @note Marked as noexcept because every failure falls back to compact().
+		 *
+		 * Time complexity: O(d) to report the d erased edges, or that of compact() when falling back.
+		 *
+		 * @param pending The compaction returned by compact_async.
+		 */
+		auto compact(pending_compaction pending) noexcept -> void;
+
+		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		//                            GRAPH ACCESSORS FUNCTIONS                                                       //
+		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/**
+		 * @brief Checks if a node exists in the graph.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Marked as noexcept because it only checks for the existence of a node in a set, which does not throw
+		 * exceptions.
+		 *
+		 * Time complexity: O(log n) for finding element in a set.
+		 *
+		 * @param value The value of the node to check.
+		 * @return True if the node exists, otherwise false.
+		 */
+		[[nodiscard]] auto is_node(N const& value) const noexcept -> bool;
+
+		/**
+		 * @brief Checks if a node exists in the graph, looking it up by a heterogeneous key.
+		 * @note Never constructs an N, e.g. g.is_node("abc"sv) does not allocate for std::string nodes.
+		 *
+		 * Time complexity: O(log n) for finding element in a set.
+		 *
+		 * @param value The key of the node to check.
+		 * @return True if the node exists, otherwise false.
+		 */
+		template<node_key<N> K>
+		[[nodiscard]] auto is_node(K const& value) const noexcept -> bool;
+
+		/**
+		 * @brief Checks if the graph is empty.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Marked as noexcept because it only checks if the set of nodes is empty, which does not throw exceptions.
+		 *
+		 * @return True if the graph is empty, otherwise false.
+		 */
+		[[nodiscard]] auto empty() const noexcept -> bool;
+
+		/**
+		 * @brief Returns the number of nodes.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Marked as noexcept because the set of nodes stores its size.
+		 *
+		 * Time complexity: O(1).
+		 *
+		 * @return The number of nodes.
+		 */
+		[[nodiscard]] auto node_count() const noexcept -> std::size_t;
+
+		/**
+		 * @brief Returns the number of edges.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Marked as noexcept because it only reads or counts the set of edges.
+		 *
+		 * Time complexity: O(1), or O(e) while lazily erased nodes leave edges behind until they are compacted.
+		 *
+		 * @return The number of edges.
+		 */
+		[[nodiscard]] auto edge_count() const noexcept -> std::size_t;
+
+		/**
+		 * @brief Checks if two nodes are connected by an edge.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Not marked as noexcept because it throws an exception if src or dst do not exist.
+		 *
+		 * Time complexity: O(log n + log e), finding the first edge between the nodes in the ordered set.
+		 *
+		 * @param src The source node.
+		 * @param dst The destination node.
+		 * @return True if the nodes are connected, otherwise false.
+		 */
+		[[nodiscard]] auto is_connected(N const& src, N const& dst) const -> bool;
+
+		/**
+		 * @brief Checks if two nodes are connected by an edge, looking them up by heterogeneous keys.
+		 * @note Not marked as noexcept because it throws an exception if src or dst do not exist.
+		 *
+		 * @param src The key of the source node.
+		 * @param dst The key of the destination node.
+		 * @return True if the nodes are connected, otherwise false.
+		 */
+		template<node_key<N> Src, node_key<N> Dst>
+		[[nodiscard]] auto is_connected(Src const& src, Dst const& dst) const -> bool;
+
+		/**
+		 * @brief Returns a vector of all nodes in the graph.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 *
+		 * Time complexity: O(n) for all nodes insertion.
+		 *
+		 * @return A vector of all nodes in the graph.
+		 */
+		[[nodiscard]] auto nodes() const -> std::vector<N>;
+
+		/**
+		 * @brief Calls a function with every node in ascending order, without copying the nodes.
+		 *
+		 * Time complexity: O(n).
+		 *
+		 * @param fn Called with an N const& for every node.
+		 */
+		template<std::invocable<N const&> F>
+		auto for_each_node(F fn) const -> void;
+
+		/**
+		 * @brief Calls a function with every edge in the order of iteration, without copying the nodes or weights. The
+		 * edges of each source come together, and the sources in ascending order.
+		 *
+		 * Time complexity: O(e).
+		 *
+		 * @param fn Called with the source, destination and weight of every edge, as N const&, N const& and
+		 * std::optional<E> const&.
+		 */
+		template<std::invocable<N const&, N const&, std::optional<E> const&> F>
+		auto for_each_edge(F fn) const -> void;
+
+		/**
+		 * @brief Returns a vector of all edges between two nodes.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Not marked as noexcept because it throws an exception if src or dst do not exist.
+		 *
+		 * Time complexity: O(log n) for error checking, O(log e + d) for finding and inserting the d edges between the
+		 * nodes. Totally O(log n + log e + d).
+		 *
+		 * @param src The source node.
+		 * @param dst The destination node.
+		 * @return A vector of unique pointers to all edges between the two nodes.
+		 */
+		[[nodiscard]] auto edges(N const& src, N const& dst) const -> std::vector<std::unique_ptr<edge<N, E>>>;
+
+		/**
+		 * @brief Returns a vector of all edges between two nodes, looking them up by heterogeneous keys.
+		 * @note Not marked as noexcept because it throws an exception if src or dst do not exist.
+		 *
+		 * @param src The key of the source node.
+		 * @param dst The key of the destination node.
+		 * @return A vector of unique pointers to all edges between the two nodes.
+		 */
+		template<node_key<N> Src, node_key<N> Dst>
+		[[nodiscard]] auto edges(Src const& src, Dst const& dst) const -> std::vector<std::unique_ptr<edge<N, E>>>;
+
+		/**
+		 * @brief Finds an edge in the graph.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Marked as noexcept because it only performs search operations that do not throw exceptions.
+		 *
+		 * Time complexity: O(log n + log e), looking up the nodes and then the edge in the ordered set.
+		 *
+		 * @param src The source node.
+		 * @param dst The destination node.
+		 * @param weight The weight of the edge, optional.
+		 * @return An iterator to the edge if found, otherwise end iterator.
+		 */
+		[[nodiscard]] auto
+		find(N const& src, N const& dst, std::optional<E> const& weight = std::nullopt) const noexcept -> iterator;
+
+		/**
+		 * @brief Finds an edge in the graph, looking up src and dst by heterogeneous keys.
+		 *
+		 * @param src The key of the source node.
+		 * @param dst The key of the destination node.
+		 * @param weight The weight of the edge, optional.
+		 * @return An iterator to the edge if found, otherwise end iterator.
+		 */
+		template<node_key<N> Src, node_key<N> Dst>
+		[[nodiscard]] auto
+		find(Src const& src, Dst const& dst, std::optional<E> const& weight = std::nullopt) const noexcept -> iterator;
+
+		/**
+		 * @brief Returns a vector of nodes connected to the given source node.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Not marked as noexcept because it throws an exception if src does not exist.
+		 *
+		 * Time complexity: O(log(n)) for error check. O(e) for iterating over the graph class to get the dst nodes and
+		 * push to vector and O(e) to remove duplicate element. Totally O(log(n)+e).
+		 *
+		 * @param src The source node.
+		 * @return A vector of nodes connected to the source node.
+		 */
+		[[nodiscard]] auto connections(N const& src) const -> std::vector<N>;
+
+		/**
+		 * @brief Returns a vector of nodes connected to the given source node, looked up by a heterogeneous key.
+		 * @note Not marked as noexcept because it throws an exception if src does not exist.
+		 *
+		 * @param src The key of the source node.
+		 * @return A vector of nodes connected to the source node.
+		 */
+		template<node_key<N> K>
+		[[nodiscard]] auto connections(K const& src) const -> std::vector<N>;
+
+		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		//                               GRAPH SUBGRAPH FUNCTIONS                                                     //
+		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/**
+		 * @brief Builds the subgraph induced by the given nodes: those nodes and every edge between two of them.
+		 * Duplicate nodes are allowed.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Not marked as noexcept because it throws an exception if a node does not exist.
+		 *
+		 * Time complexity: O(k log n + d log k) for k nodes with d outgoing edges in total, only the edges leaving the
+		 * given nodes are visited and the result is appended to in order.
+		 *
+		 * @param nodes The nodes of the subgraph, as values or heterogeneous keys.
+		 * @return A new graph with the given nodes and the edges between them.
+		 */
+		template<std::ranges::input_range R>
+		    requires node_key<std::ranges::range_value_t<R>, N>
+		[[nodiscard]] auto induced_subgraph(R&& nodes) const -> graph;
+
+		/**
+		 * @brief Builds the subgraph induced by the nodes of an initializer list.
+		 * @note Not marked as noexcept because it throws an exception if a node does not exist.
+		 *
+		 * @param nodes The nodes of the subgraph.
+		 * @return A new graph with the given nodes and the edges between them.
+		 */
+		[[nodiscard]] auto induced_subgraph(std::initializer_list<N> nodes) const -> graph;
+
+		/**
+		 * @brief Builds the subgraph induced by the nodes reachable from seed over at most the given number of
+		 * outgoing edges, including seed itself.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Not marked as noexcept because it throws an exception if seed does not exist.
+		 *
+		 * Time complexity: O(k log n + d log k), a breadth-first search visits only the edges leaving the k nodes
+		 * found.
+		 *
+		 * @param seed The node at the centre of the subgraph.
+		 * @param hops The maximum distance in edges from seed.
+		 * @return A new graph with the nodes within reach of seed and the edges between them.
+		 */
+		[[nodiscard]] auto ego_graph(N const& seed, std::size_t hops) const -> graph;
+
+		/**
+		 * @brief Returns a view of the subgraph induced by the nodes satisfying a predicate, without copying. The view
+		 * refers to this graph, so it reflects later changes and must not outlive it.
+		 * @note Marked as [[nodiscard]] because the view is important and should not be ignored.
+		 *
+		 * @tparam P The type of the predicate.
+		 * @param pred Returns true for the nodes in the view.
+		 * @return A view of the nodes satisfying pred and the edges between them.
+		 */
+		template<std::predicate<N const&> P>
+		[[nodiscard]] auto filtered(P pred) const -> graph_view<N, E, P>;
+
+		/**
+		 * @brief Builds the transpose of the graph, with every edge reversed. The nodes are immutable once stored, so
+		 * the transpose shares them with this graph instead of copying them. The transpose of a pooled graph gets a
+		 * pool of its own sized for its set entries and edges only.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 *
+		 * Time complexity: O(n + e), the edges are bucketed by destination with a counting sort and appended to the
+		 * result in order.
+		 *
+		 * @return A new graph with an edge from dst to src for every edge from src to dst.
+		 */
+		[[nodiscard]] auto transpose() const -> graph;
+
+		/**
+		 * @brief Returns a read-only view of the graph with every edge reversed, backed by an index of the incoming
+		 * edges of each node. Like an iterator, the view is invalidated by modifying the graph.
+		 * @note Marked as [[nodiscard]] because the view is important and should not be ignored.
+		 *
+		 * Time complexity: O(n + e) to build the index, which holds one pointer per edge.
+		 *
+		 * @return A view of the transpose of the graph.
+		 */
+		[[nodiscard]] auto reversed() const -> reverse_view<N, E>;
+
+		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		//                               GRAPH ITERATOR ACCESS FUNCTIONS                                              //
+		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/**
+		 * @brief Returns an iterator to the beginning of the edges set.
+		 * @note Marked as [[nodiscard]] because the iterator is important and should not be ignored.
+		 * Marked as noexcept because it only returns an iterator to the beginning of the set, which does not throw
+		 * exceptions.
+		 *
+		 * @return An iterator to the beginning of the edges set.
+		 */
+		[[nodiscard]] auto begin() const noexcept -> iterator;
+
+		/**
+		 * @brief Returns an iterator to the end of the edges set.
+		 * @note Marked as [[nodiscard]] because the iterator is important and should not be ignored.
+		 * Marked as noexcept because it only returns an iterator to the end of the set, which does not throw
+		 * exceptions.
+		 *
+		 * @return An iterator to the end of the edges set.
+		 */
+		[[nodiscard]] auto end() const noexcept -> iterator;
+
+		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		//                                  GRAPH OTHER FUNCTIONS                                                     //
+		////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		/**
+		 * @brief Compares two graphs for equality.
+		 * @note Marked as [[nodiscard]] because the result of the comparison is important and should not be ignored.
+		 * Marked as noexcept because it does not perform any operations that can throw exceptions.
+		 *
+		 * Time complexity: O(1) if the sizes or fingerprints differ, otherwise O(n + e) where it will compare all nodes
+		 * and edges.
+		 *
+		 * @param other The graph to compare with.
+		 * @return True if the graphs are equal, otherwise false.
+		 */
+		[[nodiscard]] auto operator==(graph const& other) const noexcept -> bool;
+
+		/**
+		 * @brief Returns the order-independent fingerprint of the nodes and edges of the graph.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Marked as noexcept because the fingerprint is maintained incrementally by every modifier.
+		 *
+		 * Time complexity: O(1), or O(e) while lazily erased nodes are waiting to be compacted.
+		 *
+		 * @return The fingerprint of the graph.
+		 */
+		[[nodiscard]] auto fingerprint() const noexcept -> graph_fingerprint;
+
+		/**
+		 * @brief Returns a breakdown of the memory used by the graph.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Marked as noexcept because the breakdown is computed from the sizes of the graph without allocating.
+		 *
+		 * Storage and overhead are exact for the pool and estimated for the global allocator, assuming a one word
+		 * header and two word alignment per allocation as in common malloc implementations. A pooled graph counts
+		 * only the node objects held by its own pool, so a transpose leaves the nodes it shares to its source.
+		 *
+		 * Time complexity: O(1), or O(n + e) if N or E has a heap_usage specialisation.
+		 *
+		 * @return The memory used by the graph.
+		 */
+		[[nodiscard]] auto memory_usage() const noexcept -> graph_memory_usage;
+
+		/**
+		 * @brief Returns the call counts, latency histograms and comparison and visit counts of the operations made
+		 * on the graph since it was constructed or since reset_stats.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Marked as noexcept because it only reads counters.
+		 *
+		 * Always reports zero unless GDWG_GRAPH_INSTRUMENTATION is enabled. Copies and moves of a graph start with
+		 * their own zeroed statistics.
+		 *
+		 * Time complexity: O(1).
+		 *
+		 * @return The statistics of the graph.
+		 */
+		[[nodiscard]] auto stats() const noexcept -> graph_stats;
+
+		/**
+		 * @brief Sets the statistics of the graph back to zero.
+		 * @note Marked as noexcept because it only writes counters.
+		 */
+		auto reset_stats() const noexcept -> void;
+
+		/**
+		 * @brief Creates a change_feed and attaches it to the graph.
+		 * @note Marked as [[nodiscard]] because the feed is the only way to read the changes.
+		 *
+		 * @param capacity The minimum number of changes the feed buffers before dropping them.
+		 * @return The feed, to be polled by a single consumer thread.
+		 */
+		[[nodiscard]] auto subscribe(std::size_t capacity) -> std::shared_ptr<change_feed<N, E>>;
+
+		/**
+		 * @brief Attaches a sink which receives every change made to the graph from now on, in order.
+		 *
+		 * Sinks belong to this graph object: copies start without sinks, and when the contents of the graph are
+		 * replaced by an assignment the sinks receive a clear followed by the insertion of the new contents.
+		 *
+		 * @param sink The sink to attach.
+		 */
+		auto attach(std::shared_ptr<mutation_sink<N, E>> sink) -> void;
+
+		/**
+		 * @brief Detaches a sink, which receives no further changes.
+		 *
+		 * @param sink The sink to detach.
+		 * @return True if the sink was attached, otherwise false.
+		 */
+		auto detach(std::shared_ptr<mutation_sink<N, E>> const& sink) noexcept -> bool;
+
+		/**
+		 * @brief Applies a change reported by another graph, so that replaying the changes of a graph in order
+		 * reproduces it. Cascaded edge removals are skipped, as erasing their node already removes them.
+		 *
+		 * Time complexity: that of the graph operation the change describes.
+		 *
+		 * @param event The change to apply.
+		 * @throws std::runtime_error If the change does not apply to this graph, e.g. an edge between missing nodes.
+		 */
+		auto apply(mutation<N, E> const& event) -> void;
+
+		/**
+		 * @brief Applies a delta computed by gdwg::diff(a, b) to a graph equal to a, which then equals b. The removed
+		 * edges are erased first, then the removed nodes in a single sweep, then the added nodes and edges.
+		 *
+		 * Time complexity: O(e + d log (n + e)) where d is the size of the delta, O(d log (n + e)) without removed
+		 * nodes.
+		 *
+		 * @param delta The delta to apply.
+		 * @throws std::runtime_error If an edge of the delta is between nodes missing from the graph.
+		 */
+		auto apply(graph_delta<N, E> const& delta) -> void;
+
+		/**
+		 * @brief Outputs the graph to the given output stream.
+		 * @note Not marked as noexcept because streaming to std::ostream can throw.
+		 *
+		 * @tparam T The type of the nodes in the graph.
+		 * @tparam U The type of the edges in the graph.
+		 * @param os The output stream to write to.
+		 * @param g The graph to output.
+		 * @return The output stream.
+		 */
+		template<typename T, typename U>
+		friend auto operator<<(std::ostream& os, graph<T, U> const& g) -> std::ostream&;
+
+		template<typename T, typename U, typename P>
+		friend class graph_view;
+
+		template<typename T, typename U>
+		friend class reverse_view;
+
+		template<typename T, typename U>
+		friend class graph_builder;
+
+		template<typename T, typename U>
+		friend class traversal;
+
+		template<typename T, typename U>
+		friend class parallel_algorithms;
+
+		/**
+		 * @brief Computes the changes which turn one graph into another, by walking the sorted nodes and edges of
+		 * both graphs side by side.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 *
+		 * Time complexity: O(n + e) for the walk, plus O(log r) per removed edge to leave out those of the r removed
+		 * nodes.
+		 *
+		 * @tparam T The type of the nodes in the graphs.
+		 * @tparam U The type of the edges in the graphs.
+		 * @param a The graph to start from.
+		 * @param b The graph to end at.
+		 * @return The delta, which turns a into b when applied to it.
+		 */
+		template<typename T, typename U>
+		friend auto diff(graph<T, U> const& a, graph<T, U> const& b) -> graph_delta<T, U>;
+
+		/**
+		 * @brief Builds the union of two graphs: every node and edge in either of them.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 *
+		 * Time complexity: O(n + e log n), the sorted nodes and edges are merged and appended to the result in order.
+		 *
+		 * @tparam T The type of the nodes in the graphs.
+		 * @tparam U The type of the edges in the graphs.
+		 * @param a The first graph.
+		 * @param b The second graph.
+		 * @return A new graph with the nodes and edges of both graphs.
+		 */
+		template<typename T, typename U>
+		friend auto graph_union(graph<T, U> const& a, graph<T, U> const& b) -> graph<T, U>;
+
+		/**
+		 * @brief Builds the intersection of two graphs: every node and edge in both of them.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 *
+		 * Time complexity: O(n + e log n), the sorted nodes and edges are merged and appended to the result in order.
+		 *
+		 * @tparam T The type of the nodes in the graphs.
+		 * @tparam U The type of the edges in the graphs.
+		 * @param a The first graph.
+		 * @param b The second graph.
+		 * @return A new graph with the nodes and edges common to both graphs.
+		 */
+		template<typename T, typename U>
+		friend auto graph_intersection(graph<T, U> const& a, graph<T, U> const& b) -> graph<T, U>;
+
+		/**
+		 * @brief Builds the difference of two graphs: every node of the first graph, and its edges which are not in
+		 * the second. Keeping all nodes means no edge loses an endpoint.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 *
+		 * Time complexity: O(n + e log n), the sorted nodes and edges are merged and appended to the result in order.
+		 *
+		 * @tparam T The type of the nodes in the graphs.
+		 * @tparam U The type of the edges in the graphs.
+		 * @param a The graph to take nodes and edges from.
+		 * @param b The graph whose edges are left out.
+		 * @return A new graph with the nodes of a and the edges of a which are not in b.
+		 */
+		template<typename T, typename U>
+		friend auto graph_difference(graph<T, U> const& a, graph<T, U> const& b) -> graph<T, U>;
+
+	 private:
+		// Declared first so that it outlives the storage drawing from it.
+		std::shared_ptr<node_pool> pool_;
+		type_nodes_set nodes_;
+		edges_set edges_;
+		// Lazily erased nodes, still referenced by edges until the next compaction.
+		type_nodes_set tombstones_;
+		bool lazy_erase_;
+		// Sum of the fingerprints of the nodes and of all stored edges, including those of tombstoned nodes.
+		graph_fingerprint fingerprint_;
+		// Mutable so that the accessors can record themselves too.
+		using stats_type = std::conditional_t<instrumentation_enabled, stats_recorder, stats_disabled>;
+		using probe_type = std::conditional_t<instrumentation_enabled, operation_probe, stats_disabled>;
+		[[no_unique_address]] mutable stats_type stats_;
+		std::vector<std::shared_ptr<mutation_sink<N, E>>> sinks_;
+		// Restamped by every change, from a counter shared by all graphs of this type, so that a pending compaction
+		// can tell whether it was taken from this graph in its current state. Mutable as changes are stamped where
+		// they are reported.
+		mutable std::uint64_t version_;
+		static inline std::atomic<std::uint64_t> last_version_{0};
+
+		/**
+		 * @brief Returns a version which no graph of this type has had before.
+		 * @note Marked as noexcept because it only increments an atomic counter.
+		 *
+		 * @return The new version.
+		 */
+		[[nodiscard]] static auto next_version() noexcept -> std::uint64_t;
+
+		/**
+		 * @brief Reports a change to the attached sinks, if there are any.
+		 * @note Marked as noexcept because the change has already been made; sinks are told when it cannot be
+		 * reported.
+		 *
+		 * @param kind The kind of change.
+		 * @param src The node, the source of the edge, or the old value, if any.
+		 * @param dst The destination of the edge or the new value, if any.
+		 */
+		auto notify(mutation_kind kind, N const* src = nullptr, N const* dst = nullptr) const noexcept -> void;
+
+		/**
+		 * @brief Reports a change to an edge to the attached sinks, if there are any.
+		 *
+		 * @param kind The kind of change.
+		 * @param e The edge.
+		 * @param cascaded True if the edge is removed because one of its nodes was erased.
+		 */
+		auto notify_edge(mutation_kind kind, edge_tuple const& e, bool cascaded = false) const noexcept -> void;
+
+		/**
+		 * @brief Reports a change to the attached sinks.
+		 *
+		 * @param build Builds the change, called only if there are sinks so that nothing is copied without them.
+		 */
+		template<typename Build>
+		auto notify_with(Build const& build) const noexcept -> void;
+
+		/**
+		 * @brief Reports the contents of the graph to the attached sinks as a clear followed by insertions, after the
+		 * contents have been replaced wholesale.
+		 */
+		auto replay() const noexcept -> void;
+
+		/**
+		 * @brief Starts recording a call of an operation, which is recorded when the returned probe is destroyed.
+		 *
+		 * @param op The operation.
+		 * @return A probe, or an empty object if instrumentation is compiled out.
+		 */
+		[[nodiscard]] auto probe(graph_operation op) const noexcept -> probe_type;
+
+		/**
+		 * @brief Counts an edge visited by a path walking the edge set.
+		 */
+		static auto count_visit() noexcept -> void;
+
+		/**
+		 * @brief Counts an invocation of the node or edge set comparator.
+		 */
+		static auto count_comparison() noexcept -> void;
+
+		/**
+		 * @brief Finds a node in the graph and returns a shared pointer to it.
+		 * @note Marked as [[nodiscard]] because the returned pointer is important and should not be ignored.
+		 * Marked as noexcept because it only performs a lookup and pointer operations which do not throw exceptions.
+		 *
+		 * @tparam K The type of the key, either N or a heterogeneous node_key.
+		 * @param value The value of the node to find.
+		 * @return A shared pointer to the node if found, otherwise nullptr.
+		 */
+		template<typename K>
+		[[nodiscard]] auto find_node_ptr(K const& value) const noexcept -> std::shared_ptr<N>;
+
+		/**
+		 * @brief Replaces an existing node with a new node, forwarding the new value into the node storage.
+		 *
+		 * @param old_data The existing node to replace.
+		 * @param new_data The new node to replace the old one.
+		 * @return True if the node was replaced, otherwise false.
+		 */
+		template<typename V>
+		auto replace_node_impl(N const& old_data, V&& new_data) -> bool;
+
+		/**
+		 * @brief Allocates a new node from the graph's storage.
+		 * @note Not marked as noexcept because allocating or constructing the node may throw.
+		 *
+		 * @param value The value of the node, forwarded into the storage.
+		 * @return A shared pointer to the new node.
+		 */
+		template<typename V>
+		[[nodiscard]] auto make_node(V&& value) const -> std::shared_ptr<N>;
+
+		/**
+		 * @brief Allocates a new weighted or unweighted edge from the graph's storage.
+		 * @note Not marked as noexcept because allocating or constructing the edge may throw.
+		 *
+		 * @param src The source node.
+		 * @param dst The destination node.
+		 * @param weight The weight of the edge, optional.
+		 * @return A shared pointer to the new edge.
+		 */
+		[[nodiscard]] auto make_edge(N const& src, N const& dst, std::optional<E> const& weight) const
+		    -> std::shared_ptr<edge<N, E>>;
+
+		/**
+		 * @brief Moves all nodes and edges into storage drawing from the given pool.
+		 * @note Not marked as noexcept because allocating the new storage may throw.
+		 *
+		 * Time complexity: O(n log n + e), nodes are looked up once per edge and edges are appended in order.
+		 *
+		 * @param pool The pool for the new storage.
+		 */
+		auto rebuild_storage(std::shared_ptr<node_pool> const& pool) -> void;
+
+		/**
+		 * @brief Estimates the pool bytes needed for the given number of nodes and edges.
+		 * @note Marked as noexcept because it only performs arithmetic.
+		 *
+		 * @param node_count The number of nodes.
+		 * @param edge_count The number of edges.
+		 * @return The estimated number of bytes.
+		 */
+		[[nodiscard]] static auto storage_bytes(std::size_t node_count, std::size_t edge_count) noexcept -> std::size_t;
+
+		/**
+		 * @brief Returns the first edge leaving a node, or the edge after where it would be if the node has none.
+		 * @note Marked as noexcept because it only performs a lookup in the edges set.
+		 *
+		 * @param src A node of this graph.
+		 * @return An iterator to the first edge from src at or after the smallest destination.
+		 */
+		[[nodiscard]] auto first_out_edge(N const* src) const noexcept -> typename edges_set::const_iterator;
+
+		/**
+		 * @brief Orders the live edges by destination, then source, then weight, as the edges of the transpose.
+		 * @note Not marked as noexcept because allocating the order may throw.
+		 *
+		 * Time complexity: O(n + e), a stable counting sort over the destinations of the sorted edges.
+		 *
+		 * @return Pointers to the live edges in the order of their reversed edges.
+		 */
+		[[nodiscard]] auto in_edge_order() const -> std::vector<edge_tuple const*>;
+
+		/**
+		 * @brief Builds the subgraph induced by nodes of this graph.
+		 * @note Not marked as noexcept because allocating the result may throw.
+		 *
+		 * Time complexity: O(k log k + d log k) for k nodes with d outgoing edges in total.
+		 *
+		 * @param selected The nodes, in any order and possibly repeated.
+		 * @return A new graph with the nodes and the edges between them.
+		 */
+		[[nodiscard]] auto induced_by(std::vector<std::shared_ptr<N>> selected) const -> graph;
+
+		/**
+		 * @brief Orders two nodes by value using only operator<.
+		 *
+		 * @param lhs The first node.
+		 * @param rhs The second node.
+		 * @return The order of the nodes.
+		 */
+		[[nodiscard]] static auto node_order(N const& lhs, N const& rhs) noexcept -> std::strong_ordering;
+
+		/**
+		 * @brief Orders two edges by value, which unlike the edge set comparator also works for edges of different
+		 * graphs.
+		 *
+		 * @param lhs The first edge.
+		 * @param rhs The second edge.
+		 * @return The order of the source, then the destination, then the weight.
+		 */
+		[[nodiscard]] static auto edge_order(edge_tuple const& lhs, edge_tuple const& rhs) noexcept
+		    -> std::strong_ordering;
+
+		/**
+		 * @brief Returns the edges which do not belong to a lazily erased node, in order.
+		 * @note Marked as noexcept because the view is built lazily and does not allocate.
+		 *
+		 * @return A view over the live edges.
+		 */
+		[[nodiscard]] auto live_edges() const noexcept;
+
+		/**
+		 * @brief Walks two sorted ranges side by side, calling visit(element, in_lhs, in_rhs) once per distinct
+		 * element. An element in both ranges is passed from lhs.
+		 *
+		 * Time complexity: O(l + r) calls of order.
+		 *
+		 * @param lhs The first sorted range.
+		 * @param rhs The second sorted range.
+		 * @param order Returns the std::strong_ordering of an element of lhs and an element of rhs.
+		 * @param visit Called with every element in ascending order.
+		 */
+		template<std::ranges::input_range L, std::ranges::input_range R, typename Order, typename Visit>
+		static auto merge_walk(L&& lhs, R&& rhs, Order order, Visit visit) -> void;
+
+		/**
+		 * Which elements a merge keeps: those only in lhs, those only in rhs, and those in both.
+		 */
+		struct merge_rule {
+			bool only_lhs;
+			bool only_rhs;
+			bool both;
+		};
+
+		/**
+		 * @brief Builds a graph from the nodes and edges of two graphs selected by the given rules. The edges of the
+		 * rule must only be kept where both of their nodes are kept.
+		 * @note Not marked as noexcept because allocating the result may throw.
+		 *
+		 * Time complexity: O(n + e log n), sources are found by advancing through the result nodes and destinations
+		 * by lookup.
+		 *
+		 * @param lhs The first graph.
+		 * @param rhs The second graph.
+		 * @param nodes The rule selecting nodes.
+		 * @param edges The rule selecting edges.
+		 * @return The merged graph, pooled if either input is.
+		 */
+		[[nodiscard]] static auto merge(graph const& lhs, graph const& rhs, merge_rule nodes, merge_rule edges)
+		    -> graph;
+
+		/**
+		 * @brief Estimates what the global allocator spends on top of an allocation of the given size.
+		 *
+		 * @param bytes The size of the allocation.
+		 * @return The header and padding bytes of the allocation.
+		 */
+		[[nodiscard]] static auto heap_overhead(std::size_t bytes) noexcept -> std::size_t;
+
+		// A red-black tree node is a four word header followed by the element. A shared_ptr control block made by
+		// allocate_shared holds two counts, a vtable pointer and the allocator in front of the object.
+		static constexpr std::size_t tree_header_bytes = 4 * sizeof(void*);
+		static constexpr std::size_t control_block_bytes = 2 * sizeof(void*) + sizeof(pool_allocator<N>);
+		static constexpr std::size_t node_entry_bytes = tree_header_bytes + sizeof(std::shared_ptr<N>);
+		static constexpr std::size_t node_object_bytes = control_block_bytes + sizeof(N);
+		static constexpr std::size_t edge_entry_bytes = tree_header_bytes + sizeof(edge_tuple);
+		static constexpr std::size_t edge_object_bytes = control_block_bytes + sizeof(weighted_edge<N, E>);
+
+		/**
+		 * @brief Checks if an edge belongs to a lazily erased node.
+		 * @note Marked as noexcept because it only performs lookups in a set.
+		 *
+		 * Time complexity: O(1) without tombstones, O(log t) otherwise.
+		 *
+		 * @param e The edge to check.
+		 * @return True if the source or destination of the edge has been erased, otherwise false.
+		 */
+		[[nodiscard]] auto is_tombstoned(edge_tuple const& e) const noexcept -> bool;
+
+		/**
+		 * @brief Compacts the graph if a node with the given value is tombstoned, so that a node with that value can
+		 * be inserted again without its new edges colliding with the tombstoned ones.
+		 *
+		 * @param value The value about to be inserted.
+		 */
+		auto revive(N const& value) noexcept -> void;
+
+		/**
+		 * @brief Makes an iterator to the first edge at or after the given position which is not tombstoned.
+		 * @note Marked as noexcept because it only advances a set iterator.
+		 *
+		 * @param it The position in the edges set.
+		 * @return An iterator to the first live edge at or after it.
+		 */
+		[[nodiscard]] auto make_iterator(typename iterator::set_iter it) const noexcept -> iterator;
+
+		/**
+		 * @brief Returns the fingerprint contribution of a node.
+		 * @note Marked as noexcept because std::hash must not throw.
+		 *
+		 * @param value The node.
+		 * @return The fingerprint of the node.
+		 */
+		[[nodiscard]] static auto node_fingerprint(N const& value) noexcept -> graph_fingerprint;
+
+		/**
+		 * @brief Returns the fingerprint contribution of a stored edge.
+		 * @note Marked as noexcept because std::hash must not throw.
+		 *
+		 * @param e The edge.
+		 * @return The fingerprint of the edge.
+		 */
+		[[nodiscard]] static auto edge_fingerprint(edge_tuple const& e) noexcept -> graph_fingerprint;
+
+		/**
+		 * @brief Hashes a node or weight with std::hash, or returns 0 for types without a std::hash specialisation.
+		 * @note Marked as noexcept because std::hash must not throw.
+		 *
+		 * @tparam T The type of the value.
+		 * @param value The value to hash.
+		 * @return The hash of the value.
+		 */
+		template<typename T>
+		[[nodiscard]] static auto hash_of(T const& value) noexcept -> std::uint64_t;
+
+		/**
+		 * @brief Recomputes the fingerprint from scratch.
+		 * @note Marked as noexcept because std::hash must not throw.
+		 *
+		 * Time complexity: O(n + e).
+		 */
+		auto refresh_fingerprint() noexcept -> void;
+
+		/**
+		 * @brief Updates the source or destination of an edge to a new node.
+		 * @note Marked as noexcept because it does not perform any operations that can throw exceptions.
+		 *
+		 * @param src_ptr The shared pointer to the old node.
+		 * @param dst_ptr The shared pointer to the new node.
+		 * @return void
+		 */
+		auto update_node(std::shared_ptr<N> const& src_ptr, std::shared_ptr<N> const& dst_ptr) noexcept -> void;
+
+		/**
+		 * @brief Performs a deep copy of the given graph into the current graph instance.
+		 *
+		 * This method will copy all nodes and edges from the provided graph into the
+		 * current graph instance, ensuring that the current graph becomes an exact
+		 * duplicate of the other graph. Any existing nodes and edges in the current
+		 * graph will be replaced.
+		 *
+		 * @param other The graph to copy from.
+		 * @return void
+		 */
+		auto deep_copy(graph const& other) -> void;
+	};
+	// Redeclaration of graph friend function operator<<
+	template<typename T, typename U>
+	auto operator<<(std::ostream& os, graph<T, U> const& g) -> std::ostream&;
+
+	// Redeclaration of graph friend function diff
+	template<typename T, typename U>
+	[[nodiscard]] auto diff(graph<T, U> const& a, graph<T, U> const& b) -> graph_delta<T, U>;
+
+	/**
+	 * A non-owning view of the subgraph of a graph induced by the nodes satisfying a predicate. Nothing is copied:
+	 * nodes and edges are filtered as they are visited, so the view always reflects the current graph. Like an
+	 * iterator, a view must not outlive its graph. The ranges returned by nodes and edges hold their own copy of the
+	 * predicate, so they may outlive the view.
+	 */
+	template<typename N, typename E, typename P>
+	class graph_view {
+	 public:
+		using value_type = typename graph<N, E>::iterator::value_type;
+
+		/**
+		 * @brief Constructs a view of the nodes of g satisfying pred.
+		 *
+		 * @param g The graph to view.
+		 * @param pred Returns true for the nodes in the view.
+		 */
+		graph_view(graph<N, E> const& g, P pred);
+
+		/**
+		 * @brief Checks if a node is in the view.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 *
+		 * Time complexity: O(log n).
+		 *
+		 * @param value The node to check.
+		 * @return True if the node is in the graph and satisfies the predicate, otherwise false.
+		 */
+		[[nodiscard]] auto is_node(N const& value) const -> bool;
+
+		/**
+		 * @brief Checks if there is an edge from src to dst in the view.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Not marked as noexcept because it throws an exception if src or dst is not in the view.
+		 *
+		 * Time complexity: O(log n + log e).
+		 *
+		 * @param src The source node.
+		 * @param dst The destination node.
+		 * @return True if the nodes are connected, otherwise false.
+		 */
+		[[nodiscard]] auto is_connected(N const& src, N const& dst) const -> bool;
+
+		/**
+		 * @brief Returns the nodes in the view, in order.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 *
+		 * @return A lazy range of references to the nodes.
+		 */
+		[[nodiscard]] auto nodes() const;
+
+		/**
+		 * @brief Returns the edges between nodes in the view, in order, as the graph iterator presents them.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 *
+		 * @return A lazy range of edge values.
+		 */
+		[[nodiscard]] auto edges() const;
+
+		/**
+		 * @brief Returns the nodes in the view connected from src.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Not marked as noexcept because it throws an exception if src is not in the view.
+		 *
+		 * Time complexity: O(log n + d) where d is the number of edges leaving src.
+		 *
+		 * @param src The source node.
+		 * @return The destinations of the edges from src in the view, without duplicates.
+		 */
+		[[nodiscard]] auto connections(N const& src) const -> std::vector<N>;
+
+		/**
+		 * @brief Copies the view into a graph of its own.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 *
+		 * Time complexity: O(n + d log k) for k nodes in the view with d outgoing edges in total.
+		 *
+		 * @return A new graph equal to the view.
+		 */
+		[[nodiscard]] auto materialize() const -> graph<N, E>;
+
+	 private:
+		graph<N, E> const* graph_;
+		P pred_;
+
+		/**
+		 * @brief Checks if an edge of a graph is in the view of it by a predicate. Static so that the ranges returned
+		 * by nodes and edges need not refer to the view.
+		 *
+		 * @param g The graph.
+		 * @param pred Returns true for the nodes in the view.
+		 * @param e The edge.
+		 * @return True if the edge is live and both of its nodes satisfy the predicate, otherwise false.
+		 */
+		[[nodiscard]] static auto contains(graph<N, E> const& g, P const& pred, typename graph<N, E>::edge_tuple const& e)
+		    -> bool;
+	};
+
+	/**
+	 * A read-only view of a graph with every edge reversed. The nodes and edges stay in the graph; the view only
+	 * holds an index of the edges ordered by destination, so like an iterator it is invalidated by modifying the
+	 * graph.
+	 */
+	template<typename N, typename E>
+	class reverse_view {
+	 public:
+		using value_type = typename graph<N, E>::iterator::value_type;
+
+		/**
+		 * @brief Constructs a reverse view of g, indexing its incoming edges.
+		 * @note Not marked as noexcept because allocating the index may throw.
+		 *
+		 * Time complexity: O(n + e).
+		 *
+		 * @param g The graph to view.
+		 */
+		explicit reverse_view(graph<N, E> const& g);
+
+		/**
+		 * @brief Checks if a node is in the view.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 *
+		 * @param value The node to check.
+		 * @return True if the node is in the graph, otherwise false.
+		 */
+		[[nodiscard]] auto is_node(N const& value) const noexcept -> bool;
+
+		/**
+		 * @brief Checks if there is a reversed edge from src to dst, i.e. an edge from dst to src in the graph.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Not marked as noexcept because it throws an exception if src or dst does not exist.
+		 *
+		 * @param src The source node in the view.
+		 * @param dst The destination node in the view.
+		 * @return True if the nodes are connected, otherwise false.
+		 */
+		[[nodiscard]] auto is_connected(N const& src, N const& dst) const -> bool;
+
+		/**
+		 * @brief Returns the reversed edges, in the order the transpose of the graph would iterate them.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 *
+		 * @return A lazy range of edge values.
+		 */
+		[[nodiscard]] auto edges() const;
+
+		/**
+		 * @brief Returns the nodes connected from src in the view, i.e. the nodes with an edge to src in the graph.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Not marked as noexcept because it throws an exception if src does not exist.
+		 *
+		 * Time complexity: O(log n + log e + d) where d is the number of edges into src.
+		 *
+		 * @param src The source node in the view.
+		 * @return The sources of the edges into src in the graph, without duplicates.
+		 */
+		[[nodiscard]] auto connections(N const& src) const -> std::vector<N>;
+
+	 private:
+		graph<N, E> const* graph_;
+		std::vector<typename graph<N, E>::edge_tuple const*> in_edges_;
+	};
+
+	/**
+	 * Builds a graph in bulk. Nodes and edges are collected in any order, with duplicates, then sorted and
+	 * deduplicated once and appended to the storage of the graph in order, instead of paying a search per insertion.
+	 * Loaders which intern their nodes themselves can skip the collection and hand sorted input to from_sorted.
+	 */
+	template<typename N, typename E>
+	class graph_builder {
+	 public:
+		/**
+		 * An edge between the nodes at two positions of a sorted node list.
+		 */
+		struct indexed_edge {
+			std::size_t src;
+			std::size_t dst;
+			std::optional<E> weight;
+
+			/**
+			 * @brief Compares two edges for equality.
+			 *
+			 * @return True if the positions and weights are equal, otherwise false.
+			 */
+			[[nodiscard]] auto operator==(indexed_edge const&) const -> bool = default;
+
+			/**
+			 * @brief Orders edges by source, then destination, then weight, as the graph stores them.
+			 *
+			 * @param other The edge to compare with.
+			 * @return True if this edge sorts before other, otherwise false.
+			 */
+			[[nodiscard]] auto operator<(indexed_edge const& other) const -> bool;
+		};
+
+		/**
+		 * @brief Pre-allocates room for the given number of nodes and edges.
+		 *
+		 * @param node_count The number of nodes to be added.
+		 * @param edge_count The number of edges to be added.
+		 */
+		auto reserve(std::size_t node_count, std::size_t edge_count) -> void;
+
+		/**
+		 * @brief Adds a node. Adding a node more than once is allowed.
+		 *
+		 * @param value The node.
+		 */
+		auto add_node(N value) -> void;
+
+		/**
+		 * @brief Adds an edge, along with its nodes. Adding an edge more than once is allowed.
+		 *
+		 * @param src The source node.
+		 * @param dst The destination node.
+		 * @param weight The weight of the edge, optional.
+		 */
+		auto add_edge(N src, N dst, std::optional<E> weight = std::nullopt) -> void;
+
+		/**
+		 * @brief Builds the graph from everything added so far, and empties the builder.
+		 * @note Marked as [[nodiscard]] because the graph is lost if ignored.
+		 *
+		 * Time complexity: O((n + e) log (n + e)) for sorting, after which the graph is assembled in O(n + e).
+		 *
+		 * @return A graph with the added nodes and edges.
+		 */
+		[[nodiscard]] auto build() -> graph<N, E>;
+
+		/**
+		 * @brief Assembles a graph from nodes in strictly ascending order and edges between them in strictly ascending
+		 * order, appending both to the storage of the graph without any search. The storage is reserved from a
+		 * node_pool in one step, so no node or edge is allocated individually.
+		 * @note Marked as [[nodiscard]] because the graph is lost if ignored.
+		 *
+		 * Time complexity: O(n + e).
+		 *
+		 * @param nodes The sorted, unique nodes.
+		 * @param edges The sorted, unique edges, referring to nodes by position.
+		 * @return A graph with the given nodes and edges.
+		 * @throws std::runtime_error If the nodes or edges are unsorted or repeated, or an edge refers past the nodes.
+		 */
+		[[nodiscard]] static auto from_sorted(std::vector<N> nodes, std::vector<indexed_edge> const& edges)
+		    -> graph<N, E>;
+
+	 private:
+		std::vector<N> nodes_;
+		std::vector<std::tuple<N, N, std::optional<E>>> edges_;
+	};
+
+	// Redeclaration of graph friend functions graph_union, graph_intersection and graph_difference
+	template<typename T, typename U>
+	[[nodiscard]] auto graph_union(graph<T, U> const& a, graph<T, U> const& b) -> graph<T, U>;
+
+	template<typename T, typename U>
+	[[nodiscard]] auto graph_intersection(graph<T, U> const& a, graph<T, U> const& b) -> graph<T, U>;
+
+	template<typename T, typename U>
+	[[nodiscard]] auto graph_difference(graph<T, U> const& a, graph<T, U> const& b) -> graph<T, U>;
+} // namespace gdwg
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                               POOL ALLOCATOR FUNCTIONS                                                             //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename T>
+gdwg::pool_allocator<T>::pool_allocator(std::shared_ptr<node_pool> pool) noexcept
+: pool_{std::move(pool)} {}
+
+template<typename T>
+template<typename U>
+gdwg::pool_allocator<T>::pool_allocator(pool_allocator<U> const& other) noexcept
+: pool_{other.pool()} {}
+
+template<typename T>
+auto gdwg::pool_allocator<T>::allocate(std::size_t n) -> T* {
+	if (uses_pool())
+		return static_cast<T*>(pool_->allocate(n * sizeof(T)));
+	return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{alignof(T)}));
+}
+
+template<typename T>
+auto gdwg::pool_allocator<T>::deallocate(T* ptr, std::size_t n) noexcept -> void {
+	if (uses_pool())
+		pool_->deallocate(ptr, n * sizeof(T));
+	else
+		::operator delete(ptr, n * sizeof(T), std::align_val_t{alignof(T)});
+}
+
+template<typename T>
+auto gdwg::pool_allocator<T>::pool() const noexcept -> std::shared_ptr<node_pool> const& {
+	return pool_;
+}
+
+template<typename T>
+template<typename U>
+auto gdwg::pool_allocator<T>::operator==(pool_allocator<U> const& other) const noexcept -> bool {
+	return pool_ == other.pool();
+}
+
+template<typename T>
+auto gdwg::pool_allocator<T>::uses_pool() const noexcept -> bool {
+	return pool_ != nullptr and alignof(T) <= node_pool::alignment;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  HEAP USAGE FUNCTIONS                                                              //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename T>
+auto gdwg::heap_bytes(T const& value) noexcept -> std::size_t {
+	if constexpr (heap_owning<T>) {
+		return static_cast<std::size_t>(heap_usage<T>{}(value));
+	}
+	else {
+		return 0;
+	}
+}
+
+template<typename CharT, typename Traits, typename Alloc>
+auto gdwg::heap_usage<std::basic_string<CharT, Traits, Alloc>>::operator()(
+    std::basic_string<CharT, Traits, Alloc> const& value) const noexcept -> std::size_t {
+	// A default constructed string has exactly the capacity of the small string buffer
+	auto const inline_capacity = std::basic_string<CharT, Traits, Alloc>{}.capacity();
+	if (value.capacity() <= inline_capacity)
+		return 0;
+	return (value.capacity() + 1) * sizeof(CharT);
+}
+
+template<typename T, typename Alloc>
+auto gdwg::heap_usage<std::vector<T, Alloc>>::operator()(std::vector<T, Alloc> const& value) const noexcept
+    -> std::size_t {
+	auto bytes = value.capacity() * sizeof(T);
+	if constexpr (heap_owning<T>) {
+		for (auto const& elem : value) {
+			bytes += heap_bytes(elem);
+		}
+	}
+	return bytes;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  STATS DISABLED FUNCTIONS                                                          //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+constexpr gdwg::stats_disabled::stats_disabled(stats_disabled&, graph_operation) noexcept {}
+
+constexpr auto gdwg::stats_disabled::snapshot() const noexcept -> graph_stats {
+	return graph_stats{};
+}
+
+constexpr auto gdwg::stats_disabled::reset() noexcept -> void {}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  SPSC RING FUNCTIONS                                                               //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename T>
+gdwg::spsc_ring<T>::spsc_ring(std::size_t capacity)
+: slots_(std::bit_ceil(std::max(capacity, std::size_t{1})))
+, mask_{slots_.size() - 1}
+, head_{0}
+, tail_{0} {}
+
+template<typename T>
+auto gdwg::spsc_ring<T>::try_push(T const& value) -> bool {
+	auto const tail = tail_.load(std::memory_order_relaxed);
+	// Acquiring the head makes sure the consumer is done with the slot before it is reused
+	if (tail - head_.load(std::memory_order_acquire) == slots_.size())
+		return false;
+	slots_[tail & mask_].emplace(value);
+	tail_.store(tail + 1, std::memory_order_release);
+	return true;
+}
+
+template<typename T>
+auto gdwg::spsc_ring<T>::try_pop() -> std::optional<T> {
+	auto const head = head_.load(std::memory_order_relaxed);
+	// Acquiring the tail makes the element written by the producer visible
+	if (head == tail_.load(std::memory_order_acquire))
+		return std::nullopt;
+	auto& slot = slots_[head & mask_];
+	auto value = std::move(slot);
+	slot.reset();
+	head_.store(head + 1, std::memory_order_release);
+	return value;
+}
+
+template<typename T>
+auto gdwg::spsc_ring<T>::size() const noexcept -> std::size_t {
+	auto const head = head_.load(std::memory_order_acquire);
+	return tail_.load(std::memory_order_acquire) - head;
+}
+
+template<typename T>
+auto gdwg::spsc_ring<T>::capacity() const noexcept -> std::size_t {
+	return slots_.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  CHANGE FEED FUNCTIONS                                                             //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename N, typename E>
+gdwg::change_feed<N, E>::change_feed(std::size_t capacity)
+: ring_{capacity}
+, dropped_{0} {}
+
+template<typename N, typename E>
+auto gdwg::change_feed<N, E>::on_mutation(mutation<N, E> const& event) noexcept -> void {
+	try {
+		if (ring_.try_push(event))
+			return;
+	} catch (...) {
+		// Copying the event failed, which the consumer handles like a full ring
+	}
+	dropped_.fetch_add(1, std::memory_order_relaxed);
+}
+
+template<typename N, typename E>
+auto gdwg::change_feed<N, E>::on_lost() noexcept -> void {
+	dropped_.fetch_add(1, std::memory_order_relaxed);
+}
+
+template<typename N, typename E>
+auto gdwg::change_feed<N, E>::poll() -> std::optional<mutation<N, E>> {
+	return ring_.try_pop();
+}
+
+template<typename N, typename E>
+template<typename F>
+requires std::invocable<F&, gdwg::mutation<N, E>&&>
+auto gdwg::change_feed<N, E>::drain(F f) -> std::size_t {
+	auto count = std::size_t{0};
+	for (auto event = ring_.try_pop(); event; event = ring_.try_pop()) {
+		std::invoke(f, std::move(*event));
+		++count;
+	}
+	return count;
+}
+
+template<typename N, typename E>
+auto gdwg::change_feed<N, E>::dropped() const noexcept -> std::uint64_t {
+	return dropped_.load(std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                             COMPARE SHARED PTR FUNCTIONS                                                           //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename N, typename E>
+auto gdwg::graph<N, E>::compare_shared_ptr::operator()(std::shared_ptr<N> const& lhs,
+                                                       std::shared_ptr<N> const& rhs) const noexcept -> bool {
+	count_comparison();
+	return *lhs < *rhs;
+}
+
+template<typename N, typename E>
+auto gdwg::graph<N, E>::compare_shared_ptr::operator()(std::shared_ptr<N> const& lhs,
+                                                       N const& rhs) const noexcept -> bool {
+	count_comparison();
+	return *lhs < rhs;
+}
+
+template<typename N, typename E>
+auto gdwg::graph<N, E>::compare_shared_ptr::operator()(N const& lhs,
+                                                       std::shared_ptr<N> const& rhs) const noexcept -> bool {
+	count_comparison();
+	return lhs < *rhs;
+}
+
+template<typename N, typename E>
+template<gdwg::node_key<N> K>
+auto gdwg::graph<N, E>::compare_shared_ptr::operator()(std::shared_ptr<N> const& lhs,
+                                                       K const& rhs) const noexcept -> bool {
+	count_comparison();
+	return *lhs < rhs;
+}
+
+template<typename N, typename E>
+template<gdwg::node_key<N> K>
+auto gdwg::graph<N, E>::compare_shared_ptr::operator()(K const& lhs,
+                                                       std::shared_ptr<N> const& rhs) const noexcept -> bool {
+	count_comparison();
+	return lhs < *rhs;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                             COMPARE EDGES SET FUNCTIONS                                                            //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename N, typename E>
+auto gdwg::graph<N, E>::compare_edges_set::operator()(edge_tuple const& lhs,
+                                                      edge_tuple const& rhs) const noexcept -> bool {
+	count_comparison();
+	// Compare first node
+	if (std::get<0>(lhs) != std::get<0>(rhs))
+		return comp_shared_node_(std::get<0>(lhs), std::get<0>(rhs));
+
+	// Compare second node
+	if (std::get<1>(lhs) != std::get<1>(rhs))
+		return comp_shared_node_(std::get<1>(lhs), std::get<1>(rhs));
+
+	// Compare edge
+	return std::get<2>(lhs)->edge_comp(*std::get<2>(rhs)) == std::strong_ordering::less;
+}
+
+template<typename N, typename E>
+auto gdwg::graph<N, E>::compare_edges_set::operator()(edge_tuple const& lhs,
+                                                      edge_key const& rhs) const noexcept -> bool {
+	count_comparison();
+	return key_comp(lhs, rhs) == std::strong_ordering::less;
+}
+
+template<typename N, typename E>
+auto gdwg::graph<N, E>::compare_edges_set::operator()(edge_key const& lhs,
+                                                      edge_tuple const& rhs) const noexcept -> bool {
+	count_comparison();
+	return key_comp(rhs, lhs) == std::strong_ordering::greater;
+}
+
+template<typename N, typename E>
+auto gdwg::graph<N, E>::compare_edges_set::key_comp(edge_tuple const& lhs,
+                                                    edge_key const& rhs) noexcept -> std::strong_ordering {
+	// Compare first node, skipping the value comparison for the stored node itself
+	auto const& src = std::get<0>(lhs).get();
+	if (src != rhs.src) {
+		if (*src < *rhs.src)
+			return std::strong_ordering::less;
+		if (*rhs.src < *src)
+			return std::strong_ordering::greater;
+	}
+	// Compare second node
+	auto const& dst = std::get<1>(lhs).get();
+	if (dst != rhs.dst) {
+		if (*dst < *rhs.dst)
+			return std::strong_ordering::less;
+		if (*rhs.dst < *dst)
+			return std::strong_ordering::greater;
+	}
+	// Compare edge
+	return edge<N, E>::weight_comp(std::get<2>(lhs)->weight_, *rhs.weight);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  EDGE FUNCTIONS                                                                    //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename N, typename E>
+gdwg::edge<N, E>::edge(N const& src, N const& dst, std::optional<E> const& weight) noexcept
+: src_{src}
+, dst_{dst}
+, weight_{weight} {}
+
+template<typename N, typename E>
+auto gdwg::edge<N, E>::is_weighted() const noexcept -> bool {
+	return weight_ != std::nullopt;
+}
+
+template<typename N, typename E>
+auto gdwg::edge<N, E>::get_weight() const noexcept -> std::optional<E> {
+	return weight_;
+}
+
+template<typename N, typename E>
+auto gdwg::edge<N, E>::get_nodes() const noexcept -> std::pair<N, N> {
+	return std::make_pair(src_, dst_);
+}
+
+template<typename N, typename E>
+auto gdwg::edge<N, E>::operator==(edge const& other) const noexcept -> bool {
+	return get_nodes() == other.get_nodes() and get_weight() == other.get_weight();
+}
+
+template<typename N, typename E>
+auto gdwg::edge<N, E>::set_nodes(N const& src, N const& dst) noexcept -> void {
+	src_ = src;
+	dst_ = dst;
+}
+
+template<typename N, typename E>
+auto gdwg::edge<N, E>::edge_comp(edge const& other) const noexcept -> std::strong_ordering {
+	return weight_comp(weight_, other.weight_);
+}
+
+template<typename N, typename E>
+auto gdwg::edge<N, E>::weight_comp(std::optional<E> const& lhs, std::optional<E> const& rhs) noexcept
+    -> std::strong_ordering {
+	// both has no weight, they are equal
+	if (not lhs and not rhs)
+		return std::strong_ordering::equal;
+
+	// lhs has no weight, so it comes first
+	if (not lhs)
+		return std::strong_ordering::less;
+	// rhs has no weight, so it comes first
+	if (not rhs)
+		return std::strong_ordering::greater;
+
+	// Check if the weight type is a floating-point type
+	if constexpr (std::is_floating_point_v<E>) {
+		auto cmp = lhs <=> rhs;
+		if (cmp == std::partial_ordering::equivalent)
+			return std::strong_ordering::equal;
+		if (cmp == std::partial_ordering::less)
+			return std::strong_ordering::less;
+		return std::strong_ordering::greater;
+	}
+	else {
+		// For non-floating-point types, directly return the comparison result
+		return lhs <=> rhs;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                              WEIGHT EDGE FUNCTIONS                                                                 //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename N, typename E>
+gdwg::weighted_edge<N, E>::weighted_edge(N const& src, N const& dst, E const& weight) noexcept
+: edge<N, E>{src, dst, std::make_optional(weight)} {}
+
+template<typename N, typename E>
+auto gdwg::weighted_edge<N, E>::print_edge() const -> std::string {
+	auto oss = std::ostringstream{};
+	oss << this->src_ << " -> " << this->dst_ << " | W | " << this->weight_.value();
+	return oss.str();
+}
+
+template<typename N, typename E>
+auto gdwg::weighted_edge<N, E>::clone_ptr() const -> std::unique_ptr<edge<N, E>> {
+	return std::make_unique<weighted_edge>(*this);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                              UNWEIGHT EDGE FUNCTIONS                                                               //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename N, typename E>
+gdwg::unweighted_edge<N, E>::unweighted_edge(N const& src, N const& dst) noexcept
+: edge<N, E>{src, dst} {}
+
+template<typename N, typename E>
+auto gdwg::unweighted_edge<N, E>::print_edge() const -> std::string {
+	auto oss = std::ostringstream{};
+	oss << this->src_ << " -> " << this->dst_ << " | U";
+	return oss.str();
+}
+
+template<typename N, typename E>
+auto gdwg::unweighted_edge<N, E>::clone_ptr() const -> std::unique_ptr<edge<N, E>> {
+	return std::make_unique<unweighted_edge>(*this);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                   GRAPH FUNCTIONS                                                                  //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename N, typename E>
+gdwg::graph<N, E>::graph() noexcept
+: pool_{nullptr}
+, nodes_{type_nodes_set{}}
+, edges_{edges_set{}}
+, tombstones_{type_nodes_set{}}
+, lazy_erase_{false}
+, fingerprint_{}
+, sinks_{}
+, version_{next_version()} {}
+
+template<typename N, typename E>
+gdwg::graph<N, E>::graph(std::initializer_list<N> const& il)
+: graph{il.begin(), il.end()} {}
+
+template<typename N, typename E>
+template<typename InputIt>
+gdwg::graph<N, E>::graph(InputIt const& first, InputIt const& last)
+: graph{} {
+	std::transform(first, last, std::inserter(nodes_, nodes_.end()), [this](auto const& elem) {
+		return make_node(elem);
+	});
+	refresh_fingerprint();
+}
+
+template<typename N, typename E>
+gdwg::graph<N, E>::graph(graph const& other)
+: graph{} {
+	deep_copy(other);
+}
+
+template<typename N, typename E>
+gdwg::graph<N, E>::graph(graph&& other) noexcept
+: pool_(std::exchange(other.pool_, nullptr))
+, nodes_(std::exchange(other.nodes_, type_nodes_set{}))
+, edges_(std::exchange(other.edges_, edges_set{}))
+, tombstones_(std::exchange(other.tombstones_, type_nodes_set{}))
+, lazy_erase_(std::exchange(other.lazy_erase_, false))
+, fingerprint_(std::exchange(other.fingerprint_, graph_fingerprint{}))
+, version_(other.version_) {
+	// The sinks stay with the object they were attached to, which is now empty
+	other.notify(mutation_kind::clear);
+}
+
+template<typename N, typename E>
+auto gdwg::graph<N, E>::operator=(graph const& other) -> graph& {
+	if (this != &other) {
+		deep_copy(other);
+	}
+	return *this;
+}
+
+template<typename N, typename E>
+auto gdwg::graph<N, E>::operator=(graph&& other) noexcept -> graph& {
+	if (this != &other) {
+		pool_ = std::exchange(other.pool_, nullptr);
+		nodes_ = std::exchange(other.nodes_, type_nodes_set{});
+		edges_ = std::exchange(other.edges_, edges_set{});
+		tombstones_ = std::exchange(other.tombstones_, type_nodes_set{});
+		lazy_erase_ = std::exchange(other.lazy_erase_, false);
+		fingerprint_ = std::exchange(other.fingerprint_, graph_fingerprint{});
+		other.notify(mutation_kind::clear);
+		replay();
+	}
+	return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                             GRAPH MODIFIER FUNCTIONS                                                               //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename N, typename E>
+auto gdwg::graph<N, E>::insert_node(N const& value) -> bool {
+	[[maybe_unused]] auto const& probe_scope = probe(graph_operation::insert_node);
+	if (nodes_.contains(value))
+		return false;
+	revive(value);
+	auto const& new_node = make_node(value);
+	nodes_.insert(new_node);
+	fingerprint_ += node_fingerprint(value);
+	notify(mutation_kind::insert_node, new_node.get());
+	return true;
+}
+
+template<typename N, typename E>
+auto gdwg::graph<N, E>::insert_node(N&& value) -> bool {
+	[[maybe_unused]] auto const& probe_scope = probe(graph_operation::insert_node);
+	if (nodes_.contains(value))
+		return false;
+	revive(value);
+	auto const& new_node = make_node(std::move(value));
+	nodes_.insert(new_node);
+	fingerprint_ += node_fingerprint(*new_node);
+	notify(mutation_kind::insert_node, new_node.get());
+	return true;
+}
+
+template<typename N, typename E>
+auto gdwg::graph<N, E>::insert_edge(N const& src, N const& dst, std::optional<E> const& weight) -> bool {
+	return insert_edge<N, N>(src, dst, weight);
+}
+
+template<typename N, typename E>
+template<gdwg::node_key<N> Src, gdwg::node_key<N> Dst>
+auto gdwg::graph<N, E>::insert_edge(Src const& src, Dst const& dst, std::optional<E> const& weight) -> bool {
+	[[maybe_unused]] auto const& probe_scope = probe(graph_operation::insert_edge);
+	auto const& src_ptr = find_node_ptr(src);
+	auto const& dst_ptr = find_node_ptr(dst);
+	if (not src_ptr or not dst_ptr) {
+		throw std::runtime_error("Cannot call gdwg::graph<N, E>::insert_edge when either src or dst node does not "
+		                         "exist");
+	}
+	// Look the edge up before allocating it, so that duplicates cost no allocation.
+	auto const& key = edge_key{src_ptr.get(), dst_ptr.get(), &weight};
+	auto const& hint = edges_.lower_bound(key);
+	if (hint != edges_.end() and not edges_.key_comp()(key, *hint))
+		return false;
+	// Copy the endpoints from the stored nodes so that heterogeneous keys never need converting to N.
+	auto const& edge_ptr = make_edge(*src_ptr, *dst_ptr, weight);
+	auto const& new_edge = edges_.insert(hint, edge_tuple{src_ptr, dst_ptr, edge_ptr});
+	fingerprint_ += edge_fingerprint(*new_edge);
+	notify_edge(mutation_kind::insert_edge, *new_edge);
+	return true;
+}
+
+template<typename N, typename E>
+auto gdwg::graph<N, E>::replace_node(N const& old_data, N const& new_data) -> bool {
+	return replace_node_impl(old_data, new_data);
+}
+
+template<typename N, typename E>
+auto gdwg::graph<N, E>::replace_node(N const& old_data, N&& new_data) -> bool {
+	return replace_node_impl(old_data, std::move(new_data));
+}
+
+template<typename N, typename E>
+template<typename V>
+auto gdwg::graph<N, E>::replace_node_impl(N const& old_data, V&& new_data) -> bool {
+	[[maybe_unused]] auto const& probe_scope = probe(graph_operation::replace_node);
+	auto const& src_ptr = find_node_ptr(old_data);
+	if (not src_ptr)
+		throw std::runtime_error("Cannot call gdwg::graph<N, E>::replace_node on a node that doesn't exist");
+
+	if (is_node(new_data))
+		return false;
+
+	if (old_data != new_data) {
+		revive(new_data);
+		auto const& new_node = make_node(std::forward<V>(new_data));
+		nodes_.erase(src_ptr);
+		nodes_.insert(new_node);
+		fingerprint_ -= node_fingerprint(*src_ptr);
+		fingerprint_ += node_fingerprint(*new_node);
+		update_node(src_ptr, new_node);
+		notify(mutation_kind::replace_node, src_ptr.get(), new_node.get());
+	}
+	return true;
+}
+
+template<typename N, typename E>
+auto gdwg::graph<N, E>::merge_replace_node(N const& old_data, N const& new_data) -> void {
+	[[maybe_unused]] auto const& probe_scope = probe(graph_operation::merge_replace_node);
+	auto const& src_ptr = find_node_ptr(old_data);
+	auto const& new_ptr = find_node_ptr(new_data);
+	if (not src_ptr or not new_ptr)
+		throw std::runtime_error("Cannot call gdwg::graph<N, E>::merge_replace_node on old or new data if they don't "
+		                         "exist in the graph");
+
+	if (old_data != new_data) {
+		nodes_.erase(src_ptr);
+		fingerprint_ -= node_fingerprint(*src_ptr);
+		update_node(src_ptr, new_ptr);
+		notify(mutation_kind::merge_replace_node, src_ptr.get(), new_ptr.get());
+	}
+}
+
+template<typename N, typename E>
+auto gdwg::graph<N, E>::erase_node(N const& value) -> bool {
+	return erase_node<N>(value);
+}
+
+template<typename N, typename E>
+template<gdwg::node_key<N> K>
+auto gdwg::graph<N, E>::erase_node(K const& value) -> bool {
+	[[maybe_unused]] auto const& probe_scope = probe(graph_operation::erase_node);
+	auto const& node_ptr = find_node_ptr(value);
+	if (not node_ptr)
+		return false;
+
+	nodes_.erase(node_ptr);
+	fingerprint_ -= node_fingerprint(*node_ptr);
+	notify(mutation_kind::erase_node, node_ptr.get());
+	if (lazy_erase_) {
+		// The edges keep referencing the node, and are skipped until the next compaction.
+		tombstones_.insert(node_ptr);
+		return true;
+	}
+	// Nodes are unique in the graph, so comparing the stored pointers is equivalent to comparing values.
+	std::erase_if(edges_, [this, &node_ptr](auto const& e) {
+		count_visit();
+		auto const& [from, to, edge] = e;
+		if (from != node_ptr and to != node_ptr)
+			return false;
+		fingerprint_ -= edge_fingerprint(e);
+		notify_edge(mutation_kind::erase_edge, e, true);
+		return true;
+	});
+	return true;
+}
+
+template<typename N, typename E>
+auto gdwg::graph<N, E>::erase_edge(N const& src, N const& dst, std::optional<E> const& weight) -> bool {
+	return erase_edge<N, N>(src, dst, weight);
+}
+
+template<typename N, typename E>
+template<gdwg::node_key<N> Src, gdwg::node_key<N> Dst>
+auto gdwg::graph<N, E>::erase_edge(Src const& src, Dst const& dst, std::optional<E> const& weight) -> bool {
+	[[maybe_unused]] auto const& probe_scope = probe(graph_operation::erase_edge);
+	auto const& src_ptr = find_node_ptr(src);
+	auto const& dst_ptr = find_node_ptr(dst);
+	if (not src_ptr or not dst_ptr)
+		throw std::runtime_error("Cannot call gdwg::graph<N, E>::erase_edge on src or dst if they don't exist in the "
+		                         "graph");
+
+	auto const& edge_ptr = edges_.find(edge_key{src_ptr.get(), dst_ptr.get(), &weight});
+	if (edge_ptr == edges_.end())
+		return false;
+
+	fingerprint_ -= edge_fingerprint(*edge_ptr);
+	notify_edge(mutation_kind::erase_edge, *edge_ptr);
+	edges_.erase(edge_ptr);
+	return true;
+}
+
+template<typename N, typename E>
+auto gdwg::graph<N, E>::erase_edge(iterator const& i) noexcept -> iterator {
+	auto const& it = i.base();
+	fingerprint_ -= edge_fingerprint(*it);
+	notify_edge(mutation_kind::erase_edge, *it);
+	return make_iterator(edges_.erase(it));
+}
+
+template<typename N, typename E>
+auto gdwg::graph<N, E>::erase_edge(iterator const& i, iterator const& s) noexcept -> iterator {
+	auto const& begin = i.base();
+	auto const& end = s.base();
+	for (auto it = begin; it != end; ++it) {
+		fingerprint_ -= edge_fingerprint(*it);
+		notify_edge(mutation_kind::erase_edge, *it, is_tombstoned(*it));
+	}
+	return make_iterator(edges_.erase(begin, end));
+}
+
+template<typename N, typename E>
+template<std::ranges::input_range R>
+requires gdwg::node_key<std::ranges::range_value_t<R>, N>
+auto gdwg::graph<N, E>::erase_nodes(R&& values) -> std::size_t {
+	auto doomed = std::unordered_set<N const*>{};
+	if constexpr (std::ranges::sized_range<R>) {
+		doomed.reserve(std::ranges::size(values));
+	}
+	for (auto const& value : values) {
+		auto const& it = nodes_.find(value);
+		if (it != nodes_.end()) {
+			doomed.insert(it->get());
+			fingerprint_ -= node_fingerprint(**it);
+			notify(mutation_kind::erase_node, it->get());
+			nodes_.erase(it);
+		}
+	}
+	if (doomed.empty())
+		return 0;
+
+	// The edges still own the doomed nodes, so their addresses stay valid until the sweep is done.
+	// The sweep visits every edge anyway, so it compacts the tombstoned ones as well.
+	std::erase_if(edges_, [this, &doomed](auto const& e) {
+		auto const& [from, to, edge] = e;
+		if (not doomed.contains(from.get()) and not doomed.contains(to.get()) and not is_tombstoned(e))
+			return false;
+		fingerprint_ -= edge_fingerprint(e);
+		notify_edge(mutation_kind::erase_edge, e, true);
+		return true;
+	});
+	tombstones_.clear();
+	return doomed.size();
+}
+
+template<typename N, typename E>
+template<typename Pred>
+requires std::predicate<Pred&, N const&, N const&, std::optional<E> const&>
+auto gdwg::graph<N, E>::erase_edges_if(Pred pred) -> std::size_t {
+	auto erased = std::size_t{0};
+	// Tombstoned edges are removed by the same pass, but are not counted or shown to the predicate.
+	std::erase_if(edges_, [this, &pred, &erased](auto const& e) {
+		auto const& cascaded = is_tombstoned(e);
+		if (not cascaded) {
+			auto const& [from, to, edge] = e;
+			if (not std::invoke(pred, *from, *to, edge->weight_))
+				return false;
+			++erased;
+		}
+		fingerprint_ -= edge_fingerprint(e);
+		notify_edge(mutation_kind::erase_edge, e, cascaded);
+		return true;
+	});
+	tombstones_.clear();
+	return erased;
+}
+
+template<typename N, typename E>
+auto gdwg::graph<N, E>::clear() noexcept -> void {
+	nodes_.clear();
+	edges_.clear();
+	tombstones_.clear();
+	fingerprint_ = graph_fingerprint{};
+	notify(mutation_kind::clear);
+}
+
+template<typename N, typename E>
+auto gdwg::graph<N, E>::reserve(std::size_t node_count, std::size_t edge_count) -> void {
+	if (pool_) {
+		node_count -= std::min(node_count, nodes_.size());
+		edge_count -= std::min(edge_count, edges_.size());
+		pool_->reserve(storage_bytes(node_count, edge_count));
+		return;
+	}
+	auto const& pool = std::make_shared<node_pool>();
+	pool->reserve(storage_bytes(std::max(node_count, nodes_.size()), std::max(edge_count, edges_.size())));
+	rebuild_storage(pool);
+}
+
+template<typename N, typename E>
+auto gdwg::graph<N, E>::shrink_to_fit() -> void {
+	if (not pool_)
+		return;
+	auto const& pool = std::make_shared<node_pool>();
+	pool->reserve(storage_bytes(nodes_.size(), edges_.size()));
+	rebuild_storage(pool);
+}
+
+template<typename N, typename E>
+auto gdwg::graph<N, E>::reserved_bytes() const noexcept -> std::size_t {
+	return pool_ ? pool_->capacity() : 0;
+}
+
+template<typename N, typename E>
+auto gdwg::graph<N, E>::set_lazy_erase(bool enabled) noexcept -> void {
+	lazy_erase_ = enabled;
+	if (not enabled)
+		compact();
+}
+
+template<typename N, typename E>
+auto gdwg::graph<N, E>::lazy_erase() const noexcept -> bool {
+	return lazy_erase_;
+}
+
+template<typename N, typename E>
+auto gdwg::graph<N, E>::tombstones() const noexcept -> std::size_t {
+	return tombstones_.size();
+}
+
+template<typename N, typename E>
+auto gdwg::graph<N, E>::compact() noexcept -> void {
+	if (tombstones_.empty())
+		return;
+	std::erase_if(edges_, [this](auto const& e) {
+		if (not is_tombstoned(e))
+			return false;
+		fingerprint_ -= edge_fingerprint(e);
+		notify_edge(mutation_kind::erase_edge, e, true);
+		return true;
+	});
+	tombstones_.clear();
+}
+
+template<typename N, typename E>
+auto gdwg::graph<N, E>::compact_async() const -> pending_compaction {
+	// The background thread only sees the snapshot, which keeps every edge and node it refers to alive
+	auto edges = std::vector<edge_tuple>(edges_.begin(), edges_.end());
+	auto doomed = std::unordered_set<N const*>{};
+	doomed.reserve(tombstones_.size());
+	for (auto const& n : tombstones_) {
+		doomed.insert(n.get());
+	}
+	auto build = [edges = std::move(edges), doomed = std::move(doomed), allocator = edges_.get_allocator()] {
+		auto result = typename pending_compaction::result_type{edges_set{allocator}, {}, {}};
+		for (auto const& e : edges) {
+			auto const& [src, dst, edge] = e;
+			if (doomed.contains(src.get()) or doomed.contains(dst.get())) {
+				result.erased_fingerprint += edge_fingerprint(e);
+				result.erased.push_back(e);
+			}
+			else {
+				// The snapshot is in set order, so every edge is appended at the end in O(1)
+				result.edges.insert(result.edges.end(), e);
+			}
+		}
+		return result;
+	};
+	auto pending = pending_compaction{};
+	pending.result_ = std::async(std::launch::async, std::move(build));
+	pending.version_ = version_;
+	return pending;
+}
+
+template<typename N, typename E>
+auto gdwg::graph<N, E>::compact(pending_compaction pending) noexcept -> void {
+	try {
+		auto result = pending.result_.get();
+		if (pending.version_ == version_) {
+			// The old edges are released on this thread, as the sinks may still look at them
+			edges_.swap(result.edges);
+			fingerprint_ -= result.erased_fingerprint;
+			tombstones_.clear();
+			version_ = next_version();
+			for (auto const& e : result.erased) {
+				notify_edge(mutation_kind::erase_edge, e, true);
+			}
+			return;
+		}
+	} catch (...) {
+		// A compaction which failed to build is simply redone here
+	}
+	compact();
+}
+
+template<typename N, typename E>
+auto gdwg::graph<N, E>::pending_compaction::ready() const -> bool {
+	return result_.wait_for(std::chrono::seconds{0}) == std::future_status::ready;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                            GRAPH ACCESSORS FUNCTIONS                                                               //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename N, typename E>
+auto gdwg::graph<N, E>::is_node(N const& value) const noexcept -> bool {
+	[[maybe_unused]] auto const& probe_scope = probe(graph_operation::is_node);
+	return nodes_.contains(value);
+}
+
+template<typename N, typename E>
+template<gdwg::node_key<N> K>
+auto gdwg::graph<N, E>::is_node(K const& value) const noexcept -> bool {
+	[[maybe_unused]] auto const& probe_scope = probe(graph_operation::is_node);
+	return nodes_.contains(value);
+}
+
+template<typename N, typename E>
+auto gdwg::graph<N, E>::empty() const noexcept -> bool {
+	return nodes_.empty();
+}
+
+template<typename N, typename E>
+auto gdwg::graph<N, E>::node_count() const noexcept -> std::size_t {
+	return nodes_.size();
+}
+
+template<typename N, typename E>
+auto gdwg::graph<N, E>::edge_count() const noexcept -> std::size_t {
+	if (tombstones_.empty())
+		return edges_.size();
+	return static_cast<std::size_t>(std::ranges::distance(live_edges()));
+}
+
+template<typename N, typename E>
+auto gdwg::graph<N, E>::is_connected(N const& src, N const& dst) const -> bool {
+	return is_connected<N, N>(src, dst);
+}
+
+template<typename N, typename E>
+template<gdwg::node_key<N> Src, gdwg::node_key<N> Dst>
+auto gdwg::graph<N, E>::is_connected(Src const& src, Dst const& dst) const -> bool {
+	[[maybe_unused]] auto const& probe_scope = probe(graph_operation::is_connected);
+	auto const& src_node = find_node_ptr(src);
+	auto const& dst_node = find_node_ptr(dst);
+	if (not src_node or not dst_node)
+		throw std::runtime_error("Cannot call gdwg::graph<N, E>::is_connected if src or dst node don't exist in the "
+		                         "graph");
+
+	// Unweighted edges sort first, so the lower bound of an unweighted edge is the first edge between the nodes.
+	auto const& no_weight = std::optional<E>{};
+	auto const& it = edges_.lower_bound(edge_key{src_node.get(), dst_node.get(), &no_weight});
+	return it != edges_.end() and std::get<0>(*it) == src_node and std::get<1>(*it) == dst_node;
+}
+
+template<typename N, typename E>
+auto gdwg::graph<N, E>::nodes() const -> std::vector<N> {
+	auto vec = std::vector<N>{};
+	vec.reserve(nodes_.size());
+
+	// Use std::transform to copy elements to vec
+	std::ranges::transform(nodes_, std::back_inserter(vec), [](auto const& n) { return *n; });
+	return vec;
+}
+
+template<typename N, typename E>
+template<std::invocable<N const&> F>
+auto gdwg::graph<N, E>::for_each_node(F fn) const -> void {
+	for (auto const& n : nodes_) {
+		std::invoke(fn, *n);
+	}
 }
 
 template<typename N, typename E>
-auto gdwg::graph<N, E>::compare_shared_ptr::operator()(std::shared_ptr<N> const& lhs,
-                                                       N const& rhs) const noexcept -> bool {
-	return *lhs < rhs;
+template<std::invocable<N const&, N const&, std::optional<E> const&> F>
+auto gdwg::graph<N, E>::for_each_edge(F fn) const -> void {
+	for (auto const& [src, dst, edge] : live_edges()) {
+		std::invoke(fn, *src, *dst, edge->weight_);
+	}
 }
 
 template<typename N, typename E>
-auto gdwg::graph<N, E>::compare_shared_ptr::operator()(N const& lhs,
-                                                       std::shared_ptr<N> const& rhs) const noexcept -> bool {
-	return lhs < *rhs;
+auto gdwg::graph<N, E>::edges(N const& src, N const& dst) const -> std::vector<std::unique_ptr<edge<N, E>>> {
+	return edges<N, N>(src, dst);
 }
 
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-//                             COMPARE EDGES SET FUNCTIONS                                                            //
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template<typename N, typename E>
-auto gdwg::graph<N, E>::compare_edges_set::operator()(edge_tuple const& lhs,
-                                                      edge_tuple const& rhs) const noexcept -> bool {
-	// Compare first node
-	if (std::get<0>(lhs) != std::get<0>(rhs))
-		return comp_shared_node_(std::get<0>(lhs), std::get<0>(rhs));
-
-	// Compare second node
-	if (std::get<1>(lhs) != std::get<1>(rhs))
-		return comp_shared_node_(std::get<1>(lhs), std::get<1>(rhs));
+template<gdwg::node_key<N> Src, gdwg::node_key<N> Dst>
+auto gdwg::graph<N, E>::edges(Src const& src, Dst const& dst) const -> std::vector<std::unique_ptr<edge<N, E>>> {
+	[[maybe_unused]] auto const& probe_scope = probe(graph_operation::edges);
+	auto const& src_node = find_node_ptr(src);
+	auto const& dst_node = find_node_ptr(dst);
+	if (not src_node or not dst_node)
+		throw std::runtime_error("Cannot call gdwg::graph<N, E>::edges if src or dst node don't exist in the graph");
 
-	// Compare edge
-	return std::get<2>(lhs)->edge_comp(*std::get<2>(rhs)) == std::strong_ordering::less;
+	auto vec = std::vector<std::unique_ptr<edge<N, E>>>{};
+	auto const& no_weight = std::optional<E>{};
+	for (auto it = edges_.lower_bound(edge_key{src_node.get(), dst_node.get(), &no_weight}); it != edges_.end(); ++it)
+	{
+		count_visit();
+		auto const& [src_ptr, dst_ptr, edge_ptr] = *it;
+		if (src_ptr != src_node or dst_ptr != dst_node)
+			break;
+		vec.push_back(edge_ptr->clone_ptr());
+	}
+	return vec;
 }
 
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-//                                  EDGE FUNCTIONS                                                                    //
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template<typename N, typename E>
-gdwg::edge<N, E>::edge(N const& src, N const& dst, std::optional<E> const& weight) noexcept
-: src_{src}
-, dst_{dst}
-, weight_{weight} {}
+auto gdwg::graph<N, E>::find(N const& src, N const& dst, std::optional<E> const& weight) const noexcept -> iterator {
+	return find<N, N>(src, dst, weight);
+}
 
 template<typename N, typename E>
-auto gdwg::edge<N, E>::is_weighted() const noexcept -> bool {
-	return weight_ != std::nullopt;
+template<gdwg::node_key<N> Src, gdwg::node_key<N> Dst>
+auto gdwg::graph<N, E>::find(Src const& src, Dst const& dst, std::optional<E> const& weight) const noexcept
+    -> iterator {
+	[[maybe_unused]] auto const& probe_scope = probe(graph_operation::find);
+	auto const& src_node = find_node_ptr(src);
+	auto const& dst_node = find_node_ptr(dst);
+	if (not src_node or not dst_node)
+		return end();
+
+	// Look up the stored tuple rather than dereferencing iterators, which would copy both nodes per edge.
+	return iterator{edges_.find(edge_key{src_node.get(), dst_node.get(), &weight}), this};
 }
 
 template<typename N, typename E>
-auto gdwg::edge<N, E>::get_weight() const noexcept -> std::optional<E> {
-	return weight_;
+auto gdwg::graph<N, E>::connections(N const& src) const -> std::vector<N> {
+	return connections<N>(src);
 }
 
 template<typename N, typename E>
-auto gdwg::edge<N, E>::get_nodes() const noexcept -> std::pair<N, N> {
-	return std::make_pair(src_, dst_);
+template<gdwg::node_key<N> K>
+auto gdwg::graph<N, E>::connections(K const& src) const -> std::vector<N> {
+	[[maybe_unused]] auto const& probe_scope = probe(graph_operation::connections);
+	auto const& src_node = find_node_ptr(src);
+	if (not src_node)
+		throw std::runtime_error("Cannot call gdwg::graph<N, E>::connections if src doesn't exist in the graph");
+
+	auto vec = std::vector<N>{};
+	for (auto const& e : edges_) {
+		count_visit();
+		auto const& [src_ptr, dst_ptr, edge_ptr] = e;
+		if (src_ptr == src_node and not is_tombstoned(e))
+			vec.push_back(*dst_ptr);
+	}
+	// O(e) for remove duplicate elements by STL algorithm unique.
+	auto const& last = std::unique(vec.begin(), vec.end());
+	vec.erase(last, vec.end());
+	return vec;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                               GRAPH SUBGRAPH FUNCTIONS                                                             //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template<typename N, typename E>
-auto gdwg::edge<N, E>::operator==(edge const& other) const noexcept -> bool {
-	return get_nodes() == other.get_nodes() and get_weight() == other.get_weight();
+template<std::ranges::input_range R>
+    requires gdwg::node_key<std::ranges::range_value_t<R>, N>
+auto gdwg::graph<N, E>::induced_subgraph(R&& nodes) const -> graph {
+	auto selected = std::vector<std::shared_ptr<N>>{};
+	if constexpr (std::ranges::sized_range<R>) {
+		selected.reserve(std::ranges::size(nodes));
+	}
+	for (auto const& value : nodes) {
+		auto node = find_node_ptr(value);
+		if (not node)
+			throw std::runtime_error("Cannot call gdwg::graph<N, E>::induced_subgraph if a node doesn't exist in the "
+			                         "graph");
+		selected.push_back(std::move(node));
+	}
+	return induced_by(std::move(selected));
 }
 
 template<typename N, typename E>
-auto gdwg::edge<N, E>::set_nodes(N const& src, N const& dst) noexcept -> void {
-	src_ = src;
-	dst_ = dst;
+auto gdwg::graph<N, E>::induced_subgraph(std::initializer_list<N> nodes) const -> graph {
+	return induced_subgraph(std::views::all(nodes));
 }
 
 template<typename N, typename E>
-auto gdwg::edge<N, E>::edge_comp(edge const& other) const noexcept -> std::strong_ordering {
-	// both has no weight, they are equal
-	if (not is_weighted() and not other.is_weighted())
-		return std::strong_ordering::equal;
+auto gdwg::graph<N, E>::ego_graph(N const& seed, std::size_t hops) const -> graph {
+	auto seed_node = find_node_ptr(seed);
+	if (not seed_node)
+		throw std::runtime_error("Cannot call gdwg::graph<N, E>::ego_graph if seed doesn't exist in the graph");
+
+	// Nodes are unique per graph, so the search can track them by address
+	auto visited = std::unordered_set<N const*>{seed_node.get()};
+	auto selected = std::vector<std::shared_ptr<N>>{std::move(seed_node)};
+	for (auto begin = std::size_t{0}, hop = std::size_t{0}; hop < hops and begin < selected.size(); ++hop) {
+		auto const end = selected.size();
+		for (auto i = begin; i < end; ++i) {
+			auto const* const src = selected[i].get();
+			for (auto it = first_out_edge(src); it != edges_.end() and std::get<0>(*it).get() == src; ++it) {
+				count_visit();
+				auto const& dst = std::get<1>(*it);
+				if (not is_tombstoned(*it) and visited.insert(dst.get()).second)
+					selected.push_back(dst);
+			}
+		}
+		begin = end;
+	}
+	return induced_by(std::move(selected));
+}
 
-	// lhs has no weight, so it comes first
-	if (not is_weighted())
-		return std::strong_ordering::less;
-	// rhs has no weight, so it comes first
-	if (not other.is_weighted())
-		return std::strong_ordering::greater;
+template<typename N, typename E>
+template<std::predicate<N const&> P>
+auto gdwg::graph<N, E>::filtered(P pred) const -> graph_view<N, E, P> {
+	return graph_view<N, E, P>{*this, std::move(pred)};
+}
 
-	// Check if the weight type is a floating-point type
-	if constexpr (std::is_floating_point_v<E>) {
-		auto cmp = weight_ <=> other.weight_;
-		if (cmp == std::partial_ordering::equivalent)
-			return std::strong_ordering::equal;
-		if (cmp == std::partial_ordering::less)
-			return std::strong_ordering::less;
-		return std::strong_ordering::greater;
+template<typename N, typename E>
+auto gdwg::graph<N, E>::transpose() const -> graph {
+	auto const& order = in_edge_order();
+	auto result = graph{};
+	if (pool_) {
+		// The node objects stay in this graph's pool, so the result only needs room for its set entries and edges
+		auto const& pool = std::make_shared<node_pool>();
+		pool->reserve(storage_bytes(0, order.size()) + nodes_.size() * node_pool::block_size(node_entry_bytes));
+		result.rebuild_storage(pool);
 	}
-	else {
-		// For non-floating-point types, directly return the comparison result
-		return weight_ <=> other.weight_;
+	for (auto const& n : nodes_) {
+		result.nodes_.insert(result.nodes_.end(), n);
+	}
+	result.fingerprint_ = fingerprint_;
+	for (auto const& e : edges_) {
+		result.fingerprint_ -= edge_fingerprint(e);
 	}
+	for (auto const* e : order) {
+		auto const& [src, dst, edge] = *e;
+		auto const& new_edge = edge_tuple{dst, src, result.make_edge(*dst, *src, edge->get_weight())};
+		result.edges_.insert(result.edges_.end(), new_edge);
+		result.fingerprint_ += edge_fingerprint(new_edge);
+	}
+	return result;
 }
 
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-//                              WEIGHT EDGE FUNCTIONS                                                                 //
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template<typename N, typename E>
-gdwg::weighted_edge<N, E>::weighted_edge(N const& src, N const& dst, E const& weight) noexcept
-: edge<N, E>{src, dst, std::make_optional(weight)} {}
+auto gdwg::graph<N, E>::reversed() const -> reverse_view<N, E> {
+	return reverse_view<N, E>{*this};
+}
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                               GRAPH ITERATOR ACCESS FUNCTIONS                                                      //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template<typename N, typename E>
-auto gdwg::weighted_edge<N, E>::print_edge() const -> std::string {
-	auto oss = std::ostringstream{};
-	oss << this->src_ << " -> " << this->dst_ << " | W | " << this->weight_.value();
-	return oss.str();
+auto gdwg::graph<N, E>::begin() const noexcept -> iterator {
+	return make_iterator(edges_.begin());
 }
 
 template<typename N, typename E>
-auto gdwg::weighted_edge<N, E>::clone_ptr() const -> std::unique_ptr<edge<N, E>> {
-	return std::make_unique<weighted_edge>(*this);
+auto gdwg::graph<N, E>::end() const noexcept -> iterator {
+	return iterator{edges_.end(), this};
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-//                              UNWEIGHT EDGE FUNCTIONS                                                               //
+//                                  GRAPH COMPARISON FUNCTIONS                                                        //
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template<typename N, typename E>
-gdwg::unweighted_edge<N, E>::unweighted_edge(N const& src, N const& dst) noexcept
-: edge<N, E>{src, dst} {}
+auto gdwg::graph<N, E>::operator==(graph const& other) const noexcept -> bool {
+	auto const& compacted = tombstones_.empty() and other.tombstones_.empty();
+	if (nodes_.size() != other.nodes_.size() or (compacted and edges_.size() != other.edges_.size())) {
+		return false;
+	}
+	// Equal graphs always have equal fingerprints, so a mismatch rejects without walking the contents
+	if (fingerprint() != other.fingerprint()) {
+		return false;
+	}
+	// Compare nodes using std::equal
+	if (not std::ranges::equal(nodes_, other.nodes_, [](auto const& lhs, auto const& rhs) { return *lhs == *rhs; })) {
+		return false;
+	}
+	// Compare edges using std::equal, skipping the edges of lazily erased nodes
+	auto const& live = [](graph const& g) {
+		return g.edges_ | std::views::filter([&g](auto const& e) { return not g.is_tombstoned(e); });
+	};
+	if (not std::ranges::equal(live(*this), live(other), [](auto const& lhs, auto const& rhs) {
+		    return *std::get<2>(lhs) == *std::get<2>(rhs);
+	    }))
+	{
+		return false;
+	}
+	return true;
+}
 
 template<typename N, typename E>
-auto gdwg::unweighted_edge<N, E>::print_edge() const -> std::string {
-	auto oss = std::ostringstream{};
-	oss << this->src_ << " -> " << this->dst_ << " | U";
-	return oss.str();
+auto gdwg::graph<N, E>::fingerprint() const noexcept -> graph_fingerprint {
+	if (tombstones_.empty())
+		return fingerprint_;
+	// Edges of lazily erased nodes are still part of fingerprint_ until they are compacted
+	auto live = fingerprint_;
+	for (auto const& e : edges_) {
+		if (is_tombstoned(e))
+			live -= edge_fingerprint(e);
+	}
+	return live;
 }
 
 template<typename N, typename E>
-auto gdwg::unweighted_edge<N, E>::clone_ptr() const -> std::unique_ptr<edge<N, E>> {
-	return std::make_unique<unweighted_edge>(*this);
+auto gdwg::graph<N, E>::memory_usage() const noexcept -> graph_memory_usage {
+	// Tombstoned nodes are still alive in their own set until they are compacted
+	auto const node_count = nodes_.size() + tombstones_.size();
+	auto const edge_count = edges_.size();
+	auto usage = graph_memory_usage{};
+	usage.node_storage = node_count * (node_entry_bytes + node_object_bytes);
+	usage.edge_storage = edge_count * (edge_entry_bytes + edge_object_bytes);
+	if (pool_) {
+		// A transpose shares the node objects of its source, so only the objects in blocks of this pool are counted
+		auto const entry_blocks =
+		    node_count * node_pool::block_size(node_entry_bytes)
+		    + edge_count * (node_pool::block_size(edge_entry_bytes) + node_pool::block_size(edge_object_bytes));
+		auto const used = pool_->used();
+		auto const objects =
+		    std::min(node_count, (used - std::min(used, entry_blocks)) / node_pool::block_size(node_object_bytes));
+		usage.node_storage = node_count * node_entry_bytes + objects * node_object_bytes;
+		// Whatever the pool holds beyond the objects themselves is either padding, a freed block or not yet used
+		auto const stored = usage.node_storage + usage.edge_storage;
+		auto const capacity = pool_->capacity();
+		usage.allocator_overhead = capacity > stored ? capacity - stored : 0;
+	}
+	else {
+		usage.allocator_overhead = node_count * (heap_overhead(node_entry_bytes) + heap_overhead(node_object_bytes))
+		                           + edge_count * (heap_overhead(edge_entry_bytes) + heap_overhead(edge_object_bytes));
+	}
+	if constexpr (heap_owning<N> or heap_owning<E>) {
+		auto const payload = [](auto const& set) {
+			auto bytes = std::size_t{0};
+			for (auto const& n : set) {
+				bytes += heap_bytes(*n);
+			}
+			return bytes;
+		};
+		usage.heap_payload = payload(nodes_) + payload(tombstones_);
+		for (auto const& [src, dst, edge] : edges_) {
+			usage.heap_payload += heap_bytes(edge->src_) + heap_bytes(edge->dst_);
+			if (edge->weight_)
+				usage.heap_payload += heap_bytes(*edge->weight_);
+		}
+	}
+	return usage;
 }
 
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-//                                   GRAPH FUNCTIONS                                                                  //
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template<typename N, typename E>
-gdwg::graph<N, E>::graph() noexcept
-: nodes_{type_nodes_set{}}
-, edges_{edges_set{}} {}
+auto gdwg::graph<N, E>::stats() const noexcept -> graph_stats {
+	return stats_.snapshot();
+}
 
 template<typename N, typename E>
-gdwg::graph<N, E>::graph(std::initializer_list<N> const& il)
-: graph{il.begin(), il.end()} {}
+auto gdwg::graph<N, E>::reset_stats() const noexcept -> void {
+	stats_.reset();
+}
 
 template<typename N, typename E>
-template<typename InputIt>
-gdwg::graph<N, E>::graph(InputIt const& first, InputIt const& last)
-: graph{} {
-	std::transform(first, last, std::inserter(nodes_, nodes_.end()), [](auto const& elem) {
-		return std::make_shared<N>(elem);
-	});
+auto gdwg::graph<N, E>::subscribe(std::size_t capacity) -> std::shared_ptr<change_feed<N, E>> {
+	auto feed = std::make_shared<change_feed<N, E>>(capacity);
+	attach(feed);
+	return feed;
 }
 
 template<typename N, typename E>
-gdwg::graph<N, E>::graph(graph const& other)
-: graph{} {
-	deep_copy(other);
+auto gdwg::graph<N, E>::attach(std::shared_ptr<mutation_sink<N, E>> sink) -> void {
+	sinks_.push_back(std::move(sink));
 }
 
 template<typename N, typename E>
-gdwg::graph<N, E>::graph(graph&& other) noexcept
-: nodes_(std::exchange(other.nodes_, type_nodes_set{}))
-, edges_(std::exchange(other.edges_, edges_set{})) {}
+auto gdwg::graph<N, E>::detach(std::shared_ptr<mutation_sink<N, E>> const& sink) noexcept -> bool {
+	return std::erase(sinks_, sink) != 0;
+}
 
 template<typename N, typename E>
-auto gdwg::graph<N, E>::operator=(graph const& other) -> graph& {
-	if (this != &other) {
-		deep_copy(other);
+auto gdwg::graph<N, E>::apply(graph_delta<N, E> const& delta) -> void {
+	for (auto const& [from, to, weight] : delta.removed_edges) {
+		erase_edge(from, to, weight);
+	}
+	if (not delta.removed_nodes.empty())
+		erase_nodes(delta.removed_nodes);
+	for (auto const& n : delta.added_nodes) {
+		insert_node(n);
+	}
+	for (auto const& [from, to, weight] : delta.added_edges) {
+		insert_edge(from, to, weight);
 	}
-	return *this;
 }
 
 template<typename N, typename E>
-auto gdwg::graph<N, E>::operator=(graph&& other) noexcept -> graph& {
-	if (this != &other) {
-		nodes_ = std::exchange(other.nodes_, type_nodes_set{});
-		edges_ = std::exchange(other.edges_, edges_set{});
+auto gdwg::graph<N, E>::apply(mutation<N, E> const& event) -> void {
+	auto const& required = [](std::optional<N> const& value) -> N const& {
+		if (not value)
+			throw std::runtime_error("Cannot call gdwg::graph<N, E>::apply on a change missing a node");
+		return *value;
+	};
+	switch (event.kind) {
+	case mutation_kind::insert_node: insert_node(required(event.src)); break;
+	case mutation_kind::insert_edge: insert_edge(required(event.src), required(event.dst), event.weight); break;
+	case mutation_kind::erase_node: erase_node(required(event.src)); break;
+	case mutation_kind::erase_edge:
+		if (not event.cascaded)
+			erase_edge(required(event.src), required(event.dst), event.weight);
+		break;
+	case mutation_kind::replace_node: replace_node(required(event.src), required(event.dst)); break;
+	case mutation_kind::merge_replace_node: merge_replace_node(required(event.src), required(event.dst)); break;
+	case mutation_kind::clear: clear(); break;
 	}
-	return *this;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-//                             GRAPH MODIFIER FUNCTIONS                                                               //
+//                                  GRAPH EXTRATOR FUNCTIONS                                                          //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename T, typename U>
+auto gdwg::operator<<(std::ostream& os, graph<T, U> const& g) -> std::ostream& {
+	os << std::string{"\n"};
+	for (auto const& node : g.nodes_) {
+		os << *node << " (\n";
+
+		for (auto const& e : g.edges_) {
+			auto const& [src, dst, edge] = e;
+			if (src == node and not g.is_tombstoned(e)) {
+				os << std::string{"  "} << edge->print_edge() << '\n';
+			}
+		}
+
+		os << std::string{")\n"};
+	}
+	return os;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                               GRAPH PRIVATE HELPER FUNCTIONS                                                       //
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template<typename N, typename E>
-auto gdwg::graph<N, E>::insert_node(N const& value) -> bool {
-	if (nodes_.contains(value))
-		return false;
-	auto const& new_node = std::make_shared<N>(value);
-	nodes_.insert(new_node);
-	return true;
+template<typename K>
+auto gdwg::graph<N, E>::find_node_ptr(K const& value) const noexcept -> std::shared_ptr<N> {
+	auto const& it = nodes_.find(value);
+	return it != nodes_.end() ? *it : nullptr;
 }
 
 template<typename N, typename E>
-auto gdwg::graph<N, E>::insert_edge(N const& src, N const& dst, std::optional<E> const& weight) -> bool {
-	auto const& src_ptr = find_node_ptr(src);
-	auto const& dst_ptr = find_node_ptr(dst);
-	if (not src_ptr or not dst_ptr) {
-		throw std::runtime_error("Cannot call gdwg::graph<N, E>::insert_edge when either src or dst node does not "
-		                         "exist");
-	}
-	auto edge_ptr = std::shared_ptr<edge<N, E>>{};
-	if (weight == std::nullopt) {
-		edge_ptr = std::make_shared<unweighted_edge<N, E>>(unweighted_edge<N, E>{src, dst});
+auto gdwg::graph<N, E>::update_node(std::shared_ptr<N> const& src_ptr,
+                                    std::shared_ptr<N> const& dst_ptr) noexcept -> void {
+	// Create a new set to hold updated edges
+	auto updated_edges = edges_set{edges_.get_allocator()};
+	for (auto it = edges_.begin(); it != edges_.end();) {
+		count_visit();
+		auto const& [src, dest, edge] = *it;
+		// If either src or dest equals src_ptr, insert the updated edge
+		if (src == src_ptr or dest == src_ptr) {
+			// Use ternary operator to simplify the replacement logic for src and dest
+			auto const& new_edge = edge_tuple{(src == src_ptr) ? dst_ptr : src, (dest == src_ptr) ? dst_ptr : dest, edge};
+
+			updated_edges.insert(new_edge);
+			edge->set_nodes(*std::get<0>(new_edge), *std::get<1>(new_edge));
+			fingerprint_ -= edge_fingerprint(*it);
+			it = edges_.erase(it);
+		}
+		else {
+			++it;
+		}
 	}
-	else {
-		edge_ptr = std::make_shared<weighted_edge<N, E>>(weighted_edge<N, E>{src, dst, weight.value()});
+	// Edges which collide with an existing edge after the update are merged, so only count those inserted
+	for (auto const& e : updated_edges) {
+		if (edges_.insert(e).second)
+			fingerprint_ += edge_fingerprint(e);
 	}
-	auto const& new_edge = edge_tuple{src_ptr, dst_ptr, edge_ptr};
-	if (edges_.contains(new_edge))
-		return false;
-	edges_.insert(new_edge);
-	return true;
 }
 
 template<typename N, typename E>
-auto gdwg::graph<N, E>::replace_node(N const& old_data, N const& new_data) -> bool {
-	auto const& src_ptr = find_node_ptr(old_data);
-	if (not src_ptr)
-		throw std::runtime_error("Cannot call gdwg::graph<N, E>::replace_node on a node that doesn't exist");
-
-	if (is_node(new_data))
+auto gdwg::graph<N, E>::is_tombstoned(edge_tuple const& e) const noexcept -> bool {
+	if (tombstones_.empty())
 		return false;
+	// No live node shares a value with a tombstone (see revive), so looking up by value is enough.
+	auto const& [src, dst, edge] = e;
+	return tombstones_.contains(*src) or tombstones_.contains(*dst);
+}
 
-	if (old_data != new_data) {
-		auto const& new_node = std::make_shared<N>(new_data);
-		nodes_.erase(src_ptr);
-		nodes_.insert(new_node);
-		update_node(src_ptr, new_node);
+template<typename N, typename E>
+auto gdwg::graph<N, E>::revive(N const& value) noexcept -> void {
+	if (tombstones_.contains(value))
+		compact();
+}
+
+template<typename N, typename E>
+auto gdwg::graph<N, E>::make_iterator(typename iterator::set_iter it) const noexcept -> iterator {
+	while (it != edges_.end() and is_tombstoned(*it)) {
+		++it;
 	}
-	return true;
+	return iterator{it, this};
 }
 
 template<typename N, typename E>
-auto gdwg::graph<N, E>::merge_replace_node(N const& old_data, N const& new_data) -> void {
-	auto const& src_ptr = find_node_ptr(old_data);
-	auto const& new_ptr = find_node_ptr(new_data);
-	if (not src_ptr or not new_ptr)
-		throw std::runtime_error("Cannot call gdwg::graph<N, E>::merge_replace_node on old or new data if they don't "
-		                         "exist in the graph");
+auto gdwg::graph<N, E>::probe(graph_operation op) const noexcept -> probe_type {
+	return probe_type{stats_, op};
+}
 
-	if (old_data != new_data) {
-		nodes_.erase(src_ptr);
-		update_node(src_ptr, new_ptr);
+template<typename N, typename E>
+auto gdwg::graph<N, E>::count_visit() noexcept -> void {
+	if constexpr (instrumentation_enabled) {
+		stats_recorder::count_visit();
+	}
+}
+
+template<typename N, typename E>
+auto gdwg::graph<N, E>::count_comparison() noexcept -> void {
+	if constexpr (instrumentation_enabled) {
+		stats_recorder::count_comparison();
 	}
 }
 
 template<typename N, typename E>
-auto gdwg::graph<N, E>::erase_node(N const& value) -> bool {
-	auto const& node_ptr = find_node_ptr(value);
-	if (not node_ptr)
-		return false;
-
-	nodes_.erase(node_ptr);
-	std::erase_if(edges_, [&node_ptr](auto const& e) {
-		auto const& [from, to, edge] = e;
-		return *from == *node_ptr or *to == *node_ptr;
+auto gdwg::graph<N, E>::notify(mutation_kind kind, N const* src, N const* dst) const noexcept -> void {
+	notify_with([&] {
+		return mutation<N, E>{kind,
+		                      src ? std::optional<N>{*src} : std::nullopt,
+		                      dst ? std::optional<N>{*dst} : std::nullopt,
+		                      std::nullopt,
+		                      false};
 	});
-	return true;
 }
 
 template<typename N, typename E>
-auto gdwg::graph<N, E>::erase_edge(N const& src, N const& dst, std::optional<E> const& weight) -> bool {
-	if (not is_node(src) or not is_node(dst))
-		throw std::runtime_error("Cannot call gdwg::graph<N, E>::erase_edge on src or dst if they don't exist in the "
-		                         "graph");
-
-	auto const& edge_ptr = std::ranges::find_if(edges_, [&src, &dst, &weight](auto const& e) {
-		auto const& [from, to, edge] = e;
-		return *from == src and *to == dst and edge->get_weight() == weight;
+auto gdwg::graph<N, E>::notify_edge(mutation_kind kind, edge_tuple const& e, bool cascaded) const noexcept -> void {
+	notify_with([&] {
+		auto const& [src, dst, edge] = e;
+		return mutation<N, E>{kind, *src, *dst, edge->weight_, cascaded};
 	});
-	if (edge_ptr == edges_.end())
-		return false;
-
-	edges_.erase(edge_ptr);
-	return true;
 }
 
 template<typename N, typename E>
-auto gdwg::graph<N, E>::erase_edge(iterator const& i) noexcept -> iterator {
-	auto const& it = i.base();
-	return iterator{edges_.erase(it)};
+template<typename Build>
+auto gdwg::graph<N, E>::notify_with(Build const& build) const noexcept -> void {
+	version_ = next_version();
+	if (sinks_.empty())
+		return;
+	try {
+		auto const& event = build();
+		for (auto const& sink : sinks_) {
+			sink->on_mutation(event);
+		}
+	} catch (...) {
+		for (auto const& sink : sinks_) {
+			sink->on_lost();
+		}
+	}
 }
 
 template<typename N, typename E>
-auto gdwg::graph<N, E>::erase_edge(iterator const& i, iterator const& s) noexcept -> iterator {
-	auto const& begin = i.base();
-	auto const& end = s.base();
-	return iterator{edges_.erase(begin, end)};
+auto gdwg::graph<N, E>::next_version() noexcept -> std::uint64_t {
+	return last_version_.fetch_add(1, std::memory_order_relaxed) + 1;
 }
 
 template<typename N, typename E>
-auto gdwg::graph<N, E>::clear() noexcept -> void {
-	nodes_.clear();
-	edges_.clear();
+auto gdwg::graph<N, E>::replay() const noexcept -> void {
+	if (sinks_.empty())
+		return;
+	notify(mutation_kind::clear);
+	for (auto const& n : nodes_) {
+		notify(mutation_kind::insert_node, n.get());
+	}
+	for (auto const& e : edges_) {
+		if (not is_tombstoned(e))
+			notify_edge(mutation_kind::insert_edge, e);
+	}
 }
 
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-//                            GRAPH ACCESSORS FUNCTIONS                                                               //
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template<typename N, typename E>
-auto gdwg::graph<N, E>::is_node(N const& value) const noexcept -> bool {
-	return nodes_.contains(value);
+auto gdwg::graph<N, E>::node_fingerprint(N const& value) noexcept -> graph_fingerprint {
+	return graph_fingerprint::from_hash(hash_of(value));
 }
 
 template<typename N, typename E>
-auto gdwg::graph<N, E>::empty() const noexcept -> bool {
-	return nodes_.empty();
+auto gdwg::graph<N, E>::edge_fingerprint(edge_tuple const& e) noexcept -> graph_fingerprint {
+	auto const& [src, dst, edge] = e;
+	// Chain the hashes so that the direction of the edge and the position of the weight matter
+	auto hash = graph_fingerprint::mix(hash_of(*src) + 0x2545f4914f6cdd1dU);
+	hash = graph_fingerprint::mix(hash ^ hash_of(*dst));
+	hash = graph_fingerprint::mix(hash ^ (edge->weight_ ? hash_of(*edge->weight_) : 0x5851f42d4c957f2dU));
+	return graph_fingerprint::from_hash(hash);
 }
 
 template<typename N, typename E>
-auto gdwg::graph<N, E>::is_connected(N const& src, N const& dst) const -> bool {
-	if (not is_node(src) or not is_node(dst))
-		throw std::runtime_error("Cannot call gdwg::graph<N, E>::is_connected if src or dst node don't exist in the "
-		                         "graph");
-
-	return std::ranges::find_if(edges_,
-	                            [&src, &dst](auto const& e) {
-		                            auto const& [src_ptr, dst_ptr, edge_ptr] = e;
-		                            return *src_ptr == src and *dst_ptr == dst;
-	                            })
-	       != edges_.end();
+template<typename T>
+auto gdwg::graph<N, E>::hash_of(T const& value) noexcept -> std::uint64_t {
+	if constexpr (requires { std::hash<T>{}(value); }) {
+		return static_cast<std::uint64_t>(std::hash<T>{}(value));
+	}
+	else {
+		return 0;
+	}
 }
 
 template<typename N, typename E>
-auto gdwg::graph<N, E>::nodes() const -> std::vector<N> {
-	auto vec = std::vector<N>{};
-	vec.reserve(nodes_.size());
-
-	// Use std::transform to copy elements to vec
-	std::ranges::transform(nodes_, std::back_inserter(vec), [](auto const& n) { return *n; });
-	return vec;
+auto gdwg::graph<N, E>::refresh_fingerprint() noexcept -> void {
+	fingerprint_ = graph_fingerprint{};
+	for (auto const& n : nodes_) {
+		fingerprint_ += node_fingerprint(*n);
+	}
+	for (auto const& e : edges_) {
+		fingerprint_ += edge_fingerprint(e);
+	}
 }
 
 template<typename N, typename E>
-auto gdwg::graph<N, E>::edges(N const& src, N const& dst) const -> std::vector<std::unique_ptr<edge<N, E>>> {
-	if (not is_node(src) or not is_node(dst))
-		throw std::runtime_error("Cannot call gdwg::graph<N, E>::edges if src or dst node don't exist in the graph");
-
-	auto vec = std::vector<std::unique_ptr<edge<N, E>>>{};
-	for (auto const& e : edges_) {
-		auto const& [src_ptr, dst_ptr, edge_ptr] = e;
-		if (*src_ptr == src and *dst_ptr == dst)
-			vec.push_back(edge_ptr->clone_ptr());
+auto gdwg::graph<N, E>::deep_copy(graph const& other) -> void {
+	clear();
+	// A pooled graph copies into a pool of its own sized for the whole graph
+	if (other.pool_) {
+		reserve(other.nodes_.size(), other.edges_.size());
 	}
-	return vec;
+	// Copy nodes, their fingerprint is taken from other once the edges are copied
+	for (auto const& n : other.nodes_) {
+		auto const& new_node = *nodes_.insert(nodes_.end(), make_node(*n));
+		notify(mutation_kind::insert_node, new_node.get());
+	}
+	// Copy edges, leaving out the ones of lazily erased nodes
+	for (auto const& e : other.edges_) {
+		if (other.is_tombstoned(e))
+			continue;
+		// Appended in order rather than through insert_edge, so that the copy records no calls of its own
+		auto const& [src, dst, edge] = e;
+		auto const& src_ptr = find_node_ptr(*src);
+		auto const& dst_ptr = find_node_ptr(*dst);
+		auto const& new_edge =
+		    edges_.insert(edges_.end(), edge_tuple{src_ptr, dst_ptr, make_edge(*src_ptr, *dst_ptr, edge->get_weight())});
+		notify_edge(mutation_kind::insert_edge, *new_edge);
+	}
+	lazy_erase_ = other.lazy_erase_;
+	fingerprint_ = other.fingerprint();
 }
 
 template<typename N, typename E>
-auto gdwg::graph<N, E>::find(N const& src, N const& dst, std::optional<E> const& weight) const noexcept -> iterator {
-	return std::ranges::find_if(*this, [&src, &dst, &weight](auto const& edge) {
-		return edge.from == src and edge.to == dst and edge.weight == weight;
-	});
+template<typename V>
+auto gdwg::graph<N, E>::make_node(V&& value) const -> std::shared_ptr<N> {
+	return std::allocate_shared<N>(pool_allocator<N>{pool_}, std::forward<V>(value));
 }
 
 template<typename N, typename E>
-auto gdwg::graph<N, E>::connections(N const& src) const -> std::vector<N> {
-	if (not is_node(src))
-		throw std::runtime_error("Cannot call gdwg::graph<N, E>::connections if src doesn't exist in the graph");
+auto gdwg::graph<N, E>::make_edge(N const& src, N const& dst, std::optional<E> const& weight) const
+    -> std::shared_ptr<edge<N, E>> {
+	if (weight == std::nullopt)
+		return std::allocate_shared<unweighted_edge<N, E>>(pool_allocator<unweighted_edge<N, E>>{pool_}, src, dst);
+	return std::allocate_shared<weighted_edge<N, E>>(pool_allocator<weighted_edge<N, E>>{pool_},
+	                                                 src,
+	                                                 dst,
+	                                                 weight.value());
+}
 
-	auto vec = std::vector<N>{};
-	for (auto const& e : edges_) {
-		auto const& [src_ptr, dst_ptr, edge_ptr] = e;
-		if (*src_ptr == src)
-			vec.push_back(*dst_ptr);
+template<typename N, typename E>
+auto gdwg::graph<N, E>::rebuild_storage(std::shared_ptr<node_pool> const& pool) -> void {
+	// Rebuilding compacts the graph, as the tombstoned nodes are not carried over
+	compact();
+	auto nodes = type_nodes_set{pool_allocator<std::shared_ptr<N>>{pool}};
+	auto edges = edges_set{pool_allocator<edge_tuple>{pool}};
+	auto const old_pool = std::exchange(pool_, pool);
+	try {
+		// Both sets are already sorted, so every element can be appended at the end in O(1)
+		for (auto const& n : nodes_) {
+			nodes.insert(nodes.end(), make_node(*n));
+		}
+		for (auto const& e : edges_) {
+			auto const& [src, dst, edge] = e;
+			auto const& new_edge =
+			    edge_tuple{*nodes.find(*src), *nodes.find(*dst), make_edge(*src, *dst, edge->get_weight())};
+			edges.insert(edges.end(), new_edge);
+		}
+	} catch (...) {
+		pool_ = old_pool;
+		throw;
 	}
-	// O(e) for remove duplicate elements by STL algorithm unique.
-	auto const& last = std::unique(vec.begin(), vec.end());
-	vec.erase(last, vec.end());
-	return vec;
+	nodes_ = std::move(nodes);
+	edges_ = std::move(edges);
+	tombstones_.clear();
+	refresh_fingerprint();
+	version_ = next_version();
 }
 
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-//                               GRAPH ITERATOR ACCESS FUNCTIONS                                                      //
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template<typename N, typename E>
-auto gdwg::graph<N, E>::begin() const noexcept -> iterator {
-	return iterator{edges_.begin()};
+auto gdwg::graph<N, E>::storage_bytes(std::size_t node_count, std::size_t edge_count) noexcept -> std::size_t {
+	auto const node_bytes = node_pool::block_size(node_entry_bytes) + node_pool::block_size(node_object_bytes);
+	auto const edge_bytes = node_pool::block_size(edge_entry_bytes) + node_pool::block_size(edge_object_bytes);
+	return node_count * node_bytes + edge_count * edge_bytes;
 }
 
 template<typename N, typename E>
-auto gdwg::graph<N, E>::end() const noexcept -> iterator {
-	return iterator{edges_.end()};
+auto gdwg::graph<N, E>::first_out_edge(N const* src) const noexcept -> typename edges_set::const_iterator {
+	// Unweighted edges to the smallest node sort before every other edge from src
+	auto const& no_weight = std::optional<E>{};
+	return edges_.lower_bound(edge_key{src, nodes_.begin()->get(), &no_weight});
 }
 
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-//                                  GRAPH COMPARISON FUNCTIONS                                                        //
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template<typename N, typename E>
-auto gdwg::graph<N, E>::operator==(graph const& other) const noexcept -> bool {
-	if (nodes_.size() != other.nodes_.size() or edges_.size() != other.edges_.size()) {
-		return false;
+auto gdwg::graph<N, E>::in_edge_order() const -> std::vector<edge_tuple const*> {
+	auto index = std::unordered_map<N const*, std::size_t>{};
+	index.reserve(nodes_.size());
+	for (auto const& n : nodes_) {
+		index.emplace(n.get(), index.size());
 	}
-	// Compare nodes using std::equal
-	if (not std::ranges::equal(nodes_, other.nodes_, [](auto const& lhs, auto const& rhs) { return *lhs == *rhs; })) {
-		return false;
+	auto buckets = std::vector<std::size_t>{};
+	buckets.reserve(edges_.size());
+	auto offsets = std::vector<std::size_t>(nodes_.size() + 1, 0);
+	for (auto const& e : live_edges()) {
+		buckets.push_back(index.find(std::get<1>(e).get())->second);
+		++offsets[buckets.back() + 1];
 	}
-	// Compare edges using std::equal
-	if (not std::ranges::equal(edges_, other.edges_, [](auto const& lhs, auto const& rhs) {
-		    return *std::get<2>(lhs) == *std::get<2>(rhs);
-	    }))
-	{
-		return false;
+	std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+	// The edges arrive sorted by source, so placing them stably leaves every bucket sorted by source and weight
+	auto order = std::vector<edge_tuple const*>(buckets.size());
+	auto bucket = buckets.begin();
+	for (auto const& e : live_edges()) {
+		order[offsets[*bucket++]++] = &e;
 	}
-	return true;
+	return order;
 }
 
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-//                                  GRAPH EXTRATOR FUNCTIONS                                                          //
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-template<typename T, typename U>
-auto gdwg::operator<<(std::ostream& os, graph<T, U> const& g) -> std::ostream& {
-	os << std::string{"\n"};
-	for (auto const& node : g.nodes_) {
-		os << *node << " (\n";
+template<typename N, typename E>
+auto gdwg::graph<N, E>::induced_by(std::vector<std::shared_ptr<N>> selected) const -> graph {
+	std::ranges::sort(selected, [](auto const& lhs, auto const& rhs) { return *lhs < *rhs; });
+	auto const& [last, end] = std::ranges::unique(selected);
+	selected.erase(last, end);
+	auto const& is_selected = [&selected](N const& value) {
+		return std::ranges::binary_search(selected, value, std::less<>{}, [](auto const& n) -> N const& { return *n; });
+	};
 
-		for (auto const& [src, dst, edge] : g.edges_) {
-			if (*src == *node) {
-				os << std::string{"  "} << edge->print_edge() << '\n';
-			}
+	auto result = graph{};
+	if (pool_) {
+		result.reserve(selected.size(), 0);
+	}
+	// The nodes are sorted, and so are the edges leaving them, so everything is appended at the end in O(1)
+	for (auto const& n : selected) {
+		result.nodes_.insert(result.nodes_.end(), result.make_node(*n));
+		result.fingerprint_ += node_fingerprint(*n);
+	}
+	auto src_node = result.nodes_.begin();
+	for (auto const& n : selected) {
+		for (auto it = first_out_edge(n.get()); it != edges_.end() and std::get<0>(*it) == n; ++it) {
+			count_visit();
+			auto const& [src, dst, edge] = *it;
+			if (is_tombstoned(*it) or not is_selected(*dst))
+				continue;
+			auto const& new_edge =
+			    edge_tuple{*src_node, *result.nodes_.find(*dst), result.make_edge(*src, *dst, edge->get_weight())};
+			result.edges_.insert(result.edges_.end(), new_edge);
+			result.fingerprint_ += edge_fingerprint(new_edge);
 		}
-
-		os << std::string{")\n"};
+		++src_node;
 	}
-	return os;
+	return result;
 }
 
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-//                               GRAPH PRIVATE HELPER FUNCTIONS                                                       //
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template<typename N, typename E>
-auto gdwg::graph<N, E>::find_node_ptr(N const& value) const noexcept -> std::shared_ptr<N> {
-	auto const& it = nodes_.find(value);
-	return it != nodes_.end() ? *it : nullptr;
+auto gdwg::graph<N, E>::node_order(N const& lhs, N const& rhs) noexcept -> std::strong_ordering {
+	if (lhs < rhs)
+		return std::strong_ordering::less;
+	return rhs < lhs ? std::strong_ordering::greater : std::strong_ordering::equal;
 }
 
 template<typename N, typename E>
-auto gdwg::graph<N, E>::update_node(std::shared_ptr<N> const& src_ptr,
-                                    std::shared_ptr<N> const& dst_ptr) noexcept -> void {
-	// Create a new set to hold updated edges
-	auto updated_edges = edges_set{};
-	for (auto it = edges_.begin(); it != edges_.end();) {
-		auto const& [src, dest, edge] = *it;
-		// If either src or dest equals src_ptr, insert the updated edge
-		if (src == src_ptr or dest == src_ptr) {
-			// Use ternary operator to simplify the replacement logic for src and dest
-			auto const& new_edge = edge_tuple{(src == src_ptr) ? dst_ptr : src, (dest == src_ptr) ? dst_ptr : dest, edge};
+auto gdwg::graph<N, E>::edge_order(edge_tuple const& lhs, edge_tuple const& rhs) noexcept -> std::strong_ordering {
+	auto const& [lhs_src, lhs_dst, lhs_edge] = lhs;
+	auto const& [rhs_src, rhs_dst, rhs_edge] = rhs;
+	if (auto const order = node_order(*lhs_src, *rhs_src); std::is_neq(order))
+		return order;
+	if (auto const order = node_order(*lhs_dst, *rhs_dst); std::is_neq(order))
+		return order;
+	return edge<N, E>::weight_comp(lhs_edge->weight_, rhs_edge->weight_);
+}
 
-			updated_edges.insert(new_edge);
-			edge->set_nodes(*std::get<0>(new_edge), *std::get<1>(new_edge));
-			it = edges_.erase(it);
+template<typename N, typename E>
+auto gdwg::graph<N, E>::live_edges() const noexcept {
+	return edges_ | std::views::filter([this](edge_tuple const& e) { return not is_tombstoned(e); });
+}
+
+template<typename N, typename E>
+template<std::ranges::input_range L, std::ranges::input_range R, typename Order, typename Visit>
+auto gdwg::graph<N, E>::merge_walk(L&& lhs, R&& rhs, Order order, Visit visit) -> void {
+	auto l = std::ranges::begin(lhs);
+	auto r = std::ranges::begin(rhs);
+	auto const l_end = std::ranges::end(lhs);
+	auto const r_end = std::ranges::end(rhs);
+	while (l != l_end or r != r_end) {
+		auto const cmp = l == l_end   ? std::strong_ordering::greater
+		                 : r == r_end ? std::strong_ordering::less
+		                              : std::strong_ordering{order(*l, *r)};
+		if (std::is_lt(cmp)) {
+			visit(*l++, true, false);
+		}
+		else if (std::is_gt(cmp)) {
+			visit(*r++, false, true);
 		}
 		else {
-			++it;
+			visit(*l++, true, true);
+			++r;
 		}
 	}
-	edges_.insert(updated_edges.begin(), updated_edges.end());
 }
 
 template<typename N, typename E>
-auto gdwg::graph<N, E>::deep_copy(graph const& other) -> void {
-	clear();
-	// Copy nodes
-	for (auto const& n : other.nodes_) {
-		nodes_.insert(std::make_shared<N>(*n));
-	}
-	// Copy edges
-	for (auto const& [src, dst, edge] : other.edges_) {
-		insert_edge(*src, *dst, edge->get_weight());
+auto gdwg::graph<N, E>::merge(graph const& lhs, graph const& rhs, merge_rule nodes, merge_rule edges) -> graph {
+	auto const& keeps = [](merge_rule rule, bool in_lhs, bool in_rhs) {
+		return in_lhs and in_rhs ? rule.both : in_lhs ? rule.only_lhs : rule.only_rhs;
+	};
+	auto result = graph{};
+	if (lhs.pool_ or rhs.pool_) {
+		result.reserve(lhs.nodes_.size() + rhs.nodes_.size(), lhs.edges_.size() + rhs.edges_.size());
 	}
+	// Both walks produce elements in ascending order, so every one is appended at the end in O(1)
+	merge_walk(
+	    lhs.nodes_,
+	    rhs.nodes_,
+	    [](auto const& l, auto const& r) { return node_order(*l, *r); },
+	    [&](std::shared_ptr<N> const& n, bool in_lhs, bool in_rhs) {
+		    if (not keeps(nodes, in_lhs, in_rhs))
+			    return;
+		    result.nodes_.insert(result.nodes_.end(), result.make_node(*n));
+		    result.fingerprint_ += node_fingerprint(*n);
+	    });
+	// Sources ascend with the edges, so the source node is found by advancing a cursor
+	auto src_node = result.nodes_.begin();
+	merge_walk(lhs.live_edges(), rhs.live_edges(), edge_order, [&](edge_tuple const& e, bool in_lhs, bool in_rhs) {
+		if (not keeps(edges, in_lhs, in_rhs))
+			return;
+		auto const& [src, dst, edge] = e;
+		while (**src_node < *src) {
+			++src_node;
+		}
+		auto const& new_edge =
+		    edge_tuple{*src_node, *result.nodes_.find(*dst), result.make_edge(*src, *dst, edge->get_weight())};
+		result.edges_.insert(result.edges_.end(), new_edge);
+		result.fingerprint_ += edge_fingerprint(new_edge);
+	});
+	return result;
+}
+
+template<typename N, typename E>
+auto gdwg::graph<N, E>::heap_overhead(std::size_t bytes) noexcept -> std::size_t {
+	auto constexpr granule = 2 * sizeof(void*);
+	return (bytes + sizeof(void*) + granule - 1) / granule * granule - bytes;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1204,32 +4433,39 @@ auto gdwg::graph<N, E>::iter::operator*() const noexcept -> reference {
 }
 
 template<typename N, typename E>
-gdwg::graph<N, E>::iter::iter(set_iter const& set_it) noexcept
-: set_it_{set_it} {}
+gdwg::graph<N, E>::iter::iter(set_iter const& set_it, graph const* g) noexcept
+: set_it_{set_it}
+, graph_{g} {}
 
 template<typename N, typename E>
 auto gdwg::graph<N, E>::iter::operator++() noexcept -> iter& {
-	++set_it_;
+	// Skip the edges of lazily erased nodes
+	do {
+		++set_it_;
+	} while (set_it_ != graph_->edges_.end() and graph_->is_tombstoned(*set_it_));
 	return *this;
 }
 
 template<typename N, typename E>
 auto gdwg::graph<N, E>::iter::operator++(int) noexcept -> iter {
 	auto const it = *this;
-	++set_it_;
+	++*this;
 	return it;
 }
 
 template<typename N, typename E>
 auto gdwg::graph<N, E>::iter::operator--() noexcept -> iter& {
-	--set_it_;
+	// Skip the edges of lazily erased nodes
+	do {
+		--set_it_;
+	} while (graph_->is_tombstoned(*set_it_));
 	return *this;
 }
 
 template<typename N, typename E>
 auto gdwg::graph<N, E>::iter::operator--(int) noexcept -> iter {
 	auto const it = *this;
-	--set_it_;
+	--*this;
 	return it;
 }
 
@@ -1242,3 +4478,275 @@ template<typename N, typename E>
 auto gdwg::graph<N, E>::iter::base() const noexcept -> set_iter {
 	return set_it_;
 }
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  GRAPH DIFF FUNCTIONS                                                              //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename N, typename E>
+auto gdwg::graph_delta<N, E>::size() const noexcept -> std::size_t {
+	return added_nodes.size() + removed_nodes.size() + added_edges.size() + removed_edges.size();
+}
+
+template<typename N, typename E>
+auto gdwg::graph_delta<N, E>::empty() const noexcept -> bool {
+	return size() == 0;
+}
+
+template<typename T, typename U>
+auto gdwg::diff(graph<T, U> const& a, graph<T, U> const& b) -> graph_delta<T, U> {
+	auto delta = graph_delta<T, U>{};
+
+	auto const& nodes = [&delta](std::shared_ptr<T> const& n, bool in_a, bool in_b) {
+		if (in_a and not in_b)
+			delta.removed_nodes.push_back(*n);
+		else if (in_b and not in_a)
+			delta.added_nodes.push_back(*n);
+	};
+	graph<T, U>::merge_walk(
+	    a.nodes_,
+	    b.nodes_,
+	    [](auto const& l, auto const& r) { return graph<T, U>::node_order(*l, *r); },
+	    nodes);
+
+	// Removed edges of removed nodes are implied by the nodes, so they are left out
+	auto const& removed = [&delta](T const& node) {
+		return std::binary_search(delta.removed_nodes.begin(), delta.removed_nodes.end(), node);
+	};
+	auto const& edges = [&delta, &removed](auto const& e, bool in_a, bool in_b) {
+		auto const& [src, dst, edge] = e;
+		if (in_a and not in_b and not removed(*src) and not removed(*dst))
+			delta.removed_edges.push_back({*src, *dst, edge->get_weight()});
+		else if (in_b and not in_a)
+			delta.added_edges.push_back({*src, *dst, edge->get_weight()});
+	};
+	graph<T, U>::merge_walk(a.live_edges(), b.live_edges(), graph<T, U>::edge_order, edges);
+	return delta;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  GRAPH SET ALGEBRA FUNCTIONS                                                       //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename T, typename U>
+auto gdwg::graph_union(graph<T, U> const& a, graph<T, U> const& b) -> graph<T, U> {
+	auto constexpr all = typename graph<T, U>::merge_rule{.only_lhs = true, .only_rhs = true, .both = true};
+	return graph<T, U>::merge(a, b, all, all);
+}
+
+template<typename T, typename U>
+auto gdwg::graph_intersection(graph<T, U> const& a, graph<T, U> const& b) -> graph<T, U> {
+	auto constexpr common = typename graph<T, U>::merge_rule{.only_lhs = false, .only_rhs = false, .both = true};
+	return graph<T, U>::merge(a, b, common, common);
+}
+
+template<typename T, typename U>
+auto gdwg::graph_difference(graph<T, U> const& a, graph<T, U> const& b) -> graph<T, U> {
+	auto constexpr nodes = typename graph<T, U>::merge_rule{.only_lhs = true, .only_rhs = false, .both = true};
+	auto constexpr edges = typename graph<T, U>::merge_rule{.only_lhs = true, .only_rhs = false, .both = false};
+	return graph<T, U>::merge(a, b, nodes, edges);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  GRAPH VIEW FUNCTIONS                                                              //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename N, typename E, typename P>
+gdwg::graph_view<N, E, P>::graph_view(graph<N, E> const& g, P pred)
+: graph_{&g}
+, pred_{std::move(pred)} {}
+
+template<typename N, typename E, typename P>
+auto gdwg::graph_view<N, E, P>::is_node(N const& value) const -> bool {
+	return graph_->is_node(value) and std::invoke(pred_, value);
+}
+
+template<typename N, typename E, typename P>
+auto gdwg::graph_view<N, E, P>::is_connected(N const& src, N const& dst) const -> bool {
+	if (not is_node(src) or not is_node(dst))
+		throw std::runtime_error("Cannot call gdwg::graph_view<N, E, P>::is_connected if src or dst node aren't in the "
+		                         "view");
+	return graph_->is_connected(src, dst);
+}
+
+template<typename N, typename E, typename P>
+auto gdwg::graph_view<N, E, P>::nodes() const {
+	// The range holds a copy of the predicate, so that it may outlive the view, though not the graph
+	return graph_->nodes_ | std::views::transform([](auto const& n) -> N const& { return *n; })
+	       | std::views::filter([pred = pred_](N const& n) { return std::invoke(pred, n); });
+}
+
+template<typename N, typename E, typename P>
+auto gdwg::graph_view<N, E, P>::edges() const {
+	return graph_->edges_
+	       | std::views::filter([g = graph_, pred = pred_](auto const& e) { return contains(*g, pred, e); })
+	       | std::views::transform([](auto const& e) {
+		         auto const& [src, dst, edge] = e;
+		         return value_type{*src, *dst, edge->get_weight()};
+	         });
+}
+
+template<typename N, typename E, typename P>
+auto gdwg::graph_view<N, E, P>::connections(N const& src) const -> std::vector<N> {
+	auto const& src_node = graph_->find_node_ptr(src);
+	if (not src_node or not std::invoke(pred_, src))
+		throw std::runtime_error("Cannot call gdwg::graph_view<N, E, P>::connections if src isn't in the view");
+
+	auto vec = std::vector<N>{};
+	auto const& edges = graph_->edges_;
+	for (auto it = graph_->first_out_edge(src_node.get()); it != edges.end() and std::get<0>(*it) == src_node; ++it) {
+		auto const& dst = *std::get<1>(*it);
+		if (contains(*graph_, pred_, *it) and (vec.empty() or vec.back() != dst))
+			vec.push_back(dst);
+	}
+	return vec;
+}
+
+template<typename N, typename E, typename P>
+auto gdwg::graph_view<N, E, P>::materialize() const -> graph<N, E> {
+	auto selected = std::vector<std::shared_ptr<N>>{};
+	std::ranges::copy_if(graph_->nodes_, std::back_inserter(selected), [this](auto const& n) {
+		return std::invoke(pred_, *n);
+	});
+	return graph_->induced_by(std::move(selected));
+}
+
+template<typename N, typename E, typename P>
+auto gdwg::graph_view<N, E, P>::contains(graph<N, E> const& g, P const& pred, typename graph<N, E>::edge_tuple const& e)
+    -> bool {
+	auto const& [src, dst, edge] = e;
+	return not g.is_tombstoned(e) and std::invoke(pred, *src) and std::invoke(pred, *dst);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  REVERSE VIEW FUNCTIONS                                                            //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename N, typename E>
+gdwg::reverse_view<N, E>::reverse_view(graph<N, E> const& g)
+: graph_{&g}
+, in_edges_{g.in_edge_order()} {}
+
+template<typename N, typename E>
+auto gdwg::reverse_view<N, E>::is_node(N const& value) const noexcept -> bool {
+	return graph_->is_node(value);
+}
+
+template<typename N, typename E>
+auto gdwg::reverse_view<N, E>::is_connected(N const& src, N const& dst) const -> bool {
+	if (not is_node(src) or not is_node(dst))
+		throw std::runtime_error("Cannot call gdwg::reverse_view<N, E>::is_connected if src or dst node don't exist in "
+		                         "the graph");
+	return graph_->is_connected(dst, src);
+}
+
+template<typename N, typename E>
+auto gdwg::reverse_view<N, E>::edges() const {
+	return in_edges_ | std::views::transform([](auto const* e) {
+		       auto const& [src, dst, edge] = *e;
+		       return value_type{*dst, *src, edge->get_weight()};
+	       });
+}
+
+template<typename N, typename E>
+auto gdwg::reverse_view<N, E>::connections(N const& src) const -> std::vector<N> {
+	if (not is_node(src))
+		throw std::runtime_error("Cannot call gdwg::reverse_view<N, E>::connections if src doesn't exist in the graph");
+
+	// The index is sorted by the destination in the graph, which is the source in the view
+	auto const& [first, last] = std::ranges::equal_range(in_edges_, src, std::less<>{}, [](auto const* e) -> N const& {
+		return *std::get<1>(*e);
+	});
+	auto vec = std::vector<N>{};
+	for (auto it = first; it != last; ++it) {
+		auto const& dst = *std::get<0>(**it);
+		if (vec.empty() or vec.back() != dst)
+			vec.push_back(dst);
+	}
+	return vec;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  GRAPH BUILDER FUNCTIONS                                                           //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename N, typename E>
+auto gdwg::graph_builder<N, E>::indexed_edge::operator<(indexed_edge const& other) const -> bool {
+	// An unweighted edge sorts before the weighted edges between the same nodes, as in edge::weight_comp
+	return std::tie(src, dst, weight) < std::tie(other.src, other.dst, other.weight);
+}
+
+template<typename N, typename E>
+auto gdwg::graph_builder<N, E>::reserve(std::size_t node_count, std::size_t edge_count) -> void {
+	nodes_.reserve(node_count);
+	edges_.reserve(edge_count);
+}
+
+template<typename N, typename E>
+auto gdwg::graph_builder<N, E>::add_node(N value) -> void {
+	nodes_.push_back(std::move(value));
+}
+
+template<typename N, typename E>
+auto gdwg::graph_builder<N, E>::add_edge(N src, N dst, std::optional<E> weight) -> void {
+	edges_.emplace_back(std::move(src), std::move(dst), std::move(weight));
+}
+
+template<typename N, typename E>
+auto gdwg::graph_builder<N, E>::build() -> graph<N, E> {
+	auto nodes = std::exchange(nodes_, {});
+	auto edges = std::exchange(edges_, {});
+	nodes.reserve(nodes.size() + 2 * edges.size());
+	for (auto const& [src, dst, weight] : edges) {
+		nodes.push_back(src);
+		nodes.push_back(dst);
+	}
+	std::ranges::sort(nodes, std::less<>{});
+	auto const& [last, end] = std::ranges::unique(nodes);
+	nodes.erase(last, end);
+
+	auto const& position = [&nodes](N const& value) {
+		return static_cast<std::size_t>(std::ranges::lower_bound(nodes, value, std::less<>{}) - nodes.begin());
+	};
+	auto indexed = std::vector<indexed_edge>{};
+	indexed.reserve(edges.size());
+	for (auto& [src, dst, weight] : edges) {
+		indexed.push_back(indexed_edge{position(src), position(dst), std::move(weight)});
+	}
+	edges = {};
+	std::ranges::sort(indexed, std::less<>{});
+	auto const& [last_edge, end_edge] = std::ranges::unique(indexed);
+	indexed.erase(last_edge, end_edge);
+	return from_sorted(std::move(nodes), indexed);
+}
+
+template<typename N, typename E>
+auto gdwg::graph_builder<N, E>::from_sorted(std::vector<N> nodes, std::vector<indexed_edge> const& edges)
+    -> graph<N, E> {
+	auto const& ascending = [](auto const& lhs, auto const& rhs) { return lhs < rhs; };
+	if (std::ranges::adjacent_find(nodes, std::not_fn(ascending)) != nodes.end()
+	    or std::ranges::adjacent_find(edges, std::not_fn(ascending)) != edges.end())
+		throw std::runtime_error("Cannot call gdwg::graph_builder<N, E>::from_sorted with unsorted or repeated nodes "
+		                         "or edges");
+	if (std::ranges::any_of(edges, [&nodes](auto const& e) { return e.src >= nodes.size() or e.dst >= nodes.size(); }))
+		throw std::runtime_error("Cannot call gdwg::graph_builder<N, E>::from_sorted with an edge to a missing node");
+
+	using graph_type = graph<N, E>;
+	auto g = graph_type{};
+	// The storage is sized exactly up front, so every node and edge is carved from one pool rather than allocated
+	if (not nodes.empty())
+		g.reserve(nodes.size(), edges.size());
+	auto stored = std::vector<std::shared_ptr<N>>{};
+	stored.reserve(nodes.size());
+	for (auto& n : nodes) {
+		auto node = g.make_node(std::move(n));
+		g.fingerprint_ += graph_type::node_fingerprint(*node);
+		stored.push_back(node);
+		g.nodes_.insert(g.nodes_.end(), std::move(node));
+	}
+	for (auto const& [src, dst, weight] : edges) {
+		auto const& new_edge = typename graph_type::edge_tuple{stored[src],
+		                                                       stored[dst],
+		                                                       g.make_edge(*stored[src], *stored[dst], weight)};
+		g.edges_.insert(g.edges_.end(), new_edge);
+		g.fingerprint_ += graph_type::edge_fingerprint(new_edge);
+	}
+	return g;
+}
+
+#endif // GDWG_GRAPH_H
@@ -2,6 +2,10 @@
 
 #include <catch2/catch.hpp>
 
+#include <atomic>
+#include <string_view>
+#include <thread>
+
 TEST_CASE("basic test") {
 	auto g = gdwg::graph<int, std::string>{};
 	auto constexpr n = 5;
@@ -2169,3 +2173,956 @@ TEST_CASE("Limited Test of Graph<string, double>", "[graph]") {
 		REQUIRE(oss.str() != original_output);
 	}
 }
+
+TEST_CASE("Graph heterogeneous lookup operation", "[node_key]") {
+	using namespace std::string_view_literals;
+	auto g = gdwg::graph<std::string, int>{"A", "B", "C"};
+	g.insert_edge("A"sv, "B"sv, 1);
+	g.insert_edge("A", "C");
+
+	SECTION("Accessors with string_view keys") {
+		REQUIRE(g.is_node("A"sv));
+		REQUIRE_FALSE(g.is_node("D"sv));
+		REQUIRE(g.is_connected("A"sv, "B"sv));
+		REQUIRE_FALSE(g.is_connected("B"sv, "A"sv));
+		REQUIRE(g.edges("A"sv, "B"sv).size() == 1);
+		REQUIRE(g.connections("A"sv) == std::vector<std::string>{"B", "C"});
+		REQUIRE(g.find("A"sv, "C"sv) != g.end());
+		REQUIRE(g.find("A"sv, "D"sv) == g.end());
+	}
+
+	SECTION("Accessors throw for missing string_view keys") {
+		REQUIRE_THROWS_WITH(g.is_connected("A"sv, "D"sv),
+		                    "Cannot call gdwg::graph<N, E>::is_connected if src or dst node don't exist in the graph");
+		REQUIRE_THROWS_WITH(g.connections("D"sv),
+		                    "Cannot call gdwg::graph<N, E>::connections if src doesn't exist in the graph");
+		REQUIRE_THROWS_WITH(g.insert_edge("D"sv, "A"sv),
+		                    "Cannot call gdwg::graph<N, E>::insert_edge when either src or dst node does not exist");
+	}
+
+	SECTION("Modifiers with string_view keys") {
+		REQUIRE(g.erase_edge("A"sv, "B"sv, 1));
+		REQUIRE_FALSE(g.is_connected("A", "B"));
+		REQUIRE(g.erase_node("C"sv));
+		REQUIRE_FALSE(g.is_node("C"));
+		REQUIRE(g.begin() == g.end());
+	}
+
+	SECTION("Move overloads take ownership of the value") {
+		auto value = std::string(64, 'x');
+		REQUIRE(g.insert_node(std::move(value)));
+		REQUIRE(g.is_node(std::string(64, 'x')));
+		auto replacement = std::string(64, 'y');
+		REQUIRE(g.replace_node("A", std::move(replacement)));
+		REQUIRE(g.is_connected(std::string(64, 'y'), "B"));
+		REQUIRE_FALSE(g.is_node("A"));
+	}
+}
+
+TEST_CASE("Graph reserve and shrink_to_fit operation", "[reserve]") {
+	auto g = gdwg::graph<std::string, int>{"A", "B"};
+	g.insert_edge("A", "B", 1);
+	g.insert_edge("A", "B");
+
+	SECTION("Reserve keeps the existing contents") {
+		auto const before = g;
+		REQUIRE(g.reserved_bytes() == 0);
+		g.reserve(100, 1000);
+		REQUIRE(g == before);
+		REQUIRE(g.is_connected("A", "B"));
+		REQUIRE(g.edges("A", "B").size() == 2);
+		auto const reserved = g.reserved_bytes();
+		REQUIRE(reserved > 0);
+		g.reserve(10, 10);
+		REQUIRE(g.reserved_bytes() == reserved);
+		g.reserve(1000, 1000);
+		REQUIRE(g.reserved_bytes() > reserved);
+	}
+
+	SECTION("Reserved graph supports the full modifier API") {
+		g.reserve(100, 100);
+		for (auto i = 0; i < 100; ++i) {
+			REQUIRE(g.insert_node(std::to_string(i)));
+			REQUIRE(g.insert_edge("A", std::to_string(i), i));
+		}
+		REQUIRE(g.connections("A").size() == 101);
+		REQUIRE(g.replace_node("B", "C"));
+		g.merge_replace_node("0", "C");
+		REQUIRE(g.erase_node("1"));
+		REQUIRE(g.erase_edge("A", "C", 1));
+		REQUIRE(g.is_connected("A", "C"));
+		REQUIRE_FALSE(g.is_node("1"));
+	}
+
+	SECTION("Shrink after erasing keeps the remaining contents") {
+		g.reserve(1000, 1000);
+		auto const reserved = g.reserved_bytes();
+		for (auto i = 0; i < 500; ++i) {
+			g.insert_node(std::to_string(i));
+			g.insert_edge("A", std::to_string(i), i);
+		}
+		// Inserts within the reservation are carved out of the pool without growing it
+		REQUIRE(g.reserved_bytes() == reserved);
+		for (auto i = 0; i < 500; ++i) {
+			g.erase_node(std::to_string(i));
+		}
+		REQUIRE(g.reserved_bytes() == reserved);
+		g.shrink_to_fit();
+		REQUIRE(g.reserved_bytes() > 0);
+		REQUIRE(g.reserved_bytes() * 100 < reserved);
+		REQUIRE(g.nodes() == std::vector<std::string>{"A", "B"});
+		REQUIRE(g.find("A", "B", 1) != g.end());
+		REQUIRE(g.find("A", "B") != g.end());
+		REQUIRE(g.insert_node("D"));
+	}
+
+	SECTION("Copies and moves of a reserved graph are independent") {
+		g.reserve(10, 10);
+		auto copy = g;
+		REQUIRE(copy == g);
+		copy.insert_node("C");
+		REQUIRE_FALSE(g.is_node("C"));
+		auto moved = std::move(copy);
+		REQUIRE(moved.is_node("C"));
+		REQUIRE(copy.empty());
+		REQUIRE(copy.insert_node("Z"));
+	}
+
+	SECTION("Shrink on an unreserved graph is a no-op") {
+		g.shrink_to_fit();
+		REQUIRE(g.reserved_bytes() == 0);
+		REQUIRE(g.nodes() == std::vector<std::string>{"A", "B"});
+	}
+}
+
+TEST_CASE("Graph erase_nodes operation", "[erase_nodes]") {
+	auto g = gdwg::graph<int, int>{1, 2, 3, 4, 5};
+	g.insert_edge(1, 2, 1);
+	g.insert_edge(2, 3, 2);
+	g.insert_edge(3, 4, 3);
+	g.insert_edge(4, 1, 4);
+	g.insert_edge(5, 5);
+
+	SECTION("Erases the nodes and every incident edge") {
+		REQUIRE(g.erase_nodes(std::vector<int>{2, 4}) == 2);
+		REQUIRE(g.nodes() == std::vector<int>{1, 3, 5});
+		REQUIRE(std::distance(g.begin(), g.end()) == 1);
+		REQUIRE(g.is_connected(5, 5));
+	}
+
+	SECTION("Ignores values which are not nodes") {
+		REQUIRE(g.erase_nodes(std::vector<int>{6, 7}) == 0);
+		REQUIRE(g.erase_nodes(std::vector<int>{5, 6, 5}) == 1);
+		REQUIRE(g.nodes() == std::vector<int>{1, 2, 3, 4});
+		REQUIRE(std::distance(g.begin(), g.end()) == 4);
+	}
+
+	SECTION("Matches repeated erase_node calls") {
+		auto expected = g;
+		expected.erase_node(1);
+		expected.erase_node(3);
+		REQUIRE(g.erase_nodes(std::vector<int>{1, 3}) == 2);
+		REQUIRE(g == expected);
+	}
+
+	SECTION("Accepts heterogeneous keys") {
+		using namespace std::string_view_literals;
+		auto sg = gdwg::graph<std::string, int>{"A", "B", "C"};
+		sg.insert_edge("A", "B");
+		sg.insert_edge("B", "C");
+		REQUIRE(sg.erase_nodes(std::vector{"A"sv, "C"sv}) == 2);
+		REQUIRE(sg.nodes() == std::vector<std::string>{"B"});
+		REQUIRE(sg.begin() == sg.end());
+	}
+}
+
+TEST_CASE("Graph erase_edges_if operation", "[erase_edges_if]") {
+	auto g = gdwg::graph<int, int>{1, 2, 3};
+	g.insert_edge(1, 2, 1);
+	g.insert_edge(1, 2, 5);
+	g.insert_edge(2, 3, 10);
+	g.insert_edge(3, 1);
+
+	SECTION("Erases edges below a weight threshold") {
+		auto const erased = g.erase_edges_if([](auto const&, auto const&, std::optional<int> const& weight) {
+			return weight and *weight < 6;
+		});
+		REQUIRE(erased == 2);
+		REQUIRE_FALSE(g.is_connected(1, 2));
+		REQUIRE(g.is_connected(2, 3));
+		REQUIRE(g.is_connected(3, 1));
+		REQUIRE(g.nodes() == std::vector<int>{1, 2, 3});
+	}
+
+	SECTION("Erases edges by their endpoints") {
+		auto const erased = g.erase_edges_if([](int src, int dst, auto const&) { return src > dst; });
+		REQUIRE(erased == 1);
+		REQUIRE_FALSE(g.is_connected(3, 1));
+	}
+
+	SECTION("Erases nothing when no edge matches") {
+		REQUIRE(g.erase_edges_if([](auto const&, auto const&, auto const&) { return false; }) == 0);
+		REQUIRE(std::distance(g.begin(), g.end()) == 4);
+	}
+}
+
+TEST_CASE("Graph lazy erase operation", "[lazy_erase]") {
+	auto g = gdwg::graph<std::string, int>{"A", "B", "C", "D"};
+	g.insert_edge("A", "B", 1);
+	g.insert_edge("A", "C", 2);
+	g.insert_edge("B", "C", 3);
+	g.insert_edge("C", "A");
+	g.insert_edge("D", "D", 4);
+	auto expected = g;
+	expected.erase_node("C");
+	g.set_lazy_erase(true);
+	REQUIRE(g.lazy_erase());
+	REQUIRE(g.erase_node("C"));
+
+	SECTION("Erased node is tombstoned until compaction") {
+		REQUIRE(g.tombstones() == 1);
+		REQUIRE_FALSE(g.is_node("C"));
+		REQUIRE_FALSE(g.erase_node("C"));
+		g.compact();
+		REQUIRE(g.tombstones() == 0);
+		REQUIRE(g == expected);
+	}
+
+	SECTION("Iteration, find and the accessors skip tombstones") {
+		REQUIRE(g == expected);
+		REQUIRE(std::distance(g.begin(), g.end()) == 2);
+		REQUIRE(std::distance(g.begin(), g.end()) == std::distance(expected.begin(), expected.end()));
+		REQUIRE(g.node_count() == 3);
+		REQUIRE(g.edge_count() == 2);
+		REQUIRE(expected.edge_count() == 2);
+		REQUIRE((*std::prev(g.end())).from == "D");
+		REQUIRE((*std::prev(g.end(), 2)).to == "B");
+		REQUIRE(g.find("A", "B", 1) == g.begin());
+		REQUIRE(g.connections("A") == std::vector<std::string>{"B"});
+		REQUIRE(g.edges("A", "B").size() == 1);
+		REQUIRE_THROWS(g.is_connected("A", "C"));
+		auto oss = std::ostringstream{};
+		auto expected_oss = std::ostringstream{};
+		oss << g;
+		expected_oss << expected;
+		REQUIRE(oss.str() == expected_oss.str());
+	}
+
+	SECTION("Reinserting an erased value does not revive its edges") {
+		REQUIRE(g.insert_node("C"));
+		REQUIRE_FALSE(g.is_connected("A", "C"));
+		REQUIRE(g.insert_edge("A", "C", 2));
+		REQUIRE(g.edges("A", "C").size() == 1);
+		REQUIRE(g.replace_node("C", "E"));
+		REQUIRE(g.is_connected("A", "E"));
+	}
+
+	SECTION("Erasing an edge is a keyed lookup in lazy mode too") {
+		REQUIRE(g.erase_edge("A", "B", 1));
+		REQUIRE_FALSE(g.erase_edge("A", "B", 1));
+		REQUIRE(std::distance(g.begin(), g.end()) == 1);
+	}
+
+	SECTION("Copies only contain live edges") {
+		auto const copy = g;
+		REQUIRE(copy.tombstones() == 0);
+		REQUIRE(copy == expected);
+		REQUIRE(copy.lazy_erase());
+	}
+
+	SECTION("Batch operations compact the tombstones they sweep") {
+		REQUIRE(g.erase_edges_if([](auto const&, auto const&, auto const&) { return true; }) == 2);
+		REQUIRE(g.tombstones() == 0);
+		REQUIRE(g.begin() == g.end());
+	}
+
+	SECTION("Disabling lazy erase compacts the graph") {
+		g.set_lazy_erase(false);
+		REQUIRE(g.tombstones() == 0);
+		REQUIRE(g.erase_node("D"));
+		REQUIRE(g.tombstones() == 0);
+	}
+
+	SECTION("Compaction on a background thread") {
+		auto pending = g.compact_async();
+		REQUIRE(g.tombstones() == 1);
+		REQUIRE(g == expected);
+		g.compact(std::move(pending));
+		REQUIRE(g.tombstones() == 0);
+		REQUIRE(g == expected);
+		REQUIRE(g.fingerprint() == expected.fingerprint());
+		REQUIRE(std::distance(g.begin(), g.end()) == 2);
+	}
+
+	SECTION("A background compaction follows the graph when it is moved") {
+		auto pending = g.compact_async();
+		auto moved = std::move(g);
+		g = expected;
+		moved.compact(std::move(pending));
+		REQUIRE(moved.tombstones() == 0);
+		REQUIRE(moved == expected);
+	}
+
+	SECTION("A graph changed during a background compaction is compacted again") {
+		auto pending = g.compact_async();
+		REQUIRE(g.insert_edge("A", "D", 5));
+		REQUIRE(g.erase_node("B"));
+		REQUIRE(g.tombstones() == 2);
+		g.compact(std::move(pending));
+		REQUIRE(g.tombstones() == 0);
+		expected.insert_edge("A", "D", 5);
+		expected.erase_node("B");
+		REQUIRE(g == expected);
+		REQUIRE(g.fingerprint() == expected.fingerprint());
+	}
+}
+
+TEST_CASE("Graph fingerprint operation", "[fingerprint]") {
+	auto g = gdwg::graph<std::string, int>{"A", "B", "C"};
+	g.insert_edge("A", "B", 1);
+	g.insert_edge("B", "C", 2);
+	g.insert_edge("C", "A");
+
+	SECTION("Graphs built in a different order have the same fingerprint") {
+		auto other = gdwg::graph<std::string, int>{};
+		other.insert_node("C");
+		other.insert_node("A");
+		other.insert_node("B");
+		other.insert_edge("C", "A");
+		other.insert_edge("B", "C", 2);
+		other.insert_edge("A", "B", 1);
+		REQUIRE(g.fingerprint() == other.fingerprint());
+		REQUIRE(g == other);
+		REQUIRE(gdwg::graph<std::string, int>{}.fingerprint() == gdwg::graph_fingerprint{});
+	}
+
+	SECTION("Every modifier changes the fingerprint and undoing it restores it") {
+		auto const original = g.fingerprint();
+		REQUIRE(g.insert_node("D"));
+		REQUIRE(g.fingerprint() != original);
+		REQUIRE(g.erase_node("D"));
+		REQUIRE(g.fingerprint() == original);
+
+		REQUIRE(g.insert_edge("A", "B", 3));
+		REQUIRE(g.fingerprint() != original);
+		REQUIRE(g.erase_edge("A", "B", 3));
+		REQUIRE(g.fingerprint() == original);
+
+		REQUIRE(g.erase_edge("C", "A"));
+		auto const without_edge = g.fingerprint();
+		REQUIRE(without_edge != original);
+		REQUIRE(g.insert_edge("C", "A"));
+		REQUIRE(g.fingerprint() == original);
+
+		REQUIRE(g.replace_node("A", "Z"));
+		REQUIRE(g.fingerprint() != original);
+		REQUIRE(g.replace_node("Z", "A"));
+		REQUIRE(g.fingerprint() == original);
+
+		g.erase_edge(g.begin(), g.end());
+		REQUIRE(g.fingerprint() == gdwg::graph<std::string, int>{"A", "B", "C"}.fingerprint());
+		g.clear();
+		REQUIRE(g.fingerprint() == gdwg::graph_fingerprint{});
+	}
+
+	SECTION("The direction and weight of an edge are part of the fingerprint") {
+		auto forward = gdwg::graph<std::string, int>{"A", "B"};
+		auto backward = forward;
+		auto weighted = forward;
+		forward.insert_edge("A", "B");
+		backward.insert_edge("B", "A");
+		weighted.insert_edge("A", "B", 0);
+		REQUIRE(forward.fingerprint() != backward.fingerprint());
+		REQUIRE(forward.fingerprint() != weighted.fingerprint());
+		REQUIRE_FALSE(forward == backward);
+	}
+
+	SECTION("Merging nodes collapses duplicate edges in the fingerprint") {
+		g.insert_edge("A", "C", 2);
+		g.merge_replace_node("A", "B");
+		auto expected = gdwg::graph<std::string, int>{"B", "C"};
+		expected.insert_edge("B", "B", 1);
+		expected.insert_edge("B", "C", 2);
+		expected.insert_edge("C", "B");
+		REQUIRE(g.fingerprint() == expected.fingerprint());
+		REQUIRE(g == expected);
+	}
+
+	SECTION("Lazy and eager erasure agree") {
+		auto lazy = g;
+		lazy.set_lazy_erase(true);
+		REQUIRE(lazy.erase_node("B"));
+		REQUIRE(g.erase_node("B"));
+		REQUIRE(lazy.tombstones() == 1);
+		REQUIRE(lazy.fingerprint() == g.fingerprint());
+		lazy.compact();
+		REQUIRE(lazy.fingerprint() == g.fingerprint());
+	}
+
+	SECTION("Copies and moves carry the fingerprint") {
+		auto const original = g.fingerprint();
+		auto const copy = g;
+		REQUIRE(copy.fingerprint() == original);
+		auto moved = std::move(g);
+		REQUIRE(moved.fingerprint() == original);
+		g.reserve(8, 8);
+		REQUIRE(g.fingerprint() == gdwg::graph_fingerprint{});
+		moved.reserve(64, 64);
+		REQUIRE(moved.fingerprint() == original);
+	}
+}
+
+namespace {
+	struct blob {
+		std::size_t size;
+		auto operator<=>(blob const&) const = default;
+	};
+
+	auto operator<<(std::ostream& os, blob const& value) -> std::ostream& {
+		return os << "blob(" << value.size << ")";
+	}
+} // namespace
+
+template<>
+struct gdwg::heap_usage<blob> {
+	auto operator()(blob const& value) const noexcept -> std::size_t {
+		return value.size;
+	}
+};
+
+TEST_CASE("Graph memory_usage operation", "[memory_usage]") {
+	SECTION("An empty graph uses no memory") {
+		auto const g = gdwg::graph<int, int>{};
+		REQUIRE(g.memory_usage() == gdwg::graph_memory_usage{});
+		REQUIRE(g.memory_usage().total() == 0);
+	}
+
+	SECTION("Storage grows with the nodes and edges") {
+		auto g = gdwg::graph<int, int>{1, 2, 3};
+		auto const nodes_only = g.memory_usage();
+		REQUIRE(nodes_only.node_storage > 0);
+		REQUIRE(nodes_only.edge_storage == 0);
+		REQUIRE(nodes_only.allocator_overhead > 0);
+		REQUIRE(nodes_only.heap_payload == 0);
+
+		g.insert_edge(1, 2, 3);
+		g.insert_edge(2, 3);
+		auto const with_edges = g.memory_usage();
+		REQUIRE(with_edges.node_storage == nodes_only.node_storage);
+		REQUIRE(with_edges.edge_storage > 0);
+		REQUIRE(with_edges.total() > nodes_only.total());
+
+		g.erase_node(3);
+		auto const erased = g.memory_usage();
+		REQUIRE(erased.node_storage == nodes_only.node_storage / 3 * 2);
+		REQUIRE(erased.edge_storage == with_edges.edge_storage / 2);
+	}
+
+	SECTION("Heap payload counts the node copies held by every edge") {
+		auto const long_name = std::string(100, 'x');
+		auto g = gdwg::graph<std::string, int>{"a", "b"};
+		REQUIRE(g.memory_usage().heap_payload == 0);
+		g.insert_node(long_name);
+		auto const payload = gdwg::heap_bytes(long_name);
+		REQUIRE(payload > long_name.size());
+		REQUIRE(g.memory_usage().heap_payload == payload);
+		g.insert_edge(long_name, long_name);
+		REQUIRE(g.memory_usage().heap_payload == 3 * payload);
+		g.insert_edge("a", "b", 1);
+		REQUIRE(g.memory_usage().heap_payload == 3 * payload);
+	}
+
+	SECTION("Custom heap_usage specialisations are used for nodes and weights") {
+		auto g = gdwg::graph<blob, blob>{blob{10}, blob{20}};
+		REQUIRE(g.memory_usage().heap_payload == 30);
+		g.insert_edge(blob{10}, blob{20}, blob{5});
+		REQUIRE(g.memory_usage().heap_payload == 30 + 10 + 20 + 5);
+		REQUIRE(gdwg::heap_bytes(std::vector<blob>{blob{1}, blob{2}}) >= 2 * sizeof(blob) + 3);
+		REQUIRE(gdwg::heap_bytes(1) == 0);
+	}
+
+	SECTION("A reserved pool reports its unused capacity as overhead") {
+		auto g = gdwg::graph<int, int>{1, 2};
+		g.reserve(1000, 1000);
+		auto const reserved = g.memory_usage();
+		REQUIRE(reserved.allocator_overhead > reserved.node_storage + reserved.edge_storage);
+		g.shrink_to_fit();
+		REQUIRE(g.memory_usage().allocator_overhead < reserved.allocator_overhead);
+	}
+
+	SECTION("Tombstoned nodes are accounted for until they are compacted") {
+		auto g = gdwg::graph<int, int>{1, 2};
+		g.insert_edge(1, 2);
+		auto const before = g.memory_usage();
+		g.set_lazy_erase(true);
+		g.erase_node(2);
+		REQUIRE(g.memory_usage() == before);
+		g.compact();
+		REQUIRE(g.memory_usage().total() < before.total());
+	}
+}
+
+TEST_CASE("Graph stats operation without instrumentation", "[stats]") {
+	REQUIRE_FALSE(gdwg::instrumentation_enabled);
+	auto g = gdwg::graph<std::string, int>{"A", "B"};
+	g.insert_edge("A", "B", 1);
+	REQUIRE(g.is_connected("A", "B"));
+	REQUIRE(g.stats() == gdwg::graph_stats{});
+	g.reset_stats();
+	REQUIRE(g.stats() == gdwg::graph_stats{});
+}
+
+namespace {
+	auto drain_all(gdwg::change_feed<std::string, int>& feed) -> std::vector<gdwg::mutation<std::string, int>> {
+		auto events = std::vector<gdwg::mutation<std::string, int>>{};
+		feed.drain([&events](auto&& event) { events.push_back(std::move(event)); });
+		return events;
+	}
+} // namespace
+
+TEST_CASE("Graph change feed operation", "[change_feed]") {
+	using event = gdwg::mutation<std::string, int>;
+	using kind = gdwg::mutation_kind;
+	auto g = gdwg::graph<std::string, int>{};
+	auto const feed = g.subscribe(64);
+
+	SECTION("Every modifier reports its change in order") {
+		g.insert_node("A");
+		g.insert_node("B");
+		g.insert_edge("A", "B", 1);
+		g.insert_edge("B", "A");
+		REQUIRE_FALSE(g.insert_node("A"));
+		g.replace_node("A", "C");
+		g.erase_edge("C", "B", 1);
+		auto const events = drain_all(*feed);
+		REQUIRE(events
+		        == std::vector<event>{
+		            {kind::insert_node, "A", std::nullopt, std::nullopt, false},
+		            {kind::insert_node, "B", std::nullopt, std::nullopt, false},
+		            {kind::insert_edge, "A", "B", 1, false},
+		            {kind::insert_edge, "B", "A", std::nullopt, false},
+		            {kind::replace_node, "A", "C", std::nullopt, false},
+		            {kind::erase_edge, "C", "B", 1, false},
+		        });
+		REQUIRE_FALSE(feed->poll());
+	}
+
+	SECTION("Erasing a node reports the edges removed with it") {
+		g = gdwg::graph<std::string, int>{"A", "B", "C"};
+		g.insert_edge("A", "B", 1);
+		g.insert_edge("C", "A", 2);
+		g.insert_edge("B", "C", 3);
+		drain_all(*feed);
+		g.erase_node("A");
+		auto const events = drain_all(*feed);
+		REQUIRE(events.size() == 3);
+		REQUIRE(events[0] == event{kind::erase_node, "A", std::nullopt, std::nullopt, false});
+		REQUIRE(events[1] == event{kind::erase_edge, "A", "B", 1, true});
+		REQUIRE(events[2] == event{kind::erase_edge, "C", "A", 2, true});
+	}
+
+	SECTION("With lazy erasure the removed edges are reported on compaction") {
+		g = gdwg::graph<std::string, int>{"A", "B"};
+		g.insert_edge("A", "B", 1);
+		g.set_lazy_erase(true);
+		drain_all(*feed);
+		g.erase_node("B");
+		REQUIRE(drain_all(*feed).size() == 1);
+		g.compact();
+		REQUIRE(drain_all(*feed) == std::vector<event>{{kind::erase_edge, "A", "B", 1, true}});
+	}
+
+	SECTION("Replaying the events reproduces the graph") {
+		auto mirror = gdwg::graph<std::string, int>{};
+		g.insert_node("A");
+		g.insert_node("B");
+		g.insert_node("C");
+		g.insert_edge("A", "B", 1);
+		g.insert_edge("A", "C", 1);
+		g.insert_edge("C", "B", 2);
+		g.merge_replace_node("C", "B");
+		g.erase_nodes(std::vector<std::string>{"A"});
+		g.insert_node("D");
+		g.insert_edge("D", "B", 4);
+		g.insert_edge("B", "D", 5);
+		g.erase_edges_if([](auto const&, auto const&, auto const& weight) { return weight == 5; });
+		g.erase_edge(g.begin());
+		for (auto const& e : drain_all(*feed)) {
+			mirror.apply(e);
+		}
+		REQUIRE(mirror == g);
+	}
+
+	SECTION("Assignment reports the new contents") {
+		auto other = gdwg::graph<std::string, int>{"X", "Y"};
+		other.insert_edge("X", "Y", 7);
+		g.insert_node("A");
+		g = other;
+		auto mirror = gdwg::graph<std::string, int>{"stale"};
+		for (auto const& e : drain_all(*feed)) {
+			mirror.apply(e);
+		}
+		REQUIRE(mirror == other);
+
+		g = gdwg::graph<std::string, int>{"Z"};
+		for (auto const& e : drain_all(*feed)) {
+			mirror.apply(e);
+		}
+		REQUIRE(mirror == gdwg::graph<std::string, int>{"Z"});
+
+		auto const moved = std::move(g);
+		REQUIRE(drain_all(*feed) == std::vector<event>{{kind::clear, std::nullopt, std::nullopt, std::nullopt, false}});
+	}
+
+	SECTION("Copies and detached feeds receive nothing") {
+		g.insert_node("A");
+		auto copy = g;
+		copy.insert_node("B");
+		REQUIRE(drain_all(*feed).size() == 1);
+		REQUIRE(g.detach(feed));
+		REQUIRE_FALSE(g.detach(feed));
+		g.insert_node("C");
+		REQUIRE_FALSE(feed->poll());
+	}
+
+	SECTION("A full feed drops and counts new events") {
+		auto const small = g.subscribe(2);
+		g.insert_node("A");
+		g.insert_node("B");
+		g.insert_node("C");
+		REQUIRE(small->dropped() == 1);
+		REQUIRE(feed->dropped() == 0);
+		REQUIRE(small->poll()->src == "A");
+		REQUIRE(small->poll()->src == "B");
+		REQUIRE_FALSE(small->poll());
+	}
+
+	SECTION("A consumer thread follows the writer") {
+		auto constexpr total = 5000;
+		auto received = std::vector<std::string>{};
+		auto done = std::atomic<bool>{false};
+		auto consumer = std::thread([&] {
+			while (true) {
+				auto const finished = done.load();
+				// Once the writer is done every event it pushed is visible, so an empty feed is really empty
+				while (auto e = feed->poll()) {
+					received.push_back(*e->src);
+				}
+				if (finished)
+					break;
+			}
+		});
+		for (auto i = 0; i < total; ++i) {
+			g.insert_node(std::to_string(i));
+		}
+		done.store(true);
+		consumer.join();
+		REQUIRE(received.size() + feed->dropped() == total);
+		REQUIRE(std::is_sorted(received.begin(), received.end(), [](auto const& a, auto const& b) {
+			return std::stoi(a) < std::stoi(b);
+		}));
+	}
+}
+
+TEST_CASE("Graph diff operation", "[diff]") {
+	using graph_type = gdwg::graph<std::string, int>;
+	using edge_value = gdwg::graph_delta<std::string, int>::edge_value;
+	auto a = graph_type{"A", "B", "C"};
+	a.insert_edge("A", "B", 1);
+	a.insert_edge("B", "C", 2);
+	a.insert_edge("C", "A");
+
+	SECTION("Equal graphs have an empty delta") {
+		auto const b = a;
+		auto const delta = gdwg::diff(a, b);
+		REQUIRE(delta.empty());
+		REQUIRE(delta.size() == 0);
+	}
+
+	SECTION("Added and removed nodes and edges are listed in order") {
+		auto b = a;
+		b.erase_edge("A", "B", 1);
+		b.insert_edge("A", "B", 5);
+		b.insert_edge("A", "B");
+		b.insert_node("D");
+		b.insert_node("0");
+		auto const delta = gdwg::diff(a, b);
+		REQUIRE(delta.added_nodes == std::vector<std::string>{"0", "D"});
+		REQUIRE(delta.removed_nodes.empty());
+		REQUIRE(delta.added_edges == std::vector<edge_value>{{"A", "B", std::nullopt}, {"A", "B", 5}});
+		REQUIRE(delta.removed_edges == std::vector<edge_value>{{"A", "B", 1}});
+		REQUIRE(delta.size() == 5);
+	}
+
+	SECTION("Edges of removed nodes are left out") {
+		auto b = a;
+		b.erase_node("C");
+		auto const delta = gdwg::diff(a, b);
+		REQUIRE(delta.removed_nodes == std::vector<std::string>{"C"});
+		REQUIRE(delta.removed_edges.empty());
+		REQUIRE(delta.added_nodes.empty());
+		REQUIRE(delta.added_edges.empty());
+	}
+
+	SECTION("Lazily erased edges are ignored") {
+		auto b = a;
+		b.set_lazy_erase(true);
+		b.erase_node("C");
+		REQUIRE(gdwg::diff(a, b).removed_edges.empty());
+		REQUIRE(gdwg::diff(b, a).added_edges == std::vector<edge_value>{{"B", "C", 2}, {"C", "A", std::nullopt}});
+	}
+
+	SECTION("Applying the delta turns one graph into the other") {
+		auto b = graph_type{"B", "C", "E"};
+		b.insert_edge("B", "C", 2);
+		b.insert_edge("E", "B", 7);
+		b.insert_edge("C", "C", 3);
+		auto patched = a;
+		patched.apply(gdwg::diff(a, b));
+		REQUIRE(patched == b);
+		patched.apply(gdwg::diff(b, a));
+		REQUIRE(patched == a);
+	}
+
+	SECTION("A delta with edges between missing nodes throws") {
+		auto delta = gdwg::graph_delta<std::string, int>{};
+		delta.added_edges.push_back({"X", "Y", 1});
+		REQUIRE_THROWS_AS(a.apply(delta), std::runtime_error);
+	}
+}
+
+namespace {
+	// The expected result of an operation on whole graphs, built one insertion at a time
+	auto build(std::vector<std::string> const& nodes,
+	           std::vector<std::tuple<std::string, std::string, std::optional<int>>> const& edges)
+	    -> gdwg::graph<std::string, int> {
+		auto g = gdwg::graph<std::string, int>(nodes.begin(), nodes.end());
+		for (auto const& [from, to, weight] : edges) {
+			g.insert_edge(from, to, weight);
+		}
+		return g;
+	}
+} // namespace
+
+TEST_CASE("Graph set algebra operation", "[set_algebra]") {
+	using graph_type = gdwg::graph<std::string, int>;
+	auto a = graph_type{"A", "B", "C"};
+	a.insert_edge("A", "B", 1);
+	a.insert_edge("B", "C", 2);
+	a.insert_edge("C", "A");
+	auto b = graph_type{"B", "C", "D"};
+	b.insert_edge("B", "C", 2);
+	b.insert_edge("B", "C", 3);
+	b.insert_edge("D", "B");
+
+	SECTION("Union keeps the nodes and edges of both graphs") {
+		auto const g = gdwg::graph_union(a, b);
+		auto const expected =
+		    build({"A", "B", "C", "D"},
+		          {{"A", "B", 1}, {"B", "C", 2}, {"B", "C", 3}, {"C", "A", std::nullopt}, {"D", "B", std::nullopt}});
+		REQUIRE(g == expected);
+		REQUIRE(g.fingerprint() == expected.fingerprint());
+		REQUIRE(gdwg::graph_union(a, a) == a);
+	}
+
+	SECTION("Intersection keeps what both graphs share") {
+		auto const g = gdwg::graph_intersection(a, b);
+		REQUIRE(g == build({"B", "C"}, {{"B", "C", 2}}));
+		REQUIRE(gdwg::graph_intersection(a, graph_type{}).empty());
+	}
+
+	SECTION("Difference keeps the nodes of the first graph and its edges missing from the second") {
+		auto const g = gdwg::graph_difference(a, b);
+		REQUIRE(g == build({"A", "B", "C"}, {{"A", "B", 1}, {"C", "A", std::nullopt}}));
+		REQUIRE(gdwg::graph_difference(a, a) == graph_type{"A", "B", "C"});
+	}
+
+	SECTION("Results are independent of their inputs") {
+		auto g = gdwg::graph_union(a, b);
+		g.replace_node("A", "Z");
+		REQUIRE(a.is_node("A"));
+		REQUIRE(g.is_connected("Z", "B"));
+	}
+
+	SECTION("Lazily erased edges are left out") {
+		a.set_lazy_erase(true);
+		a.erase_node("C");
+		REQUIRE(gdwg::graph_union(a, graph_type{}) == build({"A", "B"}, {{"A", "B", 1}}));
+	}
+
+	SECTION("A pooled input gives a pooled result") {
+		a.reserve(8, 8);
+		auto const before = a.memory_usage();
+		auto const g = gdwg::graph_union(a, b);
+		REQUIRE(g.memory_usage().allocator_overhead > 0);
+		REQUIRE(before == a.memory_usage());
+	}
+}
+
+TEST_CASE("Graph subgraph operation", "[subgraph]") {
+	using graph_type = gdwg::graph<std::string, int>;
+	auto g = graph_type{"A", "B", "C", "D", "E"};
+	g.insert_edge("A", "B", 1);
+	g.insert_edge("A", "B", 2);
+	g.insert_edge("B", "C", 3);
+	g.insert_edge("C", "A", 4);
+	g.insert_edge("C", "D");
+	g.insert_edge("D", "E", 5);
+	g.insert_edge("E", "E", 6);
+
+	SECTION("induced_subgraph keeps the edges between the given nodes") {
+		auto const sub = g.induced_subgraph({"C", "A", "B", "A"});
+		auto const expected = build({"A", "B", "C"}, {{"A", "B", 1}, {"A", "B", 2}, {"B", "C", 3}, {"C", "A", 4}});
+		REQUIRE(sub == expected);
+		REQUIRE(sub.fingerprint() == expected.fingerprint());
+		REQUIRE(g.induced_subgraph(std::vector<std::string>{"D", "E"}) == build({"D", "E"}, {{"D", "E", 5}, {"E", "E", 6}}));
+		REQUIRE(g.induced_subgraph(std::vector<std::string_view>{"B"}) == graph_type{"B"});
+		REQUIRE(g.induced_subgraph(std::vector<std::string>{}).empty());
+	}
+
+	SECTION("induced_subgraph throws for a missing node") {
+		REQUIRE_THROWS_WITH(g.induced_subgraph({"A", "Z"}),
+		                    "Cannot call gdwg::graph<N, E>::induced_subgraph if a node doesn't exist in the graph");
+	}
+
+	SECTION("ego_graph follows outgoing edges up to the given distance") {
+		REQUIRE(g.ego_graph("A", 0) == graph_type{"A"});
+		REQUIRE(g.ego_graph("A", 1) == g.induced_subgraph({"A", "B"}));
+		REQUIRE(g.ego_graph("A", 2) == g.induced_subgraph({"A", "B", "C"}));
+		REQUIRE(g.ego_graph("A", 3) == g.induced_subgraph({"A", "B", "C", "D"}));
+		REQUIRE(g.ego_graph("A", 100) == g);
+		REQUIRE(g.ego_graph("E", 100) == build({"E"}, {{"E", "E", 6}}));
+		REQUIRE_THROWS_WITH(g.ego_graph("Z", 1),
+		                    "Cannot call gdwg::graph<N, E>::ego_graph if seed doesn't exist in the graph");
+	}
+
+	SECTION("Lazily erased nodes are not reached") {
+		g.set_lazy_erase(true);
+		g.erase_node("C");
+		REQUIRE(g.ego_graph("A", 100) == build({"A", "B"}, {{"A", "B", 1}, {"A", "B", 2}}));
+		REQUIRE(g.induced_subgraph({"B", "D"}) == graph_type{"B", "D"});
+	}
+
+	SECTION("filtered views the induced subgraph without copying") {
+		auto const view = g.filtered([](std::string const& n) { return n != "C"; });
+		REQUIRE(view.is_node("A"));
+		REQUIRE_FALSE(view.is_node("C"));
+		REQUIRE_FALSE(view.is_node("Z"));
+		REQUIRE(std::ranges::equal(view.nodes(), std::vector<std::string>{"A", "B", "D", "E"}));
+		auto edges = std::vector<std::tuple<std::string, std::string, std::optional<int>>>{};
+		for (auto const& [from, to, weight] : view.edges()) {
+			edges.emplace_back(from, to, weight);
+		}
+		REQUIRE(edges.size() == 4);
+		REQUIRE(std::get<0>(edges.front()) == "A");
+		REQUIRE(view.connections("A") == std::vector<std::string>{"B"});
+		REQUIRE(view.is_connected("D", "E"));
+		REQUIRE_THROWS_WITH(view.connections("C"),
+		                    "Cannot call gdwg::graph_view<N, E, P>::connections if src isn't in the view");
+		REQUIRE_THROWS(view.is_connected("A", "C"));
+		REQUIRE(view.materialize() == g.induced_subgraph({"A", "B", "D", "E"}));
+	}
+
+	SECTION("The ranges of a temporary view outlive it") {
+		auto const& pred = [](std::string const& n) { return n != "C"; };
+		auto nodes = std::vector<std::string>{};
+		for (auto const& n : g.filtered(pred).nodes()) {
+			nodes.push_back(n);
+		}
+		REQUIRE(nodes == std::vector<std::string>{"A", "B", "D", "E"});
+		auto edge_count = 0;
+		for (auto const& [from, to, weight] : g.filtered(pred).edges()) {
+			REQUIRE(from != "C");
+			REQUIRE(to != "C");
+			++edge_count;
+		}
+		REQUIRE(edge_count == 4);
+	}
+
+	SECTION("A view reflects later changes to its graph") {
+		auto const view = g.filtered([](std::string const& n) { return n < "C"; });
+		REQUIRE(std::ranges::distance(view.edges()) == 2);
+		g.insert_edge("B", "A", 7);
+		REQUIRE(std::ranges::distance(view.edges()) == 3);
+		REQUIRE(view.connections("B") == std::vector<std::string>{"A"});
+	}
+}
+
+TEST_CASE("Graph transpose operation", "[transpose]") {
+	using graph_type = gdwg::graph<std::string, int>;
+	auto g = graph_type{"A", "B", "C", "D"};
+	g.insert_edge("A", "B", 1);
+	g.insert_edge("A", "C", 2);
+	g.insert_edge("B", "C", 3);
+	g.insert_edge("C", "A");
+	g.insert_edge("C", "A", 4);
+	g.insert_edge("D", "D", 5);
+
+	auto const expected = build(
+	    {"A", "B", "C", "D"},
+	    {{"B", "A", 1}, {"C", "A", 2}, {"C", "B", 3}, {"A", "C", std::nullopt}, {"A", "C", 4}, {"D", "D", 5}});
+
+	SECTION("transpose reverses every edge") {
+		auto const t = g.transpose();
+		REQUIRE(t == expected);
+		REQUIRE(t.fingerprint() == expected.fingerprint());
+		REQUIRE(t.transpose() == g);
+		REQUIRE(graph_type{}.transpose().empty());
+	}
+
+	SECTION("The transpose is independent of the graph") {
+		auto t = g.transpose();
+		t.replace_node("A", "Z");
+		g.erase_node("B");
+		REQUIRE(t.is_connected("B", "Z"));
+		REQUIRE(g.is_node("A"));
+		REQUIRE_FALSE(t.is_node("A"));
+	}
+
+	SECTION("Lazily erased edges are left out") {
+		g.set_lazy_erase(true);
+		g.erase_node("A");
+		auto compacted = g;
+		compacted.compact();
+		REQUIRE(g.transpose() == compacted.transpose());
+	}
+
+	SECTION("A pooled transpose leaves the shared nodes to the graph") {
+		g.reserve(8, 8);
+		auto t = g.transpose();
+		auto const shared = t.memory_usage();
+		REQUIRE(shared.node_storage < g.memory_usage().node_storage);
+		REQUIRE(shared.edge_storage == g.memory_usage().edge_storage);
+
+		// A copy allocates nodes of its own, so it needs the room the transpose does not
+		auto const copied = graph_type{t}.memory_usage();
+		REQUIRE(copied.node_storage == g.memory_usage().node_storage);
+		REQUIRE(shared.total() - shared.heap_payload < copied.total() - copied.heap_payload);
+
+		// A node inserted into the transpose is its own, so its object is counted as well as its entry
+		auto const object_bytes = (copied.node_storage - shared.node_storage) / g.nodes().size();
+		t.insert_node("E");
+		REQUIRE(t.memory_usage().node_storage > shared.node_storage + object_bytes);
+	}
+
+	SECTION("reversed views the transpose through an in-edge index") {
+		auto const view = g.reversed();
+		auto edges = std::vector<std::tuple<std::string, std::string, std::optional<int>>>{};
+		for (auto const& [from, to, weight] : view.edges()) {
+			edges.emplace_back(from, to, weight);
+		}
+		auto expected_edges = std::vector<std::tuple<std::string, std::string, std::optional<int>>>{};
+		for (auto const& [from, to, weight] : expected) {
+			expected_edges.emplace_back(from, to, weight);
+		}
+		REQUIRE(edges == expected_edges);
+		REQUIRE(view.connections("A") == std::vector<std::string>{"C"});
+		REQUIRE(view.connections("C") == std::vector<std::string>{"A", "B"});
+		REQUIRE(view.connections("B") == std::vector<std::string>{"A"});
+		REQUIRE(view.is_connected("B", "A"));
+		REQUIRE_FALSE(view.is_connected("A", "B"));
+		REQUIRE(view.is_node("D"));
+		REQUIRE_THROWS_WITH(view.connections("Z"),
+		                    "Cannot call gdwg::reverse_view<N, E>::connections if src doesn't exist in the graph");
+	}
+}
@@ -0,0 +1,95 @@
+#include "gdwg_graph.h"
+
+#include <catch2/catch.hpp>
+
+#include <numeric>
+#include <thread>
+
+namespace {
+	auto latency_calls(gdwg::operation_stats const& op) -> std::uint64_t {
+		return std::accumulate(op.latency_ns.begin(), op.latency_ns.end(), std::uint64_t{0});
+	}
+} // namespace
+
+TEST_CASE("Graph stats operation", "[stats]") {
+	REQUIRE(gdwg::instrumentation_enabled);
+	auto g = gdwg::graph<std::string, int>{"A", "B", "C"};
+	REQUIRE(g.stats() == gdwg::graph_stats{});
+
+	SECTION("Every call is counted once and lands in one latency bucket") {
+		g.insert_node("D");
+		g.insert_node(std::string{"E"});
+		g.insert_edge("A", "B", 1);
+		g.insert_edge("A", "C", 2);
+		REQUIRE(g.is_connected("A", "B"));
+		REQUIRE(g.is_node("A"));
+		REQUIRE(g.is_node(std::string_view{"Z"}) == false);
+		REQUIRE(g.erase_edge("A", "C", 2));
+		REQUIRE(g.erase_node("E"));
+		REQUIRE_THROWS(g.connections("Z"));
+
+		auto const stats = g.stats();
+		REQUIRE(stats[gdwg::graph_operation::insert_node].calls == 2);
+		REQUIRE(stats[gdwg::graph_operation::insert_edge].calls == 2);
+		REQUIRE(stats[gdwg::graph_operation::is_connected].calls == 1);
+		REQUIRE(stats[gdwg::graph_operation::is_node].calls == 2);
+		REQUIRE(stats[gdwg::graph_operation::erase_edge].calls == 1);
+		REQUIRE(stats[gdwg::graph_operation::erase_node].calls == 1);
+		REQUIRE(stats[gdwg::graph_operation::connections].calls == 1);
+		REQUIRE(stats[gdwg::graph_operation::find].calls == 0);
+		for (auto const& op : stats.operations) {
+			REQUIRE(latency_calls(op) == op.calls);
+		}
+	}
+
+	SECTION("Operations made by another operation are not counted as calls") {
+		REQUIRE(g.replace_node("C", "D"));
+		REQUIRE_FALSE(g.replace_node("A", "B"));
+		auto const stats = g.stats();
+		REQUIRE(stats[gdwg::graph_operation::replace_node].calls == 2);
+		REQUIRE(stats[gdwg::graph_operation::replace_node].comparisons > 0);
+		REQUIRE(stats[gdwg::graph_operation::is_node] == gdwg::operation_stats{});
+	}
+
+	SECTION("Comparisons are attributed to the operation making them") {
+		g.insert_edge("A", "B", 1);
+		auto const stats = g.stats();
+		REQUIRE(stats[gdwg::graph_operation::insert_edge].comparisons > 0);
+		REQUIRE(stats[gdwg::graph_operation::is_node].comparisons == 0);
+		g.reset_stats();
+		REQUIRE(g.is_node("C"));
+		REQUIRE(g.stats()[gdwg::graph_operation::is_node].comparisons > 0);
+		REQUIRE(g.stats()[gdwg::graph_operation::insert_edge] == gdwg::operation_stats{});
+	}
+
+	SECTION("Linear scans count the edges they visit") {
+		g.insert_edge("A", "B", 1);
+		g.insert_edge("B", "C", 2);
+		g.insert_edge("C", "A", 3);
+		g.reset_stats();
+		REQUIRE(g.connections("B") == std::vector<std::string>{"C"});
+		REQUIRE(g.stats()[gdwg::graph_operation::connections].visits == 3);
+		REQUIRE(g.erase_node("A"));
+		REQUIRE(g.stats()[gdwg::graph_operation::erase_node].visits == 3);
+		REQUIRE(g.stats()[gdwg::graph_operation::is_connected].visits == 0);
+	}
+
+	SECTION("Operations on other threads are counted") {
+		auto worker = std::thread([&g] {
+			for (auto i = 0; i < 100; ++i) {
+				REQUIRE(g.is_node("A"));
+			}
+		});
+		worker.join();
+		REQUIRE(g.stats()[gdwg::graph_operation::is_node].calls == 100);
+	}
+
+	SECTION("Copies start with their own statistics") {
+		g.insert_edge("A", "B", 1);
+		REQUIRE(g.is_node("A"));
+		auto const copy = g;
+		REQUIRE(copy == g);
+		REQUIRE(copy.stats() == gdwg::graph_stats{});
+		REQUIRE(g.stats()[gdwg::graph_operation::is_node].calls == 1);
+	}
+}
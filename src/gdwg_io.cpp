@@ -0,0 +1,742 @@
+#include "gdwg_io.h"
+
+#include "gdwg_wal.h"
+
+#include <atomic>
+#include <cerrno>
+#include <system_error>
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+	[[noreturn]] auto throw_errno(char const* what) -> void {
+		throw std::system_error(errno, std::generic_category(), what);
+	}
+
+	auto is_separator(char c) noexcept -> bool {
+		return c == ' ' or c == '\t' or c == ',' or c == '\r';
+	}
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  MAPPED FILE FUNCTIONS                                                             //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+gdwg::mapped_file::mapped_file(std::filesystem::path const& path, access_pattern pattern)
+: data_{nullptr}
+, size_{0} {
+	auto const fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		throw_errno("Cannot open file for mapping");
+	struct ::stat status {};
+	if (::fstat(fd, &status) != 0) {
+		auto const error = errno;
+		::close(fd);
+		throw std::system_error(error, std::generic_category(), "Cannot read size of mapped file");
+	}
+	size_ = static_cast<std::size_t>(status.st_size);
+	// An empty file cannot be mapped, and needs no mapping
+	if (size_ != 0) {
+		auto* const mapping = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (mapping == MAP_FAILED) {
+			auto const error = errno;
+			::close(fd);
+			throw std::system_error(error, std::generic_category(), "Cannot map file");
+		}
+		::madvise(mapping, size_, pattern == access_pattern::sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+		data_ = static_cast<char const*>(mapping);
+	}
+	// The mapping stays valid without the descriptor
+	::close(fd);
+}
+
+gdwg::mapped_file::mapped_file(mapped_file&& other) noexcept
+: data_{std::exchange(other.data_, nullptr)}
+, size_{std::exchange(other.size_, 0)} {}
+
+auto gdwg::mapped_file::operator=(mapped_file&& other) noexcept -> mapped_file& {
+	if (this != &other) {
+		if (data_ != nullptr)
+			::munmap(const_cast<char*>(data_), size_);
+		data_ = std::exchange(other.data_, nullptr);
+		size_ = std::exchange(other.size_, 0);
+	}
+	return *this;
+}
+
+gdwg::mapped_file::~mapped_file() {
+	if (data_ != nullptr)
+		::munmap(const_cast<char*>(data_), size_);
+}
+
+auto gdwg::mapped_file::contents() const noexcept -> std::string_view {
+	return data_ == nullptr ? std::string_view{} : std::string_view{data_, size_};
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  TEXT SPLITTING FUNCTIONS                                                          //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+auto gdwg::split_lines(std::string_view text, std::size_t count) -> std::vector<std::string_view> {
+	auto chunks = std::vector<std::string_view>{};
+	auto const target = text.size() / std::max(count, std::size_t{1}) + 1;
+	while (not text.empty()) {
+		// Cut after the first line ending at or past the target size, or take the rest
+		auto const newline = text.size() <= target ? std::string_view::npos : text.find('\n', target - 1);
+		auto const size = newline == std::string_view::npos ? text.size() : newline + 1;
+		chunks.push_back(text.substr(0, size));
+		text.remove_prefix(size);
+	}
+	return chunks;
+}
+
+auto gdwg::executor_of(read_options const& options) -> executor& {
+	return options.executor != nullptr ? *options.executor : default_executor();
+}
+
+auto gdwg::chunk_count(std::size_t bytes, read_options const& options) -> std::size_t {
+	auto const threads = options.threads == 0 ? executor_of(options).concurrency() : options.threads;
+	return std::min(threads, bytes / std::max(options.chunk_bytes, std::size_t{1}) + 1);
+}
+
+auto gdwg::next_line(std::string_view& in) noexcept -> std::optional<std::string_view> {
+	if (in.empty())
+		return std::nullopt;
+	auto const newline = in.find('\n');
+	auto line = in.substr(0, newline);
+	in.remove_prefix(newline == std::string_view::npos ? in.size() : newline + 1);
+	if (not line.empty() and line.back() == '\r')
+		line.remove_suffix(1);
+	return line;
+}
+
+auto gdwg::next_field(std::string_view& line) noexcept -> std::optional<std::string_view> {
+	auto pos = std::size_t{0};
+	while (pos < line.size() and is_separator(line[pos])) {
+		++pos;
+	}
+	if (pos == line.size()) {
+		line = {};
+		return std::nullopt;
+	}
+	auto const start = pos;
+	while (pos < line.size() and not is_separator(line[pos])) {
+		++pos;
+	}
+	auto const field = line.substr(start, pos - start);
+	line.remove_prefix(pos);
+	return field;
+}
+
+auto gdwg::split_fields(std::string_view line, std::span<std::string_view> fields) noexcept -> std::size_t {
+	auto count = std::size_t{0};
+	while (auto const field = next_field(line)) {
+		if (count < fields.size())
+			fields[count] = *field;
+		++count;
+	}
+	return count;
+}
+
+auto gdwg::is_comment(std::string_view line) noexcept -> bool {
+	auto const first = line.find_first_not_of(" \t\r");
+	return first == std::string_view::npos or line[first] == '#' or line[first] == '%';
+}
+
+auto gdwg::line_number(std::string_view text, char const* position) noexcept -> std::size_t {
+	auto const offset = static_cast<std::size_t>(position - text.data());
+	return static_cast<std::size_t>(std::count(text.begin(), text.begin() + static_cast<std::ptrdiff_t>(offset), '\n'))
+	       + 1;
+}
+
+auto gdwg::throw_parse_error(std::string_view format,
+                             std::string_view text,
+                             char const* position,
+                             std::string_view problem) -> void {
+	auto message = std::string{"Cannot parse "};
+	message.append(format).append(" line ").append(std::to_string(line_number(text, position))).append(": ");
+	message.append(problem);
+	throw std::runtime_error(message);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  OUTPUT BUFFER FUNCTIONS                                                           //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+gdwg::output_buffer::output_buffer(std::ostream& out, std::size_t capacity)
+: out_{&out}
+, capacity_{capacity} {
+	// A record may end just past the capacity, so leave room for a few
+	text_.reserve(capacity_ + 4096);
+}
+
+auto gdwg::output_buffer::text() noexcept -> std::string& {
+	return text_;
+}
+
+auto gdwg::output_buffer::commit() -> void {
+	if (text_.size() < capacity_)
+		return;
+	out_->write(text_.data(), static_cast<std::streamsize>(text_.size()));
+	text_.clear();
+	if (not *out_)
+		throw std::runtime_error("Cannot write graph: the output stream failed");
+}
+
+auto gdwg::output_buffer::flush() -> void {
+	out_->write(text_.data(), static_cast<std::streamsize>(text_.size()));
+	text_.clear();
+	out_->flush();
+	if (not *out_)
+		throw std::runtime_error("Cannot write graph: the output stream failed");
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  TEXT ESCAPING FUNCTIONS                                                           //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+auto gdwg::escape_dot(std::string& out, std::string_view text) -> void {
+	for (auto const c : text) {
+		switch (c) {
+		case '"': out += "\\\""; break;
+		case '\\': out += "\\\\"; break;
+		case '\n': out += "\\n"; break;
+		default: out += c;
+		}
+	}
+}
+
+auto gdwg::escape_xml(std::string& out, std::string_view text) -> void {
+	for (auto const c : text) {
+		switch (c) {
+		case '&': out += "&amp;"; break;
+		case '<': out += "&lt;"; break;
+		case '>': out += "&gt;"; break;
+		case '"': out += "&quot;"; break;
+		case '\'': out += "&apos;"; break;
+		default: out += c;
+		}
+	}
+}
+
+auto gdwg::escape_json(std::string& out, std::string_view text) -> void {
+	constexpr auto hex = std::string_view{"0123456789abcdef"};
+	for (auto const c : text) {
+		switch (c) {
+		case '"': out += "\\\""; break;
+		case '\\': out += "\\\\"; break;
+		case '\n': out += "\\n"; break;
+		case '\r': out += "\\r"; break;
+		case '\t': out += "\\t"; break;
+		default:
+			if (static_cast<unsigned char>(c) < 0x20U) {
+				out += "\\u00";
+				out += hex[static_cast<unsigned char>(c) >> 4U];
+				out += hex[static_cast<unsigned char>(c) & 0xfU];
+			}
+			else {
+				out += c;
+			}
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  ASYNCHRONOUS I/O FUNCTIONS                                                        //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+namespace {
+	// The submission and completion rings of an io_uring instance, set up with the raw system calls so that no
+	// library is needed. The kernel and this process share the ring indices, so they are accessed atomically.
+	class io_ring {
+	 public:
+		explicit io_ring(unsigned entries) {
+			auto params = ::io_uring_params{};
+			fd_ = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+			if (fd_ < 0)
+				throw_errno("Cannot set up io_uring");
+			try {
+				sq_bytes_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+				cq_bytes_ = params.cq_off.cqes + params.cq_entries * sizeof(::io_uring_cqe);
+				// Kernels with a single mapping for both rings are given its larger size
+				if ((params.features & IORING_FEAT_SINGLE_MMAP) != 0)
+					sq_bytes_ = cq_bytes_ = std::max(sq_bytes_, cq_bytes_);
+				sq_ = map(sq_bytes_, IORING_OFF_SQ_RING);
+				cq_ = (params.features & IORING_FEAT_SINGLE_MMAP) != 0 ? sq_ : map(cq_bytes_, IORING_OFF_CQ_RING);
+				sqes_bytes_ = params.sq_entries * sizeof(::io_uring_sqe);
+				sqes_ = static_cast<::io_uring_sqe*>(map(sqes_bytes_, IORING_OFF_SQES));
+			} catch (...) {
+				release();
+				throw;
+			}
+			auto* const sq = static_cast<char*>(sq_);
+			auto* const cq = static_cast<char*>(cq_);
+			sq_head_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+			sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+			sq_mask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+			sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+			cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+			cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+			cq_mask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+			cqes_ = reinterpret_cast<::io_uring_cqe*>(cq + params.cq_off.cqes);
+			entries_ = params.sq_entries;
+		}
+
+		io_ring(io_ring const&) = delete;
+		auto operator=(io_ring const&) -> io_ring& = delete;
+
+		~io_ring() {
+			release();
+		}
+
+		// The most bytes one request transfers: the length of an entry is 32 bits, and a longer transfer completes
+		// short after this many bytes, so that the rest is resubmitted like any other short transfer
+		static constexpr auto max_transfer = std::size_t{1} << 30U;
+
+		// Queues a read or write; the caller keeps at most entries() requests in flight
+		auto push(std::uint8_t opcode, int fd, char* data, std::size_t size, std::uint64_t offset, std::uint64_t tag)
+		    noexcept -> void {
+			auto const tail = *sq_tail_;
+			auto const index = tail & sq_mask_;
+			auto& entry = sqes_[index];
+			entry = ::io_uring_sqe{};
+			entry.opcode = opcode;
+			entry.fd = fd;
+			entry.addr = reinterpret_cast<std::uintptr_t>(data);
+			entry.len = static_cast<std::uint32_t>(std::min(size, max_transfer));
+			entry.off = offset;
+			entry.user_data = tag;
+			sq_array_[index] = index;
+			std::atomic_ref{*sq_tail_}.store(tail + 1, std::memory_order_release);
+			++unsubmitted_;
+		}
+
+		// Submits the queued requests and waits until at least one has completed
+		auto submit_and_wait() -> void {
+			while (true) {
+				auto const result =
+				    ::syscall(__NR_io_uring_enter, fd_, unsubmitted_, 1U, IORING_ENTER_GETEVENTS, nullptr, std::size_t{0});
+				if (result >= 0) {
+					unsubmitted_ -= static_cast<unsigned>(result);
+					return;
+				}
+				if (errno != EINTR)
+					throw_errno("Cannot enter io_uring");
+			}
+		}
+
+		struct completion {
+			std::uint64_t tag;
+			int result;
+		};
+
+		// Takes the next completion, if there is one
+		auto pop() noexcept -> std::optional<completion> {
+			auto const head = *cq_head_;
+			if (head == std::atomic_ref{*cq_tail_}.load(std::memory_order_acquire))
+				return std::nullopt;
+			auto const& entry = cqes_[head & cq_mask_];
+			auto const result = completion{entry.user_data, entry.res};
+			std::atomic_ref{*cq_head_}.store(head + 1, std::memory_order_release);
+			return result;
+		}
+
+		[[nodiscard]] auto entries() const noexcept -> unsigned {
+			return entries_;
+		}
+
+		// Asks the kernel which operations it supports; kernels before 5.6 have no probe, nor reads and writes
+		[[nodiscard]] auto supports(std::initializer_list<std::uint8_t> opcodes) const noexcept -> bool {
+			constexpr auto ops = std::size_t{256};
+			alignas(::io_uring_probe) auto buffer =
+			    std::array<std::byte, sizeof(::io_uring_probe) + ops * sizeof(::io_uring_probe_op)>{};
+			auto* const probe = reinterpret_cast<::io_uring_probe*>(buffer.data());
+			if (::syscall(__NR_io_uring_register, fd_, IORING_REGISTER_PROBE, probe, ops) < 0)
+				return false;
+			return std::ranges::all_of(opcodes, [probe](std::uint8_t opcode) {
+				return opcode <= probe->last_op and opcode < probe->ops_len
+				       and (probe->ops[opcode].flags & IO_URING_OP_SUPPORTED) != 0;
+			});
+		}
+
+	 private:
+		int fd_ = -1;
+		void* sq_ = nullptr;
+		void* cq_ = nullptr;
+		::io_uring_sqe* sqes_ = nullptr;
+		std::size_t sq_bytes_ = 0;
+		std::size_t cq_bytes_ = 0;
+		std::size_t sqes_bytes_ = 0;
+		unsigned* sq_head_ = nullptr;
+		unsigned* sq_tail_ = nullptr;
+		unsigned sq_mask_ = 0;
+		unsigned* sq_array_ = nullptr;
+		unsigned* cq_head_ = nullptr;
+		unsigned* cq_tail_ = nullptr;
+		unsigned cq_mask_ = 0;
+		::io_uring_cqe* cqes_ = nullptr;
+		unsigned entries_ = 0;
+		unsigned unsubmitted_ = 0;
+
+		auto map(std::size_t bytes, std::uint64_t offset) const -> void* {
+			auto* const mapping =
+			    ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, static_cast<::off_t>(offset));
+			if (mapping == MAP_FAILED)
+				throw_errno("Cannot map io_uring");
+			return mapping;
+		}
+
+		auto release() noexcept -> void {
+			if (sqes_ != nullptr)
+				::munmap(sqes_, sqes_bytes_);
+			if (cq_ != nullptr and cq_ != sq_)
+				::munmap(cq_, cq_bytes_);
+			if (sq_ != nullptr)
+				::munmap(sq_, sq_bytes_);
+			if (fd_ >= 0)
+				::close(fd_);
+		}
+	};
+
+	auto open_file(std::filesystem::path const& path, int flags, char const* what) -> int {
+		auto const fd = ::open(path.c_str(), flags | O_CLOEXEC, 0644);
+		if (fd < 0)
+			throw_errno(what);
+		return fd;
+	}
+} // namespace
+
+auto gdwg::io_uring_available() noexcept -> bool {
+	static auto const available = [] {
+		try {
+			auto const ring = io_ring{1};
+			return ring.supports({IORING_OP_READ, IORING_OP_WRITE});
+		} catch (...) {
+			return false;
+		}
+	}();
+	return available;
+}
+
+class gdwg::io_queue {
+ public:
+	// Called with the offset and size of every transfer once all of it has completed
+	using completion_handler = std::function<void(std::uint64_t, std::size_t)>;
+
+	io_queue(int fd, bool writing, io_options const& options, completion_handler completed = {})
+	: fd_{fd}
+	, writing_{writing}
+	, completed_{std::move(completed)} {
+		if (options.io_uring and io_uring_available()) {
+			ring_.emplace(static_cast<unsigned>(std::clamp(options.queue_depth, std::size_t{1}, std::size_t{4096})));
+			requests_.resize(ring_->entries());
+			for (auto i = requests_.size(); i > 0; --i) {
+				free_.push_back(i - 1);
+			}
+		}
+	}
+
+	io_queue(io_queue const&) = delete;
+	auto operator=(io_queue const&) -> io_queue& = delete;
+
+	// The kernel may still be reading or writing the buffers of requests in flight, so they are waited for
+	~io_queue() {
+		try {
+			wait_all();
+		} catch (...) {
+			// The ring is unusable, and closing it cancels whatever is left
+		}
+	}
+
+	// Queues a transfer of bytes which stay valid until it completes, or of a block the queue keeps until then
+	auto add(char* data, std::size_t size, std::uint64_t offset, std::string owned = {}) -> void {
+		if (not ring_) {
+			transfer_now(owned.empty() ? data : owned.data(), size, offset);
+			if (completed_)
+				completed_(offset, size);
+			return;
+		}
+		while (free_.empty() and not error_) {
+			reap();
+		}
+		// After a failure nothing more is queued: the rest completes and the failure is reported
+		if (error_)
+			drain();
+		auto const slot = free_.back();
+		free_.pop_back();
+		auto& request = requests_[slot];
+		request.owned = std::move(owned);
+		request.data = request.owned.empty() ? data : request.owned.data();
+		request.size = size;
+		request.offset = offset;
+		request.start = offset;
+		request.total = size;
+		submit(slot);
+	}
+
+	// Checks if transfers are queued to io_uring, rather than done as they are added
+	[[nodiscard]] auto asynchronous() const noexcept -> bool {
+		return ring_.has_value();
+	}
+
+	// Checks if adding a transfer would wait for another to complete
+	[[nodiscard]] auto full() const noexcept -> bool {
+		return ring_ and free_.empty();
+	}
+
+	// Waits until at least one transfer in flight has completed, reporting a failure like drain
+	auto wait_any() -> void {
+		if (ring_ and free_.size() < requests_.size())
+			reap();
+		if (error_)
+			drain();
+	}
+
+	// Waits until every queued transfer has completed, then reports the first that failed
+	auto drain() -> void {
+		wait_all();
+		if (error_)
+			std::rethrow_exception(std::exchange(error_, nullptr));
+	}
+
+ private:
+	struct request {
+		char* data = nullptr;
+		std::size_t size = 0;
+		std::uint64_t offset = 0;
+		std::uint64_t start = 0;
+		std::size_t total = 0;
+		std::string owned;
+	};
+
+	int fd_;
+	bool writing_;
+	completion_handler completed_;
+	std::optional<io_ring> ring_;
+	std::vector<request> requests_;
+	std::vector<std::size_t> free_;
+	std::exception_ptr error_;
+
+	auto submit(std::size_t slot) noexcept -> void {
+		auto const& r = requests_[slot];
+		ring_->push(writing_ ? IORING_OP_WRITE : IORING_OP_READ, fd_, r.data, r.size, r.offset, slot);
+	}
+
+	// Every request holds a slot until it completes, so the queue is idle once every slot is free again
+	auto wait_all() -> void {
+		while (ring_ and free_.size() < requests_.size()) {
+			reap();
+		}
+	}
+
+	// Takes the completions, resubmitting the partial ones and releasing the slots of the rest
+	auto reap() -> void {
+		ring_->submit_and_wait();
+		while (auto const completion = ring_->pop()) {
+			auto const slot = static_cast<std::size_t>(completion->tag);
+			auto& r = requests_[slot];
+			if (completion->result == -EINTR or completion->result == -EAGAIN) {
+				submit(slot);
+				continue;
+			}
+			// A short transfer is resubmitted for the rest
+			auto const done = static_cast<std::size_t>(std::max(completion->result, 0));
+			if (done > 0 and done < r.size) {
+				r.data += done;
+				r.size -= done;
+				r.offset += done;
+				submit(slot);
+				continue;
+			}
+			if (completion->result < 0 and not error_) {
+				error_ = std::make_exception_ptr(
+				    std::system_error(-completion->result, std::generic_category(), "Cannot transfer with io_uring"));
+			}
+			if (completion->result == 0 and not error_)
+				error_ = std::make_exception_ptr(std::runtime_error("Cannot read past the end of the file"));
+			if (completion->result > 0 and completed_)
+				completed_(r.start, r.total);
+			r.owned.clear();
+			free_.push_back(slot);
+		}
+	}
+
+	auto transfer_now(char* data, std::size_t size, std::uint64_t offset) -> void {
+		while (size > 0) {
+			auto const done = writing_ ? ::pwrite(fd_, data, size, static_cast<::off_t>(offset))
+			                           : ::pread(fd_, data, size, static_cast<::off_t>(offset));
+			if (done < 0) {
+				if (errno == EINTR)
+					continue;
+				throw_errno(writing_ ? "Cannot call pwrite" : "Cannot call pread");
+			}
+			if (done == 0)
+				throw std::runtime_error("Cannot read past the end of the file");
+			data += done;
+			size -= static_cast<std::size_t>(done);
+			offset += static_cast<std::uint64_t>(done);
+		}
+	}
+};
+
+gdwg::async_writer::async_writer(std::filesystem::path path, io_options const& options)
+: path_{std::move(path)}
+, fd_{-1}
+, block_bytes_{std::max(options.block_bytes, std::size_t{1})} {
+	// Each writer has a temporary file of its own, so that writers replacing the same file do not share one
+	static auto counter = std::atomic<std::uint64_t>{0};
+	while (fd_ < 0) {
+		temporary_ = path_.string() + ".tmp." + std::to_string(::getpid()) + '.'
+		             + std::to_string(counter.fetch_add(1, std::memory_order_relaxed));
+		fd_ = ::open(temporary_.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+		if (fd_ < 0 and errno != EEXIST)
+			throw_errno("Cannot construct gdwg::async_writer");
+	}
+	try {
+		queue_ = std::make_unique<io_queue>(fd_, true, options);
+	} catch (...) {
+		::close(fd_);
+		auto ec = std::error_code{};
+		std::filesystem::remove(temporary_, ec);
+		throw;
+	}
+}
+
+gdwg::async_writer::~async_writer() {
+	// Waits for the writes in flight before the file they target is closed
+	queue_.reset();
+	if (fd_ >= 0)
+		::close(fd_);
+	if (not committed_) {
+		auto ec = std::error_code{};
+		std::filesystem::remove(temporary_, ec);
+	}
+}
+
+auto gdwg::async_writer::write(std::string block) -> void {
+	auto const size = block.size();
+	if (size == 0)
+		return;
+	queue_->add(nullptr, size, size_, std::move(block));
+	size_ += size;
+}
+
+auto gdwg::async_writer::write(std::string_view data) -> void {
+	if (data.empty())
+		return;
+	// Only read by the writes, so the bytes are never modified
+	queue_->add(const_cast<char*>(data.data()), data.size(), size_);
+	size_ += data.size();
+}
+
+auto gdwg::async_writer::commit(bool sync) -> void {
+	queue_->drain();
+	if (sync and ::fdatasync(fd_) != 0)
+		throw_errno("Cannot call gdwg::async_writer::commit");
+	::close(std::exchange(fd_, -1));
+	std::filesystem::rename(temporary_, path_);
+	committed_ = true;
+	if (sync)
+		durable_file::sync_directory(path_.parent_path().empty() ? "." : path_.parent_path());
+}
+
+auto gdwg::async_writer::size() const noexcept -> std::uint64_t {
+	return size_;
+}
+
+auto gdwg::async_writer::block_bytes() const noexcept -> std::size_t {
+	return block_bytes_;
+}
+
+gdwg::file_stream::file_stream(std::filesystem::path const& path, io_options const& options)
+: fd_{open_file(path, O_RDONLY, "Cannot construct gdwg::file_stream")}
+, block_bytes_{std::max(options.block_bytes, std::size_t{1})} {
+	try {
+		struct ::stat status {};
+		if (::fstat(fd_, &status) != 0)
+			throw_errno("Cannot construct gdwg::file_stream");
+		data_.resize(static_cast<std::size_t>(status.st_size));
+		done_.resize((data_.size() + block_bytes_ - 1) / block_bytes_);
+		queue_ = std::make_unique<io_queue>(fd_, false, options, [this](std::uint64_t offset, std::size_t) {
+			done_[static_cast<std::size_t>(offset) / block_bytes_] = true;
+			while (front_ < done_.size() and done_[front_]) {
+				++front_;
+			}
+			arrived_ = std::min(front_ * block_bytes_, data_.size());
+		});
+		static_cast<void>(wait(0));
+	} catch (...) {
+		queue_.reset();
+		::close(fd_);
+		throw;
+	}
+}
+
+gdwg::file_stream::~file_stream() {
+	// Waits for the reads in flight before the buffer they target is freed
+	queue_.reset();
+	::close(fd_);
+}
+
+auto gdwg::file_stream::text() const noexcept -> std::string_view {
+	return data_;
+}
+
+auto gdwg::file_stream::wait(std::size_t bytes) -> std::string_view {
+	auto const needed = std::min(bytes, data_.size());
+	while (arrived_ < needed) {
+		if (queued_ < done_.size() and not queue_->full())
+			queue_next();
+		else
+			queue_->wait_any();
+	}
+	// Keeps the queue full, so that the blocks after these are read while the caller parses them
+	while (queue_->asynchronous() and queued_ < done_.size() and not queue_->full()) {
+		queue_next();
+	}
+	return std::string_view{data_}.substr(0, arrived_);
+}
+
+auto gdwg::file_stream::arrived() const noexcept -> std::size_t {
+	return arrived_;
+}
+
+auto gdwg::file_stream::take() -> std::string {
+	static_cast<void>(wait(data_.size()));
+	return std::move(data_);
+}
+
+auto gdwg::file_stream::queue_next() -> void {
+	auto const offset = queued_ * block_bytes_;
+	++queued_;
+	queue_->add(data_.data() + offset, std::min(block_bytes_, data_.size() - offset), offset);
+}
+
+gdwg::text_source::text_source(file_stream& stream)
+: text_{stream.text()}
+, stream_{&stream} {}
+
+auto gdwg::text_source::text() const noexcept -> std::string_view {
+	return text_;
+}
+
+auto gdwg::text_source::complete() const noexcept -> bool {
+	return stream_ == nullptr or stream_->arrived() == text_.size();
+}
+
+auto gdwg::text_source::wait(std::size_t bytes) const -> std::string_view {
+	return stream_ == nullptr ? text_ : stream_->wait(bytes);
+}
+
+auto gdwg::read_file(std::filesystem::path const& path, io_options const& options) -> std::string {
+	return file_stream{path, options}.take();
+}
+
+auto gdwg::write_file(std::filesystem::path const& path, std::string_view data, bool sync, io_options const& options)
+    -> void {
+	auto writer = async_writer{path, options};
+	for (auto offset = std::size_t{0}; offset < data.size(); offset += writer.block_bytes()) {
+		writer.write(data.substr(offset, writer.block_bytes()));
+	}
+	writer.commit(sync);
+}
@@ -0,0 +1,1565 @@
+#ifndef GDWG_IO_H
+#	define GDWG_IO_H
+
+#	include "gdwg_graph.h"
+#	include "gdwg_parallel.h"
+
+#	include <algorithm>
+#	include <array>
+#	include <atomic>
+#	include <charconv>
+#	include <cmath>
+#	include <concepts>
+#	include <cstddef>
+#	include <cstdint>
+#	include <deque>
+#	include <exception>
+#	include <filesystem>
+#	include <functional>
+#	include <memory>
+#	include <mutex>
+#	include <numeric>
+#	include <optional>
+#	include <ostream>
+#	include <span>
+#	include <stdexcept>
+#	include <string>
+#	include <string_view>
+#	include <tuple>
+#	include <type_traits>
+#	include <vector>
+
+namespace gdwg {
+	/**
+	 * Customisation point parsing values of type T from the fields of text formats. Parsing first produces a token,
+	 * which for strings is a view of the input rather than a copy, so that a loader can sort and deduplicate the
+	 * tokens of a whole file before constructing each distinct value once. Integers, floating point numbers and
+	 * strings are provided; other node and weight types need a specialisation with the same members.
+	 */
+	template<typename T>
+	struct text_parser;
+
+	/**
+	 * A type with a text_parser specialisation.
+	 */
+	template<typename T>
+	concept text_parsable = requires(std::string_view field, typename text_parser<T>::token_type const& token) {
+		{ text_parser<T>::parse(field) } -> std::same_as<std::optional<typename text_parser<T>::token_type>>;
+		{ text_parser<T>::make(token) } -> std::same_as<T>;
+	} and std::totally_ordered<typename text_parser<T>::token_type>;
+
+	template<typename T>
+	requires(std::integral<T> or std::floating_point<T>) and (not std::same_as<T, bool>)
+	struct text_parser<T> {
+		using token_type = T;
+
+		/**
+		 * @brief Parses a whole field as a number with std::from_chars.
+		 * @note Marked as [[nodiscard]] because the parsed value is lost if ignored.
+		 * Marked as noexcept because std::from_chars reports errors instead of throwing.
+		 *
+		 * @param field The field to parse.
+		 * @return The number, or std::nullopt if the field is not entirely a number of type T.
+		 */
+		[[nodiscard]] static auto parse(std::string_view field) noexcept -> std::optional<T>;
+
+		/**
+		 * @brief Returns the parsed number.
+		 *
+		 * @param token The parsed number.
+		 * @return The number.
+		 */
+		[[nodiscard]] static auto make(T const& token) noexcept -> T;
+	};
+
+	template<typename Traits, typename Alloc>
+	struct text_parser<std::basic_string<char, Traits, Alloc>> {
+		using token_type = std::basic_string_view<char, Traits>;
+
+		/**
+		 * @brief Takes a field as it is. A view orders the same as the string it is turned into.
+		 * @note Marked as [[nodiscard]] because the parsed value is lost if ignored.
+		 * Marked as noexcept because it only makes a view.
+		 *
+		 * @param field The field to parse.
+		 * @return A view of the field.
+		 */
+		[[nodiscard]] static auto parse(std::string_view field) noexcept -> std::optional<token_type>;
+
+		/**
+		 * @brief Copies a parsed field into a string.
+		 *
+		 * @param token The view of the field.
+		 * @return The string.
+		 */
+		[[nodiscard]] static auto make(token_type const& token) -> std::basic_string<char, Traits, Alloc>;
+	};
+
+	/**
+	 * How a mapping is going to be read, passed on to the kernel as read-ahead advice.
+	 */
+	enum class access_pattern {
+		// Front to back, as loaders parse: read ahead aggressively.
+		sequential,
+		// Lookups scattered over the file: read only the pages touched.
+		random,
+	};
+
+	/**
+	 * A read-only memory mapping of a whole file, so that loaders parse the page cache in place instead of copying
+	 * the file into a buffer. Every failure is reported as a std::system_error.
+	 */
+	class mapped_file {
+	 public:
+		/**
+		 * Maps a file for reading.
+		 *
+		 * @param path The file to map.
+		 * @param pattern How the mapping is going to be read.
+		 */
+		explicit mapped_file(std::filesystem::path const& path, access_pattern pattern = access_pattern::sequential);
+
+		mapped_file(mapped_file const&) = delete;
+		auto operator=(mapped_file const&) -> mapped_file& = delete;
+
+		/**
+		 * Move constructor. The moved-from file no longer owns a mapping.
+		 */
+		mapped_file(mapped_file&& other) noexcept;
+
+		/**
+		 * Move assignment. Unmaps the current mapping and takes over the one of other.
+		 */
+		auto operator=(mapped_file&& other) noexcept -> mapped_file&;
+
+		/**
+		 * Unmaps the file.
+		 */
+		~mapped_file();
+
+		/**
+		 * @brief Returns the contents of the file.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Marked as noexcept because it only makes a view of the mapping.
+		 *
+		 * @return A view of the mapped bytes, valid as long as the mapping.
+		 */
+		[[nodiscard]] auto contents() const noexcept -> std::string_view;
+
+	 private:
+		char const* data_;
+		std::size_t size_;
+	};
+
+	/**
+	 * How files are read and written with asynchronous I/O.
+	 */
+	struct io_options {
+		// Reads or writes kept in flight at once.
+		std::size_t queue_depth = 32;
+		// Bytes per read or write.
+		std::size_t block_bytes = std::size_t{1} << 20U;
+		// False to use blocking pread and pwrite even where io_uring is available.
+		bool io_uring = true;
+	};
+
+	/**
+	 * @brief Checks if io_uring can be used: the kernel supports it with reads and writes, which need Linux 5.6, and it
+	 * is not disabled, e.g. by seccomp.
+	 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+	 * Marked as noexcept because a failed probe only means io_uring is unavailable.
+	 *
+	 * @return True if io_uring is available, otherwise false.
+	 */
+	[[nodiscard]] auto io_uring_available() noexcept -> bool;
+
+	/**
+	 * A queue of positional reads or writes on one file. With io_uring, up to queue_depth requests are in flight at
+	 * once and adding one only waits while the queue is full; without it, each request is done with a blocking
+	 * pread or pwrite as it is added. Short transfers are resubmitted for their remainder. A failed request is
+	 * reported once every other request in flight has completed, and the destructor waits for them too, so that the
+	 * kernel never transfers into a buffer which is gone. Defined in gdwg_io.cpp.
+	 */
+	class io_queue;
+
+	/**
+	 * Writes a file from blocks handed over one at a time, so that encoding the next block overlaps writing the
+	 * previous ones. The blocks go to a temporary file of this writer's own which commit renames over the target, so
+	 * that a crash leaves either the old or the new contents. Every failure is reported as a std::system_error.
+	 */
+	class async_writer {
+	 public:
+		/**
+		 * Creates the temporary file next to the target.
+		 *
+		 * @param path The file to replace.
+		 * @param options The queue depth, and whether to use io_uring.
+		 */
+		explicit async_writer(std::filesystem::path path, io_options const& options = {});
+
+		async_writer(async_writer const&) = delete;
+		auto operator=(async_writer const&) -> async_writer& = delete;
+
+		/**
+		 * Waits for the writes in flight and removes the temporary file, unless it was committed.
+		 */
+		~async_writer();
+
+		/**
+		 * @brief Appends a block, returning as soon as its write is queued.
+		 *
+		 * @param block The bytes to append, kept until they are written.
+		 */
+		auto write(std::string block) -> void;
+
+		/**
+		 * @brief Appends bytes owned by the caller, returning as soon as their writes are queued.
+		 *
+		 * @param data The bytes to append, which must stay valid until commit returns.
+		 */
+		auto write(std::string_view data) -> void;
+
+		/**
+		 * @brief Waits for every write and renames the file over the target.
+		 *
+		 * @param sync True to wait until the contents and the rename are on stable storage.
+		 */
+		auto commit(bool sync) -> void;
+
+		/**
+		 * @brief Returns the number of bytes appended so far.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Marked as noexcept because the count is stored.
+		 *
+		 * @return The number of bytes.
+		 */
+		[[nodiscard]] auto size() const noexcept -> std::uint64_t;
+
+		/**
+		 * @brief Returns the size of the blocks this writer is meant to be handed, from io_options::block_bytes.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Marked as noexcept because the size is stored.
+		 *
+		 * @return The number of bytes per block.
+		 */
+		[[nodiscard]] auto block_bytes() const noexcept -> std::size_t;
+
+	 private:
+		std::filesystem::path path_;
+		std::filesystem::path temporary_;
+		int fd_;
+		std::size_t block_bytes_;
+		std::unique_ptr<io_queue> queue_;
+		std::uint64_t size_ = 0;
+		bool committed_ = false;
+	};
+
+	/**
+	 * A file read into memory front to back with up to queue_depth reads of block_bytes in flight, so that a loader
+	 * can parse the part which has arrived while the rest is being read. Every failure is reported as a
+	 * std::system_error.
+	 */
+	class file_stream {
+	 public:
+		/**
+		 * Opens the file and starts reading it.
+		 *
+		 * @param path The file to read.
+		 * @param options The queue depth and block size, and whether to use io_uring.
+		 */
+		explicit file_stream(std::filesystem::path const& path, io_options const& options = {});
+
+		file_stream(file_stream const&) = delete;
+		auto operator=(file_stream const&) -> file_stream& = delete;
+
+		/**
+		 * Waits for the reads in flight, which still target the buffer, and closes the file.
+		 */
+		~file_stream();
+
+		/**
+		 * @brief Returns the whole buffer, of which only the prefix returned by wait has been read.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Marked as noexcept because it only makes a view of the buffer.
+		 *
+		 * @return A view of the buffer, as long as the file.
+		 */
+		[[nodiscard]] auto text() const noexcept -> std::string_view;
+
+		/**
+		 * @brief Waits until at least the given number of bytes from the front have been read, keeping the queue
+		 * full so that the reads after them go on meanwhile.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 *
+		 * @param bytes The number of bytes needed, clamped to the size of the file.
+		 * @return A view of everything read so far, at least bytes long.
+		 */
+		[[nodiscard]] auto wait(std::size_t bytes) -> std::string_view;
+
+		/**
+		 * @brief Returns the number of bytes from the front which have been read.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Marked as noexcept because the count is stored.
+		 *
+		 * @return The number of bytes.
+		 */
+		[[nodiscard]] auto arrived() const noexcept -> std::size_t;
+
+		/**
+		 * @brief Waits for the rest of the file and hands over the buffer.
+		 * @note Marked as [[nodiscard]] because the contents are lost if ignored.
+		 *
+		 * @return The contents of the file.
+		 */
+		[[nodiscard]] auto take() -> std::string;
+
+	 private:
+		int fd_;
+		std::string data_;
+		std::size_t block_bytes_;
+		// Reads complete in any order, so each block is flagged and the front counts the blocks before the first gap
+		std::vector<bool> done_;
+		std::size_t queued_ = 0;
+		std::size_t front_ = 0;
+		std::size_t arrived_ = 0;
+		std::unique_ptr<io_queue> queue_;
+
+		/**
+		 * @brief Queues the next block.
+		 */
+		auto queue_next() -> void;
+	};
+
+	/**
+	 * @brief Reads a whole file with up to options.queue_depth reads of options.block_bytes in flight.
+	 * @note Marked as [[nodiscard]] because the contents are lost if ignored.
+	 *
+	 * @param path The file to read.
+	 * @param options The queue depth and block size, and whether to use io_uring.
+	 * @return The contents of the file.
+	 * @throws std::system_error If the file could not be read.
+	 */
+	[[nodiscard]] auto read_file(std::filesystem::path const& path, io_options const& options = {}) -> std::string;
+
+	/**
+	 * @brief Replaces a file atomically with up to options.queue_depth writes of options.block_bytes in flight.
+	 *
+	 * @param path The file to replace.
+	 * @param data The new contents.
+	 * @param sync True to wait until the new contents and the rename are on stable storage.
+	 * @param options The queue depth and block size, and whether to use io_uring.
+	 * @throws std::system_error If the file could not be written.
+	 */
+	auto write_file(std::filesystem::path const& path, std::string_view data, bool sync, io_options const& options = {})
+	    -> void;
+
+	/**
+	 * How a graph is read from text.
+	 */
+	struct read_options {
+		// True if the first line which is not a comment holds column names rather than an edge. Edge lists only.
+		bool header = false;
+		// Chunks parsed at once, 0 for the concurrency of the executor.
+		std::size_t threads = 0;
+		// Bytes below which the input is not split further, as a task per small chunk costs more than it saves.
+		std::size_t chunk_bytes = std::size_t{1} << 20U;
+		// The executor parsing the chunks, nullptr for default_executor().
+		::gdwg::executor* executor = nullptr;
+	};
+
+	/**
+	 * An edge as parsed from text, before its nodes are interned.
+	 */
+	template<text_parsable N, text_parsable E>
+	struct parsed_edge {
+		typename text_parser<N>::token_type src;
+		typename text_parser<N>::token_type dst;
+		std::optional<typename text_parser<E>::token_type> weight;
+	};
+
+	/**
+	 * The text a loader parses: a string which is there in full, or a file_stream which is still being read. Loaders
+	 * only look at the part of a stream which has arrived, so that parsing overlaps the reads of the rest.
+	 */
+	class text_source {
+	 public:
+		/**
+		 * Refers to text which is there in full. Implicit, so that the loaders are called with strings as before.
+		 *
+		 * @param text The text, which must outlive the source.
+		 */
+		template<typename T>
+		requires std::convertible_to<T const&, std::string_view>
+		text_source(T const& text)
+		: text_{text} {}
+
+		/**
+		 * Refers to a file which is still being read.
+		 *
+		 * @param stream The stream, which must outlive the source.
+		 */
+		explicit text_source(file_stream& stream);
+
+		/**
+		 * @brief Returns the whole text, of which only the prefix returned by wait may be looked at.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Marked as noexcept because it only makes a view.
+		 *
+		 * @return A view of the text.
+		 */
+		[[nodiscard]] auto text() const noexcept -> std::string_view;
+
+		/**
+		 * @brief Checks if the whole text has arrived.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Marked as noexcept because it only compares sizes.
+		 *
+		 * @return True if the text is a string or a stream which has been read, otherwise false.
+		 */
+		[[nodiscard]] auto complete() const noexcept -> bool;
+
+		/**
+		 * @brief Waits until at least the given number of bytes from the front have arrived.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 *
+		 * @param bytes The number of bytes needed, clamped to the size of the text.
+		 * @return A view of everything which has arrived, at least bytes long.
+		 */
+		[[nodiscard]] auto wait(std::size_t bytes) const -> std::string_view;
+
+	 private:
+		std::string_view text_;
+		file_stream* stream_ = nullptr;
+	};
+
+	/**
+	 * @brief Splits text into at most the given number of chunks of about equal size, each ending at the end of a
+	 * line.
+	 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+	 *
+	 * @param text The text to split.
+	 * @param count The number of chunks wanted.
+	 * @return The non-empty chunks, in order and together covering the text.
+	 */
+	[[nodiscard]] auto split_lines(std::string_view text, std::size_t count) -> std::vector<std::string_view>;
+
+	/**
+	 * @brief Returns the executor a read runs on.
+	 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+	 *
+	 * @param options The options of the read.
+	 * @return The executor of the options, or default_executor() if they have none.
+	 */
+	[[nodiscard]] auto executor_of(read_options const& options) -> executor&;
+
+	/**
+	 * @brief Decides how many chunks to split an input into.
+	 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+	 *
+	 * @param bytes The size of the input.
+	 * @param options The thread count, minimum chunk size and executor.
+	 * @return The number of chunks, at least 1.
+	 */
+	[[nodiscard]] auto chunk_count(std::size_t bytes, read_options const& options) -> std::size_t;
+
+	/**
+	 * @brief Takes the next line from the front of the input, which is advanced past it.
+	 * @note Marked as [[nodiscard]] because the line is lost if ignored.
+	 * Marked as noexcept because it only adjusts views.
+	 *
+	 * @param in The input to read from.
+	 * @return The line without its line ending, or std::nullopt at the end of the input.
+	 */
+	[[nodiscard]] auto next_line(std::string_view& in) noexcept -> std::optional<std::string_view>;
+
+	/**
+	 * @brief Takes the next field from the front of a line, which is advanced past it. Fields are separated by
+	 * spaces, tabs or commas.
+	 * @note Marked as [[nodiscard]] because the field is lost if ignored.
+	 * Marked as noexcept because it only adjusts views.
+	 *
+	 * @param line The rest of the line.
+	 * @return The field, or std::nullopt at the end of the line.
+	 */
+	[[nodiscard]] auto next_field(std::string_view& line) noexcept -> std::optional<std::string_view>;
+
+	/**
+	 * @brief Splits a line into fields separated by spaces, tabs or commas.
+	 * @note Marked as noexcept because it only makes views of the line.
+	 *
+	 * @param line The line to split.
+	 * @param fields Receives the first fields.
+	 * @return The number of fields in the line, which may be more than fits into fields.
+	 */
+	auto split_fields(std::string_view line, std::span<std::string_view> fields) noexcept -> std::size_t;
+
+	/**
+	 * @brief Checks if a line holds no data: it is blank, or a comment starting with # or %.
+	 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+	 * Marked as noexcept because it only inspects the line.
+	 *
+	 * @param line The line to check.
+	 * @return True if the line should be skipped, otherwise false.
+	 */
+	[[nodiscard]] auto is_comment(std::string_view line) noexcept -> bool;
+
+	/**
+	 * @brief Counts the line a position in a text is on, to report where parsing failed.
+	 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+	 * Marked as noexcept because it only counts line endings.
+	 *
+	 * @param text The whole text.
+	 * @param position A position within the text.
+	 * @return The 1-based line number.
+	 */
+	[[nodiscard]] auto line_number(std::string_view text, char const* position) noexcept -> std::size_t;
+
+	/**
+	 * @brief Reports a malformed line of a text format.
+	 *
+	 * @param format The name of the format.
+	 * @param text The whole text.
+	 * @param position A position on the malformed line.
+	 * @param problem What is wrong with the line.
+	 * @throws std::runtime_error Always, naming the format and the line.
+	 */
+	[[noreturn]] auto throw_parse_error(std::string_view format,
+	                                    std::string_view text,
+	                                    char const* position,
+	                                    std::string_view problem) -> void;
+
+	/**
+	 * @brief Runs a function on every chunk in parallel, a task per chunk, and collects the results in order.
+	 * An exception thrown for any chunk is rethrown once every running task has finished.
+	 * @note Marked as [[nodiscard]] because the results are lost if ignored.
+	 *
+	 * @param chunks The chunks to process.
+	 * @param fn The function to run, called with a chunk.
+	 * @param ex The executor running the tasks.
+	 * @return The result for every chunk.
+	 */
+	template<typename T, typename F>
+	[[nodiscard]] auto parallel_chunks(std::vector<T> const& chunks, F fn, executor& ex)
+	    -> std::vector<std::invoke_result_t<F&, T const&>>;
+
+	/**
+	 * @brief Runs the parser of the lines in front of the data of a format, such as a header, on as much of the text
+	 * as it needs. While the text is still arriving the parser sees whole lines only, and is run again on more of
+	 * them whenever it fails or uses up all it was given.
+	 * @note Marked as [[nodiscard]] because the body is lost if ignored.
+	 *
+	 * @param source The text.
+	 * @param fn Called with the front of the text, which it advances past the lines it parsed.
+	 * @return The rest of the text after the lines fn parsed.
+	 */
+	template<typename F>
+	requires std::invocable<F&, std::string_view&>
+	[[nodiscard]] auto read_preamble(text_source const& source, F fn) -> std::string_view;
+
+	/**
+	 * @brief Parses the body of a text in chunks ending at line endings, in parallel. A text which has arrived is
+	 * split up front; a stream is cut into chunks of options.chunk_bytes as it arrives, each taken by whichever task
+	 * is done with its previous one, so that parsing overlaps the reads. An exception thrown for any chunk is
+	 * rethrown once every running task has finished.
+	 * @note Marked as [[nodiscard]] because the results are lost if ignored.
+	 *
+	 * @param source The text.
+	 * @param body The part of the text to parse, running to its end.
+	 * @param count Counts the records in a chunk, so that parse is told the number of the first, or nullptr.
+	 * @param parse Parses a chunk, and with count also the number of its first record, counted from 1.
+	 * @param options The thread count, chunk size and executor.
+	 * @return The result for every chunk, in order.
+	 */
+	template<typename Count, typename F>
+	[[nodiscard]] auto
+	parse_chunks(text_source const& source, std::string_view body, Count count, F parse, read_options const& options);
+
+	/**
+	 * @brief Builds a graph from parsed edges. The distinct nodes are found by sorting their tokens, edges are mapped
+	 * to node positions in parallel, and the graph is assembled by graph_builder::from_sorted without a search per
+	 * edge.
+	 * @note Marked as [[nodiscard]] because the graph is lost if ignored.
+	 *
+	 * Time complexity: O((n + e) log (n + e)).
+	 *
+	 * @param parsed The edges parsed from every chunk.
+	 * @param nodes Nodes of the graph which need not have edges, in any order.
+	 * @param ex The executor running the sorts.
+	 * @return The graph of the nodes and edges, each edge once.
+	 */
+	template<text_parsable N, text_parsable E>
+	[[nodiscard]] auto intern_parsed(std::vector<std::vector<parsed_edge<N, E>>> const& parsed,
+	                                 std::vector<typename text_parser<N>::token_type> nodes,
+	                                 executor& ex) -> graph<N, E>;
+
+	/**
+	 * @brief Builds a graph from the body of a text parsed in parallel chunks with parse_chunks. Only interning the
+	 * nodes waits for the whole text.
+	 * @note Marked as [[nodiscard]] because the graph is lost if ignored.
+	 *
+	 * Time complexity: O(p / t + (n + e) log (n + e)) for parsing costing p on t threads.
+	 *
+	 * @param source The text.
+	 * @param body The part of the text to parse, running to its end.
+	 * @param nodes Nodes of the graph which need not have edges, in any order.
+	 * @param parse Parses a chunk into a std::vector<parsed_edge<N, E>>.
+	 * @param options The thread count, chunk size and executor.
+	 * @return The graph of the nodes and edges, each edge once.
+	 */
+	template<text_parsable N, text_parsable E, typename F>
+	[[nodiscard]] auto build_parsed(text_source const& source,
+	                                std::string_view body,
+	                                std::vector<typename text_parser<N>::token_type> nodes,
+	                                F parse,
+	                                read_options const& options) -> graph<N, E>;
+
+	/**
+	 * @brief Parses an edge list: one edge per line as "src dst" or "src dst weight", with fields separated by
+	 * spaces, tabs or commas. Blank lines and comments are skipped. Every node of an edge becomes a node of the graph.
+	 * @note Marked as [[nodiscard]] because the graph is lost if ignored.
+	 *
+	 * Time complexity: O(l / t + e log e) for l bytes parsed on t threads.
+	 *
+	 * @param source The edge list.
+	 * @param options How to read the edge list.
+	 * @return The graph of the edges, each edge once.
+	 * @throws std::runtime_error If a line is not an edge, naming the line.
+	 */
+	template<text_parsable N, text_parsable E>
+	[[nodiscard]] auto parse_edge_list(text_source const& source, read_options const& options = {}) -> graph<N, E>;
+
+	/**
+	 * @brief Parses a SNAP edge list: one unweighted edge per line as "src dst", with # comments. Columns after the
+	 * second, such as the timestamps of temporal networks, are ignored.
+	 * @note Marked as [[nodiscard]] because the graph is lost if ignored.
+	 *
+	 * Time complexity: O(l / t + e log e) for l bytes parsed on t threads.
+	 *
+	 * @param source The edge list.
+	 * @param options How to read the edge list.
+	 * @return The graph of the edges, each edge once.
+	 * @throws std::runtime_error If a line is not an edge, naming the line.
+	 */
+	template<text_parsable N, text_parsable E>
+	[[nodiscard]] auto parse_snap(text_source const& source, read_options const& options = {}) -> graph<N, E>;
+
+	/**
+	 * @brief Parses a Matrix Market coordinate matrix, with an edge from i to j for every entry (i, j). Nodes are
+	 * numbered from 1 to the larger dimension of the matrix. Symmetric and skew-symmetric matrices store one
+	 * triangle, so the mirrored edges are added; pattern matrices give unweighted edges, so they cannot be
+	 * skew-symmetric.
+	 * @note Marked as [[nodiscard]] because the graph is lost if ignored.
+	 *
+	 * Time complexity: O(l / t + e log e) for l bytes parsed on t threads.
+	 *
+	 * @param source The matrix.
+	 * @param options How to read the matrix.
+	 * @return The graph of the matrix.
+	 * @throws std::runtime_error If the banner is unsupported or a line is malformed, naming the line.
+	 */
+	template<std::integral N, typename E>
+	requires text_parsable<N> and text_parsable<E> and std::is_arithmetic_v<E>
+	[[nodiscard]] auto
+	parse_matrix_market(text_source const& source, read_options const& options = {}) -> graph<N, E>;
+
+	/**
+	 * @brief Parses a METIS graph: a header "n m [fmt [ncon]]" followed by one line per node, numbered from 1,
+	 * listing its neighbours and, if fmt asks for them, edge weights. Vertex sizes and weights are skipped. Every
+	 * listed neighbour gives an edge, so the two directions of an undirected METIS edge become two edges.
+	 * @note Marked as [[nodiscard]] because the graph is lost if ignored.
+	 *
+	 * Time complexity: O(l / t + e log e) for l bytes parsed on t threads.
+	 *
+	 * @param source The graph.
+	 * @param options How to read the graph.
+	 * @return The graph.
+	 * @throws std::runtime_error If the header or a line is malformed, naming the line.
+	 */
+	template<std::integral N, typename E>
+	requires text_parsable<N> and text_parsable<E> and std::is_arithmetic_v<E>
+	[[nodiscard]] auto parse_metis(text_source const& source, read_options const& options = {}) -> graph<N, E>;
+
+	/**
+	 * @brief Parses a DIMACS shortest path graph (.gr): "c" comments, a problem line "p sp n m", and arc lines
+	 * "a u v w" with nodes numbered from 1 to n.
+	 * @note Marked as [[nodiscard]] because the graph is lost if ignored.
+	 *
+	 * Time complexity: O(l / t + e log e) for l bytes parsed on t threads.
+	 *
+	 * @param source The graph.
+	 * @param options How to read the graph.
+	 * @return The graph.
+	 * @throws std::runtime_error If the problem line is missing or a line is malformed, naming the line.
+	 */
+	template<std::integral N, typename E>
+	requires text_parsable<N> and text_parsable<E> and std::is_arithmetic_v<E>
+	[[nodiscard]] auto parse_dimacs(text_source const& source, read_options const& options = {}) -> graph<N, E>;
+
+	/**
+	 * @brief Reads a graph file through a memory mapping with one of the parse functions, e.g.
+	 * read_graph(path, parse_metis<int, double>).
+	 * @note Marked as [[nodiscard]] because the graph is lost if ignored.
+	 *
+	 * @param path The file to read.
+	 * @param parse The parse function for the format of the file.
+	 * @param options How to read the file.
+	 * @return The graph.
+	 * @throws std::system_error If the file cannot be mapped.
+	 * @throws std::runtime_error If the file is malformed.
+	 */
+	template<typename F>
+	requires std::invocable<F&, std::string_view, read_options const&>
+	[[nodiscard]] auto read_graph(std::filesystem::path const& path, F parse, read_options const& options = {})
+	    -> std::invoke_result_t<F&, std::string_view, read_options const&>;
+
+	/**
+	 * @brief Reads a graph file into memory with asynchronous reads, rather than faulting in one page of a mapping at
+	 * a time, and parses it with one of the parse functions. The parse functions taking a text_source parse the
+	 * blocks which have arrived while the rest are read; any other is called once the whole file has been read.
+	 * @note Marked as [[nodiscard]] because the graph is lost if ignored.
+	 *
+	 * @param path The file to read.
+	 * @param parse The parse function for the format of the file.
+	 * @param options How to parse the file.
+	 * @param io How to read the file.
+	 * @return The graph.
+	 * @throws std::system_error If the file cannot be read.
+	 * @throws std::runtime_error If the file is malformed.
+	 */
+	template<typename F>
+	requires std::invocable<F&, std::string_view, read_options const&>
+	[[nodiscard]] auto
+	read_graph(std::filesystem::path const& path, F parse, read_options const& options, io_options const& io)
+	    -> std::invoke_result_t<F&, std::string_view, read_options const&>;
+
+	/**
+	 * @brief Reads an edge list file through a memory mapping. See parse_edge_list for the format.
+	 * @note Marked as [[nodiscard]] because the graph is lost if ignored.
+	 *
+	 * @param path The file to read.
+	 * @param options How to read the edge list.
+	 * @return The graph of the edges, each edge once.
+	 * @throws std::system_error If the file cannot be mapped.
+	 * @throws std::runtime_error If a line is not an edge, naming the line.
+	 */
+	template<text_parsable N, text_parsable E>
+	[[nodiscard]] auto read_edge_list(std::filesystem::path const& path, read_options const& options = {})
+	    -> graph<N, E>;
+
+	/**
+	 * Customisation point formatting values of type T into the fields of text formats, the inverse of text_parser.
+	 * Numbers are formatted with std::to_chars into the shortest text which parses back to the same value, and
+	 * strings are copied as they are. numeric tells the structured formats whether a value needs quoting.
+	 */
+	template<typename T>
+	struct text_formatter;
+
+	/**
+	 * A type with a text_formatter specialisation.
+	 */
+	template<typename T>
+	concept text_formattable = requires(std::string& out, T const& value) {
+		text_formatter<T>::append(out, value);
+		{ text_formatter<T>::numeric } -> std::convertible_to<bool>;
+	};
+
+	template<typename T>
+	requires(std::integral<T> or std::floating_point<T>) and (not std::same_as<T, bool>)
+	struct text_formatter<T> {
+		static constexpr bool numeric = true;
+
+		/**
+		 * @brief Appends a number with std::to_chars.
+		 *
+		 * @param out The buffer to append to.
+		 * @param value The number.
+		 */
+		static auto append(std::string& out, T const& value) -> void;
+	};
+
+	template<typename Traits, typename Alloc>
+	struct text_formatter<std::basic_string<char, Traits, Alloc>> {
+		static constexpr bool numeric = false;
+
+		/**
+		 * @brief Appends a string as it is.
+		 *
+		 * @param out The buffer to append to.
+		 * @param value The string.
+		 */
+		static auto append(std::string& out, std::basic_string<char, Traits, Alloc> const& value) -> void;
+	};
+
+	/**
+	 * A reusable buffer in front of an output stream, so that exporters issue a few large writes instead of one per
+	 * node or edge, while holding at most a bounded amount of output in memory.
+	 */
+	class output_buffer {
+	 public:
+		/**
+		 * Creates a buffer writing to a stream.
+		 *
+		 * @param out The stream to write to.
+		 * @param capacity The number of bytes after which the buffer is written out.
+		 */
+		explicit output_buffer(std::ostream& out, std::size_t capacity = std::size_t{1} << 16U);
+
+		output_buffer(output_buffer const&) = delete;
+		auto operator=(output_buffer const&) -> output_buffer& = delete;
+
+		/**
+		 * @brief Returns the pending output, to append to.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 *
+		 * @return The buffer.
+		 */
+		[[nodiscard]] auto text() noexcept -> std::string&;
+
+		/**
+		 * @brief Writes the pending output once it has reached the capacity. Called after every record.
+		 *
+		 * @throws std::runtime_error If the stream fails.
+		 */
+		auto commit() -> void;
+
+		/**
+		 * @brief Writes all pending output and flushes the stream.
+		 *
+		 * @throws std::runtime_error If the stream fails.
+		 */
+		auto flush() -> void;
+
+	 private:
+		std::ostream* out_;
+		std::size_t capacity_;
+		std::string text_;
+	};
+
+	/**
+	 * @brief Appends text as the contents of a double-quoted Graphviz DOT string.
+	 *
+	 * @param out The buffer to append to.
+	 * @param text The text to escape.
+	 */
+	auto escape_dot(std::string& out, std::string_view text) -> void;
+
+	/**
+	 * @brief Appends text as XML character data or attribute contents.
+	 *
+	 * @param out The buffer to append to.
+	 * @param text The text to escape.
+	 */
+	auto escape_xml(std::string& out, std::string_view text) -> void;
+
+	/**
+	 * @brief Appends text as the contents of a JSON string.
+	 *
+	 * @param out The buffer to append to.
+	 * @param text The text to escape.
+	 */
+	auto escape_json(std::string& out, std::string_view text) -> void;
+
+	/**
+	 * @brief Writes a graph in Graphviz DOT: a digraph with every node, then every edge with its weight as a weight
+	 * attribute.
+	 *
+	 * Time complexity: O(n + e), in one sorted pass with constant extra memory.
+	 *
+	 * @param out The stream to write to.
+	 * @param g The graph.
+	 * @param name The name of the digraph.
+	 * @throws std::runtime_error If the stream fails.
+	 */
+	template<text_formattable N, text_formattable E>
+	auto write_dot(std::ostream& out, graph<N, E> const& g, std::string_view name = "G") -> void;
+
+	/**
+	 * @brief Writes a graph in GraphML: a directed graph with every node, then every edge with its weight as a
+	 * "weight" data element.
+	 *
+	 * Time complexity: O(n + e), in one sorted pass with constant extra memory.
+	 *
+	 * @param out The stream to write to.
+	 * @param g The graph.
+	 * @throws std::runtime_error If the stream fails.
+	 */
+	template<text_formattable N, text_formattable E>
+	auto write_graphml(std::ostream& out, graph<N, E> const& g) -> void;
+
+	/**
+	 * @brief Writes a graph as JSON lines: {"node": n} for every node, then {"src": s, "dst": d, "weight": w} for
+	 * every edge, with the weight left out of unweighted edges. Numbers are written as JSON numbers, or null if
+	 * they are not finite.
+	 *
+	 * Time complexity: O(n + e), in one sorted pass with constant extra memory.
+	 *
+	 * @param out The stream to write to.
+	 * @param g The graph.
+	 * @throws std::runtime_error If the stream fails.
+	 */
+	template<text_formattable N, text_formattable E>
+	auto write_jsonl(std::ostream& out, graph<N, E> const& g) -> void;
+} // namespace gdwg
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  TEXT PARSER FUNCTIONS                                                             //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename T>
+requires(std::integral<T> or std::floating_point<T>) and (not std::same_as<T, bool>)
+auto gdwg::text_parser<T>::parse(std::string_view field) noexcept -> std::optional<T> {
+	// std::from_chars rejects a leading plus sign, which some generators write for positive weights
+	if (field.size() > 1 and field.front() == '+')
+		field.remove_prefix(1);
+	auto value = T{};
+	auto const [end, error] = std::from_chars(field.data(), field.data() + field.size(), value);
+	if (error != std::errc{} or end != field.data() + field.size())
+		return std::nullopt;
+	return value;
+}
+
+template<typename T>
+requires(std::integral<T> or std::floating_point<T>) and (not std::same_as<T, bool>)
+auto gdwg::text_parser<T>::make(T const& token) noexcept -> T {
+	return token;
+}
+
+template<typename Traits, typename Alloc>
+auto gdwg::text_parser<std::basic_string<char, Traits, Alloc>>::parse(std::string_view field) noexcept
+    -> std::optional<token_type> {
+	return token_type{field.data(), field.size()};
+}
+
+template<typename Traits, typename Alloc>
+auto gdwg::text_parser<std::basic_string<char, Traits, Alloc>>::make(token_type const& token)
+    -> std::basic_string<char, Traits, Alloc> {
+	return std::basic_string<char, Traits, Alloc>{token};
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  TEXT FORMAT FUNCTIONS                                                             //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename T, typename F>
+auto gdwg::parallel_chunks(std::vector<T> const& chunks, F fn, executor& ex)
+    -> std::vector<std::invoke_result_t<F&, T const&>> {
+	auto results = std::vector<std::invoke_result_t<F&, T const&>>(chunks.size());
+	ex.bulk(chunks.size(), [&](std::size_t i) { results[i] = fn(chunks[i]); });
+	return results;
+}
+
+template<typename F>
+requires std::invocable<F&, std::string_view&>
+auto gdwg::read_preamble(text_source const& source, F fn) -> std::string_view {
+	auto const text = source.text();
+	for (auto bytes = std::size_t{1} << 16U;; bytes *= 2) {
+		auto const arrived = source.wait(bytes);
+		auto front = arrived;
+		if (arrived.size() == text.size()) {
+			fn(front);
+			return front;
+		}
+		// Only whole lines have arrived for certain, and a preamble cut short looks malformed or unfinished
+		front = arrived.substr(0, arrived.rfind('\n') + 1);
+		try {
+			fn(front);
+		} catch (std::runtime_error const&) {
+			continue;
+		}
+		if (not front.empty())
+			return text.substr(static_cast<std::size_t>(front.data() - text.data()));
+	}
+}
+
+template<typename Count, typename F>
+auto gdwg::parse_chunks(text_source const& source,
+                        std::string_view body,
+                        Count count,
+                        F parse,
+                        read_options const& options) {
+	constexpr auto counted = not std::is_null_pointer_v<Count>;
+	auto const& run = [&parse](std::pair<std::string_view, std::size_t> const& chunk) {
+		if constexpr (counted)
+			return parse(chunk.first, chunk.second);
+		else
+			return parse(chunk.first);
+	};
+	using result_type = std::invoke_result_t<decltype(run)&, std::pair<std::string_view, std::size_t> const&>;
+	auto& ex = executor_of(options);
+	if (source.complete()) {
+		auto const chunks = split_lines(body, chunk_count(body.size(), options));
+		auto numbered = std::vector<std::pair<std::string_view, std::size_t>>{};
+		numbered.reserve(chunks.size());
+		if constexpr (counted) {
+			// Every record is numbered by the records before it, so the chunks are counted before they are parsed
+			auto const& records = parallel_chunks(chunks, count, ex);
+			auto first = std::size_t{1};
+			for (auto i = std::size_t{0}; i < chunks.size(); ++i) {
+				numbered.emplace_back(chunks[i], first);
+				first += records[i];
+			}
+		}
+		else {
+			std::ranges::transform(chunks, std::back_inserter(numbered), [](std::string_view chunk) {
+				return std::pair{chunk, std::size_t{1}};
+			});
+		}
+		return parallel_chunks(numbered, run, ex);
+	}
+
+	// Each task cuts the next chunk off the part which has arrived, waiting for more only when it has to, and
+	// counts it before letting go of the rest so that the next chunk knows its first record
+	auto results = std::deque<result_type>{};
+	auto mutex = std::mutex{};
+	auto const text = source.text();
+	auto const chunk_bytes = std::max(options.chunk_bytes, std::size_t{1});
+	auto rest = body;
+	auto first = std::size_t{1};
+	auto failed = false;
+	auto const& next = [&]() -> std::optional<std::pair<std::pair<std::string_view, std::size_t>, result_type*>> {
+		auto const lock = std::scoped_lock{mutex};
+		if (rest.empty() or failed)
+			return std::nullopt;
+		auto const offset = static_cast<std::size_t>(rest.data() - text.data());
+		// Cut after the first line ending at or past the chunk size, or take the rest
+		auto size = rest.size();
+		for (auto bytes = chunk_bytes;; bytes *= 2) {
+			auto const arrived = source.wait(offset + bytes).substr(offset);
+			auto const newline =
+			    arrived.size() < chunk_bytes ? std::string_view::npos : arrived.find('\n', chunk_bytes - 1);
+			if (newline != std::string_view::npos) {
+				size = newline + 1;
+				break;
+			}
+			if (arrived.size() == rest.size())
+				break;
+		}
+		auto const chunk = std::pair{rest.substr(0, size), first};
+		rest.remove_prefix(size);
+		if constexpr (counted)
+			first += count(chunk.first);
+		return std::pair{chunk, &results.emplace_back()};
+	};
+	ex.bulk(chunk_count(body.size(), options), [&](std::size_t) {
+		try {
+			while (auto const task = next()) {
+				*task->second = run(task->first);
+			}
+		} catch (...) {
+			auto const lock = std::scoped_lock{mutex};
+			failed = true;
+			throw;
+		}
+	});
+	return std::vector<result_type>(std::make_move_iterator(results.begin()), std::make_move_iterator(results.end()));
+}
+
+template<gdwg::text_parsable N, gdwg::text_parsable E>
+auto gdwg::intern_parsed(std::vector<std::vector<parsed_edge<N, E>>> const& parsed,
+                         std::vector<typename text_parser<N>::token_type> nodes,
+                         executor& ex) -> graph<N, E> {
+	using node_token = typename text_parser<N>::token_type;
+	// Intern the nodes: sorting the tokens once gives every distinct node its position in the graph
+	for (auto const& edges : parsed) {
+		for (auto const& edge : edges) {
+			nodes.push_back(edge.src);
+			nodes.push_back(edge.dst);
+		}
+	}
+	parallel_sort(nodes, std::less<>{}, ex);
+	auto const& [last, end] = std::ranges::unique(nodes);
+	nodes.erase(last, end);
+
+	using builder = graph_builder<N, E>;
+	auto const& index = [&nodes](std::vector<parsed_edge<N, E>> const& edges) {
+		auto const& position = [&nodes](node_token const& token) {
+			return static_cast<std::size_t>(std::ranges::lower_bound(nodes, token) - nodes.begin());
+		};
+		auto result = std::vector<typename builder::indexed_edge>{};
+		result.reserve(edges.size());
+		for (auto const& [src, dst, weight] : edges) {
+			auto const& value = weight ? std::optional<E>{text_parser<E>::make(*weight)} : std::nullopt;
+			result.push_back({position(src), position(dst), value});
+		}
+		return result;
+	};
+	auto const& indexed = parallel_chunks(parsed, index, ex);
+	auto edges = std::vector<typename builder::indexed_edge>{};
+	for (auto const& chunk : indexed) {
+		edges.insert(edges.end(), chunk.begin(), chunk.end());
+	}
+	parallel_sort(edges, std::less<>{}, ex);
+	auto const& [last_edge, end_edge] = std::ranges::unique(edges);
+	edges.erase(last_edge, end_edge);
+
+	auto values = std::vector<N>{};
+	values.reserve(nodes.size());
+	std::ranges::transform(nodes, std::back_inserter(values), [](auto const& token) {
+		return text_parser<N>::make(token);
+	});
+	return builder::from_sorted(std::move(values), edges);
+}
+
+template<gdwg::text_parsable N, gdwg::text_parsable E, typename F>
+auto gdwg::build_parsed(text_source const& source,
+                        std::string_view body,
+                        std::vector<typename text_parser<N>::token_type> nodes,
+                        F parse,
+                        read_options const& options) -> graph<N, E> {
+	auto const& parsed = parse_chunks(source, body, nullptr, parse, options);
+	return intern_parsed<N, E>(parsed, std::move(nodes), executor_of(options));
+}
+
+template<gdwg::text_parsable N, gdwg::text_parsable E>
+auto gdwg::parse_edge_list(text_source const& source, read_options const& options) -> graph<N, E> {
+	auto const text = source.text();
+	auto body = text;
+	if (options.header) {
+		body = read_preamble(source, [](std::string_view& in) {
+			auto line = next_line(in);
+			while (line and is_comment(*line)) {
+				line = next_line(in);
+			}
+		});
+	}
+	auto const& parse = [text](std::string_view chunk) {
+		auto edges = std::vector<parsed_edge<N, E>>{};
+		auto fields = std::array<std::string_view, 3>{};
+		while (auto const line = next_line(chunk)) {
+			if (is_comment(*line))
+				continue;
+			auto const count = split_fields(*line, fields);
+			if (count != 2 and count != 3)
+				throw_parse_error("edge list", text, line->data(), "expected src dst [weight]");
+			auto src = text_parser<N>::parse(fields[0]);
+			auto dst = text_parser<N>::parse(fields[1]);
+			if (not src or not dst)
+				throw_parse_error("edge list", text, line->data(), "invalid node");
+			auto& edge = edges.emplace_back(parsed_edge<N, E>{std::move(*src), std::move(*dst), std::nullopt});
+			if (count == 3) {
+				edge.weight = text_parser<E>::parse(fields[2]);
+				if (not edge.weight)
+					throw_parse_error("edge list", text, line->data(), "invalid weight");
+			}
+		}
+		return edges;
+	};
+	return build_parsed<N, E>(source, body, {}, parse, options);
+}
+
+template<gdwg::text_parsable N, gdwg::text_parsable E>
+auto gdwg::parse_snap(text_source const& source, read_options const& options) -> graph<N, E> {
+	auto const text = source.text();
+	auto const& parse = [text](std::string_view chunk) {
+		auto edges = std::vector<parsed_edge<N, E>>{};
+		auto fields = std::array<std::string_view, 2>{};
+		while (auto const line = next_line(chunk)) {
+			if (is_comment(*line))
+				continue;
+			if (split_fields(*line, fields) < 2)
+				throw_parse_error("SNAP", text, line->data(), "expected src dst");
+			auto src = text_parser<N>::parse(fields[0]);
+			auto dst = text_parser<N>::parse(fields[1]);
+			if (not src or not dst)
+				throw_parse_error("SNAP", text, line->data(), "invalid node");
+			edges.push_back(parsed_edge<N, E>{std::move(*src), std::move(*dst), std::nullopt});
+		}
+		return edges;
+	};
+	return build_parsed<N, E>(source, text, {}, parse, options);
+}
+
+template<std::integral N, typename E>
+requires gdwg::text_parsable<N> and gdwg::text_parsable<E> and std::is_arithmetic_v<E>
+auto gdwg::parse_matrix_market(text_source const& source, read_options const& options) -> graph<N, E> {
+	auto const text = source.text();
+	auto pattern = false;
+	auto mirror = false;
+	auto negate = false;
+	auto rows = std::optional<N>{};
+	auto cols = std::optional<N>{};
+	auto const body = read_preamble(source, [&](std::string_view& in) {
+		auto const banner = next_line(in).value_or(std::string_view{});
+		auto fields = std::array<std::string_view, 5>{};
+		auto lowered = std::string{banner};
+		std::ranges::transform(lowered, lowered.begin(), [](char c) {
+			return c >= 'A' and c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+		});
+		if (split_fields(lowered, fields) != 5 or fields[0] != "%%matrixmarket" or fields[1] != "matrix")
+			throw_parse_error("Matrix Market", text, banner.data(), "expected %%MatrixMarket matrix banner");
+		auto const [format, field, symmetry] = std::tuple{fields[2], fields[3], fields[4]};
+		if (format != "coordinate")
+			throw_parse_error("Matrix Market", text, banner.data(), "only coordinate matrices are supported");
+		if (field != "real" and field != "double" and field != "integer" and field != "pattern")
+			throw_parse_error("Matrix Market",
+			                  text,
+			                  banner.data(),
+			                  "only real, integer and pattern fields are supported");
+		if (symmetry != "general" and symmetry != "symmetric" and symmetry != "skew-symmetric")
+			throw_parse_error("Matrix Market",
+			                  text,
+			                  banner.data(),
+			                  "only general, symmetric and skew-symmetric matrices are supported");
+		pattern = field == "pattern";
+		mirror = symmetry != "general";
+		negate = symmetry == "skew-symmetric";
+		// The standard forbids it, and without values there is nothing to negate
+		if (pattern and negate)
+			throw_parse_error("Matrix Market", text, banner.data(), "pattern matrices cannot be skew-symmetric");
+		if constexpr (std::is_unsigned_v<E>) {
+			if (negate)
+				throw_parse_error("Matrix Market",
+				                  text,
+				                  banner.data(),
+				                  "skew-symmetric matrices need a signed weight type");
+		}
+
+		auto size_line = next_line(in);
+		while (size_line and is_comment(*size_line)) {
+			size_line = next_line(in);
+		}
+		auto sizes = std::array<std::string_view, 3>{};
+		rows = cols = std::nullopt;
+		if (size_line and split_fields(*size_line, sizes) == 3) {
+			rows = text_parser<N>::parse(sizes[0]);
+			cols = text_parser<N>::parse(sizes[1]);
+		}
+		if (not rows or not cols or *rows < 0 or *cols < 0)
+			throw_parse_error("Matrix Market", text, size_line.value_or(in).data(), "expected rows cols entries");
+	});
+
+	auto nodes = std::vector<N>(static_cast<std::size_t>(std::max(*rows, *cols)));
+	std::iota(nodes.begin(), nodes.end(), N{1});
+	auto const& parse = [&, rows = *rows, cols = *cols](std::string_view chunk) {
+		auto edges = std::vector<parsed_edge<N, E>>{};
+		auto entry = std::array<std::string_view, 3>{};
+		while (auto const line = next_line(chunk)) {
+			if (is_comment(*line))
+				continue;
+			if (split_fields(*line, entry) != (pattern ? 2U : 3U))
+				throw_parse_error("Matrix Market", text, line->data(), pattern ? "expected i j" : "expected i j value");
+			auto const i = text_parser<N>::parse(entry[0]);
+			auto const j = text_parser<N>::parse(entry[1]);
+			if (not i or not j or *i < 1 or *i > rows or *j < 1 or *j > cols)
+				throw_parse_error("Matrix Market", text, line->data(), "invalid row or column");
+			auto value = std::optional<E>{};
+			if (not pattern) {
+				value = text_parser<E>::parse(entry[2]);
+				if (not value)
+					throw_parse_error("Matrix Market", text, line->data(), "invalid value");
+			}
+			edges.push_back(parsed_edge<N, E>{*i, *j, value});
+			if (mirror and *i != *j) {
+				if (negate)
+					value = static_cast<E>(-*value);
+				edges.push_back(parsed_edge<N, E>{*j, *i, value});
+			}
+		}
+		return edges;
+	};
+	return build_parsed<N, E>(source, body, std::move(nodes), parse, options);
+}
+
+template<std::integral N, typename E>
+requires gdwg::text_parsable<N> and gdwg::text_parsable<E> and std::is_arithmetic_v<E>
+auto gdwg::parse_metis(text_source const& source, read_options const& options) -> graph<N, E> {
+	// Unlike in the other formats a blank line is data, the node without neighbours
+	auto const& is_metis_comment = [](std::string_view line) { return line.starts_with('%'); };
+	auto const text = source.text();
+	auto node_count = std::optional<N>{};
+	auto fmt = std::string_view{};
+	auto ncon = std::optional<std::size_t>{};
+	auto const body = read_preamble(source, [&](std::string_view& in) {
+		auto header = next_line(in);
+		while (header and is_metis_comment(*header)) {
+			header = next_line(in);
+		}
+		auto fields = std::array<std::string_view, 4>{};
+		auto const count = header ? split_fields(*header, fields) : 0;
+		node_count = count >= 2 ? text_parser<N>::parse(fields[0]) : std::nullopt;
+		if (not node_count or *node_count < 0 or count > 4 or (count >= 3 and fields[2].size() > 3))
+			throw_parse_error("METIS", text, header.value_or(in).data(), "expected n m [fmt [ncon]]");
+		fmt = count >= 3 ? fields[2] : std::string_view{};
+		ncon = count == 4 ? text_parser<std::size_t>::parse(fields[3]) : std::optional<std::size_t>{1};
+		if (not ncon)
+			throw_parse_error("METIS", text, header->data(), "invalid ncon");
+	});
+	// The digits of fmt flag vertex sizes, vertex weights and edge weights, with leading zeros optional
+	auto const& flag = [fmt](std::size_t digit) { return fmt.size() > digit and fmt[fmt.size() - 1 - digit] == '1'; };
+	auto const edge_weights = flag(0);
+	auto const skipped = (flag(2) ? 1 : 0) + (flag(1) ? *ncon : 0);
+
+	// Every node line is numbered by the lines before it
+	auto lines = std::atomic<std::size_t>{0};
+	auto const& count_lines = [&is_metis_comment, &lines](std::string_view chunk) {
+		auto count = std::size_t{0};
+		while (auto const line = next_line(chunk)) {
+			if (not is_metis_comment(*line))
+				++count;
+		}
+		lines.fetch_add(count, std::memory_order_relaxed);
+		return count;
+	};
+	auto const n = static_cast<std::size_t>(*node_count);
+	auto nodes = std::vector<N>(n);
+	std::iota(nodes.begin(), nodes.end(), N{1});
+	auto const& parse = [&, n](std::string_view chunk, std::size_t node) {
+		auto edges = std::vector<parsed_edge<N, E>>{};
+		for (auto line = next_line(chunk); line; line = next_line(chunk)) {
+			if (is_metis_comment(*line))
+				continue;
+			auto in = *line;
+			if (node > n) {
+				if (next_field(in))
+					throw_parse_error("METIS", text, line->data(), "more node lines than n");
+				continue;
+			}
+			for (auto i = std::size_t{0}; i < skipped; ++i) {
+				if (not next_field(in))
+					throw_parse_error("METIS", text, line->data(), "missing vertex size or weight");
+			}
+			while (auto const field = next_field(in)) {
+				auto const dst = text_parser<N>::parse(*field);
+				if (not dst or *dst < 1 or static_cast<std::size_t>(*dst) > n)
+					throw_parse_error("METIS", text, line->data(), "invalid neighbour");
+				auto weight = std::optional<E>{};
+				if (edge_weights) {
+					auto const weight_field = next_field(in);
+					weight = weight_field ? text_parser<E>::parse(*weight_field) : std::nullopt;
+					if (not weight)
+						throw_parse_error("METIS", text, line->data(), "invalid edge weight");
+				}
+				edges.push_back(parsed_edge<N, E>{static_cast<N>(node), *dst, weight});
+			}
+			++node;
+		}
+		return edges;
+	};
+	auto const& parsed = parse_chunks(source, body, count_lines, parse, options);
+	if (lines.load(std::memory_order_relaxed) < n)
+		throw_parse_error("METIS", text, text.data() + text.size(), "fewer node lines than n");
+	return intern_parsed<N, E>(parsed, std::move(nodes), executor_of(options));
+}
+
+template<std::integral N, typename E>
+requires gdwg::text_parsable<N> and gdwg::text_parsable<E> and std::is_arithmetic_v<E>
+auto gdwg::parse_dimacs(text_source const& source, read_options const& options) -> graph<N, E> {
+	auto const& is_dimacs_comment = [](std::string_view line) { return line.empty() or line.starts_with('c'); };
+	auto const text = source.text();
+	auto node_count = std::optional<N>{};
+	auto const body = read_preamble(source, [&](std::string_view& in) {
+		auto problem = next_line(in);
+		while (problem and is_dimacs_comment(*problem)) {
+			problem = next_line(in);
+		}
+		auto fields = std::array<std::string_view, 4>{};
+		node_count = problem and split_fields(*problem, fields) == 4 and fields[0] == "p" and fields[1] == "sp"
+		                 ? text_parser<N>::parse(fields[2])
+		                 : std::nullopt;
+		if (not node_count or *node_count < 0)
+			throw_parse_error("DIMACS", text, problem.value_or(in).data(), "expected p sp n m");
+	});
+
+	auto nodes = std::vector<N>(static_cast<std::size_t>(*node_count));
+	std::iota(nodes.begin(), nodes.end(), N{1});
+	auto const& parse = [&, n = *node_count](std::string_view chunk) {
+		auto edges = std::vector<parsed_edge<N, E>>{};
+		auto arc = std::array<std::string_view, 4>{};
+		while (auto const line = next_line(chunk)) {
+			if (is_dimacs_comment(*line))
+				continue;
+			if (split_fields(*line, arc) != 4 or arc[0] != "a")
+				throw_parse_error("DIMACS", text, line->data(), "expected a u v w");
+			auto const u = text_parser<N>::parse(arc[1]);
+			auto const v = text_parser<N>::parse(arc[2]);
+			if (not u or not v or *u < 1 or *u > n or *v < 1 or *v > n)
+				throw_parse_error("DIMACS", text, line->data(), "invalid node");
+			auto const w = text_parser<E>::parse(arc[3]);
+			if (not w)
+				throw_parse_error("DIMACS", text, line->data(), "invalid weight");
+			edges.push_back(parsed_edge<N, E>{*u, *v, w});
+		}
+		return edges;
+	};
+	return build_parsed<N, E>(source, body, std::move(nodes), parse, options);
+}
+
+template<typename F>
+requires std::invocable<F&, std::string_view, gdwg::read_options const&>
+auto gdwg::read_graph(std::filesystem::path const& path, F parse, read_options const& options)
+    -> std::invoke_result_t<F&, std::string_view, read_options const&> {
+	auto const file = mapped_file{path};
+	return parse(file.contents(), options);
+}
+
+template<typename F>
+requires std::invocable<F&, std::string_view, gdwg::read_options const&>
+auto gdwg::read_graph(std::filesystem::path const& path, F parse, read_options const& options, io_options const& io)
+    -> std::invoke_result_t<F&, std::string_view, read_options const&> {
+	if constexpr (std::invocable<F&, text_source const&, read_options const&>) {
+		auto stream = file_stream{path, io};
+		return parse(text_source{stream}, options);
+	}
+	else {
+		auto const text = read_file(path, io);
+		return parse(text, options);
+	}
+}
+
+template<gdwg::text_parsable N, gdwg::text_parsable E>
+auto gdwg::read_edge_list(std::filesystem::path const& path, read_options const& options) -> graph<N, E> {
+	return read_graph(path, parse_edge_list<N, E>, options);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  TEXT FORMATTER FUNCTIONS                                                          //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename T>
+requires(std::integral<T> or std::floating_point<T>) and (not std::same_as<T, bool>)
+auto gdwg::text_formatter<T>::append(std::string& out, T const& value) -> void {
+	// Large enough for any integer up to 128 bits and the shortest form of any double
+	auto digits = std::array<char, 64>{};
+	auto const [end, error] = std::to_chars(digits.data(), digits.data() + digits.size(), value);
+	out.append(digits.data(), end);
+}
+
+template<typename Traits, typename Alloc>
+auto gdwg::text_formatter<std::basic_string<char, Traits, Alloc>>::append(
+    std::string& out,
+    std::basic_string<char, Traits, Alloc> const& value) -> void {
+	out.append(value.data(), value.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  TEXT EXPORT FUNCTIONS                                                             //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<gdwg::text_formattable N, gdwg::text_formattable E>
+auto gdwg::write_dot(std::ostream& out, graph<N, E> const& g, std::string_view name) -> void {
+	auto buffer = output_buffer{out};
+	auto& text = buffer.text();
+	// Every value is formatted into the same scratch string before it is escaped into the buffer
+	auto scratch = std::string{};
+	auto const& quoted = [&text, &scratch](auto const& value) {
+		scratch.clear();
+		text_formatter<std::remove_cvref_t<decltype(value)>>::append(scratch, value);
+		text += '"';
+		escape_dot(text, scratch);
+		text += '"';
+	};
+	text += "digraph \"";
+	escape_dot(text, name);
+	text += "\" {\n";
+	g.for_each_node([&](N const& node) {
+		text += '\t';
+		quoted(node);
+		text += ";\n";
+		buffer.commit();
+	});
+	g.for_each_edge([&](N const& src, N const& dst, std::optional<E> const& weight) {
+		text += '\t';
+		quoted(src);
+		text += " -> ";
+		quoted(dst);
+		if (weight) {
+			text += " [weight=";
+			quoted(*weight);
+			text += ']';
+		}
+		text += ";\n";
+		buffer.commit();
+	});
+	text += "}\n";
+	buffer.flush();
+}
+
+template<gdwg::text_formattable N, gdwg::text_formattable E>
+auto gdwg::write_graphml(std::ostream& out, graph<N, E> const& g) -> void {
+	auto buffer = output_buffer{out};
+	auto& text = buffer.text();
+	auto scratch = std::string{};
+	auto const& escaped = [&text, &scratch](auto const& value) {
+		scratch.clear();
+		text_formatter<std::remove_cvref_t<decltype(value)>>::append(scratch, value);
+		escape_xml(text, scratch);
+	};
+	auto const* weight_type = "string";
+	if constexpr (std::floating_point<E>)
+		weight_type = "double";
+	else if constexpr (std::integral<E>)
+		weight_type = sizeof(E) <= 4 ? "int" : "long";
+	text += "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+	        "<graphml xmlns=\"http://graphml.graphdrawing.org/xmlns\">\n"
+	        "\t<key id=\"weight\" for=\"edge\" attr.name=\"weight\" attr.type=\"";
+	text += weight_type;
+	text += "\"/>\n"
+	        "\t<graph edgedefault=\"directed\">\n";
+	g.for_each_node([&](N const& node) {
+		text += "\t\t<node id=\"";
+		escaped(node);
+		text += "\"/>\n";
+		buffer.commit();
+	});
+	g.for_each_edge([&](N const& src, N const& dst, std::optional<E> const& weight) {
+		text += "\t\t<edge source=\"";
+		escaped(src);
+		text += "\" target=\"";
+		escaped(dst);
+		if (weight) {
+			text += "\"><data key=\"weight\">";
+			escaped(*weight);
+			text += "</data></edge>\n";
+		}
+		else {
+			text += "\"/>\n";
+		}
+		buffer.commit();
+	});
+	text += "\t</graph>\n"
+	        "</graphml>\n";
+	buffer.flush();
+}
+
+template<gdwg::text_formattable N, gdwg::text_formattable E>
+auto gdwg::write_jsonl(std::ostream& out, graph<N, E> const& g) -> void {
+	auto buffer = output_buffer{out};
+	auto& text = buffer.text();
+	auto scratch = std::string{};
+	auto const& value = [&text, &scratch](auto const& v) {
+		using formatter = text_formatter<std::remove_cvref_t<decltype(v)>>;
+		if constexpr (formatter::numeric) {
+			if constexpr (std::floating_point<std::remove_cvref_t<decltype(v)>>) {
+				if (not std::isfinite(v)) {
+					text += "null";
+					return;
+				}
+			}
+			formatter::append(text, v);
+		}
+		else {
+			scratch.clear();
+			formatter::append(scratch, v);
+			text += '"';
+			escape_json(text, scratch);
+			text += '"';
+		}
+	};
+	g.for_each_node([&](N const& node) {
+		text += "{\"node\":";
+		value(node);
+		text += "}\n";
+		buffer.commit();
+	});
+	g.for_each_edge([&](N const& src, N const& dst, std::optional<E> const& weight) {
+		text += "{\"src\":";
+		value(src);
+		text += ",\"dst\":";
+		value(dst);
+		if (weight) {
+			text += ",\"weight\":";
+			value(*weight);
+		}
+		text += "}\n";
+		buffer.commit();
+	});
+	buffer.flush();
+}
+
+#endif // GDWG_IO_H
@@ -0,0 +1,508 @@
+#include "gdwg_io.h"
+#include "gdwg_testing.h"
+
+#include <catch2/catch.hpp>
+
+#include <csignal>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+
+#include <sys/resource.h>
+
+namespace {
+	using gdwg::testing::scratch_file;
+} // namespace
+
+TEST_CASE("Text parser operation", "[io]") {
+	SECTION("Numbers must fill the whole field") {
+		REQUIRE(gdwg::text_parser<int>::parse("-42") == -42);
+		REQUIRE(gdwg::text_parser<int>::parse("+7") == 7);
+		REQUIRE(gdwg::text_parser<double>::parse("2.5e3") == 2500.0);
+		REQUIRE_FALSE(gdwg::text_parser<int>::parse("4x"));
+		REQUIRE_FALSE(gdwg::text_parser<int>::parse(""));
+		REQUIRE_FALSE(gdwg::text_parser<unsigned char>::parse("300"));
+	}
+
+	SECTION("Strings are parsed as views") {
+		auto const field = std::string_view{"abc"};
+		auto const token = gdwg::text_parser<std::string>::parse(field);
+		REQUIRE(token->data() == field.data());
+		REQUIRE(gdwg::text_parser<std::string>::make(*token) == "abc");
+		STATIC_REQUIRE(gdwg::text_parsable<std::string>);
+		STATIC_REQUIRE_FALSE(gdwg::text_parsable<std::vector<int>>);
+	}
+}
+
+TEST_CASE("Text splitting operation", "[io]") {
+	SECTION("Chunks end at line endings and cover the text") {
+		auto const text = std::string_view{"a b\nccc d\ne f\ng h\n"};
+		for (auto count = std::size_t{1}; count < 8; ++count) {
+			auto const& chunks = gdwg::split_lines(text, count);
+			REQUIRE(chunks.size() <= count);
+			auto joined = std::string{};
+			for (auto const& chunk : chunks) {
+				REQUIRE(chunk.back() == '\n');
+				joined += chunk;
+			}
+			REQUIRE(joined == text);
+		}
+		REQUIRE(gdwg::split_lines("", 4).empty());
+	}
+
+	SECTION("Lines and fields") {
+		auto in = std::string_view{"a, b\r\n\nlast"};
+		REQUIRE(gdwg::next_line(in) == "a, b");
+		REQUIRE(gdwg::next_line(in) == "");
+		REQUIRE(gdwg::next_line(in) == "last");
+		REQUIRE_FALSE(gdwg::next_line(in));
+		auto fields = std::array<std::string_view, 2>{};
+		REQUIRE(gdwg::split_fields(" x,\ty  z ", fields) == 3);
+		REQUIRE(fields == std::array<std::string_view, 2>{"x", "y"});
+		REQUIRE(gdwg::is_comment("  # note"));
+		REQUIRE(gdwg::is_comment("% note"));
+		REQUIRE(gdwg::is_comment(" \t"));
+		REQUIRE_FALSE(gdwg::is_comment("1 2"));
+	}
+}
+
+TEST_CASE("Edge list read operation", "[io]") {
+	SECTION("Whitespace and CSV edge lists are read with duplicates removed") {
+		auto const g = gdwg::parse_edge_list<std::string, int>("# comment\n"
+		                                                       "A B 1\n"
+		                                                       "B,C,2\r\n"
+		                                                       "\n"
+		                                                       "C\tA\n"
+		                                                       "A B 1\n"
+		                                                       "A B\n");
+		auto expected = gdwg::graph<std::string, int>{"A", "B", "C"};
+		expected.insert_edge("A", "B", 1);
+		expected.insert_edge("A", "B");
+		expected.insert_edge("B", "C", 2);
+		expected.insert_edge("C", "A");
+		REQUIRE(g == expected);
+		REQUIRE(g.fingerprint() == expected.fingerprint());
+	}
+
+	SECTION("A header line is skipped") {
+		auto const g = gdwg::parse_edge_list<int, double>("src,dst,weight\n1,2,0.5\n", {.header = true});
+		REQUIRE(g.nodes() == std::vector<int>{1, 2});
+		REQUIRE(g.find(1, 2, 0.5) != g.end());
+	}
+
+	SECTION("Parallel parsing gives the same graph") {
+		auto text = std::string{};
+		auto builder = gdwg::graph_builder<int, int>{};
+		auto rng = std::mt19937{42};
+		for (auto i = 0; i < 5000; ++i) {
+			auto const src = static_cast<int>(rng() % 300);
+			auto const dst = static_cast<int>(rng() % 300);
+			auto const weight = static_cast<int>(rng() % 4);
+			text += std::to_string(src) + ' ' + std::to_string(dst) + ' ' + std::to_string(weight) + '\n';
+			builder.add_edge(src, dst, weight);
+		}
+		auto const expected = builder.build();
+		auto const serial = gdwg::parse_edge_list<int, int>(text, {.threads = 1});
+		auto const parallel = gdwg::parse_edge_list<int, int>(text, {.threads = 8, .chunk_bytes = 64});
+		REQUIRE(serial == expected);
+		REQUIRE(parallel == expected);
+	}
+
+	SECTION("Malformed lines are reported with their line number") {
+		REQUIRE_THROWS_WITH((gdwg::parse_edge_list<int, int>("1 2\n3\n")),
+		                    "Cannot parse edge list line 2: expected src dst [weight]");
+		REQUIRE_THROWS_WITH((gdwg::parse_edge_list<int, int>("1 2\n\n1 x\n")),
+		                    "Cannot parse edge list line 3: invalid node");
+		REQUIRE_THROWS_WITH((gdwg::parse_edge_list<int, int>("1 2 w\n", {.threads = 4, .chunk_bytes = 1})),
+		                    "Cannot parse edge list line 1: invalid weight");
+	}
+
+	SECTION("Files are read through a mapping") {
+		auto const file = scratch_file{"1 2 3\n2 3\n"};
+		auto const g = gdwg::read_edge_list<int, int>(file.path);
+		REQUIRE(g.nodes() == std::vector<int>{1, 2, 3});
+		REQUIRE(g.is_connected(1, 2));
+		REQUIRE(g.is_connected(2, 3));
+		auto const empty = scratch_file{""};
+		REQUIRE(gdwg::read_edge_list<int, int>(empty.path).empty());
+		REQUIRE_THROWS_AS((gdwg::read_edge_list<int, int>(file.path.string() + ".missing")), std::system_error);
+	}
+}
+
+TEST_CASE("Graph builder operation", "[builder]") {
+	SECTION("Nodes and edges are sorted and deduplicated") {
+		auto builder = gdwg::graph_builder<std::string, int>{};
+		builder.add_node("Z");
+		builder.add_edge("B", "A", 2);
+		builder.add_edge("A", "B");
+		builder.add_edge("B", "A", 2);
+		builder.add_node("A");
+		auto expected = gdwg::graph<std::string, int>{"A", "B", "Z"};
+		expected.insert_edge("B", "A", 2);
+		expected.insert_edge("A", "B");
+		REQUIRE(builder.build() == expected);
+		REQUIRE(builder.build().empty());
+	}
+
+	SECTION("from_sorted rejects unsorted input") {
+		using builder = gdwg::graph_builder<int, int>;
+		REQUIRE_NOTHROW(builder::from_sorted({1, 2}, {{0, 1, std::nullopt}, {0, 1, 3}}));
+		REQUIRE_THROWS_AS(builder::from_sorted({2, 1}, {}), std::runtime_error);
+		REQUIRE_THROWS_AS(builder::from_sorted({1, 2}, {{0, 1, 3}, {0, 1, std::nullopt}}), std::runtime_error);
+		REQUIRE_THROWS_AS(builder::from_sorted({1, 2}, {{0, 2, 3}}), std::runtime_error);
+	}
+}
+
+TEST_CASE("Standard format read operation", "[io]") {
+	using graph_type = gdwg::graph<int, double>;
+
+	SECTION("SNAP edge lists are unweighted and ignore extra columns") {
+		auto const g = gdwg::parse_snap<int, double>("# Directed graph\n# FromNodeId\tToNodeId\n0\t1\n1\t2\t1217567877\n");
+		auto expected = graph_type{0, 1, 2};
+		expected.insert_edge(0, 1);
+		expected.insert_edge(1, 2);
+		REQUIRE(g == expected);
+	}
+
+	SECTION("Matrix Market general matrices give one edge per entry") {
+		auto const g = gdwg::parse_matrix_market<int, double>("%%MatrixMarket matrix coordinate real general\n"
+		                                                      "% comment\n"
+		                                                      "3 4 3\n"
+		                                                      "1 2 0.5\n"
+		                                                      "3 1 -2\n"
+		                                                      "2 2 1e1\n");
+		auto expected = graph_type{1, 2, 3, 4};
+		expected.insert_edge(1, 2, 0.5);
+		expected.insert_edge(3, 1, -2.0);
+		expected.insert_edge(2, 2, 10.0);
+		REQUIRE(g == expected);
+	}
+
+	SECTION("Matrix Market symmetric and pattern matrices") {
+		auto const sym = gdwg::parse_matrix_market<int, double>("%%MatrixMarket matrix coordinate integer symmetric\n"
+		                                                        "2 2 2\n2 1 7\n2 2 3\n");
+		auto expected = graph_type{1, 2};
+		expected.insert_edge(2, 1, 7.0);
+		expected.insert_edge(1, 2, 7.0);
+		expected.insert_edge(2, 2, 3.0);
+		REQUIRE(sym == expected);
+
+		auto const skew = gdwg::parse_matrix_market<int, int>("%%MatrixMarket matrix coordinate integer skew-symmetric\n"
+		                                                       "2 2 1\n2 1 7\n");
+		REQUIRE(skew.find(1, 2, -7) != skew.end());
+		REQUIRE(skew.find(2, 1, 7) != skew.end());
+
+		auto const pattern = gdwg::parse_matrix_market<int, double>("%%MatrixMarket matrix coordinate pattern general\n"
+		                                                            "2 2 1\n1 2\n");
+		REQUIRE(pattern.find(1, 2, std::nullopt) != pattern.end());
+	}
+
+	SECTION("Matrix Market errors") {
+		REQUIRE_THROWS_WITH((gdwg::parse_matrix_market<int, double>("%%MatrixMarket matrix array real general\n")),
+		                    "Cannot parse Matrix Market line 1: only coordinate matrices are supported");
+		REQUIRE_THROWS_WITH((gdwg::parse_matrix_market<int, double>("%%MatrixMarket matrix coordinate real general\n"
+		                                                            "2 2 1\n3 1 1.0\n")),
+		                    "Cannot parse Matrix Market line 3: invalid row or column");
+		REQUIRE_THROWS_WITH((gdwg::parse_matrix_market<int, double>("1 2 3\n")),
+		                    "Cannot parse Matrix Market line 1: expected %%MatrixMarket matrix banner");
+		REQUIRE_THROWS_WITH((gdwg::parse_matrix_market<int, int>("%%MatrixMarket matrix coordinate pattern "
+		                                                         "skew-symmetric\n2 2 1\n2 1\n")),
+		                    "Cannot parse Matrix Market line 1: pattern matrices cannot be skew-symmetric");
+	}
+
+	SECTION("METIS graphs list the neighbours of every node") {
+		auto const g = gdwg::parse_metis<int, double>("% a triangle and an isolated node\n"
+		                                              "4 3\n"
+		                                              "2 3\n"
+		                                              "1 3\n"
+		                                              "1 2\n"
+		                                              "\n");
+		auto expected = graph_type{1, 2, 3, 4};
+		for (auto const& [src, dst] : std::vector<std::pair<int, int>>{{1, 2}, {1, 3}, {2, 1}, {2, 3}, {3, 1}, {3, 2}}) {
+			expected.insert_edge(src, dst);
+		}
+		REQUIRE(g == expected);
+	}
+
+	SECTION("METIS graphs with vertex and edge weights") {
+		// fmt 011: vertex weights (two per vertex with ncon 2) and edge weights
+		auto const g = gdwg::parse_metis<int, double>("2 1 011 2\n5 6 2 1.5\n7 8 1 1.5\n");
+		auto expected = graph_type{1, 2};
+		expected.insert_edge(1, 2, 1.5);
+		expected.insert_edge(2, 1, 1.5);
+		REQUIRE(g == expected);
+		REQUIRE_THROWS_WITH((gdwg::parse_metis<int, double>("2 1 1\n2 1.5\n1\n")),
+		                    "Cannot parse METIS line 3: invalid edge weight");
+		REQUIRE_THROWS_WITH((gdwg::parse_metis<int, double>("3 1\n2\n1\n")),
+		                    "Cannot parse METIS line 4: fewer node lines than n");
+		REQUIRE_THROWS_WITH((gdwg::parse_metis<int, double>("1 0\n\n1\n")),
+		                    "Cannot parse METIS line 3: more node lines than n");
+	}
+
+	SECTION("METIS lines are numbered correctly across parallel chunks") {
+		auto text = std::string{"200 199\n"};
+		auto expected = graph_type{};
+		for (auto i = 1; i <= 200; ++i) {
+			expected.insert_node(i);
+		}
+		for (auto i = 1; i <= 200; ++i) {
+			text += i < 200 ? std::to_string(i + 1) + '\n' : std::string{"% last\n\n"};
+			if (i < 200)
+				expected.insert_edge(i, i + 1);
+		}
+		REQUIRE(gdwg::parse_metis<int, double>(text, {.threads = 8, .chunk_bytes = 16}) == expected);
+	}
+
+	SECTION("DIMACS shortest path graphs") {
+		auto const g = gdwg::parse_dimacs<int, double>("c 9th DIMACS challenge\n"
+		                                               "p sp 3 2\n"
+		                                               "c arcs\n"
+		                                               "a 1 2 803\n"
+		                                               "a 2 3 158\n");
+		auto expected = graph_type{1, 2, 3};
+		expected.insert_edge(1, 2, 803.0);
+		expected.insert_edge(2, 3, 158.0);
+		REQUIRE(g == expected);
+		REQUIRE_THROWS_WITH((gdwg::parse_dimacs<int, double>("a 1 2 3\n")),
+		                    "Cannot parse DIMACS line 1: expected p sp n m");
+		REQUIRE_THROWS_WITH((gdwg::parse_dimacs<int, double>("p sp 2 1\na 1 3 1\n")),
+		                    "Cannot parse DIMACS line 2: invalid node");
+	}
+
+	SECTION("Files are read with the parse function of their format") {
+		auto const file = scratch_file{"p sp 2 1\na 1 2 4\n"};
+		auto const g = gdwg::read_graph(file.path, gdwg::parse_dimacs<int, double>);
+		REQUIRE(g.find(1, 2, 4.0) != g.end());
+	}
+}
+
+TEST_CASE("Standard format write operation", "[io]") {
+	auto g = gdwg::graph<std::string, double>{"A", "B \"quoted\"", "C<&>"};
+	g.insert_edge("A", "B \"quoted\"", 1.5);
+	g.insert_edge("A", "C<&>");
+	g.insert_edge("C<&>", "A", 0.1);
+
+	SECTION("Numbers are formatted with to_chars") {
+		auto out = std::string{};
+		gdwg::text_formatter<double>::append(out, 0.1);
+		gdwg::text_formatter<int>::append(out, -42);
+		REQUIRE(out == "0.1-42");
+		STATIC_REQUIRE(gdwg::text_formattable<std::string>);
+		STATIC_REQUIRE_FALSE(gdwg::text_formattable<std::vector<int>>);
+	}
+
+	SECTION("DOT lists every node, then every edge in order") {
+		auto out = std::ostringstream{};
+		gdwg::write_dot(out, g, "my \"graph\"");
+		REQUIRE(out.str()
+		        == "digraph \"my \\\"graph\\\"\" {\n"
+		           "\t\"A\";\n"
+		           "\t\"B \\\"quoted\\\"\";\n"
+		           "\t\"C<&>\";\n"
+		           "\t\"A\" -> \"B \\\"quoted\\\"\" [weight=\"1.5\"];\n"
+		           "\t\"A\" -> \"C<&>\";\n"
+		           "\t\"C<&>\" -> \"A\" [weight=\"0.1\"];\n"
+		           "}\n");
+	}
+
+	SECTION("GraphML escapes node names and types the weight key") {
+		auto out = std::ostringstream{};
+		gdwg::write_graphml(out, g);
+		auto const text = out.str();
+		REQUIRE(text.find("attr.type=\"double\"") != std::string::npos);
+		REQUIRE(text.find("<graph edgedefault=\"directed\">") != std::string::npos);
+		REQUIRE(text.find("\t\t<node id=\"C&lt;&amp;&gt;\"/>\n") != std::string::npos);
+		REQUIRE(text.find("\t\t<edge source=\"A\" target=\"B &quot;quoted&quot;\"><data key=\"weight\">1.5</data></edge>\n")
+		        != std::string::npos);
+		REQUIRE(text.find("\t\t<edge source=\"A\" target=\"C&lt;&amp;&gt;\"/>\n") != std::string::npos);
+		REQUIRE(text.ends_with("\t</graph>\n</graphml>\n"));
+	}
+
+	SECTION("JSON lines leave out missing weights and write numbers bare") {
+		auto out = std::ostringstream{};
+		gdwg::write_jsonl(out, g);
+		REQUIRE(out.str()
+		        == "{\"node\":\"A\"}\n"
+		           "{\"node\":\"B \\\"quoted\\\"\"}\n"
+		           "{\"node\":\"C<&>\"}\n"
+		           "{\"src\":\"A\",\"dst\":\"B \\\"quoted\\\"\",\"weight\":1.5}\n"
+		           "{\"src\":\"A\",\"dst\":\"C<&>\"}\n"
+		           "{\"src\":\"C<&>\",\"dst\":\"A\",\"weight\":0.1}\n");
+		auto numbers = gdwg::graph<int, double>{1, 2};
+		numbers.insert_edge(1, 2, std::numeric_limits<double>::infinity());
+		auto number_out = std::ostringstream{};
+		gdwg::write_jsonl(number_out, numbers);
+		REQUIRE(number_out.str() == "{\"node\":1}\n{\"node\":2}\n{\"src\":1,\"dst\":2,\"weight\":null}\n");
+	}
+
+	SECTION("Large graphs are written through the buffer in pieces") {
+		auto large = gdwg::graph<int, int>{};
+		for (auto i = 0; i < 20000; ++i) {
+			large.insert_node(i);
+			if (i > 0)
+				large.insert_edge(i - 1, i, i);
+		}
+		auto out = std::ostringstream{};
+		gdwg::write_jsonl(out, large);
+		auto const text = out.str();
+		REQUIRE(std::ranges::count(text, '\n') == 39999);
+		REQUIRE(text.ends_with("{\"src\":19998,\"dst\":19999,\"weight\":19999}\n"));
+	}
+
+	SECTION("A failed stream throws") {
+		auto out = std::ostringstream{};
+		out.setstate(std::ios::badbit);
+		REQUIRE_THROWS_AS(gdwg::write_dot(out, g), std::runtime_error);
+	}
+}
+
+TEST_CASE("Asynchronous file operation", "[io]") {
+	auto const file = scratch_file{""};
+	auto data = std::string{};
+	for (auto i = 0; i < 5000; ++i) {
+		data += std::to_string(i) + ' ' + std::to_string(i * 7 % 5000) + '\n';
+	}
+	// Small blocks put many transfers in flight at once
+	auto const uring = gdwg::io_options{.queue_depth = 4, .block_bytes = 1000};
+	auto const blocking = gdwg::io_options{.queue_depth = 4, .block_bytes = 1000, .io_uring = false};
+
+	SECTION("Files round-trip with and without io_uring") {
+		for (auto const& options : {uring, blocking}) {
+			gdwg::write_file(file.path, data, false, options);
+			REQUIRE(std::filesystem::file_size(file.path) == data.size());
+			REQUIRE(gdwg::read_file(file.path, options) == data);
+			REQUIRE(gdwg::read_file(file.path, gdwg::io_options{.io_uring = not options.io_uring}) == data);
+		}
+		gdwg::write_file(file.path, "", true);
+		REQUIRE(gdwg::read_file(file.path).empty());
+	}
+
+	SECTION("Blocks written one at a time are committed atomically") {
+		gdwg::write_file(file.path, "old", false);
+		{
+			auto writer = gdwg::async_writer{file.path, uring};
+			writer.write(std::string{"discarded"});
+		}
+		REQUIRE(gdwg::read_file(file.path) == "old");
+		for (auto const& entry : std::filesystem::directory_iterator{file.path.parent_path()}) {
+			REQUIRE_FALSE(entry.path().string().starts_with(file.path.string() + ".tmp"));
+		}
+		auto writer = gdwg::async_writer{file.path, uring};
+		for (auto i = 0; i < 100; ++i) {
+			writer.write(std::to_string(i) + ',');
+		}
+		REQUIRE(gdwg::read_file(file.path) == "old");
+		writer.commit(true);
+		REQUIRE(writer.size() == gdwg::read_file(file.path).size());
+		REQUIRE(gdwg::read_file(file.path).starts_with("0,1,2,"));
+	}
+
+	SECTION("Writers replacing the same file do not share a temporary file") {
+		auto first = gdwg::async_writer{file.path, uring};
+		auto second = gdwg::async_writer{file.path, blocking};
+		first.write(std::string{"first"});
+		second.write(std::string{"second"});
+		second.commit(false);
+		first.commit(false);
+		REQUIRE(gdwg::read_file(file.path) == "first");
+	}
+
+	SECTION("A failed write is reported once the other writes have completed") {
+		// Writes past the file size limit fail with EFBIG instead of raising SIGXFSZ while it is ignored
+		auto const previous_handler = std::signal(SIGXFSZ, SIG_IGN);
+		auto limit = ::rlimit{};
+		::getrlimit(RLIMIT_FSIZE, &limit);
+		auto const previous_limit = limit;
+		limit.rlim_cur = 10000;
+		::setrlimit(RLIMIT_FSIZE, &limit);
+		for (auto const& options : {uring, blocking}) {
+			auto writer = gdwg::async_writer{file.path, options};
+			REQUIRE_THROWS_AS(
+			    [&] {
+				    writer.write(std::string_view{data});
+				    writer.commit(false);
+			    }(),
+			    std::system_error);
+		}
+		::setrlimit(RLIMIT_FSIZE, &previous_limit);
+		std::signal(SIGXFSZ, previous_handler);
+	}
+
+	SECTION("Graphs are read with asynchronous reads") {
+		gdwg::write_file(file.path, data, false);
+		auto const g = gdwg::read_graph(file.path, gdwg::parse_edge_list<int, int>, {}, uring);
+		REQUIRE(g == gdwg::read_edge_list<int, int>(file.path));
+		REQUIRE_THROWS_AS(gdwg::read_file(file.path.string() + ".missing"), std::system_error);
+		auto const& whole = [](std::string_view text, gdwg::read_options const& options) {
+			return gdwg::parse_edge_list<int, int>(text, options);
+		};
+		REQUIRE(gdwg::read_graph(file.path, whole, {}, uring) == g);
+	}
+
+	SECTION("A file stream reads ahead of what it waits for") {
+		gdwg::write_file(file.path, data, false);
+		auto stream = gdwg::file_stream{file.path, blocking};
+		REQUIRE(stream.text().size() == data.size());
+		REQUIRE(stream.wait(1500) == std::string_view{data}.substr(0, 2000));
+		REQUIRE(stream.arrived() == 2000);
+		auto ahead = gdwg::file_stream{file.path, uring};
+		REQUIRE(ahead.wait(1).size() >= 1000);
+		REQUIRE(ahead.take() == data);
+		REQUIRE(stream.take() == data);
+	}
+
+	SECTION("Graphs are parsed while they are read") {
+		// Comments longer than the first look at a file put the header past it
+		auto const padding = [] {
+			auto text = std::string{};
+			for (auto i = 0; i < 8000; ++i) {
+				text += "% padding\n";
+			}
+			return text;
+		}();
+		auto edge_list = "# comment\nsrc dst weight\n" + data;
+		auto matrix = "%%MatrixMarket matrix coordinate integer general\n" + padding + "5000 5000 5000\n";
+		auto metis = padding + "5000 5000 001\n";
+		auto dimacs = "c 9th DIMACS challenge\np sp 5000 5000\n" + std::string{};
+		for (auto i = 0; i < 5000; ++i) {
+			auto const u = std::to_string(i + 1);
+			auto const v = std::to_string(i * 7 % 5000 + 1);
+			auto const w = std::to_string(i);
+			edge_list += u + ' ' + v + ' ' + w + '\n';
+			matrix += u + ' ' + v + ' ' + w + '\n';
+			metis += v + ' ' + w + '\n';
+			dimacs += "a " + u + ' ' + v + ' ' + w + '\n';
+		}
+		auto const options = gdwg::read_options{.threads = 4, .chunk_bytes = 512};
+		auto const header = gdwg::read_options{.header = true, .threads = 4, .chunk_bytes = 512};
+		for (auto const& io : {uring, blocking}) {
+			gdwg::write_file(file.path, edge_list, false);
+			REQUIRE(gdwg::read_graph(file.path, gdwg::parse_edge_list<int, int>, header, io)
+			        == gdwg::parse_edge_list<int, int>(edge_list, header));
+			gdwg::write_file(file.path, data, false);
+			REQUIRE(gdwg::read_graph(file.path, gdwg::parse_snap<int, int>, options, io)
+			        == gdwg::parse_snap<int, int>(data, options));
+			gdwg::write_file(file.path, matrix, false);
+			REQUIRE(gdwg::read_graph(file.path, gdwg::parse_matrix_market<int, int>, options, io)
+			        == gdwg::parse_matrix_market<int, int>(matrix, options));
+			gdwg::write_file(file.path, metis, false);
+			auto const g = gdwg::read_graph(file.path, gdwg::parse_metis<int, int>, options, io);
+			REQUIRE(g == gdwg::parse_metis<int, int>(metis, options));
+			REQUIRE(std::distance(g.begin(), g.end()) == 5000);
+			gdwg::write_file(file.path, dimacs, false);
+			REQUIRE(gdwg::read_graph(file.path, gdwg::parse_dimacs<int, int>, options, io)
+			        == gdwg::parse_dimacs<int, int>(dimacs, options));
+		}
+	}
+
+	SECTION("Errors in graphs parsed while they are read name the line") {
+		gdwg::write_file(file.path, data + "1 x\n", false);
+		REQUIRE_THROWS_WITH((gdwg::read_graph(file.path, gdwg::parse_edge_list<int, int>, {.chunk_bytes = 512}, uring)),
+		                    "Cannot parse edge list line 5001: invalid node");
+		gdwg::write_file(file.path, "5001 0\n" + std::string(5000, '\n'), false);
+		REQUIRE_THROWS_WITH((gdwg::read_graph(file.path, gdwg::parse_metis<int, int>, {.chunk_bytes = 512}, uring)),
+		                    "Cannot parse METIS line 5002: fewer node lines than n");
+	}
+}
@@ -0,0 +1,77 @@
+#include "gdwg_mapped.h"
+
+namespace {
+	constexpr auto file_magic = std::string_view{"GDWGMAPD"};
+	// Written in native byte order, so a reader with the other order sees it reversed
+	constexpr auto byte_order_tag = std::uint32_t{0x01020304};
+
+	auto align(std::size_t offset) noexcept -> std::size_t {
+		return (offset + 7) / 8 * 8;
+	}
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  MAPPED LAYOUT FUNCTIONS                                                           //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+auto gdwg::mapped_layout::make(std::uint64_t node_count,
+                               std::uint64_t edge_count,
+                               std::size_t node_size,
+                               std::size_t weight_size) noexcept -> mapped_layout {
+	auto layout = mapped_layout{};
+	layout.node_count = node_count;
+	layout.edge_count = edge_count;
+	layout.node_size = node_size;
+	layout.weight_size = weight_size;
+	auto const nodes = static_cast<std::size_t>(node_count);
+	auto const edges = static_cast<std::size_t>(edge_count);
+	layout.nodes = header_size;
+	layout.offsets = align(layout.nodes + nodes * node_size);
+	layout.targets = layout.offsets + (nodes + 1) * sizeof(std::uint64_t);
+	layout.flags = layout.targets + edges * sizeof(std::uint64_t);
+	layout.weights = align(layout.flags + edges);
+	layout.heap = align(layout.weights + edges * weight_size);
+	return layout;
+}
+
+auto gdwg::mapped_layout::read(std::string_view file, std::size_t node_size, std::size_t weight_size)
+    -> mapped_layout {
+	if (file.size() < header_size or not file.starts_with(file_magic))
+		throw std::runtime_error("Cannot call gdwg::mapped_layout::read on a file which is not a mapped graph");
+	auto in = file.substr(file_magic.size());
+	if (mapped_codec<std::uint32_t>::load(in.data(), {}) != byte_order_tag)
+		throw std::runtime_error("Cannot call gdwg::mapped_layout::read on a file written with another byte order");
+	in.remove_prefix(sizeof(std::uint32_t));
+	auto const stored_node_size = serializer<std::uint32_t>::read(in);
+	auto const stored_weight_size = serializer<std::uint32_t>::read(in);
+	if (stored_node_size != node_size or stored_weight_size != weight_size)
+		throw std::runtime_error("Cannot call gdwg::mapped_layout::read on a file written for other node or weight types");
+	in.remove_prefix(sizeof(std::uint32_t));
+	auto const node_count = serializer<std::uint64_t>::read(in);
+	auto const edge_count = serializer<std::uint64_t>::read(in);
+	// Every node and edge takes at least 8 bytes, which bounds the counts before they are multiplied
+	if (node_count > file.size() / 8 or edge_count > file.size() / 8)
+		throw std::runtime_error("Cannot call gdwg::mapped_layout::read on a truncated file");
+	auto const layout = make(node_count, edge_count, node_size, weight_size);
+	if (file.size() < layout.heap)
+		throw std::runtime_error("Cannot call gdwg::mapped_layout::read on a truncated file");
+	// Readers clamp the other offsets and targets, which is only safe if every edge has a source
+	auto const first = mapped_codec<std::uint64_t>::load(file.data() + layout.offsets, {});
+	auto const last = mapped_codec<std::uint64_t>::load(file.data() + layout.targets - sizeof(std::uint64_t), {});
+	if (first != 0 or last != edge_count)
+		throw std::runtime_error("Cannot call gdwg::mapped_layout::read on a corrupt file");
+	return layout;
+}
+
+auto gdwg::mapped_layout::header() const -> std::string {
+	auto out = std::string{file_magic};
+	out.resize(out.size() + sizeof(std::uint32_t));
+	auto unused = std::string{};
+	mapped_codec<std::uint32_t>::store(out.data() + file_magic.size(), byte_order_tag, unused);
+	serializer<std::uint32_t>::write(out, static_cast<std::uint32_t>(node_size));
+	serializer<std::uint32_t>::write(out, static_cast<std::uint32_t>(weight_size));
+	serializer<std::uint32_t>::write(out, 0);
+	serializer<std::uint64_t>::write(out, node_count);
+	serializer<std::uint64_t>::write(out, edge_count);
+	out.resize(header_size);
+	return out;
+}
@@ -0,0 +1,725 @@
+#ifndef GDWG_MAPPED_H
+#	define GDWG_MAPPED_H
+
+#	include "gdwg_graph.h"
+#	include "gdwg_io.h"
+#	include "gdwg_wal.h"
+
+#	include <algorithm>
+#	include <cstddef>
+#	include <cstdint>
+#	include <cstring>
+#	include <filesystem>
+#	include <iterator>
+#	include <numeric>
+#	include <optional>
+#	include <ranges>
+#	include <stdexcept>
+#	include <string>
+#	include <string_view>
+#	include <type_traits>
+#	include <utility>
+#	include <vector>
+
+namespace gdwg {
+	/**
+	 * Customisation point storing values of type T in the fixed-size slots of a mapped graph file. Trivially copyable
+	 * types are stored as their bytes. Strings are stored as an offset and a length into a heap at the end of the
+	 * file, and read back as views of the mapping. Other types need a specialisation with the same members.
+	 */
+	template<typename T>
+	struct mapped_codec;
+
+	/**
+	 * A type with a mapped_codec specialisation.
+	 */
+	template<typename T>
+	concept mappable = requires(char* slot, char const* stored, T const& value, std::string& heap, std::string_view mapped) {
+		typename mapped_codec<T>::view_type;
+		{ mapped_codec<T>::size } -> std::convertible_to<std::size_t>;
+		mapped_codec<T>::store(slot, value, heap);
+		{ mapped_codec<T>::load(stored, mapped) } -> std::same_as<typename mapped_codec<T>::view_type>;
+	};
+
+	template<typename T>
+	requires std::is_trivially_copyable_v<T>
+	struct mapped_codec<T> {
+		using view_type = T;
+		static constexpr std::size_t size = sizeof(T);
+
+		/**
+		 * @brief Copies the bytes of a value into its slot.
+		 *
+		 * @param slot The slot, size bytes long.
+		 * @param value The value.
+		 */
+		static auto store(char* slot, T const& value, std::string&) noexcept -> void;
+
+		/**
+		 * @brief Copies the bytes of a value out of its slot, which need not be aligned.
+		 * @note Marked as [[nodiscard]] because the value is lost if ignored.
+		 *
+		 * @param slot The slot, size bytes long.
+		 * @return The value.
+		 */
+		[[nodiscard]] static auto load(char const* slot, std::string_view) noexcept -> T;
+	};
+
+	template<typename Traits, typename Alloc>
+	struct mapped_codec<std::basic_string<char, Traits, Alloc>> {
+		using view_type = std::basic_string_view<char, Traits>;
+		static constexpr std::size_t size = 2 * sizeof(std::uint64_t);
+
+		/**
+		 * @brief Appends the characters of a string to the heap and stores their offset and length in its slot.
+		 *
+		 * @param slot The slot, size bytes long.
+		 * @param value The string.
+		 * @param heap The heap of the file being written.
+		 */
+		static auto store(char* slot, std::basic_string<char, Traits, Alloc> const& value, std::string& heap) -> void;
+
+		/**
+		 * @brief Returns a view of the characters of a string in the heap.
+		 * @note Marked as [[nodiscard]] because the view is lost if ignored.
+		 *
+		 * @param slot The slot, size bytes long.
+		 * @param heap The heap of the mapped file.
+		 * @return The view.
+		 * @throws std::runtime_error If the string is not inside the heap, as in a corrupt file.
+		 */
+		[[nodiscard]] static auto load(char const* slot, std::string_view heap) -> view_type;
+	};
+
+	/**
+	 * Where the sections of a mapped graph file are. A 64-byte header is followed by the sorted node column, the
+	 * per-node edge offsets, and the destination, weighted-flag and weight columns of the edges in graph order, then
+	 * the string heap. Every section starts 8-byte aligned and its position follows from the counts in the header,
+	 * so opening a file reads nothing else. Columns hold native integers, so files move only between machines of the
+	 * same byte order, which the header records.
+	 */
+	struct mapped_layout {
+		static constexpr std::size_t header_size = 64;
+
+		std::uint64_t node_count = 0;
+		std::uint64_t edge_count = 0;
+		std::size_t node_size = 0;
+		std::size_t weight_size = 0;
+		std::size_t nodes = 0;
+		std::size_t offsets = 0;
+		std::size_t targets = 0;
+		std::size_t flags = 0;
+		std::size_t weights = 0;
+		std::size_t heap = 0;
+
+		/**
+		 * @brief Computes the layout of a file.
+		 * @note Marked as [[nodiscard]] because the layout is lost if ignored.
+		 *
+		 * @param node_count The number of nodes.
+		 * @param edge_count The number of edges.
+		 * @param node_size The size of a node slot.
+		 * @param weight_size The size of a weight slot.
+		 * @return The layout.
+		 */
+		[[nodiscard]] static auto make(std::uint64_t node_count,
+		                               std::uint64_t edge_count,
+		                               std::size_t node_size,
+		                               std::size_t weight_size) noexcept -> mapped_layout;
+
+		/**
+		 * @brief Reads the layout from the header of a file and checks that the file is large enough to hold it, and
+		 * that the offsets of the first node and of the past-the-end node span every edge.
+		 * @note Marked as [[nodiscard]] because the layout is lost if ignored.
+		 *
+		 * Time complexity: O(1).
+		 *
+		 * @param file The contents of the file.
+		 * @param node_size The size of a node slot expected by the reader.
+		 * @param weight_size The size of a weight slot expected by the reader.
+		 * @return The layout.
+		 * @throws std::runtime_error If the file is not a mapped graph with these slot sizes, or is truncated or
+		 * corrupt.
+		 */
+		[[nodiscard]] static auto read(std::string_view file, std::size_t node_size, std::size_t weight_size)
+		    -> mapped_layout;
+
+		/**
+		 * @brief Returns the header recording this layout.
+		 * @note Marked as [[nodiscard]] because the header is lost if ignored.
+		 *
+		 * @return The header, header_size bytes long.
+		 */
+		[[nodiscard]] auto header() const -> std::string;
+	};
+
+	/**
+	 * A read-only graph working directly on a memory-mapped file written by save. Opening a file maps it without
+	 * reading it, so startup takes constant time, and the pages are read on demand from the page cache, which every
+	 * process mapping the same file shares. Nodes are found by binary search over the sorted node column and edges by
+	 * binary search over the destinations of their source. Strings are returned as views of the mapping, valid as
+	 * long as the mapped graph.
+	 */
+	template<mappable N, mappable E>
+	class mapped_graph {
+	 public:
+		using node_view = typename mapped_codec<N>::view_type;
+		using weight_view = typename mapped_codec<E>::view_type;
+
+		class iterator {
+		 public:
+			using value_type = struct {
+				node_view from;
+				node_view to;
+				std::optional<weight_view> weight;
+			};
+			using reference = value_type;
+			using pointer = void;
+			using difference_type = std::ptrdiff_t;
+			using iterator_category = std::bidirectional_iterator_tag;
+
+			/**
+			 * Iterator default constructor
+			 */
+			iterator() = default;
+
+			/**
+			 * @brief Reads the current edge from the mapping.
+			 * @note Marked as [[nodiscard]] because the dereferenced value is important and should not be ignored.
+			 *
+			 * @return The current edge.
+			 */
+			[[nodiscard]] auto operator*() const -> reference;
+
+			/**
+			 * @brief Advances the iterator to the next edge (pre-increment).
+			 * @note Marked as noexcept because it only reads edge offsets.
+			 *
+			 * @return A reference to the incremented iterator.
+			 */
+			auto operator++() noexcept -> iterator&;
+
+			/**
+			 * @brief Advances the iterator to the next edge (post-increment).
+			 *
+			 * @return A copy of the iterator before incrementing.
+			 */
+			auto operator++(int) noexcept -> iterator;
+
+			/**
+			 * @brief Moves the iterator to the previous edge (pre-decrement).
+			 * @note Marked as noexcept because it only reads edge offsets.
+			 *
+			 * @return A reference to the decremented iterator.
+			 */
+			auto operator--() noexcept -> iterator&;
+
+			/**
+			 * @brief Moves the iterator to the previous edge (post-decrement).
+			 *
+			 * @return A copy of the iterator before decrementing.
+			 */
+			auto operator--(int) noexcept -> iterator;
+
+			/**
+			 * @brief Compares two iterators for equality.
+			 * @note Marked as noexcept because it only compares positions.
+			 *
+			 * @param other The iterator to compare with.
+			 * @return True if the iterators are at the same edge, otherwise false.
+			 */
+			auto operator==(iterator const& other) const noexcept -> bool;
+
+		 private:
+			mapped_graph const* graph_ = nullptr;
+			// The source of the current edge, kept in step with the edge so that it never needs a search
+			std::size_t src_ = 0;
+			std::size_t edge_ = 0;
+
+			/**
+			 * @brief Constructs an iterator at an edge.
+			 *
+			 * @param g The mapped graph.
+			 * @param src The source of the edge.
+			 * @param edge The position of the edge.
+			 */
+			iterator(mapped_graph const* g, std::size_t src, std::size_t edge) noexcept;
+
+			friend class mapped_graph;
+		};
+
+		/**
+		 * @brief Maps a file written by save.
+		 * @note Not marked as noexcept because opening the file may fail.
+		 *
+		 * Time complexity: O(1).
+		 *
+		 * @param path The file to map.
+		 * @throws std::system_error If the file could not be mapped.
+		 * @throws std::runtime_error If the file is not a mapped graph of these types.
+		 */
+		explicit mapped_graph(std::filesystem::path const& path);
+
+		/**
+		 * @brief Writes a graph as a file to be mapped, replacing it atomically with asynchronous writes.
+		 *
+		 * Time complexity: O(n + e log n).
+		 *
+		 * @param g The graph to write.
+		 * @param path The file to write.
+		 * @throws std::system_error If the file could not be written.
+		 */
+		static auto save(graph<N, E> const& g, std::filesystem::path const& path) -> void;
+
+		/**
+		 * @brief Checks if a node is in the graph.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 *
+		 * Time complexity: O(log n).
+		 *
+		 * @param value The node to check.
+		 * @return True if the node is in the graph, otherwise false.
+		 */
+		[[nodiscard]] auto is_node(N const& value) const -> bool;
+
+		/**
+		 * @brief Checks if there is an edge from src to dst.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Not marked as noexcept because it throws an exception if src or dst does not exist.
+		 *
+		 * Time complexity: O(log n + log d) where d is the out-degree of src.
+		 *
+		 * @param src The source node.
+		 * @param dst The destination node.
+		 * @return True if the nodes are connected, otherwise false.
+		 */
+		[[nodiscard]] auto is_connected(N const& src, N const& dst) const -> bool;
+
+		/**
+		 * @brief Returns all nodes in ascending order, read lazily from the mapping.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 *
+		 * @return A lazy range of node views.
+		 */
+		[[nodiscard]] auto nodes() const;
+
+		/**
+		 * @brief Returns the nodes connected from src.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Not marked as noexcept because it throws an exception if src does not exist.
+		 *
+		 * Time complexity: O(log n + d) where d is the out-degree of src.
+		 *
+		 * @param src The source node.
+		 * @return Views of the destinations of the edges from src in ascending order, without duplicates.
+		 */
+		[[nodiscard]] auto connections(N const& src) const -> std::vector<node_view>;
+
+		/**
+		 * @brief Finds an edge.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 *
+		 * Time complexity: O(log n + log d + p) where d is the out-degree of src and p the number of edges from src to
+		 * dst.
+		 *
+		 * @param src The source node.
+		 * @param dst The destination node.
+		 * @param weight The weight of the edge, optional.
+		 * @return An iterator to the edge if found, otherwise end iterator.
+		 */
+		[[nodiscard]] auto find(N const& src, N const& dst, std::optional<E> const& weight = std::nullopt) const
+		    -> iterator;
+
+		/**
+		 * @brief Returns an iterator to the first edge.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Marked as noexcept because it only reads edge offsets.
+		 *
+		 * @return The iterator.
+		 */
+		[[nodiscard]] auto begin() const noexcept -> iterator;
+
+		/**
+		 * @brief Returns an iterator past the last edge.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Marked as noexcept because it only reads the counts.
+		 *
+		 * @return The iterator.
+		 */
+		[[nodiscard]] auto end() const noexcept -> iterator;
+
+		/**
+		 * @brief Returns the number of nodes.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Marked as noexcept because the count is in the header.
+		 *
+		 * @return The number of nodes.
+		 */
+		[[nodiscard]] auto node_count() const noexcept -> std::size_t;
+
+		/**
+		 * @brief Returns the number of edges.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Marked as noexcept because the count is in the header.
+		 *
+		 * @return The number of edges.
+		 */
+		[[nodiscard]] auto edge_count() const noexcept -> std::size_t;
+
+		/**
+		 * @brief Checks if there are no nodes.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Marked as noexcept because the count is in the header.
+		 *
+		 * @return True if there are no nodes, otherwise false.
+		 */
+		[[nodiscard]] auto empty() const noexcept -> bool;
+
+	 private:
+		mapped_file file_;
+		mapped_layout layout_;
+		char const* data_;
+		std::string_view heap_;
+
+		/**
+		 * @brief Reads a node from the node column.
+		 *
+		 * @param id The position of the node.
+		 * @return A view of the node.
+		 */
+		[[nodiscard]] auto node_at(std::size_t id) const -> node_view;
+
+		/**
+		 * @brief Reads the position of the first edge of a node, or the number of edges for the past-the-end node.
+		 *
+		 * @param id The position of the node, at most node_count().
+		 * @return The position of the edge.
+		 */
+		[[nodiscard]] auto offset_at(std::size_t id) const noexcept -> std::size_t;
+
+		/**
+		 * @brief Reads the destination of an edge.
+		 *
+		 * @param edge The position of the edge.
+		 * @return The position of the destination node.
+		 */
+		[[nodiscard]] auto target_at(std::size_t edge) const noexcept -> std::size_t;
+
+		/**
+		 * @brief Reads the weight of an edge.
+		 *
+		 * @param edge The position of the edge.
+		 * @return A view of the weight, or std::nullopt if the edge is unweighted.
+		 */
+		[[nodiscard]] auto weight_at(std::size_t edge) const -> std::optional<weight_view>;
+
+		/**
+		 * @brief Finds the position of a node by binary search.
+		 *
+		 * @param value The node.
+		 * @return The position, or std::nullopt if the node is not in the graph.
+		 */
+		[[nodiscard]] auto id_of(N const& value) const -> std::optional<std::size_t>;
+
+		/**
+		 * @brief Finds the first edge from src to a destination at or after dst by binary search.
+		 *
+		 * @param src The position of the source node.
+		 * @param dst The position of the destination node.
+		 * @return The position of the edge, or offset_at(src + 1) if there is none.
+		 */
+		[[nodiscard]] auto lower_edge(std::size_t src, std::size_t dst) const noexcept -> std::size_t;
+	};
+} // namespace gdwg
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  MAPPED CODEC FUNCTIONS                                                            //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename T>
+requires std::is_trivially_copyable_v<T>
+auto gdwg::mapped_codec<T>::store(char* slot, T const& value, std::string&) noexcept -> void {
+	std::memcpy(slot, &value, sizeof(T));
+}
+
+template<typename T>
+requires std::is_trivially_copyable_v<T>
+auto gdwg::mapped_codec<T>::load(char const* slot, std::string_view) noexcept -> T {
+	auto value = T{};
+	std::memcpy(&value, slot, sizeof(T));
+	return value;
+}
+
+template<typename Traits, typename Alloc>
+auto gdwg::mapped_codec<std::basic_string<char, Traits, Alloc>>::store(char* slot,
+                                                                       std::basic_string<char, Traits, Alloc> const& value,
+                                                                       std::string& heap) -> void {
+	mapped_codec<std::uint64_t>::store(slot, heap.size(), heap);
+	mapped_codec<std::uint64_t>::store(slot + sizeof(std::uint64_t), value.size(), heap);
+	heap.append(value.data(), value.size());
+}
+
+template<typename Traits, typename Alloc>
+auto gdwg::mapped_codec<std::basic_string<char, Traits, Alloc>>::load(char const* slot, std::string_view heap)
+    -> view_type {
+	auto const offset = mapped_codec<std::uint64_t>::load(slot, heap);
+	auto const length = mapped_codec<std::uint64_t>::load(slot + sizeof(std::uint64_t), heap);
+	if (offset > heap.size() or length > heap.size() - offset)
+		throw std::runtime_error("Cannot call gdwg::mapped_codec<std::string>::load on a string outside the heap");
+	return view_type{heap.data() + offset, static_cast<std::size_t>(length)};
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  MAPPED GRAPH ITERATOR FUNCTIONS                                                   //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<gdwg::mappable N, gdwg::mappable E>
+gdwg::mapped_graph<N, E>::iterator::iterator(mapped_graph const* g, std::size_t src, std::size_t edge) noexcept
+: graph_{g}
+, src_{src}
+, edge_{edge} {}
+
+template<gdwg::mappable N, gdwg::mappable E>
+auto gdwg::mapped_graph<N, E>::iterator::operator*() const -> reference {
+	return value_type{graph_->node_at(src_), graph_->node_at(graph_->target_at(edge_)), graph_->weight_at(edge_)};
+}
+
+template<gdwg::mappable N, gdwg::mappable E>
+auto gdwg::mapped_graph<N, E>::iterator::operator++() noexcept -> iterator& {
+	++edge_;
+	// Skip the sources whose edges end here, including those without edges
+	while (src_ < graph_->node_count() and graph_->offset_at(src_ + 1) <= edge_) {
+		++src_;
+	}
+	return *this;
+}
+
+template<gdwg::mappable N, gdwg::mappable E>
+auto gdwg::mapped_graph<N, E>::iterator::operator++(int) noexcept -> iterator {
+	auto const copy = *this;
+	++*this;
+	return copy;
+}
+
+template<gdwg::mappable N, gdwg::mappable E>
+auto gdwg::mapped_graph<N, E>::iterator::operator--() noexcept -> iterator& {
+	--edge_;
+	while (graph_->offset_at(src_) > edge_) {
+		--src_;
+	}
+	return *this;
+}
+
+template<gdwg::mappable N, gdwg::mappable E>
+auto gdwg::mapped_graph<N, E>::iterator::operator--(int) noexcept -> iterator {
+	auto const copy = *this;
+	--*this;
+	return copy;
+}
+
+template<gdwg::mappable N, gdwg::mappable E>
+auto gdwg::mapped_graph<N, E>::iterator::operator==(iterator const& other) const noexcept -> bool {
+	return edge_ == other.edge_;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  MAPPED GRAPH FUNCTIONS                                                            //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<gdwg::mappable N, gdwg::mappable E>
+gdwg::mapped_graph<N, E>::mapped_graph(std::filesystem::path const& path)
+: file_{path, access_pattern::random}
+, layout_{mapped_layout::read(file_.contents(), mapped_codec<N>::size, mapped_codec<E>::size)}
+, data_{file_.contents().data()}
+, heap_{file_.contents().substr(layout_.heap)} {}
+
+template<gdwg::mappable N, gdwg::mappable E>
+auto gdwg::mapped_graph<N, E>::save(graph<N, E> const& g, std::filesystem::path const& path) -> void {
+	auto nodes = std::vector<N const*>{};
+	nodes.reserve(g.node_count());
+	g.for_each_node([&nodes](N const& value) { nodes.push_back(&value); });
+	auto const layout = mapped_layout::make(nodes.size(), g.edge_count(), mapped_codec<N>::size, mapped_codec<E>::size);
+	auto const& id_of = [&nodes](N const& value) {
+		auto const& less = [](N const* node, N const& key) { return *node < key; };
+		return static_cast<std::size_t>(std::lower_bound(nodes.begin(), nodes.end(), value, less) - nodes.begin());
+	};
+	// The columns are written in the order of the layout, each padded to where the next one starts
+	auto out = async_writer{path};
+	auto block = layout.header();
+	auto heap = std::string{};
+	auto const& slot = [&out, &block](std::size_t size) {
+		if (block.size() >= out.block_bytes())
+			out.write(std::exchange(block, std::string{}));
+		block.resize(block.size() + size);
+		return block.data() + block.size() - size;
+	};
+	auto const& pad_to = [&out, &block](std::size_t offset) {
+		block.resize(offset - static_cast<std::size_t>(out.size()));
+	};
+	for (auto const* n : nodes) {
+		mapped_codec<N>::store(slot(layout.node_size), *n, heap);
+	}
+	pad_to(layout.offsets);
+	// The offsets are the running totals of the out-degrees
+	auto ends = std::vector<std::uint64_t>(nodes.size() + 1);
+	g.for_each_edge([&](N const& src, N const&, std::optional<E> const&) { ++ends[id_of(src) + 1]; });
+	std::partial_sum(ends.begin(), ends.end(), ends.begin());
+	for (auto const end : ends) {
+		mapped_codec<std::uint64_t>::store(slot(sizeof(std::uint64_t)), end, heap);
+	}
+	g.for_each_edge([&](N const&, N const& dst, std::optional<E> const&) {
+		mapped_codec<std::uint64_t>::store(slot(sizeof(std::uint64_t)), id_of(dst), heap);
+	});
+	g.for_each_edge([&](N const&, N const&, std::optional<E> const& weight) { *slot(1) = weight ? '\1' : '\0'; });
+	pad_to(layout.weights);
+	g.for_each_edge([&](N const&, N const&, std::optional<E> const& weight) {
+		auto* const at = slot(layout.weight_size);
+		if (weight)
+			mapped_codec<E>::store(at, *weight, heap);
+	});
+	pad_to(layout.heap);
+	block += heap;
+	out.write(std::move(block));
+	out.commit(true);
+}
+
+template<gdwg::mappable N, gdwg::mappable E>
+auto gdwg::mapped_graph<N, E>::is_node(N const& value) const -> bool {
+	return id_of(value).has_value();
+}
+
+template<gdwg::mappable N, gdwg::mappable E>
+auto gdwg::mapped_graph<N, E>::is_connected(N const& src, N const& dst) const -> bool {
+	auto const src_id = id_of(src);
+	auto const dst_id = id_of(dst);
+	if (not src_id or not dst_id) {
+		throw std::runtime_error("Cannot call gdwg::mapped_graph<N, E>::is_connected if src or dst node don't exist in "
+		                         "the graph");
+	}
+	auto const edge = lower_edge(*src_id, *dst_id);
+	return edge < offset_at(*src_id + 1) and target_at(edge) == *dst_id;
+}
+
+template<gdwg::mappable N, gdwg::mappable E>
+auto gdwg::mapped_graph<N, E>::nodes() const {
+	return std::views::iota(std::size_t{0}, node_count())
+	       | std::views::transform([this](std::size_t id) { return node_at(id); });
+}
+
+template<gdwg::mappable N, gdwg::mappable E>
+auto gdwg::mapped_graph<N, E>::connections(N const& src) const -> std::vector<node_view> {
+	auto const src_id = id_of(src);
+	if (not src_id)
+		throw std::runtime_error("Cannot call gdwg::mapped_graph<N, E>::connections if src doesn't exist in the graph");
+	auto result = std::vector<node_view>{};
+	auto previous = std::optional<std::size_t>{};
+	for (auto edge = offset_at(*src_id); edge < offset_at(*src_id + 1); ++edge) {
+		auto const dst = target_at(edge);
+		if (previous != dst)
+			result.push_back(node_at(dst));
+		previous = dst;
+	}
+	return result;
+}
+
+template<gdwg::mappable N, gdwg::mappable E>
+auto gdwg::mapped_graph<N, E>::find(N const& src, N const& dst, std::optional<E> const& weight) const -> iterator {
+	auto const src_id = id_of(src);
+	auto const dst_id = id_of(dst);
+	if (not src_id or not dst_id)
+		return end();
+	// Parallel edges are ordered by weight with the unweighted one first, and are few, so scan them
+	auto const last = offset_at(*src_id + 1);
+	for (auto edge = lower_edge(*src_id, *dst_id); edge < last and target_at(edge) == *dst_id; ++edge) {
+		auto const stored = weight_at(edge);
+		if (stored.has_value() == weight.has_value() and (not weight or *weight == *stored))
+			return iterator{this, *src_id, edge};
+	}
+	return end();
+}
+
+template<gdwg::mappable N, gdwg::mappable E>
+auto gdwg::mapped_graph<N, E>::begin() const noexcept -> iterator {
+	auto it = iterator{this, 0, 0};
+	// Start at the source of the first edge, past any nodes without edges
+	while (it.src_ < node_count() and offset_at(it.src_ + 1) == 0) {
+		++it.src_;
+	}
+	return it;
+}
+
+template<gdwg::mappable N, gdwg::mappable E>
+auto gdwg::mapped_graph<N, E>::end() const noexcept -> iterator {
+	return iterator{this, node_count(), edge_count()};
+}
+
+template<gdwg::mappable N, gdwg::mappable E>
+auto gdwg::mapped_graph<N, E>::node_count() const noexcept -> std::size_t {
+	return static_cast<std::size_t>(layout_.node_count);
+}
+
+template<gdwg::mappable N, gdwg::mappable E>
+auto gdwg::mapped_graph<N, E>::edge_count() const noexcept -> std::size_t {
+	return static_cast<std::size_t>(layout_.edge_count);
+}
+
+template<gdwg::mappable N, gdwg::mappable E>
+auto gdwg::mapped_graph<N, E>::empty() const noexcept -> bool {
+	return layout_.node_count == 0;
+}
+
+template<gdwg::mappable N, gdwg::mappable E>
+auto gdwg::mapped_graph<N, E>::node_at(std::size_t id) const -> node_view {
+	return mapped_codec<N>::load(data_ + layout_.nodes + id * layout_.node_size, heap_);
+}
+
+template<gdwg::mappable N, gdwg::mappable E>
+auto gdwg::mapped_graph<N, E>::offset_at(std::size_t id) const noexcept -> std::size_t {
+	// Clamped so that a corrupt offset cannot send a reader outside the edge columns
+	auto const offset = mapped_codec<std::uint64_t>::load(data_ + layout_.offsets + id * sizeof(std::uint64_t), {});
+	return static_cast<std::size_t>(std::min(offset, layout_.edge_count));
+}
+
+template<gdwg::mappable N, gdwg::mappable E>
+auto gdwg::mapped_graph<N, E>::target_at(std::size_t edge) const noexcept -> std::size_t {
+	// Clamped so that a corrupt target cannot send a reader outside the node column. A file with an edge has a node,
+	// as mapped_layout::read checks that the offsets span every edge
+	auto const target = mapped_codec<std::uint64_t>::load(data_ + layout_.targets + edge * sizeof(std::uint64_t), {});
+	return static_cast<std::size_t>(std::min(target, layout_.node_count - 1));
+}
+
+template<gdwg::mappable N, gdwg::mappable E>
+auto gdwg::mapped_graph<N, E>::weight_at(std::size_t edge) const -> std::optional<weight_view> {
+	if (data_[layout_.flags + edge] == '\0')
+		return std::nullopt;
+	return mapped_codec<E>::load(data_ + layout_.weights + edge * layout_.weight_size, heap_);
+}
+
+template<gdwg::mappable N, gdwg::mappable E>
+auto gdwg::mapped_graph<N, E>::id_of(N const& value) const -> std::optional<std::size_t> {
+	auto low = std::size_t{0};
+	auto high = node_count();
+	while (low < high) {
+		auto const mid = low + (high - low) / 2;
+		if (node_at(mid) < value)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+	if (low == node_count() or value < node_at(low))
+		return std::nullopt;
+	return low;
+}
+
+template<gdwg::mappable N, gdwg::mappable E>
+auto gdwg::mapped_graph<N, E>::lower_edge(std::size_t src, std::size_t dst) const noexcept -> std::size_t {
+	auto low = offset_at(src);
+	auto high = std::max(low, offset_at(src + 1));
+	while (low < high) {
+		auto const mid = low + (high - low) / 2;
+		if (target_at(mid) < dst)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+	return low;
+}
+
+#endif // GDWG_MAPPED_H
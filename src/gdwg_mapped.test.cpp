@@ -0,0 +1,117 @@
+#include "gdwg_mapped.h"
+#include "gdwg_testing.h"
+
+#include <catch2/catch.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace {
+	using gdwg::testing::sample;
+	using gdwg::testing::scratch_path;
+} // namespace
+
+TEST_CASE("Mapped graph operation", "[mapped]") {
+	auto const file = scratch_path{};
+	auto const g = sample();
+	gdwg::mapped_graph<std::string, int>::save(g, file.path);
+	auto const m = gdwg::mapped_graph<std::string, int>{file.path};
+
+	SECTION("Nodes are read from the mapping") {
+		REQUIRE(m.node_count() == 5);
+		REQUIRE(m.edge_count() == 8);
+		REQUIRE_FALSE(m.empty());
+		REQUIRE(std::ranges::equal(m.nodes(), g.nodes()));
+		REQUIRE(m.is_node("E"));
+		REQUIRE_FALSE(m.is_node("F"));
+		REQUIRE_FALSE(m.is_node(""));
+	}
+
+	SECTION("Connections and edges match the graph") {
+		for (auto const& src : g.nodes()) {
+			REQUIRE(std::ranges::equal(m.connections(src), g.connections(src)));
+			for (auto const& dst : g.nodes()) {
+				REQUIRE(m.is_connected(src, dst) == g.is_connected(src, dst));
+			}
+		}
+		REQUIRE_THROWS_WITH(m.is_connected("A", "F"),
+		                    "Cannot call gdwg::mapped_graph<N, E>::is_connected if src or dst node don't exist in the "
+		                    "graph");
+		REQUIRE_THROWS_WITH(m.connections("F"),
+		                    "Cannot call gdwg::mapped_graph<N, E>::connections if src doesn't exist in the graph");
+	}
+
+	SECTION("Edges iterate in graph order in both directions") {
+		auto expected = g.begin();
+		for (auto const& [from, to, weight] : m) {
+			auto const& edge = *expected++;
+			REQUIRE(from == edge.from);
+			REQUIRE(to == edge.to);
+			REQUIRE(weight == edge.weight);
+		}
+		REQUIRE(expected == g.end());
+		auto last = m.end();
+		--last;
+		REQUIRE((*last).from == "D");
+		REQUIRE((*last).weight == -2);
+		REQUIRE(std::distance(m.begin(), m.end()) == 8);
+	}
+
+	SECTION("find locates weighted and unweighted edges") {
+		auto const unweighted = m.find("A", "B");
+		REQUIRE(unweighted != m.end());
+		REQUIRE_FALSE((*unweighted).weight);
+		auto const weighted = m.find("A", "B", 1);
+		REQUIRE((*weighted).weight == 1);
+		REQUIRE(std::next(unweighted) == weighted);
+		REQUIRE((*m.find("D", "A")).to == "A");
+		REQUIRE(m.find("A", "B", 5) == m.end());
+		REQUIRE(m.find("A", "F") == m.end());
+		REQUIRE(m.find("E", "A") == m.end());
+	}
+
+	SECTION("Trivially copyable nodes and weights are stored inline") {
+		auto const numbers_file = scratch_path{};
+		auto numbers = gdwg::graph<int, double>{3, 1, 2};
+		numbers.insert_edge(1, 3, 0.5);
+		numbers.insert_edge(3, 2);
+		gdwg::mapped_graph<int, double>::save(numbers, numbers_file.path);
+		auto const mapped = gdwg::mapped_graph<int, double>{numbers_file.path};
+		REQUIRE(std::ranges::equal(mapped.nodes(), std::vector{1, 2, 3}));
+		REQUIRE(mapped.is_connected(1, 3));
+		REQUIRE_FALSE(mapped.is_connected(3, 1));
+		REQUIRE((*mapped.find(1, 3, 0.5)).weight == 0.5);
+		REQUIRE(mapped.connections(3) == std::vector{2});
+	}
+
+	SECTION("Corrupt offsets and targets stay inside the mapping") {
+		auto const corrupt_file = scratch_path{};
+		gdwg::mapped_graph<std::string, int>::save(g, corrupt_file.path);
+		auto const layout = gdwg::mapped_layout::make(5, 8, gdwg::mapped_codec<std::string>::size, sizeof(int));
+		auto const overwrite = [&corrupt_file](std::size_t offset) {
+			auto out = std::fstream{corrupt_file.path, std::ios::binary | std::ios::in | std::ios::out};
+			out.seekp(static_cast<std::streamoff>(offset));
+			out.write("\xff\xff\xff\xff\xff\xff\xff\x7f", 8);
+		};
+		overwrite(layout.targets);
+		auto const corrupt = gdwg::mapped_graph<std::string, int>{corrupt_file.path};
+		REQUIRE(std::distance(corrupt.begin(), corrupt.end()) == 8);
+		REQUIRE(corrupt.connections("A").front() == "E");
+		overwrite(layout.targets - sizeof(std::uint64_t));
+		REQUIRE_THROWS_WITH((gdwg::mapped_graph<std::string, int>{corrupt_file.path}),
+		                    "Cannot call gdwg::mapped_layout::read on a corrupt file");
+	}
+
+	SECTION("Empty graphs and mismatched files") {
+		auto const empty_file = scratch_path{};
+		gdwg::mapped_graph<std::string, int>::save(gdwg::graph<std::string, int>{}, empty_file.path);
+		auto const empty = gdwg::mapped_graph<std::string, int>{empty_file.path};
+		REQUIRE(empty.empty());
+		REQUIRE(empty.begin() == empty.end());
+		REQUIRE_THROWS_AS((gdwg::mapped_graph<std::string, double>{file.path}), std::runtime_error);
+		std::filesystem::resize_file(file.path, 100);
+		REQUIRE_THROWS_AS((gdwg::mapped_graph<std::string, int>{file.path}), std::runtime_error);
+		REQUIRE_THROWS_AS((gdwg::mapped_graph<std::string, int>{empty_file.path / "missing"}), std::system_error);
+	}
+}
@@ -0,0 +1,248 @@
+#include "gdwg_parallel.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <new>
+#include <system_error>
+#include <thread>
+
+#include <pthread.h>
+#include <sched.h>
+
+namespace {
+	// Rounds of looking for a task, yielding in between, before an idle worker goes to sleep
+	constexpr auto idle_rounds = 64;
+} // namespace
+
+struct gdwg::work_stealing_pool::job {
+	std::function<void(std::size_t)> const* fn;
+	// Indices not yet run or skipped; whoever brings it to 0 wakes the caller
+	std::atomic<std::size_t> remaining;
+	std::atomic<bool> failed;
+	std::exception_ptr error;
+};
+
+struct gdwg::work_stealing_pool::task {
+	std::shared_ptr<job> owner;
+	std::size_t begin;
+	std::size_t end;
+};
+
+struct gdwg::work_stealing_pool::worker {
+	work_stealing_deque<task*> deque;
+	std::thread thread;
+	// Where to start looking for a victim, so that thieves spread over the workers
+	std::size_t next_victim = 0;
+};
+
+thread_local gdwg::work_stealing_pool const* gdwg::work_stealing_pool::current_pool_ = nullptr;
+thread_local gdwg::work_stealing_pool::worker* gdwg::work_stealing_pool::current_worker_ = nullptr;
+
+auto gdwg::parallel_threads(std::size_t threads) noexcept -> std::size_t {
+	return threads == 0 ? std::size_t{std::max(std::thread::hardware_concurrency(), 1U)} : threads;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  INLINE EXECUTOR FUNCTIONS                                                         //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+auto gdwg::inline_executor::concurrency() const noexcept -> std::size_t {
+	return 1;
+}
+
+auto gdwg::inline_executor::bulk(std::size_t count, std::function<void(std::size_t)> const& fn) -> void {
+	for (auto i = std::size_t{0}; i < count; ++i) {
+		fn(i);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  WORK STEALING POOL FUNCTIONS                                                      //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+gdwg::work_stealing_pool::work_stealing_pool(pool_options const& options)
+: injected_{0}
+, epoch_{0}
+, stopping_{false}
+, steals_{0} {
+	auto const threads = parallel_threads(options.threads);
+	auto allowed = cpu_set_t{};
+	if (options.pin and ::sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+		throw std::system_error(errno, std::generic_category(), "Cannot construct gdwg::work_stealing_pool");
+	auto cpus = std::vector<std::size_t>{};
+	for (auto cpu = std::size_t{0}; options.pin and cpu < std::size_t{CPU_SETSIZE}; ++cpu) {
+		if (CPU_ISSET(cpu, &allowed))
+			cpus.push_back(cpu);
+	}
+	workers_.reserve(threads);
+	for (auto i = std::size_t{0}; i < threads; ++i) {
+		workers_.push_back(std::make_unique<worker>());
+	}
+	try {
+		for (auto i = std::size_t{0}; i < threads; ++i) {
+			auto& thread = workers_[i]->thread;
+			thread = std::thread([this, i] { run_worker(i); });
+			if (not options.pin)
+				continue;
+			auto set = cpu_set_t{};
+			CPU_ZERO(&set);
+			CPU_SET(cpus[i % cpus.size()], &set);
+			if (auto const error = ::pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set); error != 0)
+				throw std::system_error(error, std::generic_category(), "Cannot construct gdwg::work_stealing_pool");
+		}
+	} catch (...) {
+		stop();
+		throw;
+	}
+}
+
+gdwg::work_stealing_pool::~work_stealing_pool() {
+	stop();
+}
+
+auto gdwg::work_stealing_pool::concurrency() const noexcept -> std::size_t {
+	return workers_.size();
+}
+
+auto gdwg::work_stealing_pool::bulk(std::size_t count, std::function<void(std::size_t)> const& fn) -> void {
+	if (count == 0)
+		return;
+	auto const owner = std::make_shared<job>(&fn, count, false, nullptr);
+	auto root = std::make_unique<task>(owner, 0, count);
+	auto* const self = current_pool_ == this ? current_worker_ : nullptr;
+	if (self != nullptr) {
+		self->deque.push(root.get());
+		root.release();
+		signal();
+		// Waiting would tie up the worker, and the tasks waited for may be behind this one, so it helps instead
+		for (auto remaining = owner->remaining.load(std::memory_order_acquire); remaining != 0;
+		     remaining = owner->remaining.load(std::memory_order_acquire))
+		{
+			if (auto* const next = find_task(self))
+				execute(next, self);
+			else
+				std::this_thread::yield();
+		}
+	}
+	else {
+		{
+			auto const lock = std::lock_guard{injection_mutex_};
+			injection_.push_back(root.get());
+			root.release();
+			injected_.fetch_add(1, std::memory_order_release);
+		}
+		signal();
+		for (auto remaining = owner->remaining.load(std::memory_order_acquire); remaining != 0;
+		     remaining = owner->remaining.load(std::memory_order_acquire))
+		{
+			owner->remaining.wait(remaining, std::memory_order_acquire);
+		}
+	}
+	if (owner->error)
+		std::rethrow_exception(owner->error);
+}
+
+auto gdwg::work_stealing_pool::steals() const noexcept -> std::size_t {
+	return steals_.load(std::memory_order_relaxed);
+}
+
+auto gdwg::work_stealing_pool::run_worker(std::size_t index) -> void {
+	auto* const self = workers_[index].get();
+	current_pool_ = this;
+	current_worker_ = self;
+	auto idle = 0;
+	while (true) {
+		// Read before looking, so that a task queued after the last look changes it and cuts the wait short
+		auto const seen = epoch_.load(std::memory_order_acquire);
+		if (auto* const next = find_task(self)) {
+			execute(next, self);
+			idle = 0;
+			continue;
+		}
+		if (stopping_.load(std::memory_order_acquire))
+			return;
+		if (++idle < idle_rounds) {
+			std::this_thread::yield();
+			continue;
+		}
+		epoch_.wait(seen, std::memory_order_acquire);
+		idle = 0;
+	}
+}
+
+auto gdwg::work_stealing_pool::find_task(worker* self) -> task* {
+	if (auto* const own = self->deque.pop())
+		return own;
+	for (auto i = std::size_t{0}; i < workers_.size(); ++i) {
+		auto* const victim = workers_[(self->next_victim + i) % workers_.size()].get();
+		if (victim == self)
+			continue;
+		if (auto* const stolen = victim->deque.steal()) {
+			self->next_victim = (self->next_victim + i) % workers_.size();
+			steals_.fetch_add(1, std::memory_order_relaxed);
+			return stolen;
+		}
+	}
+	// Checked before locking, so that idle workers looking for tasks do not contend for the mutex
+	if (injected_.load(std::memory_order_acquire) == 0)
+		return nullptr;
+	auto const lock = std::lock_guard{injection_mutex_};
+	if (injection_.empty())
+		return nullptr;
+	auto* const next = injection_.front();
+	injection_.pop_front();
+	injected_.fetch_sub(1, std::memory_order_relaxed);
+	return next;
+}
+
+auto gdwg::work_stealing_pool::execute(task* next, worker* self) noexcept -> void {
+	auto const current = std::unique_ptr<task>{next};
+	auto& owner = *current->owner;
+	auto const begin = current->begin;
+	auto end = current->end;
+	// Split off upper halves for idle workers to steal, until a single index is left to run
+	try {
+		while (end - begin > 1) {
+			auto const middle = begin + (end - begin) / 2;
+			auto half = std::make_unique<task>(current->owner, middle, end);
+			self->deque.push(half.get());
+			half.release();
+			signal();
+			end = middle;
+		}
+	} catch (std::bad_alloc const&) {
+		// Without memory to split, the rest of the range runs here
+	}
+	for (auto i = begin; i < end and not owner.failed.load(std::memory_order_relaxed); ++i) {
+		try {
+			(*owner.fn)(i);
+		} catch (...) {
+			if (not owner.failed.exchange(true, std::memory_order_relaxed))
+				owner.error = std::current_exception();
+		}
+	}
+	// The job stays alive through current until after the caller has been woken
+	if (owner.remaining.fetch_sub(end - begin, std::memory_order_acq_rel) == end - begin)
+		owner.remaining.notify_all();
+}
+
+auto gdwg::work_stealing_pool::signal() noexcept -> void {
+	epoch_.fetch_add(1, std::memory_order_release);
+	epoch_.notify_all();
+}
+
+auto gdwg::work_stealing_pool::stop() noexcept -> void {
+	stopping_.store(true, std::memory_order_release);
+	signal();
+	for (auto& w : workers_) {
+		if (w->thread.joinable())
+			w->thread.join();
+	}
+}
+
+auto gdwg::default_executor() -> executor& {
+	static auto pool = work_stealing_pool{};
+	return pool;
+}
+
+auto gdwg::default_chunk_count(executor const& ex, std::size_t count) noexcept -> std::size_t {
+	return std::min(count, 4 * ex.concurrency());
+}
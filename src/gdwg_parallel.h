@@ -0,0 +1,1267 @@
+#ifndef GDWG_PARALLEL_H
+#	define GDWG_PARALLEL_H
+
+#	include "gdwg_graph.h"
+
+#	include <algorithm>
+#	include <atomic>
+#	include <bit>
+#	include <cmath>
+#	include <cstddef>
+#	include <cstdint>
+#	include <deque>
+#	include <functional>
+#	include <iterator>
+#	include <limits>
+#	include <map>
+#	include <memory>
+#	include <mutex>
+#	include <numeric>
+#	include <optional>
+#	include <stdexcept>
+#	include <tuple>
+#	include <type_traits>
+#	include <unordered_map>
+#	include <utility>
+#	include <vector>
+
+namespace gdwg {
+	/**
+	 * @brief Resolves a requested number of threads.
+	 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+	 * Marked as noexcept because it only queries the hardware.
+	 *
+	 * @param threads The requested number of threads, 0 for one per hardware thread.
+	 * @return The number of threads to use, at least 1.
+	 */
+	[[nodiscard]] auto parallel_threads(std::size_t threads) noexcept -> std::size_t;
+
+	/**
+	 * Runs the tasks of the parallel graph operations. Every parallel operation takes an executor, default_executor()
+	 * unless another one is given, so that all of them share one set of threads instead of starting their own.
+	 * Derive from it to run the operations on threads managed elsewhere.
+	 */
+	class executor {
+	 public:
+		/**
+		 * Virtual destructor, as executors are used through references to this interface.
+		 */
+		virtual ~executor() = default;
+
+		/**
+		 * @brief Returns how many tasks the executor runs at once, which the parallel operations split their work by.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 *
+		 * @return The number of tasks run at once, at least 1.
+		 */
+		[[nodiscard]] virtual auto concurrency() const noexcept -> std::size_t = 0;
+
+		/**
+		 * @brief Calls a function with every index below count, possibly at the same time on different threads, and
+		 * returns once every call has finished. Once a call has thrown, the calls not yet started may be skipped, and
+		 * the first exception is rethrown. Called from inside one of its own tasks, it must not block the thread it
+		 * runs on without running other tasks, as the tasks waited for may be queued behind it.
+		 *
+		 * @param count The number of indices.
+		 * @param fn The function to call with every index.
+		 */
+		virtual auto bulk(std::size_t count, std::function<void(std::size_t)> const& fn) -> void = 0;
+	};
+
+	/**
+	 * An executor which runs every task on the calling thread, one after the other.
+	 */
+	class inline_executor final : public executor {
+	 public:
+		/**
+		 * @brief Returns 1, as one task runs at a time.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 *
+		 * @return 1.
+		 */
+		[[nodiscard]] auto concurrency() const noexcept -> std::size_t override;
+
+		/**
+		 * @brief Calls a function with every index below count in ascending order, stopping at the first exception.
+		 *
+		 * @param count The number of indices.
+		 * @param fn The function to call with every index.
+		 */
+		auto bulk(std::size_t count, std::function<void(std::size_t)> const& fn) -> void override;
+	};
+
+	/**
+	 * A Chase-Lev work-stealing deque of non-null pointers. The thread owning the deque pushes and pops at the
+	 * bottom, while any thread may steal from the top, without a lock. A full ring is replaced by one twice its size;
+	 * replaced rings are kept until the deque is destroyed, as a thief may still be reading from one.
+	 */
+	template<typename T>
+	requires std::is_pointer_v<T>
+	class work_stealing_deque {
+	 public:
+		/**
+		 * @brief Constructs an empty deque.
+		 * @note Not marked as noexcept because allocating the ring may throw std::bad_alloc.
+		 *
+		 * @param capacity The initial capacity, rounded up to a power of two.
+		 */
+		explicit work_stealing_deque(std::size_t capacity = 64);
+
+		/**
+		 * The thieves refer to the deque, so it can be neither copied nor moved.
+		 */
+		work_stealing_deque(work_stealing_deque const&) = delete;
+		auto operator=(work_stealing_deque const&) -> work_stealing_deque& = delete;
+
+		/**
+		 * @brief Destructor.
+		 * @note Defaulted, releases the rings but not the pointers left in them.
+		 */
+		~work_stealing_deque() = default;
+
+		/**
+		 * @brief Pushes a pointer at the bottom. Only the owner may call it.
+		 * @note Not marked as noexcept because growing the ring may throw std::bad_alloc.
+		 *
+		 * Time complexity: O(1) amortised.
+		 *
+		 * @param value The pointer, not null.
+		 */
+		auto push(T value) -> void;
+
+		/**
+		 * @brief Pops the pointer pushed last. Only the owner may call it.
+		 * @note Marked as [[nodiscard]] because the pointer is lost if ignored.
+		 * Marked as noexcept because it only performs atomic operations.
+		 *
+		 * Time complexity: O(1).
+		 *
+		 * @return The pointer, or nullptr if the deque is empty.
+		 */
+		[[nodiscard]] auto pop() noexcept -> T;
+
+		/**
+		 * @brief Steals the pointer pushed first. Any thread may call it.
+		 * @note Marked as [[nodiscard]] because the pointer is lost if ignored.
+		 * Marked as noexcept because it only performs atomic operations.
+		 *
+		 * Time complexity: O(1).
+		 *
+		 * @return The pointer, or nullptr if the deque is empty or another thread took the pointer first.
+		 */
+		[[nodiscard]] auto steal() noexcept -> T;
+
+		/**
+		 * @brief Returns the number of pointers in the deque, which may be stale by the time it is used.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Marked as noexcept because it only performs atomic loads.
+		 *
+		 * @return The number of pointers.
+		 */
+		[[nodiscard]] auto size() const noexcept -> std::size_t;
+
+	 private:
+		struct ring {
+			std::size_t mask;
+			std::unique_ptr<std::atomic<T>[]> slots;
+
+			explicit ring(std::size_t capacity);
+
+			[[nodiscard]] auto slot(std::int64_t index) const noexcept -> std::atomic<T>&;
+		};
+
+		std::atomic<std::int64_t> top_;
+		std::atomic<std::int64_t> bottom_;
+		std::atomic<ring*> ring_;
+		// Every ring ever used, only touched by the owner
+		std::vector<std::unique_ptr<ring>> rings_;
+	};
+
+	/**
+	 * How a work_stealing_pool runs its threads.
+	 */
+	struct pool_options {
+		// Worker threads, 0 for one per hardware thread.
+		std::size_t threads = 0;
+		// True to pin every worker to one of the CPUs the process may run on, in turn.
+		bool pin = false;
+	};
+
+	/**
+	 * An executor running tasks on a fixed set of worker threads, each with a work_stealing_deque. A bulk call is
+	 * split in halves on demand: the worker running a range pushes its upper half for idle workers to steal, and
+	 * goes on with the lower half. A worker which waits for a bulk call of its own runs other tasks meanwhile, so
+	 * parallel operations may nest. Idle workers sleep until a task is pushed.
+	 */
+	class work_stealing_pool final : public executor {
+	 public:
+		/**
+		 * @brief Starts the worker threads.
+		 * @note Not marked as noexcept because starting the threads may throw.
+		 *
+		 * @param options The number of threads and whether to pin them.
+		 * @throws std::system_error If a thread cannot be started or pinned.
+		 */
+		explicit work_stealing_pool(pool_options const& options = {});
+
+		/**
+		 * The workers refer to the pool, so it can be neither copied nor moved.
+		 */
+		work_stealing_pool(work_stealing_pool const&) = delete;
+		auto operator=(work_stealing_pool const&) -> work_stealing_pool& = delete;
+
+		/**
+		 * @brief Destructor. Stops and joins the worker threads, which must not be running a bulk call.
+		 */
+		~work_stealing_pool() override;
+
+		/**
+		 * @brief Returns the number of worker threads.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 *
+		 * @return The number of worker threads.
+		 */
+		[[nodiscard]] auto concurrency() const noexcept -> std::size_t override;
+
+		/**
+		 * @brief Calls a function with every index below count on the worker threads, and returns once every call
+		 * has finished. A calling thread outside the pool sleeps meanwhile, a worker runs other tasks.
+		 *
+		 * Time complexity: O(count / t + log count) on t threads, for a function costing O(1).
+		 *
+		 * @param count The number of indices.
+		 * @param fn The function to call with every index.
+		 */
+		auto bulk(std::size_t count, std::function<void(std::size_t)> const& fn) -> void override;
+
+		/**
+		 * @brief Returns the number of tasks taken from the deque of another worker so far.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 *
+		 * @return The number of steals.
+		 */
+		[[nodiscard]] auto steals() const noexcept -> std::size_t;
+
+	 private:
+		struct job;
+		struct task;
+		struct worker;
+
+		std::vector<std::unique_ptr<worker>> workers_;
+		// Bulk calls from outside the pool enter here, as only a worker may push to its own deque
+		std::mutex injection_mutex_;
+		std::deque<task*> injection_;
+		std::atomic<std::size_t> injected_;
+		// Bumped whenever a task is queued, for idle workers to wait on
+		std::atomic<std::uint64_t> epoch_;
+		std::atomic<bool> stopping_;
+		std::atomic<std::size_t> steals_;
+
+		// The pool and worker the current thread belongs to, if it is a worker
+		static thread_local work_stealing_pool const* current_pool_;
+		static thread_local worker* current_worker_;
+
+		auto run_worker(std::size_t index) -> void;
+		[[nodiscard]] auto find_task(worker* self) -> task*;
+		auto execute(task* next, worker* self) noexcept -> void;
+		auto signal() noexcept -> void;
+		auto stop() noexcept -> void;
+	};
+
+	/**
+	 * @brief Returns the executor shared by the parallel operations unless they are given another one: a
+	 * work_stealing_pool with one thread per hardware thread, started on first use.
+	 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+	 *
+	 * @return The default executor.
+	 */
+	[[nodiscard]] auto default_executor() -> executor&;
+
+	/**
+	 * @brief Returns how many chunks to split count items into for an executor: a few per task it runs at once, so
+	 * that stealing can even out chunks of unequal cost, but never more than the items.
+	 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+	 * Marked as noexcept because it only does arithmetic.
+	 *
+	 * @param ex The executor running the chunks.
+	 * @param count The number of items.
+	 * @return The number of chunks, 0 only if count is 0.
+	 */
+	[[nodiscard]] auto default_chunk_count(executor const& ex, std::size_t count) noexcept -> std::size_t;
+
+	/**
+	 * @brief Calls a function for every index below count, with the indices split into default_chunk_count(ex,
+	 * count) contiguous ranges of about equal size.
+	 * Once a call has thrown the ranges not yet started are skipped, and the exception is rethrown when every
+	 * running range has finished.
+	 *
+	 * Time complexity: O(count / t) on t threads, for a function costing O(1).
+	 *
+	 * @param ex The executor running the ranges.
+	 * @param count The number of indices.
+	 * @param fn The function to run, called with an index.
+	 */
+	template<typename F>
+	auto parallel_for(executor& ex, std::size_t count, F fn) -> void;
+
+	/**
+	 * @brief Sorts a vector on several threads: runs of about equal size are sorted in parallel, then merged
+	 * pairwise, with the merges of each round running in parallel. The sort is not stable.
+	 *
+	 * Time complexity: O((k log k) / t + k log t) for k values on t threads.
+	 *
+	 * @param values The values to sort.
+	 * @param comp The strict weak ordering to sort by.
+	 * @param ex The executor running the sorts and merges.
+	 */
+	template<typename T, typename Compare = std::less<>>
+	auto parallel_sort(std::vector<T>& values, Compare comp = {}, executor& ex = default_executor()) -> void;
+
+	/**
+	 * Builds a graph in bulk from many threads at once. Every thread fills a local_buffer of its own without any
+	 * synchronisation, or hands over a whole batch of edges; build then interns the nodes, sorts and deduplicates
+	 * the edges in parallel, and assembles the graph with graph_builder::from_sorted.
+	 */
+	template<typename N, typename E>
+	class parallel_graph_builder {
+		struct batch {
+			std::vector<N> nodes;
+			std::vector<std::tuple<N, N, std::optional<E>>> edges;
+		};
+
+	 public:
+		/**
+		 * A buffer owned by one thread, which adds nodes and edges to the builder. Adding to it takes no lock,
+		 * so a buffer must not be shared between threads.
+		 */
+		class local_buffer {
+		 public:
+			/**
+			 * @brief Pre-allocates room for the given number of edges.
+			 *
+			 * @param edge_count The number of edges to be added.
+			 */
+			auto reserve(std::size_t edge_count) -> void;
+
+			/**
+			 * @brief Adds a node. Adding a node more than once is allowed.
+			 *
+			 * @param value The node.
+			 */
+			auto add_node(N value) -> void;
+
+			/**
+			 * @brief Adds an edge, along with its nodes. Adding an edge more than once is allowed.
+			 *
+			 * @param src The source node.
+			 * @param dst The destination node.
+			 * @param weight The weight of the edge, optional.
+			 */
+			auto add_edge(N src, N dst, std::optional<E> weight = std::nullopt) -> void;
+
+		 private:
+			friend class parallel_graph_builder;
+
+			explicit local_buffer(batch& buffer) noexcept;
+
+			batch* buffer_;
+		};
+
+		/**
+		 * @brief Constructs an empty builder.
+		 *
+		 * @param ex The executor sorting the nodes and edges at build.
+		 */
+		explicit parallel_graph_builder(executor& ex = default_executor()) noexcept;
+
+		/**
+		 * @brief Returns a new buffer for the calling thread. Safe to call from several threads at once.
+		 * @note Marked as [[nodiscard]] because nothing can be added through a discarded buffer.
+		 *
+		 * Time complexity: O(1) amortised.
+		 *
+		 * @return A buffer adding to this builder, valid until build is called.
+		 */
+		[[nodiscard]] auto local() -> local_buffer;
+
+		/**
+		 * @brief Adds a batch of edges, along with their nodes, without copying them. Safe to call from several
+		 * threads at once.
+		 *
+		 * Time complexity: O(1) amortised.
+		 *
+		 * @param edges The edges, in any order and with duplicates.
+		 */
+		auto add_batch(std::vector<std::tuple<N, N, std::optional<E>>> edges) -> void;
+
+		/**
+		 * @brief Builds the graph from everything added so far, and empties the builder. Every thread adding to
+		 * the builder must have finished first.
+		 * @note Marked as [[nodiscard]] because the graph is lost if ignored.
+		 *
+		 * Time complexity: O(((n + e) log (n + e)) / t + (n + e) log t) for sorting on t threads, after which the
+		 * graph is assembled in O(n + e).
+		 *
+		 * @return A graph with the added nodes and edges.
+		 */
+		[[nodiscard]] auto build() -> graph<N, E>;
+
+	 private:
+		executor* executor_;
+		std::mutex mutex_;
+		// The batches are held by pointer, so that a buffer stays valid while other threads add batches
+		std::vector<std::unique_ptr<batch>> batches_;
+	};
+
+	/**
+	 * Single-source shortest paths by parallel delta-stepping over a graph in compressed sparse row form, with the
+	 * nodes numbered from 0, as run by gdwg::shortest_paths. The out-edges of every node are stored light edges
+	 * first, so that either kind is one contiguous range.
+	 */
+	template<typename E>
+	requires std::is_arithmetic_v<E>
+	class delta_stepping {
+	 public:
+		/**
+		 * @brief Chooses delta for a weight distribution: 2w / d for a mean weight w and mean out-degree d, as Meyer
+		 * and Sanders choose for uniform weights. Integer deltas are rounded up, and delta is never 0.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Marked as noexcept because it only performs arithmetic.
+		 *
+		 * @param mean_weight The mean weight of the edges.
+		 * @param mean_degree The mean out-degree of the nodes.
+		 * @return The bucket width.
+		 */
+		[[nodiscard]] static auto tune(double mean_weight, double mean_degree) noexcept -> E;
+
+		/**
+		 * @brief Takes over a graph, with no distances computed yet.
+		 *
+		 * @param offsets The first edge of every node, followed by the number of edges.
+		 * @param light_ends The end of the light edges of every node, which its heavy edges follow.
+		 * @param targets The destination of every edge.
+		 * @param weights The weight of every edge, not negative.
+		 * @param delta The bucket width, above 0; edges of weight at most delta are light.
+		 */
+		delta_stepping(std::vector<std::size_t> offsets,
+		               std::vector<std::size_t> light_ends,
+		               std::vector<std::size_t> targets,
+		               std::vector<E> weights,
+		               E delta);
+
+		/**
+		 * @brief Computes the distances and predecessors from a source, replacing those of any earlier run.
+		 * @note Not marked as noexcept because allocating the buckets or queueing the tasks may throw.
+		 *
+		 * Time complexity: O(n + e) work for random weights, spread over the threads of ex.
+		 *
+		 * @param source The node to start from.
+		 * @param ex The executor running the relaxations.
+		 */
+		auto run(std::size_t source, executor& ex) -> void;
+
+		/**
+		 * @brief Returns the length of the shortest path to a node from the last source run.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Marked as noexcept because it only performs an atomic load.
+		 *
+		 * @param node The node.
+		 * @return The distance, or std::nullopt if the node was not reached.
+		 */
+		[[nodiscard]] auto distance(std::size_t node) const noexcept -> std::optional<E>;
+
+		/**
+		 * @brief Returns the node before a node on one of its shortest paths from the last source run.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Marked as noexcept because it only performs an atomic load.
+		 *
+		 * @param node The node.
+		 * @return The predecessor, or std::nullopt for the source and for nodes not reached.
+		 */
+		[[nodiscard]] auto predecessor(std::size_t node) const noexcept -> std::optional<std::size_t>;
+
+		/**
+		 * @brief Returns the bucket width.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 * Marked as noexcept because it only returns a member.
+		 *
+		 * @return Delta.
+		 */
+		[[nodiscard]] auto delta() const noexcept -> E;
+
+	 private:
+		static constexpr E unreached = std::numeric_limits<E>::max();
+		static constexpr std::size_t no_node = std::numeric_limits<std::size_t>::max();
+
+		std::vector<std::size_t> offsets_;
+		std::vector<std::size_t> light_ends_;
+		std::vector<std::size_t> targets_;
+		std::vector<E> weights_;
+		E delta_;
+		std::vector<std::atomic<E>> distances_;
+		// The relaxation round which last lowered the distance of every node, which orders the predecessors
+		std::vector<std::atomic<std::size_t>> rounds_;
+		std::vector<std::atomic<std::size_t>> predecessors_;
+
+		/**
+		 * @brief Returns the bucket of a distance.
+		 * @note Marked as noexcept because it only performs arithmetic.
+		 *
+		 * @param distance A distance which has been reached.
+		 * @return The bucket.
+		 */
+		[[nodiscard]] auto bucket_of(E distance) const noexcept -> std::size_t;
+
+		/**
+		 * @brief Relaxes the light or heavy edges of nodes at once, each from the distance it had before the round.
+		 * @note Not marked as noexcept because queueing the tasks may throw.
+		 *
+		 * @param nodes The nodes, each at most once.
+		 * @param bases The distance of every node when the round started.
+		 * @param light True to relax the light edges, false for the heavy edges.
+		 * @param round The number of the round, above that of every earlier round.
+		 * @param ex The executor running the relaxations.
+		 * @return The nodes whose distance the round lowered, each once.
+		 */
+		[[nodiscard]] auto relax(std::vector<std::size_t> const& nodes,
+		                         std::vector<E> const& bases,
+		                         bool light,
+		                         std::size_t round,
+		                         executor& ex) -> std::vector<std::size_t>;
+
+		/**
+		 * @brief Picks the predecessor of every node reached: the smallest node with an edge to it which adds up to
+		 * its distance, and whose distance was last lowered in an earlier round. Rounds decrease along the
+		 * predecessors, so they lead back to the source even across edges of weight 0.
+		 * @note Not marked as noexcept because queueing the tasks may throw.
+		 *
+		 * @param ex The executor running the search.
+		 */
+		auto link(executor& ex) -> void;
+	};
+
+	/**
+	 * The shortest paths from a source to every node it reaches, as computed by gdwg::shortest_paths. Following the
+	 * predecessors back from a node to the source gives one of its shortest paths in reverse.
+	 */
+	template<typename N, typename E>
+	struct shortest_path_tree {
+		// The length of the shortest path to every node reached, the source included with a length of 0.
+		std::map<N, E> distances;
+		// The node before every node reached other than the source, on one of its shortest paths.
+		std::map<N, N> predecessors;
+	};
+
+	/**
+	 * The parallel algorithms over the storage of a graph, which the functions below run. The nodes are split into
+	 * ranges of about equal size, and every task works on one range of nodes and the edges leaving them, which follow
+	 * one another in the edges set.
+	 */
+	template<typename N, typename E>
+	class parallel_algorithms {
+	 public:
+		/**
+		 * @brief Compares two graphs on several threads, see gdwg::parallel_equal.
+		 */
+		[[nodiscard]] static auto equal(graph<N, E> const& a, graph<N, E> const& b, executor& ex) -> bool;
+
+		/**
+		 * @brief Copies a graph on several threads, see gdwg::parallel_copy.
+		 */
+		[[nodiscard]] static auto copy(graph<N, E> const& g, executor& ex) -> graph<N, E>;
+
+		/**
+		 * @brief Finds the shortest paths from a node on several threads, see gdwg::shortest_paths.
+		 */
+		[[nodiscard]] static auto shortest_paths(graph<N, E> const& g, N const& source, executor& ex)
+		    -> shortest_path_tree<N, E>
+		requires std::is_arithmetic_v<E>;
+
+	 private:
+		/**
+		 * @brief Returns the stored nodes of a graph in ascending order, to split them into ranges.
+		 *
+		 * @param g The graph.
+		 * @return The address of every node.
+		 */
+		[[nodiscard]] static auto node_pointers(graph<N, E> const& g) -> std::vector<N const*>;
+	};
+
+	/**
+	 * @brief Compares two graphs for equality on several threads. The nodes are split into ranges of about equal
+	 * size, and every task compares one range of nodes and the edges leaving them. The first mismatch found by any
+	 * task stops the others.
+	 * @note Marked as [[nodiscard]] because the result of the comparison is important and should not be ignored.
+	 * Not marked as noexcept because queueing the tasks may throw.
+	 *
+	 * Time complexity: O(1) if the sizes or fingerprints differ, otherwise O(n + (n + e) / t) on t threads.
+	 *
+	 * @param a The first graph.
+	 * @param b The second graph.
+	 * @param ex The executor running the comparisons.
+	 * @return True if the graphs are equal, otherwise false.
+	 */
+	template<typename N, typename E>
+	[[nodiscard]] auto parallel_equal(graph<N, E> const& a, graph<N, E> const& b, executor& ex = default_executor())
+	    -> bool;
+
+	/**
+	 * @brief Copies a graph on several threads. The nodes are split into ranges of about equal size, and every task
+	 * copies one range of nodes and the edges leaving them, which are then appended to the storage of the copy in
+	 * order without any search. Like the copy constructor, the edges of lazily erased nodes are left out.
+	 * @note Marked as [[nodiscard]] because the copy is lost if ignored.
+	 *
+	 * Time complexity: O(n + ((n + e) log n) / t) on t threads.
+	 *
+	 * @param g The graph to copy.
+	 * @param ex The executor running the copies.
+	 * @return A copy of the graph.
+	 */
+	template<typename N, typename E>
+	[[nodiscard]] auto parallel_copy(graph<N, E> const& g, executor& ex = default_executor()) -> graph<N, E>;
+
+	/**
+	 * @brief Finds the shortest paths from a node to every node it reaches, on several threads, by delta-stepping.
+	 * Nodes wait in buckets of width delta by tentative distance. The lowest bucket is emptied by relaxing the light
+	 * edges, of weight at most delta, of all its nodes at once, again for nodes whose distance drops within the
+	 * bucket; the heavy edges of the nodes it settled are then relaxed once. Distances are lowered with an atomic
+	 * compare-and-swap. Delta is 2w / d for a mean weight w and mean out-degree d, as Meyer and Sanders choose for
+	 * uniform weights, so that a bucket takes about one light edge per path to empty. Unweighted edges have no length
+	 * and are not followed, nor are the edges of lazily erased nodes.
+	 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+	 * Not marked as noexcept because allocating the buckets may throw.
+	 *
+	 * Time complexity: O(n + e) work for random weights, spread over the threads of ex, plus O(n) to number the nodes
+	 * and build the result. Path lengths must stay below std::numeric_limits<E>::max().
+	 *
+	 * @param g The graph.
+	 * @param source The node to start from.
+	 * @param ex The executor running the relaxations.
+	 * @return The distances and predecessors of the nodes reached from source.
+	 * @throws std::runtime_error If source doesn't exist in the graph, or an edge has a negative weight.
+	 */
+	template<typename N, typename E>
+	requires std::is_arithmetic_v<E>
+	[[nodiscard]] auto shortest_paths(graph<N, E> const& g,
+	                                  std::type_identity_t<N> const& source,
+	                                  executor& ex = default_executor()) -> shortest_path_tree<N, E>;
+} // namespace gdwg
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  PARALLEL ALGORITHM FUNCTIONS                                                      //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename F>
+auto gdwg::parallel_for(executor& ex, std::size_t count, F fn) -> void {
+	auto const ranges = default_chunk_count(ex, count);
+	if (ranges == 0)
+		return;
+	ex.bulk(ranges, [&fn, count, ranges](std::size_t range) {
+		for (auto i = count * range / ranges; i < count * (range + 1) / ranges; ++i) {
+			fn(i);
+		}
+	});
+}
+
+template<typename T, typename Compare>
+auto gdwg::parallel_sort(std::vector<T>& values, Compare comp, executor& ex) -> void {
+	// Below this many values per run, a task costs more than the sorting it takes over
+	constexpr auto min_run = std::size_t{1} << 14U;
+	auto const runs = std::min(ex.concurrency(), values.size() / min_run + 1);
+	if (runs <= 1) {
+		std::sort(values.begin(), values.end(), comp);
+		return;
+	}
+	auto bounds = std::vector<std::ptrdiff_t>(runs + 1);
+	for (auto i = std::size_t{0}; i <= runs; ++i) {
+		bounds[i] = static_cast<std::ptrdiff_t>(values.size() * i / runs);
+	}
+	auto const& at = [&values, &bounds](std::size_t run) { return values.begin() + bounds[run]; };
+	ex.bulk(runs, [&](std::size_t run) { std::sort(at(run), at(run + 1), comp); });
+	// Each round merges neighbouring pairs of sorted runs, halving their number
+	for (auto width = std::size_t{1}; width < runs; width *= 2) {
+		ex.bulk((runs + 2 * width - 1) / (2 * width), [&](std::size_t pair) {
+			auto const first = pair * 2 * width;
+			auto const middle = std::min(first + width, runs);
+			auto const last = std::min(first + 2 * width, runs);
+			std::inplace_merge(at(first), at(middle), at(last), comp);
+		});
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  WORK STEALING DEQUE FUNCTIONS                                                     //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename T>
+requires std::is_pointer_v<T>
+gdwg::work_stealing_deque<T>::ring::ring(std::size_t capacity)
+: mask{std::bit_ceil(std::max(capacity, std::size_t{2})) - 1}
+, slots{std::make_unique<std::atomic<T>[]>(mask + 1)} {}
+
+template<typename T>
+requires std::is_pointer_v<T>
+auto gdwg::work_stealing_deque<T>::ring::slot(std::int64_t index) const noexcept -> std::atomic<T>& {
+	return slots[static_cast<std::size_t>(index) & mask];
+}
+
+template<typename T>
+requires std::is_pointer_v<T>
+gdwg::work_stealing_deque<T>::work_stealing_deque(std::size_t capacity)
+: top_{0}
+, bottom_{0}
+, ring_{nullptr} {
+	rings_.push_back(std::make_unique<ring>(capacity));
+	ring_.store(rings_.back().get(), std::memory_order_relaxed);
+}
+
+template<typename T>
+requires std::is_pointer_v<T>
+auto gdwg::work_stealing_deque<T>::push(T value) -> void {
+	auto const bottom = bottom_.load(std::memory_order_relaxed);
+	auto const top = top_.load(std::memory_order_acquire);
+	auto* current = ring_.load(std::memory_order_relaxed);
+	if (bottom - top > static_cast<std::int64_t>(current->mask)) {
+		rings_.reserve(rings_.size() + 1);
+		auto grown = std::make_unique<ring>(2 * (current->mask + 1));
+		for (auto i = top; i < bottom; ++i) {
+			grown->slot(i).store(current->slot(i).load(std::memory_order_relaxed), std::memory_order_relaxed);
+		}
+		current = grown.get();
+		rings_.push_back(std::move(grown));
+		ring_.store(current, std::memory_order_release);
+	}
+	current->slot(bottom).store(value, std::memory_order_relaxed);
+	// Publishes the pointer, and whatever it points to, to the thieves
+	bottom_.store(bottom + 1, std::memory_order_release);
+}
+
+template<typename T>
+requires std::is_pointer_v<T>
+auto gdwg::work_stealing_deque<T>::pop() noexcept -> T {
+	auto const bottom = bottom_.load(std::memory_order_relaxed) - 1;
+	auto* current = ring_.load(std::memory_order_relaxed);
+	// Claiming the bottom slot before reading top must not be reordered, hence sequential consistency with steal
+	bottom_.store(bottom, std::memory_order_seq_cst);
+	auto top = top_.load(std::memory_order_seq_cst);
+	if (top > bottom) {
+		bottom_.store(bottom + 1, std::memory_order_release);
+		return nullptr;
+	}
+	auto value = current->slot(bottom).load(std::memory_order_relaxed);
+	if (top == bottom) {
+		// The last pointer is also in reach of the thieves, whoever moves top first takes it
+		if (not top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			value = nullptr;
+		bottom_.store(bottom + 1, std::memory_order_release);
+	}
+	return value;
+}
+
+template<typename T>
+requires std::is_pointer_v<T>
+auto gdwg::work_stealing_deque<T>::steal() noexcept -> T {
+	auto top = top_.load(std::memory_order_seq_cst);
+	auto const bottom = bottom_.load(std::memory_order_seq_cst);
+	if (top >= bottom)
+		return nullptr;
+	auto const value = ring_.load(std::memory_order_acquire)->slot(top).load(std::memory_order_relaxed);
+	if (not top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+		return nullptr;
+	return value;
+}
+
+template<typename T>
+requires std::is_pointer_v<T>
+auto gdwg::work_stealing_deque<T>::size() const noexcept -> std::size_t {
+	auto const bottom = bottom_.load(std::memory_order_relaxed);
+	auto const top = top_.load(std::memory_order_relaxed);
+	return bottom > top ? static_cast<std::size_t>(bottom - top) : 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  PARALLEL GRAPH BUILDER FUNCTIONS                                                  //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename N, typename E>
+gdwg::parallel_graph_builder<N, E>::local_buffer::local_buffer(batch& buffer) noexcept
+: buffer_{&buffer} {}
+
+template<typename N, typename E>
+auto gdwg::parallel_graph_builder<N, E>::local_buffer::reserve(std::size_t edge_count) -> void {
+	buffer_->edges.reserve(edge_count);
+}
+
+template<typename N, typename E>
+auto gdwg::parallel_graph_builder<N, E>::local_buffer::add_node(N value) -> void {
+	buffer_->nodes.push_back(std::move(value));
+}
+
+template<typename N, typename E>
+auto gdwg::parallel_graph_builder<N, E>::local_buffer::add_edge(N src, N dst, std::optional<E> weight) -> void {
+	buffer_->edges.emplace_back(std::move(src), std::move(dst), std::move(weight));
+}
+
+template<typename N, typename E>
+gdwg::parallel_graph_builder<N, E>::parallel_graph_builder(executor& ex) noexcept
+: executor_{&ex} {}
+
+template<typename N, typename E>
+auto gdwg::parallel_graph_builder<N, E>::local() -> local_buffer {
+	auto buffer = std::make_unique<batch>();
+	auto const lock = std::lock_guard{mutex_};
+	batches_.push_back(std::move(buffer));
+	return local_buffer{*batches_.back()};
+}
+
+template<typename N, typename E>
+auto gdwg::parallel_graph_builder<N, E>::add_batch(std::vector<std::tuple<N, N, std::optional<E>>> edges) -> void {
+	auto buffer = std::make_unique<batch>(batch{{}, std::move(edges)});
+	auto const lock = std::lock_guard{mutex_};
+	batches_.push_back(std::move(buffer));
+}
+
+template<typename N, typename E>
+auto gdwg::parallel_graph_builder<N, E>::build() -> graph<N, E> {
+	auto batches = std::exchange(batches_, {});
+
+	// Intern the nodes: sorting the nodes of all batches together once gives every distinct node its position
+	auto node_count = std::size_t{0};
+	for (auto const& batch : batches) {
+		node_count += batch->nodes.size() + 2 * batch->edges.size();
+	}
+	auto nodes = std::vector<N>{};
+	nodes.reserve(node_count);
+	for (auto const& batch : batches) {
+		std::ranges::move(batch->nodes, std::back_inserter(nodes));
+		batch->nodes = {};
+		for (auto const& [src, dst, weight] : batch->edges) {
+			nodes.push_back(src);
+			nodes.push_back(dst);
+		}
+	}
+	parallel_sort(nodes, std::less<>{}, *executor_);
+	auto const& [last, end] = std::ranges::unique(nodes);
+	nodes.erase(last, end);
+
+	// Map every edge to node positions, in ranges of the concatenated batches of about equal size
+	using indexed_edge = typename graph_builder<N, E>::indexed_edge;
+	auto offsets = std::vector<std::size_t>{0};
+	offsets.reserve(batches.size() + 1);
+	for (auto const& batch : batches) {
+		offsets.push_back(offsets.back() + batch->edges.size());
+	}
+	auto indexed = std::vector<indexed_edge>(offsets.back());
+	auto const& position = [&nodes](N const& value) {
+		return static_cast<std::size_t>(std::ranges::lower_bound(nodes, value, std::less<>{}) - nodes.begin());
+	};
+	parallel_for(*executor_, indexed.size(), [&](std::size_t i) {
+		auto const batch = static_cast<std::size_t>(std::ranges::upper_bound(offsets, i) - offsets.begin()) - 1;
+		auto& [src, dst, weight] = batches[batch]->edges[i - offsets[batch]];
+		indexed[i] = indexed_edge{position(src), position(dst), std::move(weight)};
+	});
+	batches.clear();
+	parallel_sort(indexed, std::less<>{}, *executor_);
+	auto const& [last_edge, end_edge] = std::ranges::unique(indexed);
+	indexed.erase(last_edge, end_edge);
+	return graph_builder<N, E>::from_sorted(std::move(nodes), indexed);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  DELTA STEPPING FUNCTIONS                                                          //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename E>
+requires std::is_arithmetic_v<E>
+auto gdwg::delta_stepping<E>::tune(double mean_weight, double mean_degree) noexcept -> E {
+	auto const delta = 2 * mean_weight / std::max(mean_degree, 1.0);
+	if constexpr (std::is_integral_v<E>) {
+		// Capped at half the range, which converts back to E exactly
+		auto const widest = static_cast<double>(std::numeric_limits<E>::max() / 2);
+		return static_cast<E>(std::clamp(std::ceil(delta), 1.0, widest));
+	}
+	else {
+		auto const width = static_cast<E>(std::min(delta, static_cast<double>(std::numeric_limits<E>::max())));
+		return width > 0 ? width : E{1};
+	}
+}
+
+template<typename E>
+requires std::is_arithmetic_v<E>
+gdwg::delta_stepping<E>::delta_stepping(std::vector<std::size_t> offsets,
+                                        std::vector<std::size_t> light_ends,
+                                        std::vector<std::size_t> targets,
+                                        std::vector<E> weights,
+                                        E delta)
+: offsets_{std::move(offsets)}
+, light_ends_{std::move(light_ends)}
+, targets_{std::move(targets)}
+, weights_{std::move(weights)}
+, delta_{delta}
+, distances_(light_ends_.size())
+, rounds_(light_ends_.size())
+, predecessors_(light_ends_.size()) {}
+
+template<typename E>
+requires std::is_arithmetic_v<E>
+auto gdwg::delta_stepping<E>::run(std::size_t source, executor& ex) -> void {
+	auto const n = light_ends_.size();
+	parallel_for(ex, n, [this](std::size_t v) {
+		distances_[v].store(unreached, std::memory_order_relaxed);
+		rounds_[v].store(0, std::memory_order_relaxed);
+		predecessors_[v].store(no_node, std::memory_order_relaxed);
+	});
+	distances_[source].store(E{}, std::memory_order_relaxed);
+	// Buckets are made as distances reach them, which may leave wide gaps, so only those in use are kept
+	auto buckets = std::map<std::size_t, std::vector<std::size_t>>{{0, {source}}};
+	// The round which last listed every node, and the bucket which last settled it, so that each happens once
+	auto listed = std::vector<std::size_t>(n, 0);
+	auto settled_in = std::vector<std::size_t>(n, no_node);
+	auto bases = std::vector<E>{};
+	auto round = std::size_t{0};
+	while (not buckets.empty()) {
+		auto const bucket = buckets.begin()->first;
+		auto frontier = std::move(buckets.begin()->second);
+		buckets.erase(buckets.begin());
+		auto settled = std::vector<std::size_t>{};
+		while (not frontier.empty()) {
+			++round;
+			bases.clear();
+			auto kept = std::size_t{0};
+			for (auto const v : frontier) {
+				auto const distance = distances_[v].load(std::memory_order_relaxed);
+				// A node whose distance has since dropped into a lower bucket was relaxed there
+				if (listed[v] == round or bucket_of(distance) != bucket)
+					continue;
+				listed[v] = round;
+				frontier[kept++] = v;
+				bases.push_back(distance);
+				if (settled_in[v] != bucket) {
+					settled_in[v] = bucket;
+					settled.push_back(v);
+				}
+			}
+			frontier.resize(kept);
+			auto const lowered = relax(frontier, bases, true, round, ex);
+			frontier.clear();
+			for (auto const v : lowered) {
+				auto const target = bucket_of(distances_[v].load(std::memory_order_relaxed));
+				if (target == bucket)
+					frontier.push_back(v);
+				else
+					buckets[target].push_back(v);
+			}
+		}
+		// Light edges cannot lower the distances of the settled nodes any more, so their heavy edges are relaxed once
+		++round;
+		bases.clear();
+		for (auto const v : settled) {
+			bases.push_back(distances_[v].load(std::memory_order_relaxed));
+		}
+		for (auto const v : relax(settled, bases, false, round, ex)) {
+			buckets[bucket_of(distances_[v].load(std::memory_order_relaxed))].push_back(v);
+		}
+	}
+	link(ex);
+}
+
+template<typename E>
+requires std::is_arithmetic_v<E>
+auto gdwg::delta_stepping<E>::distance(std::size_t node) const noexcept -> std::optional<E> {
+	auto const distance = distances_[node].load(std::memory_order_relaxed);
+	return distance == unreached ? std::nullopt : std::optional<E>{distance};
+}
+
+template<typename E>
+requires std::is_arithmetic_v<E>
+auto gdwg::delta_stepping<E>::predecessor(std::size_t node) const noexcept -> std::optional<std::size_t> {
+	auto const predecessor = predecessors_[node].load(std::memory_order_relaxed);
+	return predecessor == no_node ? std::nullopt : std::optional<std::size_t>{predecessor};
+}
+
+template<typename E>
+requires std::is_arithmetic_v<E>
+auto gdwg::delta_stepping<E>::delta() const noexcept -> E {
+	return delta_;
+}
+
+template<typename E>
+requires std::is_arithmetic_v<E>
+auto gdwg::delta_stepping<E>::bucket_of(E distance) const noexcept -> std::size_t {
+	if constexpr (std::is_floating_point_v<E>) {
+		// Clamped, as the quotient of a long path by a narrow bucket need not fit in std::size_t
+		constexpr auto last_bucket = std::size_t{1} << 62U;
+		auto const bucket = distance / delta_;
+		return bucket < static_cast<E>(last_bucket) ? static_cast<std::size_t>(bucket) : last_bucket;
+	}
+	else {
+		return static_cast<std::size_t>(distance / delta_);
+	}
+}
+
+template<typename E>
+requires std::is_arithmetic_v<E>
+auto gdwg::delta_stepping<E>::relax(std::vector<std::size_t> const& nodes,
+                                    std::vector<E> const& bases,
+                                    bool light,
+                                    std::size_t round,
+                                    executor& ex) -> std::vector<std::size_t> {
+	// Below this many nodes, a task costs more than the relaxations it takes over
+	constexpr auto serial_nodes = std::size_t{256};
+	auto const chunks = nodes.size() < serial_nodes ? std::size_t{1} : default_chunk_count(ex, nodes.size());
+	auto lowered = std::vector<std::vector<std::size_t>>(chunks);
+	auto const& relax_chunk = [&](std::size_t chunk) {
+		auto& found = lowered[chunk];
+		for (auto i = nodes.size() * chunk / chunks; i < nodes.size() * (chunk + 1) / chunks; ++i) {
+			auto const u = nodes[i];
+			auto const last = light ? light_ends_[u] : offsets_[u + 1];
+			for (auto e = light ? offsets_[u] : light_ends_[u]; e < last; ++e) {
+				auto const v = targets_[e];
+				auto const candidate = static_cast<E>(bases[i] + weights_[e]);
+				auto current = distances_[v].load(std::memory_order_relaxed);
+				// Atomic min: a failed exchange reloads current, and is retried only while candidate is still lower
+				while (candidate < current) {
+					if (not distances_[v].compare_exchange_weak(current, candidate, std::memory_order_relaxed))
+						continue;
+					// Only the first task to lower the distance in a round lists the node
+					if (rounds_[v].exchange(round, std::memory_order_relaxed) != round)
+						found.push_back(v);
+					break;
+				}
+			}
+		}
+	};
+	if (chunks == 1)
+		relax_chunk(0);
+	else
+		ex.bulk(chunks, relax_chunk);
+	auto result = std::move(lowered.front());
+	for (auto chunk = std::size_t{1}; chunk < chunks; ++chunk) {
+		result.insert(result.end(), lowered[chunk].begin(), lowered[chunk].end());
+	}
+	return result;
+}
+
+template<typename E>
+requires std::is_arithmetic_v<E>
+auto gdwg::delta_stepping<E>::link(executor& ex) -> void {
+	parallel_for(ex, light_ends_.size(), [this](std::size_t u) {
+		auto const base = distances_[u].load(std::memory_order_relaxed);
+		if (base == unreached)
+			return;
+		auto const round = rounds_[u].load(std::memory_order_relaxed);
+		for (auto e = offsets_[u]; e < offsets_[u + 1]; ++e) {
+			auto const v = targets_[e];
+			if (static_cast<E>(base + weights_[e]) != distances_[v].load(std::memory_order_relaxed)
+			    or round >= rounds_[v].load(std::memory_order_relaxed))
+			{
+				continue;
+			}
+			auto current = predecessors_[v].load(std::memory_order_relaxed);
+			while (u < current and not predecessors_[v].compare_exchange_weak(current, u, std::memory_order_relaxed)) {
+			}
+		}
+	});
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  GRAPH PARALLEL FUNCTIONS                                                          //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename N, typename E>
+auto gdwg::parallel_algorithms<N, E>::node_pointers(graph<N, E> const& g) -> std::vector<N const*> {
+	auto result = std::vector<N const*>{};
+	result.reserve(g.nodes_.size());
+	std::ranges::transform(g.nodes_, std::back_inserter(result), [](auto const& n) { return n.get(); });
+	return result;
+}
+
+template<typename N, typename E>
+auto gdwg::parallel_algorithms<N, E>::equal(graph<N, E> const& a, graph<N, E> const& b, executor& ex) -> bool {
+	auto const& compacted = a.tombstones_.empty() and b.tombstones_.empty();
+	if (a.nodes_.size() != b.nodes_.size() or (compacted and a.edges_.size() != b.edges_.size())) {
+		return false;
+	}
+	if (a.fingerprint() != b.fingerprint()) {
+		return false;
+	}
+	if (a.nodes_.empty()) {
+		return true;
+	}
+	auto const& lhs_nodes = node_pointers(a);
+	auto const& rhs_nodes = node_pointers(b);
+	auto const chunks = default_chunk_count(ex, lhs_nodes.size());
+	auto mismatch = std::atomic<bool>{false};
+	ex.bulk(chunks, [&](std::size_t chunk) {
+		auto const first = lhs_nodes.size() * chunk / chunks;
+		auto const last = lhs_nodes.size() * (chunk + 1) / chunks;
+		for (auto i = first; i < last; ++i) {
+			if (mismatch.load(std::memory_order_relaxed))
+				return;
+			if (*lhs_nodes[i] != *rhs_nodes[i]) {
+				mismatch.store(true, std::memory_order_relaxed);
+				return;
+			}
+		}
+		// The edges leaving the range, which line up in both graphs once their nodes are equal
+		auto const& edges = [first, last](graph<N, E> const& g, std::vector<N const*> const& nodes) {
+			auto const& end = last == nodes.size() ? g.edges_.end() : g.first_out_edge(nodes[last]);
+			return std::ranges::subrange(g.first_out_edge(nodes[first]), end)
+			       | std::views::filter([&g](auto const& e) { return not g.is_tombstoned(e); });
+		};
+		auto lhs = edges(a, lhs_nodes);
+		auto rhs = edges(b, rhs_nodes);
+		auto lhs_it = lhs.begin();
+		auto rhs_it = rhs.begin();
+		for (; lhs_it != lhs.end() and rhs_it != rhs.end(); ++lhs_it, ++rhs_it) {
+			if (mismatch.load(std::memory_order_relaxed))
+				return;
+			if (*std::get<2>(*lhs_it) != *std::get<2>(*rhs_it)) {
+				mismatch.store(true, std::memory_order_relaxed);
+				return;
+			}
+		}
+		if (lhs_it != lhs.end() or rhs_it != rhs.end())
+			mismatch.store(true, std::memory_order_relaxed);
+	});
+	return not mismatch.load();
+}
+
+template<typename N, typename E>
+auto gdwg::parallel_algorithms<N, E>::copy(graph<N, E> const& g, executor& ex) -> graph<N, E> {
+	auto result = graph<N, E>{};
+	// A pooled graph copies into a pool of its own sized for the whole graph, as in deep_copy
+	if (g.pool_) {
+		result.reserve(g.nodes_.size(), g.edges_.size());
+	}
+	auto const& sources = node_pointers(g);
+	auto copies = std::vector<std::shared_ptr<N>>(sources.size());
+	parallel_for(ex, sources.size(), [&](std::size_t i) { copies[i] = result.make_node(*sources[i]); });
+	for (auto const& n : copies) {
+		result.nodes_.insert(result.nodes_.end(), n);
+	}
+
+	auto const chunks = default_chunk_count(ex, sources.size());
+	auto parts = std::vector<std::vector<typename graph<N, E>::edge_tuple>>(chunks);
+	auto const& copy_of = [&copies](N const& value) -> std::shared_ptr<N> const& {
+		return *std::ranges::lower_bound(copies, value, std::less<>{}, [](auto const& n) -> N const& { return *n; });
+	};
+	ex.bulk(chunks, [&](std::size_t chunk) {
+		auto const last = sources.size() * (chunk + 1) / chunks;
+		auto const& end = last == sources.size() ? g.edges_.end() : g.first_out_edge(sources[last]);
+		auto& part = parts[chunk];
+		for (auto it = g.first_out_edge(sources[sources.size() * chunk / chunks]); it != end; ++it) {
+			if (g.is_tombstoned(*it))
+				continue;
+			auto const& [src, dst, edge] = *it;
+			auto const& new_src = copy_of(*src);
+			auto const& new_dst = copy_of(*dst);
+			part.emplace_back(new_src, new_dst, result.make_edge(*new_src, *new_dst, edge->get_weight()));
+		}
+	});
+	// The parts hold consecutive ranges of edges, so every edge is appended at the end in O(1)
+	for (auto& part : parts) {
+		for (auto& e : part) {
+			result.edges_.insert(result.edges_.end(), std::move(e));
+		}
+		part = {};
+	}
+	result.lazy_erase_ = g.lazy_erase_;
+	result.fingerprint_ = g.fingerprint();
+	return result;
+}
+
+template<typename N, typename E>
+auto gdwg::parallel_algorithms<N, E>::shortest_paths(graph<N, E> const& g, N const& source, executor& ex)
+    -> shortest_path_tree<N, E>
+requires std::is_arithmetic_v<E>
+{
+	auto const source_node = g.find_node_ptr(source);
+	if (not source_node)
+		throw std::runtime_error("Cannot call gdwg::shortest_paths if source doesn't exist in the graph");
+	auto const& nodes = node_pointers(g);
+	auto index = std::unordered_map<N const*, std::size_t>{};
+	index.reserve(nodes.size());
+	for (auto const* n : nodes) {
+		index.emplace(n, index.size());
+	}
+	// Walks the live weighted edges leaving a range of nodes, which follow one another in the edges set
+	auto const& for_each_weight = [&g, &nodes](std::size_t first, std::size_t last, auto fn) {
+		auto it = g.edges_.end();
+		for (auto k = first; k < last; ++k) {
+			auto const* const src = nodes[k];
+			// Only a node without edges, or one after the edges of a lazily erased node, needs a search
+			if (it == g.edges_.end() or std::get<0>(*it).get() != src)
+				it = g.first_out_edge(src);
+			for (; it != g.edges_.end() and std::get<0>(*it).get() == src; ++it) {
+				if (g.is_tombstoned(*it))
+					continue;
+				if (auto const weight = std::get<2>(*it)->get_weight())
+					fn(k, std::get<1>(*it).get(), *weight);
+			}
+		}
+	};
+	auto const chunks = default_chunk_count(ex, nodes.size());
+	auto const& first_node = [&nodes, chunks](std::size_t chunk) { return nodes.size() * chunk / chunks; };
+
+	// The degrees are counted first, as delta must be known to put the light edges of a node before the heavy ones
+	auto offsets = std::vector<std::size_t>(nodes.size() + 1);
+	auto sums = std::vector<double>(chunks);
+	ex.bulk(chunks, [&](std::size_t chunk) {
+		auto sum = 0.0;
+		for_each_weight(first_node(chunk), first_node(chunk + 1), [&](std::size_t k, N const*, E weight) {
+			if constexpr (std::is_signed_v<E>) {
+				if (not(weight >= E{}))
+					throw std::runtime_error("Cannot call gdwg::shortest_paths on a graph with a negative weight");
+			}
+			++offsets[k + 1];
+			sum += static_cast<double>(weight);
+		});
+		sums[chunk] = sum;
+	});
+	std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+	auto const edge_count = static_cast<double>(offsets.back());
+	auto const mean_weight = edge_count == 0 ? 0.0 : std::reduce(sums.begin(), sums.end()) / edge_count;
+	auto const delta = delta_stepping<E>::tune(mean_weight, edge_count / static_cast<double>(nodes.size()));
+
+	// Light edges fill the edges of a node from the front and heavy edges from the back
+	auto light_ends = std::vector<std::size_t>(offsets.begin(), offsets.end() - 1);
+	auto heavy_begins = std::vector<std::size_t>(offsets.begin() + 1, offsets.end());
+	auto targets = std::vector<std::size_t>(offsets.back());
+	auto weights = std::vector<E>(offsets.back());
+	ex.bulk(chunks, [&](std::size_t chunk) {
+		for_each_weight(first_node(chunk), first_node(chunk + 1), [&](std::size_t k, N const* dst, E weight) {
+			auto const slot = weight <= delta ? light_ends[k]++ : --heavy_begins[k];
+			targets[slot] = index.find(dst)->second;
+			weights[slot] = weight;
+		});
+	});
+
+	auto paths =
+	    delta_stepping<E>{std::move(offsets), std::move(light_ends), std::move(targets), std::move(weights), delta};
+	paths.run(index.at(source_node.get()), ex);
+	auto result = shortest_path_tree<N, E>{};
+	for (auto k = std::size_t{0}; k < nodes.size(); ++k) {
+		auto const distance = paths.distance(k);
+		if (not distance)
+			continue;
+		result.distances.emplace_hint(result.distances.end(), *nodes[k], *distance);
+		if (auto const predecessor = paths.predecessor(k))
+			result.predecessors.emplace_hint(result.predecessors.end(), *nodes[k], *nodes[*predecessor]);
+	}
+	return result;
+}
+
+template<typename N, typename E>
+auto gdwg::parallel_equal(graph<N, E> const& a, graph<N, E> const& b, executor& ex) -> bool {
+	return parallel_algorithms<N, E>::equal(a, b, ex);
+}
+
+template<typename N, typename E>
+auto gdwg::parallel_copy(graph<N, E> const& g, executor& ex) -> graph<N, E> {
+	return parallel_algorithms<N, E>::copy(g, ex);
+}
+
+template<typename N, typename E>
+requires std::is_arithmetic_v<E>
+auto gdwg::shortest_paths(graph<N, E> const& g, std::type_identity_t<N> const& source, executor& ex)
+    -> shortest_path_tree<N, E> {
+	return parallel_algorithms<N, E>::shortest_paths(g, source, ex);
+}
+
+#endif // GDWG_PARALLEL_H
@@ -0,0 +1,412 @@
+#include "gdwg_parallel.h"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <optional>
+#include <queue>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+	// Sequential Dijkstra over the public interface, which the parallel shortest paths are checked against
+	template<typename N, typename E>
+	auto dijkstra(gdwg::graph<N, E> const& g, N const& source) -> std::map<N, E> {
+		auto out = std::map<N, std::vector<std::pair<N, E>>>{};
+		for (auto const& [from, to, weight] : g) {
+			if (weight)
+				out[from].emplace_back(to, *weight);
+		}
+		auto distances = std::map<N, E>{{source, E{}}};
+		auto queue = std::priority_queue<std::pair<E, N>, std::vector<std::pair<E, N>>, std::greater<>>{};
+		queue.emplace(E{}, source);
+		while (not queue.empty()) {
+			auto const [distance, u] = queue.top();
+			queue.pop();
+			if (distance > distances.at(u))
+				continue;
+			for (auto const& [v, weight] : out[u]) {
+				auto const candidate = static_cast<E>(distance + weight);
+				if (auto const it = distances.find(v); it == distances.end() or candidate < it->second) {
+					distances[v] = candidate;
+					queue.emplace(candidate, v);
+				}
+			}
+		}
+		return distances;
+	}
+
+	// Checks that every predecessor is over a tight edge, and that following them leads back to the source
+	template<typename N, typename E>
+	auto is_shortest_path_tree(gdwg::graph<N, E> const& g, N const& source, gdwg::shortest_path_tree<N, E> const& tree)
+	    -> bool {
+		if (tree.predecessors.contains(source) or tree.predecessors.size() + 1 != tree.distances.size())
+			return false;
+		for (auto const& [node, predecessor] : tree.predecessors) {
+			auto const& tight = [&](auto const& e) {
+				auto const weight = e->get_weight();
+				return weight and static_cast<E>(tree.distances.at(predecessor) + *weight) == tree.distances.at(node);
+			};
+			if (std::ranges::none_of(g.edges(predecessor, node), tight))
+				return false;
+			auto at = node;
+			for (auto steps = std::size_t{0}; at != source; ++steps) {
+				if (steps == tree.distances.size())
+					return false;
+				at = tree.predecessors.at(at);
+			}
+		}
+		return true;
+	}
+} // namespace
+
+TEST_CASE("Work stealing deque operation", "[parallel]") {
+	SECTION("The owner pops in last in first out order, thieves steal in first in first out order") {
+		auto values = std::array<int, 3>{1, 2, 3};
+		auto deque = gdwg::work_stealing_deque<int*>{2};
+		REQUIRE(deque.pop() == nullptr);
+		REQUIRE(deque.steal() == nullptr);
+		for (auto& v : values) {
+			deque.push(&v);
+		}
+		REQUIRE(deque.size() == 3);
+		REQUIRE(deque.steal() == &values[0]);
+		REQUIRE(deque.pop() == &values[2]);
+		REQUIRE(deque.pop() == &values[1]);
+		REQUIRE(deque.pop() == nullptr);
+		REQUIRE(deque.size() == 0);
+	}
+
+	SECTION("Every pointer is taken exactly once while thieves race the owner") {
+		constexpr auto count = 100'000;
+		auto values = std::vector<int>(count);
+		auto taken = std::vector<std::atomic<int>>(count);
+		auto deque = gdwg::work_stealing_deque<int*>{};
+		auto done = std::atomic<bool>{false};
+		auto const& take = [&](int* value) { ++taken[static_cast<std::size_t>(value - values.data())]; };
+		auto thieves = std::vector<std::thread>{};
+		for (auto t = 0; t < 3; ++t) {
+			thieves.emplace_back([&] {
+				while (not done.load()) {
+					if (auto* const value = deque.steal())
+						take(value);
+				}
+			});
+		}
+		for (auto i = 0; i < count; ++i) {
+			deque.push(&values[static_cast<std::size_t>(i)]);
+			if (i % 3 == 0) {
+				if (auto* const value = deque.pop())
+					take(value);
+			}
+		}
+		while (auto* const value = deque.pop()) {
+			take(value);
+		}
+		done = true;
+		for (auto& thief : thieves) {
+			thief.join();
+		}
+		REQUIRE(std::ranges::all_of(taken, [](auto const& t) { return t.load() == 1; }));
+	}
+}
+
+TEST_CASE("Executor operation", "[parallel]") {
+	auto pool = gdwg::work_stealing_pool{{.threads = 4}};
+	auto serial = gdwg::inline_executor{};
+
+	SECTION("A pool runs every index once, on its own threads") {
+		REQUIRE(pool.concurrency() == 4);
+		auto visits = std::vector<std::atomic<int>>(1000);
+		auto caller = std::this_thread::get_id();
+		auto on_caller = std::atomic<bool>{false};
+		pool.bulk(visits.size(), [&](std::size_t i) {
+			++visits[i];
+			if (std::this_thread::get_id() == caller)
+				on_caller = true;
+		});
+		REQUIRE(std::ranges::all_of(visits, [](auto const& v) { return v.load() == 1; }));
+		REQUIRE_FALSE(on_caller);
+		pool.bulk(0, [](std::size_t) { FAIL("called for an empty bulk"); });
+	}
+
+	SECTION("A pool rethrows the first exception and stays usable") {
+		REQUIRE_THROWS_AS(pool.bulk(100,
+		                            [](std::size_t i) {
+			                            if (i == 42)
+				                            throw std::runtime_error("task failed");
+		                            }),
+		                  std::runtime_error);
+		auto sum = std::atomic<std::size_t>{0};
+		pool.bulk(100, [&sum](std::size_t i) { sum += i; });
+		REQUIRE(sum == 4950);
+	}
+
+	SECTION("Nested bulk calls finish without deadlock") {
+		auto visits = std::atomic<std::size_t>{0};
+		pool.bulk(16, [&](std::size_t) { pool.bulk(16, [&](std::size_t) { ++visits; }); });
+		REQUIRE(visits == 256);
+	}
+
+	SECTION("Idle workers steal the halves of a long bulk") {
+		auto const before = pool.steals();
+		pool.bulk(64, [](std::size_t) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); });
+		REQUIRE(pool.steals() > before);
+	}
+
+	SECTION("Pinned workers run tasks") {
+		auto pinned = gdwg::work_stealing_pool{{.threads = 2, .pin = true}};
+		auto sum = std::atomic<std::size_t>{0};
+		pinned.bulk(10, [&sum](std::size_t i) { sum += i; });
+		REQUIRE(sum == 45);
+	}
+
+	SECTION("parallel_for visits every index once on any executor") {
+		for (auto* const ex : {static_cast<gdwg::executor*>(&pool), static_cast<gdwg::executor*>(&serial)}) {
+			for (auto const count : {std::size_t{0}, std::size_t{1}, std::size_t{3}, std::size_t{1000}}) {
+				auto visits = std::vector<std::atomic<int>>(count);
+				gdwg::parallel_for(*ex, count, [&visits](std::size_t i) { ++visits[i]; });
+				REQUIRE(std::ranges::all_of(visits, [](auto const& v) { return v.load() == 1; }));
+			}
+		}
+	}
+
+	SECTION("Chunks are a few per task run at once, but no more than the items") {
+		REQUIRE(gdwg::default_chunk_count(pool, 1000) == 16);
+		REQUIRE(gdwg::default_chunk_count(pool, 3) == 3);
+		REQUIRE(gdwg::default_chunk_count(pool, 0) == 0);
+		REQUIRE(gdwg::default_chunk_count(serial, 1000) == 4);
+	}
+
+	SECTION("parallel_sort agrees with std::sort") {
+		auto engine = std::mt19937{7};
+		for (auto const size : {std::size_t{0}, std::size_t{10}, std::size_t{100'000}}) {
+			auto values = std::vector<int>(size);
+			for (auto& v : values) {
+				v = std::uniform_int_distribution<int>{-1000, 1000}(engine);
+			}
+			auto expected = values;
+			std::ranges::sort(expected);
+			for (auto* const ex : {static_cast<gdwg::executor*>(&pool), static_cast<gdwg::executor*>(&serial)}) {
+				auto sorted = values;
+				gdwg::parallel_sort(sorted, std::less<>{}, *ex);
+				REQUIRE(sorted == expected);
+			}
+			gdwg::parallel_sort(values, std::greater<>{});
+			REQUIRE(std::ranges::is_sorted(values, std::greater<>{}));
+		}
+	}
+}
+
+TEST_CASE("Parallel graph builder operation", "[parallel]") {
+	SECTION("Nodes and edges are sorted and deduplicated") {
+		auto pool = gdwg::work_stealing_pool{{.threads = 2}};
+		auto builder = gdwg::parallel_graph_builder<std::string, int>{pool};
+		auto first = builder.local();
+		auto second = builder.local();
+		first.add_node("Z");
+		first.add_edge("B", "A", 2);
+		second.add_edge("A", "B");
+		second.add_edge("B", "A", 2);
+		builder.add_batch({{"A", "B", std::nullopt}, {"C", "C", 1}});
+		auto expected = gdwg::graph<std::string, int>{"A", "B", "C", "Z"};
+		expected.insert_edge("B", "A", 2);
+		expected.insert_edge("A", "B");
+		expected.insert_edge("C", "C", 1);
+		REQUIRE(builder.build() == expected);
+		REQUIRE(builder.build().empty());
+	}
+
+	SECTION("Many threads build the same graph as graph_builder") {
+		constexpr auto threads = 4;
+		constexpr auto edges_per_thread = 20'000;
+		auto sequential = gdwg::graph_builder<int, int>{};
+		auto pool = gdwg::work_stealing_pool{{.threads = threads}};
+		auto parallel = gdwg::parallel_graph_builder<int, int>{pool};
+		auto buffers = std::vector<gdwg::parallel_graph_builder<int, int>::local_buffer>{};
+		for (auto t = 0; t < threads; ++t) {
+			buffers.push_back(parallel.local());
+			auto engine = std::mt19937{static_cast<unsigned>(t)};
+			for (auto i = 0; i < edges_per_thread; ++i) {
+				auto const src = std::uniform_int_distribution<int>{0, 999}(engine);
+				auto const dst = std::uniform_int_distribution<int>{0, 999}(engine);
+				auto const weight = std::uniform_int_distribution<int>{0, 3}(engine);
+				sequential.add_edge(src, dst, weight == 0 ? std::nullopt : std::optional<int>{weight});
+			}
+		}
+		auto workers = std::vector<std::thread>{};
+		for (auto t = 0; t < threads; ++t) {
+			workers.emplace_back([&buffers, t] {
+				auto& buffer = buffers[static_cast<std::size_t>(t)];
+				buffer.reserve(edges_per_thread);
+				auto engine = std::mt19937{static_cast<unsigned>(t)};
+				for (auto i = 0; i < edges_per_thread; ++i) {
+					auto const src = std::uniform_int_distribution<int>{0, 999}(engine);
+					auto const dst = std::uniform_int_distribution<int>{0, 999}(engine);
+					auto const weight = std::uniform_int_distribution<int>{0, 3}(engine);
+					buffer.add_edge(src, dst, weight == 0 ? std::nullopt : std::optional<int>{weight});
+				}
+			});
+		}
+		for (auto& worker : workers) {
+			worker.join();
+		}
+		auto const g = parallel.build();
+		REQUIRE(g == sequential.build());
+	}
+}
+
+TEST_CASE("Parallel copy and comparison operation", "[parallel]") {
+	auto pool = gdwg::work_stealing_pool{{.threads = 4}};
+	auto const& random_graph = [](unsigned seed) {
+		auto builder = gdwg::graph_builder<int, std::string>{};
+		auto engine = std::mt19937{seed};
+		for (auto i = 0; i < 5000; ++i) {
+			auto const src = std::uniform_int_distribution<int>{0, 499}(engine);
+			auto const dst = std::uniform_int_distribution<int>{0, 499}(engine);
+			auto const weight = std::uniform_int_distribution<int>{0, 3}(engine);
+			builder.add_edge(src, dst, weight == 0 ? std::nullopt : std::optional<std::string>{std::to_string(weight)});
+		}
+		return builder.build();
+	};
+
+	SECTION("parallel_copy makes an equal, independent graph") {
+		auto g = random_graph(1);
+		for (auto const threads : {std::size_t{1}, std::size_t{3}, std::size_t{16}}) {
+			auto pool = gdwg::work_stealing_pool{{.threads = threads}};
+			auto copy = gdwg::parallel_copy(g, pool);
+			REQUIRE(copy == g);
+			REQUIRE(copy.fingerprint() == g.fingerprint());
+			copy.insert_node(1000);
+			REQUIRE(copy != g);
+		}
+		REQUIRE(gdwg::parallel_copy(gdwg::graph<int, std::string>{}).empty());
+	}
+
+	SECTION("parallel_copy leaves out the edges of lazily erased nodes") {
+		auto g = random_graph(2);
+		auto expected = g;
+		REQUIRE(expected.erase_node(7));
+		g.set_lazy_erase(true);
+		REQUIRE(g.erase_node(7));
+		auto const copy = gdwg::parallel_copy(g, pool);
+		REQUIRE(copy == expected);
+		REQUIRE(std::ranges::distance(copy.begin(), copy.end())
+		        == std::ranges::distance(expected.begin(), expected.end()));
+	}
+
+	SECTION("parallel_equal agrees with operator==") {
+		auto const g = random_graph(3);
+		auto same = random_graph(3);
+		REQUIRE(gdwg::parallel_equal(g, same, pool));
+		REQUIRE(gdwg::parallel_equal(gdwg::graph<int, std::string>{}, {}));
+
+		auto renamed = same;
+		REQUIRE(renamed.replace_node(499, 500));
+		REQUIRE_FALSE(gdwg::parallel_equal(g, renamed, pool));
+		REQUIRE_FALSE(gdwg::parallel_equal(g, random_graph(4), pool));
+
+		auto lazy = same;
+		lazy.set_lazy_erase(true);
+		REQUIRE(lazy.erase_node(0));
+		auto erased = same;
+		REQUIRE(erased.erase_node(0));
+		REQUIRE(gdwg::parallel_equal(lazy, erased, pool));
+		REQUIRE(gdwg::parallel_equal(erased, lazy, pool));
+		REQUIRE_FALSE(gdwg::parallel_equal(lazy, g, pool));
+	}
+}
+
+TEST_CASE("Parallel shortest paths operation", "[parallel]") {
+	auto pool = gdwg::work_stealing_pool{{.threads = 4}};
+	auto const& random_graph = []<typename E>(unsigned seed, int nodes, int edges, E max_weight) {
+		auto builder = gdwg::graph_builder<int, E>{};
+		auto engine = std::mt19937{seed};
+		for (auto i = 0; i < nodes; ++i) {
+			builder.add_node(i);
+		}
+		for (auto i = 0; i < edges; ++i) {
+			auto const src = std::uniform_int_distribution<int>{0, nodes - 1}(engine);
+			auto const dst = std::uniform_int_distribution<int>{0, nodes - 1}(engine);
+			if constexpr (std::is_integral_v<E>)
+				builder.add_edge(src, dst, std::uniform_int_distribution<E>{0, max_weight}(engine));
+			else
+				builder.add_edge(src, dst, std::uniform_real_distribution<E>{0, max_weight}(engine));
+		}
+		return builder.build();
+	};
+
+	SECTION("Distances match Dijkstra on random graphs") {
+		auto inline_ex = gdwg::inline_executor{};
+		auto const sparse = random_graph(1, 20'000, 50'000, 1000);
+		auto const dense = random_graph(2, 2000, 60'000, 255);
+		auto const real = random_graph(3, 5000, 40'000, 1.0);
+		for (auto* ex : std::initializer_list<gdwg::executor*>{&pool, &inline_ex}) {
+			for (auto const source : {0, 17}) {
+				auto const tree = gdwg::shortest_paths(sparse, source, *ex);
+				REQUIRE(tree.distances == dijkstra(sparse, source));
+				REQUIRE(is_shortest_path_tree(sparse, source, tree));
+				auto const dense_tree = gdwg::shortest_paths(dense, source, *ex);
+				REQUIRE(dense_tree.distances == dijkstra(dense, source));
+				REQUIRE(is_shortest_path_tree(dense, source, dense_tree));
+				auto const real_tree = gdwg::shortest_paths(real, source, *ex);
+				REQUIRE(real_tree.distances == dijkstra(real, source));
+				REQUIRE(is_shortest_path_tree(real, source, real_tree));
+			}
+		}
+	}
+
+	SECTION("Edges of weight 0, unreached nodes and unweighted edges") {
+		auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d", "e", "f"};
+		g.insert_edge("a", "b", 0);
+		g.insert_edge("b", "c", 0);
+		g.insert_edge("c", "b", 0);
+		g.insert_edge("c", "a", 0);
+		g.insert_edge("b", "d", 5);
+		g.insert_edge("a", "d", 7);
+		g.insert_edge("d", "e");
+		g.insert_edge("e", "f", 1);
+		auto const tree = gdwg::shortest_paths(g, "a", pool);
+		REQUIRE(tree.distances == std::map<std::string, int>{{"a", 0}, {"b", 0}, {"c", 0}, {"d", 5}});
+		REQUIRE(tree.predecessors == std::map<std::string, std::string>{{"b", "a"}, {"c", "b"}, {"d", "b"}});
+	}
+
+	SECTION("Edges of lazily erased nodes are not followed") {
+		auto g = gdwg::graph<int, double>{1, 2, 3};
+		g.insert_edge(1, 2, 1.5);
+		g.insert_edge(2, 3, 1.5);
+		g.insert_edge(1, 3, 4.0);
+		g.set_lazy_erase(true);
+		REQUIRE(g.erase_node(2));
+		auto const tree = gdwg::shortest_paths(g, 1, pool);
+		REQUIRE(tree.distances == std::map<int, double>{{1, 0.0}, {3, 4.0}});
+		REQUIRE(tree.predecessors == std::map<int, int>{{3, 1}});
+	}
+
+	SECTION("A source which doesn't exist or a negative weight throws") {
+		auto g = gdwg::graph<int, int>{1, 2};
+		REQUIRE_THROWS_WITH(gdwg::shortest_paths(g, 3),
+		                    "Cannot call gdwg::shortest_paths if source doesn't exist in the graph");
+		g.insert_edge(2, 1, -1);
+		REQUIRE_THROWS_WITH(gdwg::shortest_paths(g, 1, pool),
+		                    "Cannot call gdwg::shortest_paths on a graph with a negative weight");
+	}
+
+	SECTION("Delta follows the weights and degrees") {
+		REQUIRE(gdwg::delta_stepping<int>::tune(100.0, 4.0) == 50);
+		REQUIRE(gdwg::delta_stepping<int>::tune(0.1, 8.0) == 1);
+		REQUIRE(gdwg::delta_stepping<int>::tune(0.0, 0.0) == 1);
+		REQUIRE(gdwg::delta_stepping<double>::tune(0.5, 2.0) == 0.5);
+		REQUIRE(gdwg::delta_stepping<double>::tune(0.0, 3.0) == 1.0);
+	}
+}
@@ -0,0 +1,64 @@
+#ifndef GDWG_TESTING_H
+#	define GDWG_TESTING_H
+
+#	include "gdwg_graph.h"
+
+#	include <filesystem>
+#	include <fstream>
+#	include <ios>
+#	include <random>
+#	include <string>
+#	include <string_view>
+#	include <system_error>
+
+// Fixtures shared by the tests of the storage layers.
+namespace gdwg::testing {
+	// A path in the temporary directory for one test, removed with everything in it afterwards
+	struct scratch_path {
+		std::filesystem::path path;
+
+		scratch_path()
+		: path{std::filesystem::temp_directory_path()
+		       / ("gdwg_test_" + std::to_string(std::random_device{}()) + std::to_string(std::random_device{}()))} {}
+
+		scratch_path(scratch_path const&) = delete;
+		auto operator=(scratch_path const&) -> scratch_path& = delete;
+
+		~scratch_path() {
+			auto ec = std::error_code{};
+			std::filesystem::remove_all(path, ec);
+		}
+	};
+
+	// A fresh directory for one test
+	struct scratch_dir : scratch_path {
+		scratch_dir() {
+			std::filesystem::create_directory(path);
+		}
+	};
+
+	// A fresh file for one test, holding the given contents
+	struct scratch_file : scratch_path {
+		explicit scratch_file(std::string_view contents) {
+			auto out = std::ofstream{path, std::ios::binary};
+			out.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+		}
+	};
+
+	// Nodes A to E, with parallel weighted and unweighted edges, self-loops, a negative weight and a node without
+	// edges.
+	inline auto sample() -> graph<std::string, int> {
+		auto g = graph<std::string, int>{"A", "B", "C", "D", "E"};
+		g.insert_edge("A", "B", 1);
+		g.insert_edge("A", "B", 2);
+		g.insert_edge("A", "B");
+		g.insert_edge("A", "D", 3);
+		g.insert_edge("C", "A", 4);
+		g.insert_edge("C", "C");
+		g.insert_edge("D", "A");
+		g.insert_edge("D", "D", -2);
+		return g;
+	}
+} // namespace gdwg::testing
+
+#endif // GDWG_TESTING_H
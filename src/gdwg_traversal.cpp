@@ -0,0 +1,67 @@
+#include "gdwg_traversal.h"
+
+#include <array>
+#include <new>
+
+namespace {
+	// Frames kept per thread, enough for a few generators alive at once, e.g. nested traversals
+	constexpr auto cached_frames = std::size_t{4};
+	// Room before every frame for its capacity, keeping the frame aligned as operator new would
+	constexpr auto header_bytes = std::size_t{__STDCPP_DEFAULT_NEW_ALIGNMENT__};
+
+	// The frames released on a thread, any of which is handed out again if it is large enough
+	class frame_cache {
+	 public:
+		frame_cache() = default;
+		frame_cache(frame_cache const&) = delete;
+		auto operator=(frame_cache const&) -> frame_cache& = delete;
+
+		~frame_cache() {
+			for (auto i = std::size_t{0}; i < count_; ++i) {
+				::operator delete(blocks_[i]);
+			}
+		}
+
+		[[nodiscard]] auto take(std::size_t size) noexcept -> std::byte* {
+			for (auto i = std::size_t{0}; i < count_; ++i) {
+				auto* const block = blocks_[i];
+				if (*std::launder(reinterpret_cast<std::size_t*>(block)) >= size) {
+					blocks_[i] = blocks_[--count_];
+					return block;
+				}
+			}
+			return nullptr;
+		}
+
+		[[nodiscard]] auto keep(std::byte* block) noexcept -> bool {
+			if (count_ == blocks_.size())
+				return false;
+			blocks_[count_++] = block;
+			return true;
+		}
+
+	 private:
+		std::array<std::byte*, cached_frames> blocks_{};
+		std::size_t count_ = 0;
+	};
+
+	thread_local auto frames = frame_cache{};
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  COROUTINE FRAME FUNCTIONS                                                         //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+auto gdwg::allocate_frame(std::size_t size) -> void* {
+	auto* block = frames.take(size);
+	if (block == nullptr) {
+		block = static_cast<std::byte*>(::operator new(header_bytes + size));
+		::new (block) std::size_t{size};
+	}
+	return block + header_bytes;
+}
+
+auto gdwg::deallocate_frame(void* frame) noexcept -> void {
+	auto* const block = static_cast<std::byte*>(frame) - header_bytes;
+	if (not frames.keep(block))
+		::operator delete(block);
+}
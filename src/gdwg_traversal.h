@@ -0,0 +1,710 @@
+#ifndef GDWG_TRAVERSAL_H
+#	define GDWG_TRAVERSAL_H
+
+#	include "gdwg_graph.h"
+
+#	include <coroutine>
+#	include <cstddef>
+#	include <exception>
+#	include <iterator>
+#	include <memory>
+#	include <ranges>
+#	include <stdexcept>
+#	include <string>
+#	include <type_traits>
+#	include <unordered_map>
+#	include <unordered_set>
+#	include <utility>
+#	include <vector>
+
+namespace gdwg {
+	/**
+	 * @brief Allocates a coroutine frame, reusing one freed earlier on the same thread if it is large enough.
+	 * @note Marked as [[nodiscard]] because the frame is leaked if ignored.
+	 * Not marked as noexcept because allocating a new frame may throw std::bad_alloc.
+	 *
+	 * @param size The size of the frame.
+	 * @return The frame, to be released with deallocate_frame.
+	 */
+	[[nodiscard]] auto allocate_frame(std::size_t size) -> void*;
+
+	/**
+	 * @brief Releases a coroutine frame, keeping it for the next allocate_frame on the same thread while fewer than
+	 * a handful are kept.
+	 * @note Marked as noexcept because it only frees memory.
+	 *
+	 * @param frame A frame from allocate_frame.
+	 */
+	auto deallocate_frame(void* frame) noexcept -> void;
+
+	/**
+	 * A lazily evaluated sequence of values produced by a coroutine, as a move-only view. The coroutine runs up to
+	 * its next co_yield only as the view is iterated, so a consumer which stops early never pays for the rest of the
+	 * sequence. An exception thrown by the coroutine is rethrown from begin or operator++. Frames are drawn from
+	 * allocate_frame, so generators made one after another on a thread reuse the same memory.
+	 */
+	template<typename T>
+	class generator : public std::ranges::view_interface<generator<T>> {
+	 public:
+		using value_type = std::remove_cvref_t<T>;
+		using reference = std::conditional_t<std::is_reference_v<T>, T, T const&>;
+
+		/**
+		 * The promise of a coroutine returning a generator, which holds the value last yielded.
+		 */
+		class promise_type {
+		 public:
+			/**
+			 * @brief Makes the generator owning the coroutine.
+			 * @note Marked as [[nodiscard]] because the coroutine is leaked if ignored.
+			 * Marked as noexcept because it only wraps a handle.
+			 *
+			 * @return The generator.
+			 */
+			[[nodiscard]] auto get_return_object() noexcept -> generator;
+
+			/**
+			 * @brief Suspends the coroutine before it runs, so that nothing is computed until the first begin.
+			 * @note Marked as [[nodiscard]] because the awaiter is needed by the coroutine.
+			 * Marked as noexcept because it only returns an awaiter.
+			 *
+			 * @return An awaiter which always suspends.
+			 */
+			[[nodiscard]] auto initial_suspend() const noexcept -> std::suspend_always;
+
+			/**
+			 * @brief Suspends the coroutine once it has finished, so that the generator can see that it is done.
+			 * @note Marked as [[nodiscard]] because the awaiter is needed by the coroutine.
+			 * Marked as noexcept because a final suspend must not throw.
+			 *
+			 * @return An awaiter which always suspends.
+			 */
+			[[nodiscard]] auto final_suspend() const noexcept -> std::suspend_always;
+
+			/**
+			 * @brief Holds a yielded value until the coroutine is resumed. The value is not copied: a temporary lives
+			 * in the frame for as long as the coroutine is suspended on it.
+			 * @note Marked as noexcept because it only stores an address.
+			 *
+			 * @param value The value yielded.
+			 * @return An awaiter which always suspends.
+			 */
+			auto yield_value(reference value) noexcept -> std::suspend_always;
+
+			/**
+			 * @brief Finishes the sequence.
+			 * @note Marked as noexcept because it does nothing.
+			 */
+			auto return_void() const noexcept -> void;
+
+			/**
+			 * @brief Keeps an exception thrown by the coroutine for the consumer to rethrow.
+			 * @note Marked as noexcept because it only stores the exception.
+			 */
+			auto unhandled_exception() noexcept -> void;
+
+			/**
+			 * @brief Allocates the frame of the coroutine.
+			 * @note Marked as [[nodiscard]] because the frame is leaked if ignored.
+			 *
+			 * @param size The size of the frame.
+			 * @return The frame.
+			 */
+			[[nodiscard]] static auto operator new(std::size_t size) -> void*;
+
+			/**
+			 * @brief Releases the frame of the coroutine for reuse.
+			 * @note Marked as noexcept because it only frees memory.
+			 *
+			 * @param frame The frame.
+			 */
+			static auto operator delete(void* frame) noexcept -> void;
+
+			/**
+			 * A generator yields values rather than waiting for them, so it cannot co_await.
+			 */
+			template<typename U>
+			auto await_transform(U&& value) -> void = delete;
+
+		 private:
+			std::add_pointer_t<reference> value_ = nullptr;
+			std::exception_ptr error_;
+
+			friend class generator;
+		};
+
+		/**
+		 * An input iterator over the values of a generator, each read in place.
+		 */
+		class iterator {
+		 public:
+			using value_type = generator::value_type;
+			using reference = generator::reference;
+			using difference_type = std::ptrdiff_t;
+			using iterator_concept = std::input_iterator_tag;
+
+			/**
+			 * @brief Default constructor, for an iterator which must not be used.
+			 * @note Defaulted, as required of an input iterator.
+			 */
+			iterator() noexcept = default;
+
+			/**
+			 * @brief Reads the value last yielded.
+			 * @note Marked as [[nodiscard]] because the dereferenced value is important and should not be ignored.
+			 * Marked as noexcept because it only follows a pointer.
+			 *
+			 * @return The value, valid until the iterator is advanced.
+			 */
+			[[nodiscard]] auto operator*() const noexcept -> reference;
+
+			/**
+			 * @brief Runs the coroutine up to its next value (pre-increment).
+			 * @note Not marked as noexcept because the coroutine may throw.
+			 *
+			 * @return A reference to the incremented iterator.
+			 * @throws Whatever the coroutine throws.
+			 */
+			auto operator++() -> iterator&;
+
+			/**
+			 * @brief Runs the coroutine up to its next value (post-increment). The value before is gone, so nothing is
+			 * returned.
+			 * @note Not marked as noexcept because the coroutine may throw.
+			 */
+			auto operator++(int) -> void;
+
+			/**
+			 * @brief Checks if the coroutine has finished.
+			 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+			 * Marked as noexcept because it only checks the handle.
+			 *
+			 * @return True if no values are left, otherwise false.
+			 */
+			[[nodiscard]] auto operator==(std::default_sentinel_t) const noexcept -> bool;
+
+		 private:
+			std::coroutine_handle<promise_type> handle_;
+
+			/**
+			 * @brief Constructs an iterator over a coroutine.
+			 *
+			 * @param handle The coroutine.
+			 */
+			explicit iterator(std::coroutine_handle<promise_type> handle) noexcept;
+
+			friend class generator;
+		};
+
+		/**
+		 * @brief Move constructor, taking the coroutine of another generator.
+		 * @note Marked as noexcept because it only moves a handle.
+		 *
+		 * @param other The generator to move from, which is left empty.
+		 */
+		generator(generator&& other) noexcept;
+
+		/**
+		 * @brief Move assignment, destroying the coroutine of this generator and taking that of another.
+		 * @note Marked as noexcept because it only destroys and moves handles.
+		 *
+		 * @param other The generator to move from, which is left empty.
+		 * @return A reference to this generator.
+		 */
+		auto operator=(generator&& other) noexcept -> generator&;
+
+		/**
+		 * A coroutine can only be resumed by one consumer, so a generator cannot be copied.
+		 */
+		generator(generator const&) = delete;
+		auto operator=(generator const&) -> generator& = delete;
+
+		/**
+		 * @brief Destructor, destroying the coroutine wherever it is suspended.
+		 */
+		~generator();
+
+		/**
+		 * @brief Runs the coroutine up to its first value. May be called once.
+		 * @note Marked as [[nodiscard]] because the iterator is important and should not be ignored.
+		 * Not marked as noexcept because the coroutine may throw.
+		 *
+		 * @return An iterator at the first value.
+		 * @throws Whatever the coroutine throws.
+		 */
+		[[nodiscard]] auto begin() -> iterator;
+
+		/**
+		 * @brief Returns the sentinel which an iterator equals once the coroutine has finished.
+		 * @note Marked as [[nodiscard]] because the sentinel is important and should not be ignored.
+		 * Marked as noexcept because it only returns a tag.
+		 *
+		 * @return std::default_sentinel.
+		 */
+		[[nodiscard]] auto end() const noexcept -> std::default_sentinel_t;
+
+	 private:
+		std::coroutine_handle<promise_type> handle_;
+
+		/**
+		 * @brief Constructs a generator owning a coroutine.
+		 *
+		 * @param handle The coroutine.
+		 */
+		explicit generator(std::coroutine_handle<promise_type> handle) noexcept;
+
+		/**
+		 * @brief Rethrows the exception the coroutine stopped with, if any.
+		 *
+		 * @param handle The coroutine.
+		 */
+		static auto rethrow(std::coroutine_handle<promise_type> handle) -> void;
+	};
+
+	/**
+	 * An edge of a traversal tree: the edge through which a traversal first reached a node.
+	 */
+	template<typename N>
+	struct tree_edge {
+		// The node the traversal came from, already visited.
+		N const& from;
+		// The node reached for the first time.
+		N const& to;
+	};
+
+	/**
+	 * The traversals over the storage of a graph, which the generators below run. Nodes are unique per graph, so a
+	 * traversal tracks them by address and never copies or compares an N. Like an iterator, a traversal is
+	 * invalidated by modifying the graph, and must not outlive it.
+	 */
+	template<typename N, typename E>
+	class traversal {
+	 public:
+		/**
+		 * @brief Starts a depth-first traversal, see gdwg::dfs.
+		 */
+		[[nodiscard]] static auto dfs(graph<N, E> const& g, N const& start) -> generator<N const&>;
+
+		/**
+		 * @brief Starts a depth-first traversal yielding tree edges, see gdwg::dfs_edges.
+		 */
+		[[nodiscard]] static auto dfs_edges(graph<N, E> const& g, N const& start) -> generator<tree_edge<N>>;
+
+		/**
+		 * @brief Starts a breadth-first traversal, see gdwg::bfs.
+		 */
+		[[nodiscard]] static auto bfs(graph<N, E> const& g, N const& start) -> generator<N const&>;
+
+		/**
+		 * @brief Starts a breadth-first traversal yielding tree edges, see gdwg::bfs_edges.
+		 */
+		[[nodiscard]] static auto bfs_edges(graph<N, E> const& g, N const& start) -> generator<tree_edge<N>>;
+
+		/**
+		 * @brief Starts a topological traversal, see gdwg::topological.
+		 */
+		[[nodiscard]] static auto topological(graph<N, E> const& g) -> generator<N const&>;
+
+	 private:
+		// The position of a depth-first traversal in the out-edges of a node
+		struct cursor {
+			N const* node;
+			typename graph<N, E>::edges_set::const_iterator next;
+		};
+
+		/**
+		 * @brief Finds the stored node with a value, as the root of a traversal.
+		 *
+		 * @param g The graph.
+		 * @param start The value of the node.
+		 * @param caller The function to name in the exception.
+		 * @return The stored node.
+		 * @throws std::runtime_error If no node has the value.
+		 */
+		[[nodiscard]] static auto root(graph<N, E> const& g, N const& start, char const* caller) -> N const*;
+
+		/**
+		 * @brief Advances a depth-first traversal to the next node it reaches for the first time.
+		 *
+		 * @param g The graph.
+		 * @param stack The nodes being explored, innermost last, popped as their out-edges run out.
+		 * @param visited The nodes reached so far, to which the next node is added.
+		 * @return The edge through which the next node was reached, or nullptr if the traversal is over.
+		 */
+		[[nodiscard]] static auto next_depth_first(graph<N, E> const& g,
+		                                           std::vector<cursor>& stack,
+		                                           std::unordered_set<N const*>& visited) ->
+		    typename graph<N, E>::edge_tuple const*;
+
+		[[nodiscard]] static auto run_dfs(graph<N, E> const& g, N const* root) -> generator<N const&>;
+		[[nodiscard]] static auto run_dfs_edges(graph<N, E> const& g, N const* root) -> generator<tree_edge<N>>;
+		[[nodiscard]] static auto run_bfs(graph<N, E> const& g, N const* root) -> generator<N const&>;
+		[[nodiscard]] static auto run_bfs_edges(graph<N, E> const& g, N const* root) -> generator<tree_edge<N>>;
+		[[nodiscard]] static auto run_topological(graph<N, E> const& g) -> generator<N const&>;
+	};
+
+	/**
+	 * @brief Walks the nodes reachable from start depth-first, yielding each as it is first reached, start first.
+	 * Out-edges are followed in the order of their destinations. Nothing is visited until the first value is read.
+	 * @note Marked as [[nodiscard]] because the traversal does nothing if ignored.
+	 *
+	 * Time complexity: O(log n) to find start, then O(1) amortised per edge followed, so stopping after k nodes
+	 * costs only the edges of those k nodes.
+	 *
+	 * @param g The graph, which must outlive the generator and not be modified while it is in use.
+	 * @param start The node to start from.
+	 * @return A generator of the nodes in depth-first preorder, as references into the graph.
+	 * @throws std::runtime_error If start doesn't exist in the graph.
+	 */
+	template<typename N, typename E>
+	[[nodiscard]] auto dfs(graph<N, E> const& g, N const& start) -> generator<N const&>;
+
+	/**
+	 * @brief Walks the nodes reachable from start depth-first like dfs, yielding the edge through which each node
+	 * other than start is first reached. Following the from fields back leads to start, so the edges give a path to
+	 * every node yielded.
+	 * @note Marked as [[nodiscard]] because the traversal does nothing if ignored.
+	 *
+	 * Time complexity: as dfs.
+	 *
+	 * @param g The graph, which must outlive the generator and not be modified while it is in use.
+	 * @param start The node to start from.
+	 * @return A generator of the edges of the depth-first tree, in the order they are found.
+	 * @throws std::runtime_error If start doesn't exist in the graph.
+	 */
+	template<typename N, typename E>
+	[[nodiscard]] auto dfs_edges(graph<N, E> const& g, N const& start) -> generator<tree_edge<N>>;
+
+	/**
+	 * @brief Walks the nodes reachable from start breadth-first, yielding each as it is first reached, start first,
+	 * so in order of their distance in edges from start. Nothing is visited until the first value is read.
+	 * @note Marked as [[nodiscard]] because the traversal does nothing if ignored.
+	 *
+	 * Time complexity: O(log n) to find start, then O(1) amortised per edge followed.
+	 *
+	 * @param g The graph, which must outlive the generator and not be modified while it is in use.
+	 * @param start The node to start from.
+	 * @return A generator of the nodes in breadth-first order, as references into the graph.
+	 * @throws std::runtime_error If start doesn't exist in the graph.
+	 */
+	template<typename N, typename E>
+	[[nodiscard]] auto bfs(graph<N, E> const& g, N const& start) -> generator<N const&>;
+
+	/**
+	 * @brief Walks the nodes reachable from start breadth-first like bfs, yielding the edge through which each node
+	 * other than start is first reached. Following the from fields back gives a path with the fewest edges.
+	 * @note Marked as [[nodiscard]] because the traversal does nothing if ignored.
+	 *
+	 * Time complexity: as bfs.
+	 *
+	 * @param g The graph, which must outlive the generator and not be modified while it is in use.
+	 * @param start The node to start from.
+	 * @return A generator of the edges of the breadth-first tree, in the order they are found.
+	 * @throws std::runtime_error If start doesn't exist in the graph.
+	 */
+	template<typename N, typename E>
+	[[nodiscard]] auto bfs_edges(graph<N, E> const& g, N const& start) -> generator<tree_edge<N>>;
+
+	/**
+	 * @brief Yields every node of the graph after all nodes with an edge to it. Ready nodes are yielded first in,
+	 * first out: the nodes without in-edges in ascending order, then each node in the order its last in-edge was
+	 * followed. The in-degrees are counted when the first value is read; after that, each node costs only its
+	 * out-edges.
+	 * @note Marked as [[nodiscard]] because the traversal does nothing if ignored.
+	 *
+	 * Time complexity: O(n + e) for the in-degrees, then O(1) amortised per edge followed.
+	 *
+	 * @param g The graph, which must outlive the generator and not be modified while it is in use.
+	 * @return A generator of the nodes in topological order, as references into the graph.
+	 * @throws std::runtime_error Once the nodes outside cycles are exhausted, if the graph has a cycle.
+	 */
+	template<typename N, typename E>
+	[[nodiscard]] auto topological(graph<N, E> const& g) -> generator<N const&>;
+} // namespace gdwg
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  GENERATOR FUNCTIONS                                                               //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename T>
+auto gdwg::generator<T>::promise_type::get_return_object() noexcept -> generator {
+	return generator{std::coroutine_handle<promise_type>::from_promise(*this)};
+}
+
+template<typename T>
+auto gdwg::generator<T>::promise_type::initial_suspend() const noexcept -> std::suspend_always {
+	return {};
+}
+
+template<typename T>
+auto gdwg::generator<T>::promise_type::final_suspend() const noexcept -> std::suspend_always {
+	return {};
+}
+
+template<typename T>
+auto gdwg::generator<T>::promise_type::yield_value(reference value) noexcept -> std::suspend_always {
+	value_ = std::addressof(value);
+	return {};
+}
+
+template<typename T>
+auto gdwg::generator<T>::promise_type::return_void() const noexcept -> void {}
+
+template<typename T>
+auto gdwg::generator<T>::promise_type::unhandled_exception() noexcept -> void {
+	error_ = std::current_exception();
+}
+
+template<typename T>
+auto gdwg::generator<T>::promise_type::operator new(std::size_t size) -> void* {
+	return allocate_frame(size);
+}
+
+template<typename T>
+auto gdwg::generator<T>::promise_type::operator delete(void* frame) noexcept -> void {
+	deallocate_frame(frame);
+}
+
+template<typename T>
+gdwg::generator<T>::iterator::iterator(std::coroutine_handle<promise_type> handle) noexcept
+: handle_{handle} {}
+
+template<typename T>
+auto gdwg::generator<T>::iterator::operator*() const noexcept -> reference {
+	return static_cast<reference>(*handle_.promise().value_);
+}
+
+template<typename T>
+auto gdwg::generator<T>::iterator::operator++() -> iterator& {
+	handle_.resume();
+	rethrow(handle_);
+	return *this;
+}
+
+template<typename T>
+auto gdwg::generator<T>::iterator::operator++(int) -> void {
+	++*this;
+}
+
+template<typename T>
+auto gdwg::generator<T>::iterator::operator==(std::default_sentinel_t) const noexcept -> bool {
+	return handle_.done();
+}
+
+template<typename T>
+gdwg::generator<T>::generator(std::coroutine_handle<promise_type> handle) noexcept
+: handle_{handle} {}
+
+template<typename T>
+gdwg::generator<T>::generator(generator&& other) noexcept
+: handle_{std::exchange(other.handle_, nullptr)} {}
+
+template<typename T>
+auto gdwg::generator<T>::operator=(generator&& other) noexcept -> generator& {
+	if (this != &other) {
+		if (handle_)
+			handle_.destroy();
+		handle_ = std::exchange(other.handle_, nullptr);
+	}
+	return *this;
+}
+
+template<typename T>
+gdwg::generator<T>::~generator() {
+	if (handle_)
+		handle_.destroy();
+}
+
+template<typename T>
+auto gdwg::generator<T>::begin() -> iterator {
+	handle_.resume();
+	rethrow(handle_);
+	return iterator{handle_};
+}
+
+template<typename T>
+auto gdwg::generator<T>::end() const noexcept -> std::default_sentinel_t {
+	return std::default_sentinel;
+}
+
+template<typename T>
+auto gdwg::generator<T>::rethrow(std::coroutine_handle<promise_type> handle) -> void {
+	if (auto& error = handle.promise().error_)
+		std::rethrow_exception(std::exchange(error, nullptr));
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  TRAVERSAL FUNCTIONS                                                               //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename N, typename E>
+auto gdwg::traversal<N, E>::dfs(graph<N, E> const& g, N const& start) -> generator<N const&> {
+	return run_dfs(g, root(g, start, "gdwg::dfs"));
+}
+
+template<typename N, typename E>
+auto gdwg::traversal<N, E>::dfs_edges(graph<N, E> const& g, N const& start) -> generator<tree_edge<N>> {
+	return run_dfs_edges(g, root(g, start, "gdwg::dfs_edges"));
+}
+
+template<typename N, typename E>
+auto gdwg::traversal<N, E>::bfs(graph<N, E> const& g, N const& start) -> generator<N const&> {
+	return run_bfs(g, root(g, start, "gdwg::bfs"));
+}
+
+template<typename N, typename E>
+auto gdwg::traversal<N, E>::bfs_edges(graph<N, E> const& g, N const& start) -> generator<tree_edge<N>> {
+	return run_bfs_edges(g, root(g, start, "gdwg::bfs_edges"));
+}
+
+template<typename N, typename E>
+auto gdwg::traversal<N, E>::topological(graph<N, E> const& g) -> generator<N const&> {
+	return run_topological(g);
+}
+
+template<typename N, typename E>
+auto gdwg::traversal<N, E>::root(graph<N, E> const& g, N const& start, char const* caller) -> N const* {
+	// Checked before the coroutine starts, so that a bad start throws here rather than at the first read
+	auto const it = g.nodes_.find(start);
+	if (it == g.nodes_.end())
+		throw std::runtime_error(std::string{"Cannot call "} + caller + " if start doesn't exist in the graph");
+	return it->get();
+}
+
+template<typename N, typename E>
+auto gdwg::traversal<N, E>::next_depth_first(graph<N, E> const& g,
+                                             std::vector<cursor>& stack,
+                                             std::unordered_set<N const*>& visited) ->
+    typename graph<N, E>::edge_tuple const* {
+	while (not stack.empty()) {
+		auto& top = stack.back();
+		if (top.next == g.edges_.end() or std::get<0>(*top.next).get() != top.node) {
+			stack.pop_back();
+			continue;
+		}
+		auto const& e = *top.next++;
+		graph<N, E>::count_visit();
+		auto const* const dst = std::get<1>(e).get();
+		if (g.is_tombstoned(e) or not visited.insert(dst).second)
+			continue;
+		stack.push_back(cursor{dst, g.first_out_edge(dst)});
+		return &e;
+	}
+	return nullptr;
+}
+
+// GCC 12 warns about a null pointer it writes into every coroutine frame, wherever the coroutine is defined
+#	pragma GCC diagnostic push
+#	pragma GCC diagnostic ignored "-Wzero-as-null-pointer-constant"
+
+template<typename N, typename E>
+auto gdwg::traversal<N, E>::run_dfs(graph<N, E> const& g, N const* root) -> generator<N const&> {
+	auto visited = std::unordered_set<N const*>{root};
+	auto stack = std::vector<cursor>{cursor{root, g.first_out_edge(root)}};
+	co_yield *root;
+	while (auto const* e = next_depth_first(g, stack, visited)) {
+		co_yield *std::get<1>(*e);
+	}
+}
+
+template<typename N, typename E>
+auto gdwg::traversal<N, E>::run_dfs_edges(graph<N, E> const& g, N const* root) -> generator<tree_edge<N>> {
+	auto visited = std::unordered_set<N const*>{root};
+	auto stack = std::vector<cursor>{cursor{root, g.first_out_edge(root)}};
+	while (auto const* e = next_depth_first(g, stack, visited)) {
+		co_yield tree_edge<N>{*std::get<0>(*e), *std::get<1>(*e)};
+	}
+}
+
+template<typename N, typename E>
+auto gdwg::traversal<N, E>::run_bfs(graph<N, E> const& g, N const* root) -> generator<N const&> {
+	auto visited = std::unordered_set<N const*>{root};
+	// Nodes are yielded as they are queued rather than as they are explored, so that none waits on its siblings
+	auto queue = std::vector<N const*>{root};
+	co_yield *root;
+	for (auto head = std::size_t{0}; head < queue.size(); ++head) {
+		auto const* const src = queue[head];
+		for (auto it = g.first_out_edge(src); it != g.edges_.end() and std::get<0>(*it).get() == src; ++it) {
+			graph<N, E>::count_visit();
+			auto const* const dst = std::get<1>(*it).get();
+			if (g.is_tombstoned(*it) or not visited.insert(dst).second)
+				continue;
+			queue.push_back(dst);
+			co_yield *dst;
+		}
+	}
+}
+
+template<typename N, typename E>
+auto gdwg::traversal<N, E>::run_bfs_edges(graph<N, E> const& g, N const* root) -> generator<tree_edge<N>> {
+	auto visited = std::unordered_set<N const*>{root};
+	auto queue = std::vector<N const*>{root};
+	for (auto head = std::size_t{0}; head < queue.size(); ++head) {
+		auto const* const src = queue[head];
+		for (auto it = g.first_out_edge(src); it != g.edges_.end() and std::get<0>(*it).get() == src; ++it) {
+			graph<N, E>::count_visit();
+			auto const* const dst = std::get<1>(*it).get();
+			if (g.is_tombstoned(*it) or not visited.insert(dst).second)
+				continue;
+			queue.push_back(dst);
+			co_yield tree_edge<N>{*src, *dst};
+		}
+	}
+}
+
+template<typename N, typename E>
+auto gdwg::traversal<N, E>::run_topological(graph<N, E> const& g) -> generator<N const&> {
+	auto in_degree = std::unordered_map<N const*, std::size_t>{};
+	in_degree.reserve(g.nodes_.size());
+	for (auto const& n : g.nodes_) {
+		in_degree.emplace(n.get(), 0);
+	}
+	for (auto const& e : g.edges_) {
+		if (not g.is_tombstoned(e))
+			++in_degree[std::get<1>(e).get()];
+	}
+	auto ready = std::vector<N const*>{};
+	for (auto const& n : g.nodes_) {
+		if (in_degree[n.get()] == 0)
+			ready.push_back(n.get());
+	}
+	// Every node is queued once its last in-edge is followed, so the queue ends up holding the whole order
+	for (auto head = std::size_t{0}; head < ready.size(); ++head) {
+		auto const* const src = ready[head];
+		co_yield *src;
+		for (auto it = g.first_out_edge(src); it != g.edges_.end() and std::get<0>(*it).get() == src; ++it) {
+			graph<N, E>::count_visit();
+			if (not g.is_tombstoned(*it) and --in_degree[std::get<1>(*it).get()] == 0)
+				ready.push_back(std::get<1>(*it).get());
+		}
+	}
+	if (ready.size() != g.nodes_.size())
+		throw std::runtime_error("Cannot call gdwg::topological on a graph with a cycle");
+}
+
+#	pragma GCC diagnostic pop
+
+template<typename N, typename E>
+auto gdwg::dfs(graph<N, E> const& g, N const& start) -> generator<N const&> {
+	return traversal<N, E>::dfs(g, start);
+}
+
+template<typename N, typename E>
+auto gdwg::dfs_edges(graph<N, E> const& g, N const& start) -> generator<tree_edge<N>> {
+	return traversal<N, E>::dfs_edges(g, start);
+}
+
+template<typename N, typename E>
+auto gdwg::bfs(graph<N, E> const& g, N const& start) -> generator<N const&> {
+	return traversal<N, E>::bfs(g, start);
+}
+
+template<typename N, typename E>
+auto gdwg::bfs_edges(graph<N, E> const& g, N const& start) -> generator<tree_edge<N>> {
+	return traversal<N, E>::bfs_edges(g, start);
+}
+
+template<typename N, typename E>
+auto gdwg::topological(graph<N, E> const& g) -> generator<N const&> {
+	return traversal<N, E>::topological(g);
+}
+
+#endif // GDWG_TRAVERSAL_H
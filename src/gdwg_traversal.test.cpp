@@ -0,0 +1,202 @@
+#include "gdwg_traversal.h"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <map>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+	template<typename R>
+	auto collect(R&& range) -> std::vector<std::ranges::range_value_t<R>> {
+		auto values = std::vector<std::ranges::range_value_t<R>>{};
+		for (auto const& value : range) {
+			values.push_back(value);
+		}
+		return values;
+	}
+
+// GCC 12 warns about a null pointer it writes into every coroutine frame
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wzero-as-null-pointer-constant"
+
+	auto counted(int& resumed) -> gdwg::generator<int> {
+		for (auto i = 0;; ++i) {
+			++resumed;
+			co_yield i;
+		}
+	}
+
+	auto failing() -> gdwg::generator<int> {
+		co_yield 1;
+		throw std::runtime_error("failed");
+	}
+
+#pragma GCC diagnostic pop
+} // namespace
+
+TEST_CASE("Generator operation", "[traversal]") {
+	SECTION("Values are computed only as far as they are read") {
+		auto resumed = 0;
+		auto values = counted(resumed);
+		REQUIRE(resumed == 0);
+		auto it = values.begin();
+		REQUIRE(*it == 0);
+		++it;
+		REQUIRE(*it == 1);
+		REQUIRE(resumed == 2);
+
+		auto more = 0;
+		for (auto const i : counted(more)) {
+			if (i == 4)
+				break;
+		}
+		REQUIRE(more == 5);
+		REQUIRE(collect(counted(more) | std::views::take(3)) == std::vector<int>{0, 1, 2});
+	}
+
+	SECTION("An exception thrown by the coroutine reaches the consumer") {
+		auto values = failing();
+		auto it = values.begin();
+		REQUIRE(*it == 1);
+		REQUIRE_THROWS_WITH(++it, "failed");
+		REQUIRE(it == values.end());
+	}
+
+	SECTION("A moved generator owns the coroutine") {
+		auto resumed = 0;
+		auto values = counted(resumed);
+		auto moved = std::move(values);
+		REQUIRE(*moved.begin() == 0);
+		values = std::move(moved);
+		REQUIRE(resumed == 1);
+	}
+
+	SECTION("Frames released on a thread are reused") {
+		auto* const frame = gdwg::allocate_frame(256);
+		gdwg::deallocate_frame(frame);
+		auto* const smaller = gdwg::allocate_frame(128);
+		REQUIRE(smaller == frame);
+		auto* const larger = gdwg::allocate_frame(512);
+		REQUIRE(larger != frame);
+		gdwg::deallocate_frame(larger);
+		gdwg::deallocate_frame(smaller);
+	}
+}
+
+TEST_CASE("Traversal operation", "[traversal]") {
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d", "e", "f"};
+	g.insert_edge("a", "b", 1);
+	g.insert_edge("a", "c", 2);
+	g.insert_edge("a", "c", 3);
+	g.insert_edge("b", "d", 4);
+	g.insert_edge("c", "d", 5);
+	g.insert_edge("d", "a", 6);
+	g.insert_edge("e", "f", 7);
+
+	SECTION("dfs yields the reachable nodes in depth-first preorder") {
+		REQUIRE(collect(gdwg::dfs(g, std::string{"a"})) == std::vector<std::string>{"a", "b", "d", "c"});
+		REQUIRE(collect(gdwg::dfs(g, std::string{"e"})) == std::vector<std::string>{"e", "f"});
+		REQUIRE(collect(gdwg::dfs(g, std::string{"f"})) == std::vector<std::string>{"f"});
+	}
+
+	SECTION("bfs yields the reachable nodes in order of distance") {
+		REQUIRE(collect(gdwg::bfs(g, std::string{"a"})) == std::vector<std::string>{"a", "b", "c", "d"});
+		REQUIRE(collect(gdwg::bfs(g, std::string{"d"})) == std::vector<std::string>{"d", "a", "b", "c"});
+	}
+
+	SECTION("The nodes yielded are the nodes stored in the graph") {
+		auto const& first = *gdwg::bfs(g, std::string{"b"}).begin();
+		REQUIRE(&first == &*gdwg::dfs(g, std::string{"b"}).begin());
+	}
+
+	SECTION("The tree edges lead back to the start") {
+		auto const& path_to = [](auto edges, std::string const& target) {
+			auto parent = std::map<std::string, std::string>{};
+			for (auto const& [from, to] : edges) {
+				parent.emplace(to, from);
+				if (to == target)
+					break;
+			}
+			auto path = std::vector<std::string>{target};
+			while (parent.contains(path.back())) {
+				path.push_back(parent.at(path.back()));
+			}
+			std::ranges::reverse(path);
+			return path;
+		};
+		REQUIRE(path_to(gdwg::bfs_edges(g, std::string{"d"}), "c") == std::vector<std::string>{"d", "a", "c"});
+		REQUIRE(path_to(gdwg::dfs_edges(g, std::string{"a"}), "d") == std::vector<std::string>{"a", "b", "d"});
+		REQUIRE(std::ranges::distance(gdwg::dfs_edges(g, std::string{"a"})) == 3);
+		REQUIRE(std::ranges::distance(gdwg::bfs_edges(g, std::string{"f"})) == 0);
+	}
+
+	SECTION("Stopping early leaves the rest of the graph unvisited") {
+		auto chain = gdwg::graph<int, int>{};
+		for (auto i = 0; i < 100'000; ++i) {
+			chain.insert_node(i);
+		}
+		for (auto i = 0; i + 1 < 100'000; ++i) {
+			chain.insert_edge(i, i + 1, i);
+		}
+		auto found = std::vector<int>{};
+		for (auto const& n : gdwg::bfs(chain, 0)) {
+			found.push_back(n);
+			if (n == 2)
+				break;
+		}
+		REQUIRE(found == std::vector<int>{0, 1, 2});
+		REQUIRE(collect(gdwg::dfs(chain, 99'990) | std::views::take(3)) == std::vector<int>{99'990, 99'991, 99'992});
+	}
+
+	SECTION("Edges of lazily erased nodes are not followed") {
+		g.set_lazy_erase(true);
+		REQUIRE(g.erase_node("b"));
+		REQUIRE(collect(gdwg::dfs(g, std::string{"a"})) == std::vector<std::string>{"a", "c", "d"});
+		REQUIRE(collect(gdwg::bfs(g, std::string{"d"})) == std::vector<std::string>{"d", "a", "c"});
+	}
+
+	SECTION("A start which doesn't exist throws before anything is read") {
+		REQUIRE_THROWS_WITH(gdwg::dfs(g, std::string{"z"}),
+		                    "Cannot call gdwg::dfs if start doesn't exist in the graph");
+		REQUIRE_THROWS_WITH(gdwg::bfs(g, std::string{"z"}),
+		                    "Cannot call gdwg::bfs if start doesn't exist in the graph");
+		REQUIRE_THROWS_WITH(gdwg::dfs_edges(g, std::string{"z"}),
+		                    "Cannot call gdwg::dfs_edges if start doesn't exist in the graph");
+		REQUIRE_THROWS_WITH(gdwg::bfs_edges(g, std::string{"z"}),
+		                    "Cannot call gdwg::bfs_edges if start doesn't exist in the graph");
+	}
+}
+
+TEST_CASE("Topological traversal operation", "[traversal]") {
+	SECTION("Every node comes after the nodes with an edge to it, ready nodes first in first out") {
+		auto g = gdwg::graph<int, int>{1, 2, 3, 4, 5, 6};
+		g.insert_edge(5, 2, 1);
+		g.insert_edge(5, 2, 2);
+		g.insert_edge(2, 4, 3);
+		g.insert_edge(1, 4, 4);
+		g.insert_edge(4, 3, 5);
+		REQUIRE(collect(gdwg::topological(g)) == std::vector<int>{1, 5, 6, 2, 4, 3});
+		REQUIRE(collect(gdwg::topological(gdwg::graph<int, int>{})).empty());
+	}
+
+	SECTION("A cycle throws once the nodes outside it are exhausted") {
+		auto g = gdwg::graph<int, int>{1, 2, 3, 4};
+		g.insert_edge(1, 2, 1);
+		g.insert_edge(2, 3, 2);
+		g.insert_edge(3, 2, 3);
+		auto order = gdwg::topological(g);
+		auto it = order.begin();
+		REQUIRE(*it == 1);
+		++it;
+		REQUIRE(*it == 4);
+		REQUIRE_THROWS_WITH(++it, "Cannot call gdwg::topological on a graph with a cycle");
+
+		auto loop = gdwg::graph<int, int>{1};
+		loop.insert_edge(1, 1, 1);
+		REQUIRE_THROWS_WITH(collect(gdwg::topological(loop)), "Cannot call gdwg::topological on a graph with a cycle");
+	}
+}
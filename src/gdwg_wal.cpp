@@ -0,0 +1,166 @@
+#include "gdwg_wal.h"
+
+#include <array>
+#include <cerrno>
+#include <fstream>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+	// The reflected CRC-32 polynomial, tabulated one byte at a time
+	constexpr auto crc_table = [] {
+		auto table = std::array<std::uint32_t, 256>{};
+		for (auto i = std::uint32_t{0}; i < table.size(); ++i) {
+			auto crc = i;
+			for (auto bit = 0; bit < 8; ++bit) {
+				crc = (crc & 1U) != 0 ? (crc >> 1U) ^ 0xedb88320U : crc >> 1U;
+			}
+			table[i] = crc;
+		}
+		return table;
+	}();
+
+	auto store_u32(char* out, std::uint32_t value) noexcept -> void {
+		for (auto i = 0U; i < 4U; ++i) {
+			out[i] = static_cast<char>(static_cast<std::uint8_t>(value >> (8U * i)));
+		}
+	}
+
+	auto load_u32(char const* in) noexcept -> std::uint32_t {
+		auto value = std::uint32_t{0};
+		for (auto i = 0U; i < 4U; ++i) {
+			value |= std::uint32_t{static_cast<std::uint8_t>(in[i])} << (8U * i);
+		}
+		return value;
+	}
+
+	[[noreturn]] auto throw_errno(char const* what) -> void {
+		throw std::system_error(errno, std::generic_category(), what);
+	}
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  CRC FUNCTIONS                                                                     //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+auto gdwg::crc32(std::string_view data, std::uint32_t crc) noexcept -> std::uint32_t {
+	crc ^= 0xffffffffU;
+	for (auto const c : data) {
+		crc = crc_table[(crc ^ static_cast<std::uint8_t>(c)) & 0xffU] ^ (crc >> 8U);
+	}
+	return crc ^ 0xffffffffU;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  WAL FRAME FUNCTIONS                                                               //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+auto gdwg::wal_frame::open(std::string& out) -> std::size_t {
+	auto const start = out.size();
+	out.append(header_size, '\0');
+	return start;
+}
+
+auto gdwg::wal_frame::seal(std::string& out, std::size_t start) noexcept -> void {
+	auto const payload = std::string_view{out}.substr(start + header_size);
+	store_u32(out.data() + start, static_cast<std::uint32_t>(payload.size()));
+	store_u32(out.data() + start + 4, crc32(payload));
+}
+
+auto gdwg::wal_frame::next(std::string_view& in) noexcept -> std::optional<std::string_view> {
+	if (in.size() < header_size)
+		return std::nullopt;
+	auto const size = load_u32(in.data());
+	if (size > in.size() - header_size)
+		return std::nullopt;
+	auto const payload = in.substr(header_size, size);
+	if (crc32(payload) != load_u32(in.data() + 4))
+		return std::nullopt;
+	in.remove_prefix(header_size + size);
+	return payload;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  DURABLE FILE FUNCTIONS                                                            //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+gdwg::durable_file::durable_file(std::filesystem::path const& path, bool truncate)
+: fd_{::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC | (truncate ? O_TRUNC : 0), 0644)} {
+	if (fd_ < 0)
+		throw_errno("Cannot construct gdwg::durable_file");
+}
+
+gdwg::durable_file::durable_file(durable_file&& other) noexcept
+: fd_{std::exchange(other.fd_, -1)} {}
+
+auto gdwg::durable_file::operator=(durable_file&& other) noexcept -> durable_file& {
+	if (this != &other) {
+		if (fd_ >= 0)
+			::close(fd_);
+		fd_ = std::exchange(other.fd_, -1);
+	}
+	return *this;
+}
+
+gdwg::durable_file::~durable_file() {
+	if (fd_ >= 0)
+		::close(fd_);
+}
+
+auto gdwg::durable_file::append(std::string_view data) -> void {
+	while (not data.empty()) {
+		auto const written = ::write(fd_, data.data(), data.size());
+		if (written < 0) {
+			if (errno == EINTR)
+				continue;
+			throw_errno("Cannot call gdwg::durable_file::append");
+		}
+		data.remove_prefix(static_cast<std::size_t>(written));
+	}
+}
+
+auto gdwg::durable_file::sync() -> void {
+	// Only the data and the size need to be durable, not the other metadata of the file
+	if (::fdatasync(fd_) != 0)
+		throw_errno("Cannot call gdwg::durable_file::sync");
+}
+
+auto gdwg::durable_file::truncate(std::size_t size) -> void {
+	if (::ftruncate(fd_, static_cast<::off_t>(size)) != 0)
+		throw_errno("Cannot call gdwg::durable_file::truncate");
+}
+
+auto gdwg::durable_file::read(std::filesystem::path const& path, std::size_t limit) -> std::optional<std::string> {
+	auto file = std::ifstream{path, std::ios::binary};
+	if (not file)
+		return std::nullopt;
+	auto const size = std::min(static_cast<std::size_t>(std::filesystem::file_size(path)), limit);
+	auto data = std::string(size, '\0');
+	file.read(data.data(), static_cast<std::streamsize>(size));
+	data.resize(static_cast<std::size_t>(file.gcount()));
+	return data;
+}
+
+auto gdwg::durable_file::replace(std::filesystem::path const& path, std::string_view data, bool sync) -> void {
+	auto tmp = path;
+	tmp += ".tmp";
+	{
+		auto file = durable_file{tmp, true};
+		file.append(data);
+		if (sync)
+			file.sync();
+	}
+	std::filesystem::rename(tmp, path);
+	if (sync)
+		sync_directory(path.parent_path());
+}
+
+auto gdwg::durable_file::sync_directory(std::filesystem::path const& dir) -> void {
+	auto const fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	if (fd < 0)
+		throw_errno("Cannot call gdwg::durable_file::sync_directory");
+	auto const result = ::fsync(fd);
+	::close(fd);
+	if (result != 0)
+		throw_errno("Cannot call gdwg::durable_file::sync_directory");
+}
@@ -0,0 +1,760 @@
+#ifndef GDWG_WAL_H
+#	define GDWG_WAL_H
+
+#	include "gdwg_graph.h"
+#	include "gdwg_io.h"
+
+#	include <algorithm>
+#	include <bit>
+#	include <concepts>
+#	include <cstddef>
+#	include <cstdint>
+#	include <exception>
+#	include <filesystem>
+#	include <memory>
+#	include <optional>
+#	include <stdexcept>
+#	include <string>
+#	include <string_view>
+#	include <type_traits>
+#	include <utility>
+#	include <vector>
+
+namespace gdwg {
+	/**
+	 * Customisation point encoding values of type T into the binary formats of the durability layer. Like std::hash
+	 * it is specialised for the types which can be encoded: arithmetic types and strings are provided, and other
+	 * node and weight types need a specialisation with the same two static functions.
+	 */
+	template<typename T>
+	struct serializer;
+
+	/**
+	 * A type with a serializer specialisation.
+	 */
+	template<typename T>
+	concept serializable = requires(std::string& out, std::string_view& in, T const& value) {
+		serializer<T>::write(out, value);
+		{ serializer<T>::read(in) } -> std::same_as<T>;
+	};
+
+	template<typename T>
+	requires std::is_arithmetic_v<T>
+	struct serializer<T> {
+		// The unsigned integer type with the same size as T, holding its object representation
+		using narrow_bits = std::conditional_t<sizeof(T) == 1, std::uint8_t, std::uint16_t>;
+		using wide_bits = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+		using bits_type = std::conditional_t<(sizeof(T) <= 2), narrow_bits, wide_bits>;
+		static_assert(sizeof(bits_type) == sizeof(T), "gdwg::serializer supports arithmetic types of up to 64 bits");
+
+		/**
+		 * @brief Appends a value in little-endian byte order.
+		 *
+		 * @param out The buffer to append to.
+		 * @param value The value to encode.
+		 */
+		static auto write(std::string& out, T const& value) -> void;
+
+		/**
+		 * @brief Decodes a value from the front of the input, which is advanced past it.
+		 * @note Marked as [[nodiscard]] because the decoded value is lost if ignored.
+		 *
+		 * @param in The input to decode from.
+		 * @return The decoded value.
+		 * @throws std::runtime_error If the input is too short.
+		 */
+		[[nodiscard]] static auto read(std::string_view& in) -> T;
+	};
+
+	template<typename CharT, typename Traits, typename Alloc>
+	struct serializer<std::basic_string<CharT, Traits, Alloc>> {
+		/**
+		 * @brief Appends the length of a string followed by its characters.
+		 *
+		 * @param out The buffer to append to.
+		 * @param value The string to encode.
+		 */
+		static auto write(std::string& out, std::basic_string<CharT, Traits, Alloc> const& value) -> void;
+
+		/**
+		 * @brief Decodes a string from the front of the input, which is advanced past it.
+		 * @note Marked as [[nodiscard]] because the decoded value is lost if ignored.
+		 *
+		 * @param in The input to decode from.
+		 * @return The decoded string.
+		 * @throws std::runtime_error If the input is too short.
+		 */
+		[[nodiscard]] static auto read(std::string_view& in) -> std::basic_string<CharT, Traits, Alloc>;
+	};
+
+	/**
+	 * @brief Computes the CRC-32 (IEEE 802.3) of some bytes, used to detect torn and corrupt records.
+	 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+	 *
+	 * @param data The bytes to checksum.
+	 * @param crc The checksum of the bytes in front of these, to checksum bytes written in several blocks.
+	 * @return The checksum.
+	 */
+	[[nodiscard]] auto crc32(std::string_view data, std::uint32_t crc = 0) noexcept -> std::uint32_t;
+
+	/**
+	 * The framing of the records of a write-ahead log: a 32-bit payload size and a 32-bit CRC of the payload in front
+	 * of every payload, so that a record torn by a crash is detected instead of replayed.
+	 */
+	struct wal_frame {
+		static constexpr std::size_t header_size = 8;
+
+		/**
+		 * @brief Reserves the header of a new record at the end of a buffer. The payload is appended after it.
+		 *
+		 * @param out The buffer to append to.
+		 * @return The position of the record, to be passed to seal once the payload has been appended.
+		 */
+		static auto open(std::string& out) -> std::size_t;
+
+		/**
+		 * @brief Fills in the header of a record whose payload has been appended.
+		 * @note Marked as noexcept because it only writes into the reserved header.
+		 *
+		 * @param out The buffer holding the record.
+		 * @param start The position returned by open.
+		 */
+		static auto seal(std::string& out, std::size_t start) noexcept -> void;
+
+		/**
+		 * @brief Takes the next intact record from the front of the input, which is advanced past it.
+		 * @note Marked as [[nodiscard]] because the payload is lost if ignored.
+		 * Marked as noexcept because a truncated or corrupt record is reported as the end of the log.
+		 *
+		 * @param in The log to read from.
+		 * @return The payload of the record, or std::nullopt at the end of the intact part of the log.
+		 */
+		[[nodiscard]] static auto next(std::string_view& in) noexcept -> std::optional<std::string_view>;
+	};
+
+	/**
+	 * An append-only file descriptor with the few POSIX operations the durability layer needs. Every failure is
+	 * reported as a std::system_error.
+	 */
+	class durable_file {
+	 public:
+		/**
+		 * Opens a file for appending, creating it if needed.
+		 *
+		 * @param path The file to open.
+		 * @param truncate True to discard the current contents of the file.
+		 */
+		durable_file(std::filesystem::path const& path, bool truncate);
+
+		durable_file(durable_file const&) = delete;
+		auto operator=(durable_file const&) -> durable_file& = delete;
+
+		/**
+		 * Move constructor. The moved-from file no longer owns a descriptor.
+		 */
+		durable_file(durable_file&& other) noexcept;
+
+		/**
+		 * Move assignment. Closes the current descriptor and takes over the one of other.
+		 */
+		auto operator=(durable_file&& other) noexcept -> durable_file&;
+
+		/**
+		 * Closes the file.
+		 */
+		~durable_file();
+
+		/**
+		 * @brief Appends bytes to the file, retrying short writes.
+		 *
+		 * @param data The bytes to append.
+		 */
+		auto append(std::string_view data) -> void;
+
+		/**
+		 * @brief Waits until the appended bytes are on stable storage.
+		 */
+		auto sync() -> void;
+
+		/**
+		 * @brief Shrinks the file, e.g. to cut off a torn record.
+		 *
+		 * @param size The new size of the file.
+		 */
+		auto truncate(std::size_t size) -> void;
+
+		/**
+		 * @brief Reads a file, or the start of it.
+		 * @note Marked as [[nodiscard]] because the contents are lost if ignored.
+		 *
+		 * @param path The file to read.
+		 * @param limit The maximum number of bytes to read.
+		 * @return The contents of the file, or std::nullopt if it does not exist.
+		 */
+		[[nodiscard]] static auto read(std::filesystem::path const& path, std::size_t limit = std::string::npos)
+		    -> std::optional<std::string>;
+
+		/**
+		 * @brief Replaces a file atomically: the data is written to a temporary file which is then renamed over it,
+		 * so that a crash leaves either the old or the new contents.
+		 *
+		 * @param path The file to replace.
+		 * @param data The new contents.
+		 * @param sync True to wait until the new contents and the rename are on stable storage.
+		 */
+		static auto replace(std::filesystem::path const& path, std::string_view data, bool sync) -> void;
+
+		/**
+		 * @brief Waits until the entries of a directory, e.g. a created or renamed file, are on stable storage.
+		 *
+		 * @param dir The directory.
+		 */
+		static auto sync_directory(std::filesystem::path const& dir) -> void;
+
+	 private:
+		int fd_;
+	};
+
+	/**
+	 * The durability settings of a write_ahead_log.
+	 */
+	struct wal_options {
+		// Records buffered and committed together. 1 makes every change durable before its modifier returns, larger
+		// groups amortise the write and fsync over many changes at the cost of losing the last group in a crash.
+		std::size_t group_records = 256;
+		// Buffered bytes after which a group is committed early.
+		std::size_t group_bytes = std::size_t{1} << 20U;
+		// True to fsync every group commit. Without it commits survive a process crash, but not a power loss.
+		bool sync = true;
+		// Records after which maybe_checkpoint writes a checkpoint.
+		std::size_t checkpoint_records = std::size_t{1} << 20U;
+	};
+
+	/**
+	 * A mutation_sink making a graph durable. Every change is appended to a binary log in group commits, and
+	 * checkpoints store the whole graph so that the log can be truncated. recover rebuilds the graph from the
+	 * directory after a crash.
+	 *
+	 * The directory holds a "checkpoint" file and a "wal-<generation>" log of the changes made after it. Writing a
+	 * checkpoint starts the next generation, so a crash at any point leaves either the old checkpoint and its log,
+	 * or the new checkpoint and an empty log.
+	 *
+	 * Like the graph it is attached to, a log is used by one thread at a time. A change which cannot be logged, e.g.
+	 * because the disk is full, makes the next flush or checkpoint throw; a successful checkpoint repairs the log.
+	 */
+	template<typename N, typename E>
+	requires serializable<N> and serializable<E>
+	class write_ahead_log final : public mutation_sink<N, E> {
+	 public:
+		/**
+		 * Opens the log in a directory, creating the directory if needed. A torn record at the end of an existing
+		 * log is cut off, so the log continues from the state recover returns for the directory.
+		 *
+		 * @param dir The directory of the log.
+		 * @param options The durability settings.
+		 */
+		explicit write_ahead_log(std::filesystem::path dir, wal_options const& options = wal_options{});
+
+		write_ahead_log(write_ahead_log const&) = delete;
+		auto operator=(write_ahead_log const&) -> write_ahead_log& = delete;
+
+		/**
+		 * Commits the buffered changes. Failures are ignored here; call flush to observe them.
+		 */
+		~write_ahead_log() override;
+
+		/**
+		 * @brief Appends a change to the current group, committing the group once it is full. Cascaded edge removals
+		 * are not logged, as replaying the erase_node they follow removes them again.
+		 * @note Marked as noexcept because the change has already been made; failures surface in flush.
+		 *
+		 * @param event The change.
+		 */
+		auto on_mutation(mutation<N, E> const& event) noexcept -> void override;
+
+		/**
+		 * @brief Marks the log as incomplete, as a change could not be logged.
+		 */
+		auto on_lost() noexcept -> void override;
+
+		/**
+		 * @brief Commits the buffered changes, making every change so far durable.
+		 *
+		 * @throws std::system_error If a write or fsync failed since the last checkpoint.
+		 * @throws std::runtime_error If a change could not be logged since the last checkpoint.
+		 */
+		auto flush() -> void;
+
+		/**
+		 * @brief Writes a checkpoint of a graph and starts a new, empty log.
+		 *
+		 * @param g The graph this log is attached to.
+		 * @throws std::system_error If the checkpoint could not be written, in which case the old one stays valid.
+		 */
+		auto checkpoint(graph<N, E> const& g) -> void;
+
+		/**
+		 * @brief Writes a checkpoint if options.checkpoint_records changes were logged since the last one.
+		 *
+		 * @param g The graph this log is attached to.
+		 * @return True if a checkpoint was written, otherwise false.
+		 */
+		auto maybe_checkpoint(graph<N, E> const& g) -> bool;
+
+		/**
+		 * @brief Returns the number of changes logged since the last checkpoint.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 *
+		 * @return The length of the log.
+		 */
+		[[nodiscard]] auto records() const noexcept -> std::size_t;
+
+		/**
+		 * @brief Returns the generation of the current checkpoint and log, 0 before the first checkpoint.
+		 * @note Marked as [[nodiscard]] because the result is important and should not be ignored.
+		 *
+		 * @return The generation.
+		 */
+		[[nodiscard]] auto generation() const noexcept -> std::uint64_t;
+
+		/**
+		 * @brief Returns the path of the checkpoint file in a directory.
+		 *
+		 * @param dir The directory of the log.
+		 * @return The path of the checkpoint.
+		 */
+		[[nodiscard]] static auto checkpoint_path(std::filesystem::path const& dir) -> std::filesystem::path;
+
+		/**
+		 * @brief Returns the path of the log of a generation in a directory.
+		 *
+		 * @param dir The directory of the log.
+		 * @param generation The generation.
+		 * @return The path of the log.
+		 */
+		[[nodiscard]] static auto log_path(std::filesystem::path const& dir, std::uint64_t generation)
+		    -> std::filesystem::path;
+
+		/**
+		 * @brief Rebuilds a graph made durable by a log, from the last checkpoint in the directory followed by the
+		 * changes logged after it. A torn record at the end of the log, left by a crash during a write, ends the
+		 * replay.
+		 * @note Marked as [[nodiscard]] because the recovered graph is lost if ignored.
+		 *
+		 * Time complexity: O((n + e) log (n + e)) for the checkpoint, plus the cost of replaying the log.
+		 *
+		 * @param dir The directory of the log.
+		 * @return The recovered graph, or an empty graph if the directory holds no checkpoint and no log.
+		 * @throws std::runtime_error If the checkpoint is corrupt or the log does not apply to it.
+		 */
+		[[nodiscard]] static auto recover(std::filesystem::path const& dir) -> graph<N, E>;
+
+		/**
+		 * @brief Encodes a graph as a checkpoint, handing it to a writer one block at a time.
+		 *
+		 * @param g The graph to encode.
+		 * @param generation The generation of the log following the checkpoint.
+		 * @param out The writer of the checkpoint file, which is left to be committed.
+		 */
+		static auto encode_checkpoint(graph<N, E> const& g, std::uint64_t generation, async_writer& out) -> void;
+
+		/**
+		 * @brief Decodes a checkpoint, assembling the graph with graph_builder::from_sorted as the checkpoint holds
+		 * its nodes and edges in order.
+		 *
+		 * Time complexity: O(n + e log n).
+		 *
+		 * @param data The checkpoint.
+		 * @param g The graph to replace with the decoded one.
+		 * @return The generation of the log following the checkpoint.
+		 * @throws std::runtime_error If the checkpoint is corrupt.
+		 */
+		static auto decode_checkpoint(std::string_view data, graph<N, E>& g) -> std::uint64_t;
+
+		/**
+		 * @brief Encodes a change as the payload of a log record.
+		 *
+		 * @param out The buffer to append to.
+		 * @param event The change.
+		 */
+		static auto encode_mutation(std::string& out, mutation<N, E> const& event) -> void;
+
+		/**
+		 * @brief Decodes the payload of a log record.
+		 *
+		 * @param payload The payload.
+		 * @return The change.
+		 * @throws std::runtime_error If the payload is malformed.
+		 */
+		[[nodiscard]] static auto decode_mutation(std::string_view payload) -> mutation<N, E>;
+
+	 private:
+		static constexpr std::string_view checkpoint_magic = "GDWGCKPT";
+
+		std::filesystem::path dir_;
+		wal_options options_;
+		std::uint64_t generation_;
+		std::unique_ptr<durable_file> log_;
+		std::string buffer_;
+		std::size_t pending_;
+		std::size_t records_;
+		std::exception_ptr error_;
+		// The size of the log up to the last group committed, which a failed group is cut back to
+		std::size_t log_size_;
+		// True if a failed group could not be cut off, so that nothing can be appended after it
+		bool torn_;
+
+		/**
+		 * @brief Writes and syncs the buffered group. If that fails, the log is cut back to its size before the
+		 * group, so that committing the group again neither leaves a torn record in front of it nor repeats it.
+		 */
+		auto commit() -> void;
+	};
+} // namespace gdwg
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  SERIALIZER FUNCTIONS                                                              //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename T>
+requires std::is_arithmetic_v<T>
+auto gdwg::serializer<T>::write(std::string& out, T const& value) -> void {
+	auto const bits = static_cast<std::uint64_t>(std::bit_cast<bits_type>(value));
+	for (auto i = std::size_t{0}; i < sizeof(T); ++i) {
+		out.push_back(static_cast<char>(static_cast<std::uint8_t>(bits >> (8 * i))));
+	}
+}
+
+template<typename T>
+requires std::is_arithmetic_v<T>
+auto gdwg::serializer<T>::read(std::string_view& in) -> T {
+	if (in.size() < sizeof(T))
+		throw std::runtime_error("Cannot call gdwg::serializer<T>::read on a truncated input");
+	auto bits = std::uint64_t{0};
+	for (auto i = std::size_t{0}; i < sizeof(T); ++i) {
+		bits |= std::uint64_t{static_cast<std::uint8_t>(in[i])} << (8 * i);
+	}
+	in.remove_prefix(sizeof(T));
+	return std::bit_cast<T>(static_cast<bits_type>(bits));
+}
+
+template<typename CharT, typename Traits, typename Alloc>
+auto gdwg::serializer<std::basic_string<CharT, Traits, Alloc>>::write(
+    std::string& out,
+    std::basic_string<CharT, Traits, Alloc> const& value) -> void {
+	serializer<std::uint64_t>::write(out, value.size());
+	for (auto const& c : value) {
+		serializer<CharT>::write(out, c);
+	}
+}
+
+template<typename CharT, typename Traits, typename Alloc>
+auto gdwg::serializer<std::basic_string<CharT, Traits, Alloc>>::read(std::string_view& in)
+    -> std::basic_string<CharT, Traits, Alloc> {
+	auto const size = serializer<std::uint64_t>::read(in);
+	// Check the length before allocating, so that a corrupt length cannot request an absurd amount of memory
+	if (size > in.size() / sizeof(CharT))
+		throw std::runtime_error("Cannot call gdwg::serializer<std::basic_string>::read on a truncated input");
+	auto value = std::basic_string<CharT, Traits, Alloc>{};
+	value.reserve(static_cast<std::size_t>(size));
+	for (auto i = std::uint64_t{0}; i < size; ++i) {
+		value.push_back(serializer<CharT>::read(in));
+	}
+	return value;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                  WRITE AHEAD LOG FUNCTIONS                                                         //
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template<typename N, typename E>
+requires gdwg::serializable<N> and gdwg::serializable<E>
+gdwg::write_ahead_log<N, E>::write_ahead_log(std::filesystem::path dir, wal_options const& options)
+: dir_{std::move(dir)}
+, options_{options}
+, generation_{0}
+, log_{nullptr}
+, buffer_{}
+, pending_{0}
+, records_{0}
+, error_{nullptr}
+, log_size_{0}
+, torn_{false} {
+	std::filesystem::create_directories(dir_);
+	// Only the header of the checkpoint is needed to find the current generation
+	if (auto const& header = durable_file::read(checkpoint_path(dir_), checkpoint_magic.size() + sizeof(std::uint64_t))) {
+		auto in = std::string_view{*header};
+		if (not in.starts_with(checkpoint_magic))
+			throw std::runtime_error("Cannot construct gdwg::write_ahead_log<N, E> on a corrupt checkpoint");
+		in.remove_prefix(checkpoint_magic.size());
+		generation_ = serializer<std::uint64_t>::read(in);
+	}
+	// Continue after the last intact record, cutting off one torn by a crash
+	auto const& path = log_path(dir_, generation_);
+	auto valid = std::size_t{0};
+	if (auto const& log = durable_file::read(path)) {
+		auto in = std::string_view{*log};
+		while (wal_frame::next(in)) {
+			++records_;
+		}
+		valid = log->size() - in.size();
+	}
+	log_ = std::make_unique<durable_file>(path, false);
+	log_->truncate(valid);
+	log_size_ = valid;
+	durable_file::sync_directory(dir_);
+	buffer_.reserve(options_.group_bytes);
+}
+
+template<typename N, typename E>
+requires gdwg::serializable<N> and gdwg::serializable<E>
+gdwg::write_ahead_log<N, E>::~write_ahead_log() {
+	try {
+		commit();
+	} catch (...) {
+		// Destructors must not throw; flush reports the failure to callers who need to know
+	}
+}
+
+template<typename N, typename E>
+requires gdwg::serializable<N> and gdwg::serializable<E>
+auto gdwg::write_ahead_log<N, E>::on_mutation(mutation<N, E> const& event) noexcept -> void {
+	if (event.cascaded)
+		return;
+	try {
+		auto const start = wal_frame::open(buffer_);
+		encode_mutation(buffer_, event);
+		wal_frame::seal(buffer_, start);
+		++pending_;
+		++records_;
+		if (pending_ >= options_.group_records or buffer_.size() >= options_.group_bytes)
+			commit();
+	} catch (...) {
+		if (not error_)
+			error_ = std::current_exception();
+	}
+}
+
+template<typename N, typename E>
+requires gdwg::serializable<N> and gdwg::serializable<E>
+auto gdwg::write_ahead_log<N, E>::on_lost() noexcept -> void {
+	if (not error_)
+		error_ = std::make_exception_ptr(std::runtime_error("gdwg::write_ahead_log is missing a change which could "
+		                                                    "not be logged, write a checkpoint to repair it"));
+}
+
+template<typename N, typename E>
+requires gdwg::serializable<N> and gdwg::serializable<E>
+auto gdwg::write_ahead_log<N, E>::flush() -> void {
+	if (error_)
+		std::rethrow_exception(error_);
+	commit();
+}
+
+template<typename N, typename E>
+requires gdwg::serializable<N> and gdwg::serializable<E>
+auto gdwg::write_ahead_log<N, E>::checkpoint(graph<N, E> const& g) -> void {
+	// The checkpoint holds every change, so the buffered ones only need to reach the old log if writing it fails
+	auto const next = generation_ + 1;
+	auto next_log = durable_file{log_path(dir_, next), true};
+	auto checkpoint = async_writer{checkpoint_path(dir_)};
+	encode_checkpoint(g, next, checkpoint);
+	checkpoint.commit(options_.sync);
+	// From here on recovery reads the new checkpoint, so the old log and anything buffered for it are obsolete
+	auto const& old_log = log_path(dir_, generation_);
+	*log_ = std::move(next_log);
+	generation_ = next;
+	buffer_.clear();
+	pending_ = 0;
+	records_ = 0;
+	error_ = nullptr;
+	log_size_ = 0;
+	torn_ = false;
+	std::filesystem::remove(old_log);
+}
+
+template<typename N, typename E>
+requires gdwg::serializable<N> and gdwg::serializable<E>
+auto gdwg::write_ahead_log<N, E>::maybe_checkpoint(graph<N, E> const& g) -> bool {
+	if (records_ < options_.checkpoint_records)
+		return false;
+	checkpoint(g);
+	return true;
+}
+
+template<typename N, typename E>
+requires gdwg::serializable<N> and gdwg::serializable<E>
+auto gdwg::write_ahead_log<N, E>::records() const noexcept -> std::size_t {
+	return records_;
+}
+
+template<typename N, typename E>
+requires gdwg::serializable<N> and gdwg::serializable<E>
+auto gdwg::write_ahead_log<N, E>::generation() const noexcept -> std::uint64_t {
+	return generation_;
+}
+
+template<typename N, typename E>
+requires gdwg::serializable<N> and gdwg::serializable<E>
+auto gdwg::write_ahead_log<N, E>::checkpoint_path(std::filesystem::path const& dir) -> std::filesystem::path {
+	return dir / "checkpoint";
+}
+
+template<typename N, typename E>
+requires gdwg::serializable<N> and gdwg::serializable<E>
+auto gdwg::write_ahead_log<N, E>::log_path(std::filesystem::path const& dir, std::uint64_t generation)
+    -> std::filesystem::path {
+	return dir / ("wal-" + std::to_string(generation));
+}
+
+template<typename N, typename E>
+requires gdwg::serializable<N> and gdwg::serializable<E>
+auto gdwg::write_ahead_log<N, E>::recover(std::filesystem::path const& dir) -> graph<N, E> {
+	auto g = graph<N, E>{};
+	auto generation = std::uint64_t{0};
+	if (auto const& checkpoint = durable_file::read(checkpoint_path(dir))) {
+		generation = decode_checkpoint(*checkpoint, g);
+	}
+	if (auto const& log = durable_file::read(log_path(dir, generation))) {
+		auto in = std::string_view{*log};
+		while (auto const& payload = wal_frame::next(in)) {
+			g.apply(decode_mutation(*payload));
+		}
+	}
+	return g;
+}
+
+template<typename N, typename E>
+requires gdwg::serializable<N> and gdwg::serializable<E>
+auto gdwg::write_ahead_log<N, E>::encode_checkpoint(graph<N, E> const& g, std::uint64_t generation, async_writer& out)
+    -> void {
+	// The CRC is carried across the blocks handed to the writer
+	auto block = std::string{checkpoint_magic};
+	auto crc = std::uint32_t{0};
+	auto const& hand_over = [&out, &block, &crc](std::size_t at_least) {
+		if (block.size() < at_least)
+			return;
+		crc = crc32(block, crc);
+		out.write(std::exchange(block, std::string{}));
+	};
+	serializer<std::uint64_t>::write(block, generation);
+	serializer<std::uint64_t>::write(block, g.node_count());
+	g.for_each_node([&](N const& value) {
+		serializer<N>::write(block, value);
+		hand_over(out.block_bytes());
+	});
+	serializer<std::uint64_t>::write(block, g.edge_count());
+	g.for_each_edge([&](N const& src, N const& dst, std::optional<E> const& weight) {
+		serializer<N>::write(block, src);
+		serializer<N>::write(block, dst);
+		serializer<bool>::write(block, weight.has_value());
+		if (weight)
+			serializer<E>::write(block, *weight);
+		hand_over(out.block_bytes());
+	});
+	hand_over(0);
+	serializer<std::uint32_t>::write(block, crc);
+	out.write(std::move(block));
+}
+
+template<typename N, typename E>
+requires gdwg::serializable<N> and gdwg::serializable<E>
+auto gdwg::write_ahead_log<N, E>::decode_checkpoint(std::string_view data, graph<N, E>& g) -> std::uint64_t {
+	if (data.size() < checkpoint_magic.size() + sizeof(std::uint32_t) or not data.starts_with(checkpoint_magic))
+		throw std::runtime_error("Cannot call gdwg::write_ahead_log<N, E>::decode_checkpoint on a corrupt checkpoint");
+	// The checkpoint ends with the CRC of everything in front of it
+	auto const body = data.substr(0, data.size() - sizeof(std::uint32_t));
+	auto trailer = data.substr(body.size());
+	if (serializer<std::uint32_t>::read(trailer) != crc32(body))
+		throw std::runtime_error("Cannot call gdwg::write_ahead_log<N, E>::decode_checkpoint on a corrupt checkpoint");
+
+	// The checkpoint holds the nodes and edges in the order the graph stores them, so they are appended in bulk
+	auto in = body.substr(checkpoint_magic.size());
+	auto const generation = serializer<std::uint64_t>::read(in);
+	// Every value takes at least a byte, which bounds the counts of a checkpoint which is corrupt all the same
+	auto const node_count = serializer<std::uint64_t>::read(in);
+	auto nodes = std::vector<N>{};
+	nodes.reserve(static_cast<std::size_t>(std::min<std::uint64_t>(node_count, in.size())));
+	for (auto i = std::uint64_t{0}; i < node_count; ++i) {
+		nodes.push_back(serializer<N>::read(in));
+	}
+	auto const& position = [&nodes](N const& value) {
+		auto const it = std::ranges::lower_bound(nodes, value);
+		if (it == nodes.end() or value < *it)
+			throw std::runtime_error("Cannot call gdwg::write_ahead_log<N, E>::decode_checkpoint on a corrupt "
+			                         "checkpoint");
+		return static_cast<std::size_t>(it - nodes.begin());
+	};
+	using builder = graph_builder<N, E>;
+	auto const edge_count = serializer<std::uint64_t>::read(in);
+	auto edges = std::vector<typename builder::indexed_edge>{};
+	edges.reserve(static_cast<std::size_t>(std::min<std::uint64_t>(edge_count, in.size())));
+	for (auto i = std::uint64_t{0}; i < edge_count; ++i) {
+		auto const src = position(serializer<N>::read(in));
+		auto const dst = position(serializer<N>::read(in));
+		auto weight = std::optional<E>{};
+		if (serializer<bool>::read(in))
+			weight = serializer<E>::read(in);
+		edges.push_back({src, dst, std::move(weight)});
+	}
+	g = builder::from_sorted(std::move(nodes), edges);
+	return generation;
+}
+
+template<typename N, typename E>
+requires gdwg::serializable<N> and gdwg::serializable<E>
+auto gdwg::write_ahead_log<N, E>::encode_mutation(std::string& out, mutation<N, E> const& event) -> void {
+	// One byte for the kind, then one flag bit per optional field
+	auto const flags = static_cast<std::uint8_t>((event.src ? 1U : 0U) | (event.dst ? 2U : 0U) | (event.weight ? 4U : 0U));
+	serializer<std::uint8_t>::write(out, static_cast<std::uint8_t>(event.kind));
+	serializer<std::uint8_t>::write(out, flags);
+	if (event.src)
+		serializer<N>::write(out, *event.src);
+	if (event.dst)
+		serializer<N>::write(out, *event.dst);
+	if (event.weight)
+		serializer<E>::write(out, *event.weight);
+}
+
+template<typename N, typename E>
+requires gdwg::serializable<N> and gdwg::serializable<E>
+auto gdwg::write_ahead_log<N, E>::decode_mutation(std::string_view payload) -> mutation<N, E> {
+	auto const kind = serializer<std::uint8_t>::read(payload);
+	auto const flags = serializer<std::uint8_t>::read(payload);
+	if (kind > static_cast<std::uint8_t>(mutation_kind::clear))
+		throw std::runtime_error("Cannot call gdwg::write_ahead_log<N, E>::decode_mutation on an unknown change");
+	auto event = mutation<N, E>{static_cast<mutation_kind>(kind), std::nullopt, std::nullopt, std::nullopt, false};
+	if ((flags & 1U) != 0)
+		event.src = serializer<N>::read(payload);
+	if ((flags & 2U) != 0)
+		event.dst = serializer<N>::read(payload);
+	if ((flags & 4U) != 0)
+		event.weight = serializer<E>::read(payload);
+	return event;
+}
+
+template<typename N, typename E>
+requires gdwg::serializable<N> and gdwg::serializable<E>
+auto gdwg::write_ahead_log<N, E>::commit() -> void {
+	if (buffer_.empty())
+		return;
+	if (torn_)
+		throw std::runtime_error("Cannot call gdwg::write_ahead_log<N, E>::commit after a group which could not be cut "
+		                         "off, write a checkpoint to repair it");
+	try {
+		log_->append(buffer_);
+		if (options_.sync)
+			log_->sync();
+	} catch (...) {
+		// The group may be partly written, or written but not durable, so it is cut off to be committed again
+		try {
+			log_->truncate(log_size_);
+		} catch (...) {
+			torn_ = true;
+		}
+		throw;
+	}
+	log_size_ += buffer_.size();
+	buffer_.clear();
+	pending_ = 0;
+}
+
+#endif // GDWG_WAL_H
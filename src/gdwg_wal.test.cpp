@@ -0,0 +1,233 @@
+#include "gdwg_testing.h"
+#include "gdwg_wal.h"
+
+#include <catch2/catch.hpp>
+
+#include <csignal>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include <sys/resource.h>
+
+namespace {
+	using gdwg::testing::scratch_dir;
+
+	using graph_type = gdwg::graph<std::string, int>;
+	using log_type = gdwg::write_ahead_log<std::string, int>;
+
+	auto populate(graph_type& g) -> void {
+		g.insert_node("A");
+		g.insert_node("B");
+		g.insert_node("C");
+		g.insert_edge("A", "B", 1);
+		g.insert_edge("B", "C");
+		g.insert_edge("C", "A", 3);
+	}
+} // namespace
+
+TEST_CASE("Serializer operation", "[wal]") {
+	SECTION("Values round-trip in order") {
+		auto out = std::string{};
+		gdwg::serializer<int>::write(out, -42);
+		gdwg::serializer<double>::write(out, 2.5);
+		gdwg::serializer<bool>::write(out, true);
+		gdwg::serializer<std::string>::write(out, "hello");
+		gdwg::serializer<std::uint64_t>::write(out, 0x0102030405060708U);
+		REQUIRE(out.size() == 4 + 8 + 1 + 8 + 5 + 8);
+		auto in = std::string_view{out};
+		REQUIRE(gdwg::serializer<int>::read(in) == -42);
+		REQUIRE(gdwg::serializer<double>::read(in) == 2.5);
+		REQUIRE(gdwg::serializer<bool>::read(in));
+		REQUIRE(gdwg::serializer<std::string>::read(in) == "hello");
+		REQUIRE(gdwg::serializer<std::uint64_t>::read(in) == 0x0102030405060708U);
+		REQUIRE(in.empty());
+	}
+
+	SECTION("Integers are little-endian") {
+		auto out = std::string{};
+		gdwg::serializer<std::uint16_t>::write(out, 0x1234);
+		REQUIRE(out == std::string{"\x34\x12"});
+	}
+
+	SECTION("Truncated input throws") {
+		auto out = std::string{};
+		gdwg::serializer<std::string>::write(out, "hello");
+		out.pop_back();
+		auto in = std::string_view{out};
+		REQUIRE_THROWS_AS(gdwg::serializer<std::string>::read(in), std::runtime_error);
+		auto short_in = std::string_view{"\x01\x02"};
+		REQUIRE_THROWS_AS(gdwg::serializer<int>::read(short_in), std::runtime_error);
+	}
+
+	SECTION("Only supported types are serializable") {
+		STATIC_REQUIRE(gdwg::serializable<int>);
+		STATIC_REQUIRE(gdwg::serializable<std::string>);
+		STATIC_REQUIRE_FALSE(gdwg::serializable<std::vector<int>>);
+	}
+}
+
+TEST_CASE("WAL frame operation", "[wal]") {
+	REQUIRE(gdwg::crc32("123456789") == 0xcbf43926U);
+	auto log = std::string{};
+	for (auto const* payload : {"first", "second"}) {
+		auto const start = gdwg::wal_frame::open(log);
+		log += payload;
+		gdwg::wal_frame::seal(log, start);
+	}
+
+	SECTION("Intact records are read back in order") {
+		auto in = std::string_view{log};
+		REQUIRE(gdwg::wal_frame::next(in) == "first");
+		REQUIRE(gdwg::wal_frame::next(in) == "second");
+		REQUIRE_FALSE(gdwg::wal_frame::next(in));
+	}
+
+	SECTION("A torn or corrupt record ends the log") {
+		auto torn = std::string_view{log}.substr(0, log.size() - 1);
+		REQUIRE(gdwg::wal_frame::next(torn) == "first");
+		REQUIRE_FALSE(gdwg::wal_frame::next(torn));
+		log[gdwg::wal_frame::header_size] = 'F';
+		auto corrupt = std::string_view{log};
+		REQUIRE_FALSE(gdwg::wal_frame::next(corrupt));
+	}
+}
+
+TEST_CASE("Graph recover operation", "[wal]") {
+	auto const dir = scratch_dir{};
+
+	SECTION("An empty directory recovers an empty graph") {
+		REQUIRE(log_type::recover(dir.path).empty());
+	}
+
+	SECTION("Every logged change is recovered") {
+		auto g = graph_type{};
+		auto const wal = std::make_shared<log_type>(dir.path, gdwg::wal_options{.group_records = 1});
+		g.attach(wal);
+		populate(g);
+		g.replace_node("C", "D");
+		g.erase_edge("A", "B", 1);
+		g.insert_node("E");
+		g.merge_replace_node("E", "A");
+		REQUIRE(log_type::recover(dir.path) == g);
+	}
+
+	SECTION("Cascaded edge removals are not logged") {
+		auto g = graph_type{};
+		auto const wal = std::make_shared<log_type>(dir.path);
+		g.attach(wal);
+		populate(g);
+		REQUIRE(wal->records() == 6);
+		g.erase_node("A");
+		REQUIRE(wal->records() == 7);
+		wal->flush();
+		REQUIRE(log_type::recover(dir.path) == g);
+	}
+
+	SECTION("Changes are buffered until the group is committed") {
+		auto g = graph_type{};
+		auto const wal = std::make_shared<log_type>(dir.path, gdwg::wal_options{.group_records = 100, .sync = false});
+		g.attach(wal);
+		populate(g);
+		REQUIRE(log_type::recover(dir.path).empty());
+		wal->flush();
+		REQUIRE(log_type::recover(dir.path) == g);
+	}
+
+	SECTION("A checkpoint starts a new, empty log") {
+		auto g = graph_type{};
+		auto const wal = std::make_shared<log_type>(dir.path);
+		g.attach(wal);
+		populate(g);
+		wal->checkpoint(g);
+		REQUIRE(wal->generation() == 1);
+		REQUIRE(wal->records() == 0);
+		REQUIRE_FALSE(std::filesystem::exists(log_type::log_path(dir.path, 0)));
+		REQUIRE(log_type::recover(dir.path) == g);
+		g.erase_node("B");
+		g.insert_edge("A", "A", 9);
+		wal->flush();
+		REQUIRE(log_type::recover(dir.path) == g);
+	}
+
+	SECTION("maybe_checkpoint checkpoints after the configured number of changes") {
+		auto g = graph_type{};
+		auto const wal = std::make_shared<log_type>(dir.path, gdwg::wal_options{.checkpoint_records = 4});
+		g.attach(wal);
+		g.insert_node("A");
+		REQUIRE_FALSE(wal->maybe_checkpoint(g));
+		populate(g);
+		REQUIRE(wal->maybe_checkpoint(g));
+		REQUIRE(wal->generation() == 1);
+	}
+
+	SECTION("A torn tail is ignored and cut off when the log is reopened") {
+		auto g = graph_type{};
+		{
+			auto const wal = std::make_shared<log_type>(dir.path);
+			g.attach(wal);
+			populate(g);
+			g.detach(wal);
+		}
+		auto out = std::ofstream{log_type::log_path(dir.path, 0), std::ios::binary | std::ios::app};
+		out.write("\x10\x00\x00\x00torn", 8);
+		out.close();
+		REQUIRE(log_type::recover(dir.path) == g);
+
+		auto recovered = log_type::recover(dir.path);
+		auto const wal = std::make_shared<log_type>(dir.path);
+		REQUIRE(wal->records() == 6);
+		recovered.attach(wal);
+		recovered.insert_node("Z");
+		wal->flush();
+		REQUIRE(log_type::recover(dir.path) == recovered);
+	}
+
+	SECTION("A lost change fails the next flush until a checkpoint") {
+		auto g = graph_type{};
+		auto const wal = std::make_shared<log_type>(dir.path);
+		g.attach(wal);
+		populate(g);
+		wal->on_lost();
+		REQUIRE_THROWS_AS(wal->flush(), std::runtime_error);
+		wal->checkpoint(g);
+		REQUIRE_NOTHROW(wal->flush());
+		REQUIRE(log_type::recover(dir.path) == g);
+	}
+
+	SECTION("A group which fails part way is cut off and committed again in full") {
+		auto g = graph_type{};
+		auto const wal = std::make_shared<log_type>(dir.path, gdwg::wal_options{.group_records = 100, .sync = false});
+		g.attach(wal);
+		populate(g);
+		wal->flush();
+		auto const committed = std::filesystem::file_size(log_type::log_path(dir.path, 0));
+		g.insert_node("D");
+		g.insert_edge("D", "A", 4);
+		// A write past the file size limit is cut short, and the next one fails with EFBIG while SIGXFSZ is ignored
+		auto const previous_handler = std::signal(SIGXFSZ, SIG_IGN);
+		auto limit = ::rlimit{};
+		::getrlimit(RLIMIT_FSIZE, &limit);
+		auto const previous_limit = limit;
+		limit.rlim_cur = committed + 4;
+		::setrlimit(RLIMIT_FSIZE, &limit);
+		REQUIRE_THROWS_AS(wal->flush(), std::system_error);
+		::setrlimit(RLIMIT_FSIZE, &previous_limit);
+		std::signal(SIGXFSZ, previous_handler);
+		REQUIRE(std::filesystem::file_size(log_type::log_path(dir.path, 0)) == committed);
+		wal->flush();
+		REQUIRE(log_type::recover(dir.path) == g);
+		REQUIRE(log_type{dir.path}.records() == 8);
+	}
+
+	SECTION("A corrupt checkpoint is reported") {
+		auto g = graph_type{};
+		populate(g);
+		auto wal = log_type{dir.path};
+		wal.checkpoint(g);
+		auto data = *gdwg::durable_file::read(log_type::checkpoint_path(dir.path));
+		data[data.size() / 2] = static_cast<char>(data[data.size() / 2] ^ 0x55);
+		gdwg::durable_file::replace(log_type::checkpoint_path(dir.path), data, false);
+		REQUIRE_THROWS_AS(log_type::recover(dir.path), std::runtime_error);
+	}
+}